@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "graph_optimizer.h"
+#include "inference_engine.h"
+#include "onnx_parser.h"
+#include "perf_counters.h"
+#include "data_type.h"
+#include "kernels/kernels.h"
+
+// kernel and model micro-benchmarks. every iteration is timed on its own and, when
+// the kernel exposes them, wrapped in hardware counter reads so the report can tell
+// compute-bound (high IPC) from memory-bound (low IPC, high LLC miss rate) cases
+
+namespace
+{
+
+struct Result
+{
+    std::string name;
+    std::vector<double> seconds;        // per iteration
+    double flops = 0.0;                 // per iteration, 0 when not meaningful
+    PerfSample counters;                // summed over iterations
+};
+
+Result measure(const std::string& name, double flops, int iterations, const PerfCounters& counters, const std::function<void()>& fn)
+{
+    Result result;
+    result.name = name;
+    result.flops = flops;
+
+    fn();                                                   // warm caches and lazy allocations
+    for (int i = 0; i < iterations; ++i)
+    {
+        const PerfSample before = counters.read();
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.counters += counters.read() - before;
+        result.seconds.push_back(elapsed.count());
+    }
+    return result;
+}
+
+void print_results(const std::vector<Result>& results, const PerfCounters& counters)
+{
+    const bool counted = counters.available();
+    std::cout << std::left << std::setw(28) << "benchmark" << std::right << std::setw(12) << "median us" << std::setw(12) << "min us"
+              << std::setw(10) << "GFLOP/s";
+    if (counted) std::cout << std::setw(8) << "IPC" << std::setw(10) << "LLC miss%" << std::setw(14) << "instr/iter";
+    std::cout << "\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (Result r : results)
+    {
+        std::sort(r.seconds.begin(), r.seconds.end());
+        const double median = r.seconds[r.seconds.size() / 2];
+        std::cout << std::left << std::setw(28) << r.name << std::right << std::setw(12) << median * 1e6 << std::setw(12) << r.seconds[0] * 1e6
+                  << std::setw(10) << (r.flops > 0 ? r.flops / median * 1e-9 : 0.0);
+        if (counted)
+        {
+            const double instructions = r.counters.has(PerfSample::Instructions) ? static_cast<double>(r.counters.values[PerfSample::Instructions]) / r.seconds.size() : 0.0;
+            std::cout << std::setw(8) << r.counters.ipc() << std::setw(10) << 100.0 * r.counters.miss_rate() << std::setw(14) << std::setprecision(0) << instructions << std::setprecision(2);
+        }
+        std::cout << "\n";
+    }
+    if (!counted) std::cout << "hardware counters " << counters.status() << "\n";
+}
+
+std::vector<float> random_floats(std::size_t n)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    // opened first so the compute pool's threads inherit the counters
+    PerfCounters counters;
+
+    std::string model_path;
+    int iterations = 50;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--iterations=", 0) == 0)
+            iterations = std::max(1, std::stoi(arg.substr(13)));
+        else
+            model_path = arg;
+    }
+
+    std::cout << "Kernels: " << kernels().name << ", " << iterations << " iterations\n\n";
+    std::vector<Result> results;
+
+    struct Shape { std::size_t M, N, K; };
+    for (Shape s : {Shape{1, 4096, 4096}, Shape{64, 512, 512}, Shape{256, 1024, 1024}})
+    {
+        std::vector<float> A = random_floats(s.M * s.K), B = random_floats(s.K * s.N), C(s.M * s.N);
+        std::vector<uint16_t> B16(B.size());
+        for (std::size_t i = 0; i < B.size(); ++i) B16[i] = float_to_half(B[i]);
+
+        const double flops = 2.0 * s.M * s.N * s.K;
+        const std::string dims = std::to_string(s.M) + "x" + std::to_string(s.N) + "x" + std::to_string(s.K);
+        results.push_back(measure("sgemm " + dims, flops, iterations, counters, [&]
+        {
+            kernels().sgemm(false, false, s.M, s.N, s.K, 1.0f, A.data(), s.K, B.data(), s.N, 0.0f, C.data(), s.N);
+        }));
+        results.push_back(measure("sgemm_f16 " + dims, flops, iterations, counters, [&]
+        {
+            kernels().sgemm_f16(false, false, s.M, s.N, s.K, 1.0f, A.data(), s.K, B16.data(), s.N, 0.0f, C.data(), s.N);
+        }));
+    }
+
+    if (!model_path.empty())
+    {
+        Graph graph;
+        OnnxParser parser;
+        parser.parse(graph, model_path);
+        GraphOptimizer::optimize(graph);
+        graph.infer_input_size();
+
+        Tensor<float> input({1, 1, static_cast<std::size_t>(graph.get_input_height()), static_cast<std::size_t>(graph.get_input_width())});
+        std::vector<float> values = random_floats(input.size());
+        std::copy(values.begin(), values.end(), input.data());
+
+        InferenceEngine engine;
+        results.push_back(measure("model " + model_path, 0.0, iterations, counters, [&] { engine.run(graph, {&input}); }));
+    }
+
+    std::cout << "\n";
+    print_results(results, counters);
+    return 0;
+}
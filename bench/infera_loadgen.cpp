@@ -0,0 +1,738 @@
+#include <arpa/inet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "bounded_queue.h"
+#include "image_loader.h"
+#include "inference_engine.h"
+#include "metrics.h"
+#include "server/json.h"
+#include "server/kserve.h"
+#include "server/shm_transport.h"
+
+// closed-loop load generator for infera-server: every connection keeps exactly one
+// request in flight over a keep-alive socket, so throughput is connections / latency.
+// inputs are random tensors shaped from the model metadata (dynamic dims become 1).
+// with --shm-socket the same loop runs over shared-memory channels instead.
+//
+// with --replay=<trace.jsonl> it replays recorded requests instead, against the
+// server or, with --model-repository, an in-process engine. closed loop cycles
+// through the trace as above; open loop (--mode=trace|rate|poisson) sends at the
+// trace's timestamps, a fixed rate or Poisson arrivals regardless of how fast
+// responses come back, and measures latency from the intended send time so a
+// backed-up server is not hidden by the generator waiting for it
+
+namespace
+{
+
+struct Options
+{
+    std::string host = "127.0.0.1";
+    std::string port = "8000";
+    std::string model;
+    int connections = 4;
+    double duration = 10.0;
+    bool binary = false;
+    std::string shm_socket;                                 // shared-memory channels instead of HTTP
+
+    std::string replay;                                     // trace of requests to replay
+    std::string mode = "closed";                            // closed, trace, rate or poisson
+    double rate = 100.0;                                    // open-loop arrivals per second
+    double speed = 1.0;                                     // trace timestamps are divided by this
+    std::string repository;                                 // replay in-process against this model directory
+    std::string latency_log;                                // per-request CSV
+    uint64_t seed = 42;
+};
+
+int connect_to(const Options& options)
+{
+    addrinfo hints{}, *addresses = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(options.host.c_str(), options.port.c_str(), &hints, &addresses) != 0)
+        throw std::runtime_error("cannot resolve " + options.host);
+
+    int fd = -1;
+    for (addrinfo* a = addresses; a && fd < 0; a = a->ai_next)
+    {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) < 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) throw std::runtime_error("cannot connect to " + options.host + ":" + options.port);
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+// one keep-alive connection: write a request, read back one Content-Length framed response
+class Connection
+{
+public:
+    explicit Connection(const Options& options) : fd_(connect_to(options)) {}
+    ~Connection() { close(fd_); }
+
+    int exchange(const std::string& request, std::string& body)
+    {
+        for (std::size_t sent = 0; sent < request.size();)
+        {
+            ssize_t n = send(fd_, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) throw std::runtime_error("send failed");
+            sent += static_cast<std::size_t>(n);
+        }
+
+        std::size_t end;
+        while ((end = buffer_.find("\r\n\r\n")) == std::string::npos) fill();
+        const int status = std::stoi(buffer_.substr(9, 3));
+        const std::size_t at = buffer_.find("Content-Length: ");
+        if (at == std::string::npos || at > end) throw std::runtime_error("response without Content-Length");
+        const std::size_t length = std::stoul(buffer_.substr(at + 16));
+
+        while (buffer_.size() < end + 4 + length) fill();
+        body.assign(buffer_, end + 4, length);
+        buffer_.erase(0, end + 4 + length);
+        return status;
+    }
+private:
+    void fill()
+    {
+        char chunk[64 * 1024];
+        ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) throw std::runtime_error("connection closed by server");
+        buffer_.append(chunk, static_cast<std::size_t>(n));
+    }
+
+    int fd_;
+    std::string buffer_;
+};
+
+std::string http_request(const Options& options, const std::string& method, const std::string& path, const std::string& body,
+                         const std::string& headers = "")
+{
+    return method + " " + path + " HTTP/1.1\r\nHost: " + options.host + "\r\nContent-Length: " + std::to_string(body.size()) +
+           "\r\n" + headers + "\r\n" + body;
+}
+
+// random tensor for one model input; dynamic dims become 1
+struct InputSpec
+{
+    std::string name;
+    std::string datatype;
+    DataType type = DataType::Float32;
+    std::vector<std::size_t> shape;
+    std::vector<float> values;                              // float inputs get uniform [0, 1), anything else zeros
+    std::string bytes;
+};
+
+std::vector<InputSpec> random_inputs(const JsonValue& metadata)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    std::vector<InputSpec> specs;
+    for (const JsonValue& input : metadata.at("inputs").as_array())
+    {
+        InputSpec spec;
+        spec.name = input.at("name").as_string();
+        spec.datatype = input.at("datatype").as_string();
+        if (!parse_kserve_datatype(spec.datatype, spec.type)) throw std::runtime_error("unsupported input datatype " + spec.datatype);
+
+        std::size_t elements = 1;
+        for (const JsonValue& dim : input.at("shape").as_array())
+        {
+            spec.shape.push_back(dim.as_int() < 0 ? 1 : static_cast<std::size_t>(dim.as_int()));
+            elements *= spec.shape.back();
+        }
+
+        spec.values.resize(elements);
+        for (float& v : spec.values) v = uniform(rng);
+        spec.bytes.assign(elements * data_type_size(spec.type), '\0');
+        if (spec.type == DataType::Float32) std::memcpy(&spec.bytes[0], spec.values.data(), spec.bytes.size());
+        specs.push_back(std::move(spec));
+    }
+    return specs;
+}
+
+std::string build_infer_request(const Options& options, const std::vector<InputSpec>& inputs)
+{
+    std::string header = "{\"inputs\":[";
+    std::string payload;
+    for (std::size_t n = 0; n < inputs.size(); ++n)
+    {
+        const InputSpec& input = inputs[n];
+        JsonValue shape = JsonValue::array();
+        for (auto d : input.shape) shape.push(d);
+
+        if (n) header += ",";
+        header += "{\"name\":";
+        JsonValue::append_string(header, input.name);
+        header += ",\"datatype\":\"" + input.datatype + "\",\"shape\":" + shape.dump();
+        if (options.binary)
+        {
+            header += ",\"parameters\":{\"binary_data_size\":" + std::to_string(input.bytes.size()) + "}}";
+            payload += input.bytes;
+            continue;
+        }
+        header += ",\"data\":[";
+        for (std::size_t i = 0; i < input.values.size(); ++i)
+        {
+            if (i) header += ",";
+            JsonValue::append_number(header, input.type == DataType::Float32 ? input.values[i] : 0.0);
+        }
+        header += "]}";
+    }
+    header += "]";
+    if (options.binary) header += ",\"parameters\":{\"binary_data_output\":true}";
+    header += "}";
+
+    const std::string path = "/v2/models/" + options.model + "/infer";
+    if (!options.binary) return http_request(options, "POST", path, header, "Content-Type: application/json\r\n");
+    return http_request(options, "POST", path, header + payload,
+                        "Content-Type: application/octet-stream\r\nInference-Header-Content-Length: " + std::to_string(header.size()) + "\r\n");
+}
+
+// one shared-memory channel with the inputs written once and room for every output
+class ShmRunner
+{
+public:
+    static constexpr std::size_t kOutputBytes = 1 << 20;
+
+    ShmRunner(const Options& options, const std::vector<InputSpec>& inputs, const JsonValue& metadata)
+        : model_(options.model), client_(options.shm_socket, bytes_needed(inputs, metadata))
+    {
+        std::size_t offset = 0;
+        for (const InputSpec& input : inputs)
+        {
+            std::memcpy(static_cast<char*>(client_.data()) + offset, input.bytes.data(), input.bytes.size());
+            inputs_.push_back({input.name, input.type, input.shape, 0, offset, input.bytes.size()});
+            offset += (input.bytes.size() + 63) / 64 * 64;
+        }
+        for (const JsonValue& output : metadata.at("outputs").as_array())
+        {
+            outputs_.push_back({output.at("name").as_string(), DataType::Float32, {}, 0, offset, kOutputBytes});
+            offset += kOutputBytes;
+        }
+    }
+
+    void run() { client_.infer(model_, inputs_, outputs_); }
+private:
+    static std::size_t bytes_needed(const std::vector<InputSpec>& inputs, const JsonValue& metadata)
+    {
+        std::size_t bytes = metadata.at("outputs").size() * kOutputBytes;
+        for (const InputSpec& input : inputs) bytes += (input.bytes.size() + 63) / 64 * 64;
+        return bytes;
+    }
+
+    std::string model_;
+    ShmClient client_;
+    std::vector<ShmClient::TensorRef> inputs_;
+    std::vector<ShmClient::TensorRef> outputs_;
+};
+
+// ---- replay ----
+
+using Clock = std::chrono::steady_clock;
+
+// one request of a trace, prepared once and sent as often as the run needs. a
+// trace line is a JSON object:
+//
+//   {"model": "mnist", "timestamp": 0.25, "image": "src/images/number_3.jpg"}
+//   {"model": "mnist", "inputs": [{"name": "Input3", "datatype": "FP32", "shape": [1, 1, 28, 28], "data": [...]}]}
+//
+// "model" defaults to --model, "timestamp" (seconds) only matters to --mode=trace.
+// an image is decoded and resized for the model's first input: NCHW inputs give
+// the channels and size, anything else must hold a square grayscale image
+struct ReplayEntry
+{
+    double timestamp = 0.0;
+    std::string model;
+    InferRequest decoded;                                   // in-process runs only read these inputs
+    std::string http;                                       // framed request for the server
+};
+
+struct ReplaySample
+{
+    double offset = 0.0;                                    // intended send time, seconds from the start
+    uint64_t latency_us = 0;
+    int status = 0;                                         // HTTP status, 0 when the request failed to complete
+    std::size_t entry = 0;
+};
+
+std::string image_request(const std::string& path, const JsonValue& metadata)
+{
+    const std::vector<JsonValue>& inputs = metadata.at("inputs").as_array();
+    if (inputs.empty()) throw std::runtime_error("model has no inputs");
+    const JsonValue& input = inputs[0];
+    if (input.at("datatype").as_string() != "FP32") throw std::runtime_error("images need an FP32 model input");
+
+    std::vector<std::size_t> shape;
+    std::size_t elements = 1;
+    for (const JsonValue& dim : input.at("shape").as_array())
+    {
+        shape.push_back(dim.as_int() < 0 ? 1 : static_cast<std::size_t>(dim.as_int()));
+        elements *= shape.back();
+    }
+
+    PreprocessOptions preprocess;
+    if (shape.size() == 4)
+    {
+        preprocess.channels = static_cast<int>(shape[1]);
+        preprocess.height = static_cast<int>(shape[2]);
+        preprocess.width = static_cast<int>(shape[3]);
+    }
+    else
+    {
+        preprocess.width = preprocess.height = static_cast<int>(std::lround(std::sqrt(static_cast<double>(elements))));
+    }
+    const std::size_t pixels = static_cast<std::size_t>(preprocess.channels) * preprocess.height * preprocess.width;
+    if (pixels != elements) throw std::runtime_error("cannot shape an image for input '" + input.at("name").as_string() + "'");
+
+    std::vector<float> values(pixels);
+    ImageLoader::load_into(path, preprocess, values.data());
+
+    JsonValue dims = JsonValue::array();
+    for (auto d : shape) dims.push(d);
+    std::string json = "{\"inputs\":[{\"name\":";
+    JsonValue::append_string(json, input.at("name").as_string());
+    json += ",\"datatype\":\"FP32\",\"shape\":" + dims.dump() + ",\"data\":[";
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        if (i) json += ",";
+        JsonValue::append_number(json, values[i]);
+    }
+    return json + "]}]}";
+}
+
+// the entry as an HTTP request: its JSON as is, or re-encoded with binary tensors
+std::string replay_http_request(const Options& options, const ReplayEntry& entry, const std::string& json)
+{
+    const std::string path = "/v2/models/" + entry.model + "/infer";
+    if (!options.binary) return http_request(options, "POST", path, json, "Content-Type: application/json\r\n");
+
+    std::string header = "{\"inputs\":[";
+    std::string payload;
+    for (std::size_t n = 0; n < entry.decoded.inputs.size(); ++n)
+    {
+        const InferInput& input = entry.decoded.inputs[n];
+        JsonValue shape = JsonValue::array();
+        for (auto d : input.tensor.shape()) shape.push(d);
+
+        if (n) header += ",";
+        header += "{\"name\":";
+        JsonValue::append_string(header, input.name);
+        header += ",\"datatype\":\"" + std::string(kserve_datatype(input.tensor.dtype())) + "\",\"shape\":" + shape.dump() +
+                  ",\"parameters\":{\"binary_data_size\":" + std::to_string(input.tensor.bytes()) + "}}";
+        payload.append(static_cast<const char*>(input.tensor.raw()), input.tensor.bytes());
+    }
+    header += "],\"parameters\":{\"binary_data_output\":true}}";
+    return http_request(options, "POST", path, header + payload,
+                        "Content-Type: application/octet-stream\r\nInference-Header-Content-Length: " + std::to_string(header.size()) + "\r\n");
+}
+
+std::vector<ReplayEntry> load_trace(const Options& options, const std::function<JsonValue(const std::string&)>& metadata)
+{
+    std::ifstream file(options.replay);
+    if (!file) throw std::runtime_error("cannot open trace " + options.replay);
+
+    std::map<std::string, JsonValue> models;                // metadata fetched once per model
+    std::vector<ReplayEntry> entries;
+    std::size_t line_number = 0;
+    for (std::string line; std::getline(file, line);)
+    {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        try
+        {
+            const JsonValue record = JsonValue::parse(line);
+            ReplayEntry entry;
+            const JsonValue* model = record.find("model");
+            entry.model = model ? model->as_string() : options.model;
+            if (entry.model.empty()) throw std::runtime_error("no \"model\" and no --model");
+            if (const JsonValue* timestamp = record.find("timestamp")) entry.timestamp = timestamp->as_number();
+
+            std::string json;
+            if (const JsonValue* inputs = record.find("inputs"))
+            {
+                json = "{\"inputs\":" + inputs->dump() + "}";
+            }
+            else if (const JsonValue* image = record.find("image"))
+            {
+                auto it = models.find(entry.model);
+                if (it == models.end()) it = models.emplace(entry.model, metadata(entry.model)).first;
+                json = image_request(image->as_string(), it->second);
+            }
+            else
+            {
+                throw std::runtime_error("needs \"inputs\" or \"image\"");
+            }
+
+            entry.decoded = decode_infer_request(json, json.size());
+            entry.http = replay_http_request(options, entry, json);
+            entries.push_back(std::move(entry));
+        }
+        catch (const std::exception& e)
+        {
+            throw std::runtime_error(options.replay + ":" + std::to_string(line_number) + ": " + e.what());
+        }
+    }
+    if (entries.empty()) throw std::runtime_error("trace " + options.replay + " holds no requests");
+
+    std::stable_sort(entries.begin(), entries.end(), [](const ReplayEntry& a, const ReplayEntry& b) { return a.timestamp < b.timestamp; });
+    return entries;
+}
+
+// sends one entry and returns its status: over a keep-alive connection to the
+// server, or straight through an engine of its own for --model-repository
+using Sender = std::function<int(ReplayEntry&)>;
+
+Sender make_sender(const Options& options, ModelRepository* repository)
+{
+    if (repository)
+    {
+        auto engine = std::make_shared<InferenceEngine>();
+        return [engine, repository](ReplayEntry& entry)
+        {
+            std::shared_ptr<LoadedModel> model;
+            try
+            {
+                model = repository->get(entry.model);
+            }
+            catch (const std::exception&)
+            {
+                return 404;
+            }
+
+            // bind by name, the way the server does
+            Graph& graph = model->graph;
+            std::vector<AnyTensor*> inputs;
+            for (std::size_t i = 0; i < graph.get_input_size(); ++i)
+            {
+                AnyTensor* bound = nullptr;
+                for (InferInput& input : entry.decoded.inputs)
+                    if (input.name == graph.get_input_name(i)) bound = &input.tensor;
+                if (!bound) return 400;
+                inputs.push_back(bound);
+            }
+
+            try
+            {
+                CachedOutputs held;
+                model->run(*engine, inputs, held);
+                return 200;
+            }
+            catch (const std::exception&)
+            {
+                return 500;
+            }
+        };
+    }
+
+    auto connection = std::make_shared<Connection>(options);
+    auto response = std::make_shared<std::string>();
+    return [connection, response](ReplayEntry& entry) { return connection->exchange(entry.http, *response); };
+}
+
+int run_replay(const Options& options)
+{
+    const bool closed = options.mode == "closed";
+    if (!closed && options.mode != "trace" && options.mode != "rate" && options.mode != "poisson")
+        throw std::runtime_error("unknown --mode " + options.mode);
+    if ((options.mode == "rate" || options.mode == "poisson") && options.rate <= 0.0) throw std::runtime_error("--rate must be positive");
+
+    std::unique_ptr<ModelRepository> repository;
+    std::function<JsonValue(const std::string&)> metadata;
+    if (!options.repository.empty())
+    {
+        repository = std::make_unique<ModelRepository>(options.repository);
+        metadata = [&](const std::string& name) { return model_metadata(*repository->get(name), repository->versions(name)); };
+    }
+    else
+    {
+        metadata = [&](const std::string& name)
+        {
+            Connection probe(options);
+            std::string body;
+            if (probe.exchange(http_request(options, "GET", "/v2/models/" + name, ""), body) != 200)
+                throw std::runtime_error("metadata request for '" + name + "' failed: " + body);
+            return JsonValue::parse(body);
+        };
+    }
+    std::vector<ReplayEntry> entries = load_trace(options, metadata);
+
+    // the first request of each model loads it; keep those out of the measurement
+    {
+        Sender warm = make_sender(options, repository.get());
+        std::set<std::string> warmed;
+        for (ReplayEntry& entry : entries)
+        {
+            if (!warmed.insert(entry.model).second) continue;
+            const int status = warm(entry);
+            if (status != 200) throw std::runtime_error("warm-up request for '" + entry.model + "' failed with status " + std::to_string(status));
+        }
+    }
+
+    Histogram latency;
+    std::atomic<uint64_t> errors{0};
+    std::vector<std::vector<ReplaySample>> samples(options.connections);
+    const auto start = Clock::now();
+    const auto stop = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+
+    auto record = [&](std::vector<ReplaySample>& out, std::size_t entry, Clock::time_point intended, int status)
+    {
+        const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - intended).count();
+        latency.record(us);
+        if (status != 200) errors.fetch_add(1, std::memory_order_relaxed);
+        out.push_back({std::chrono::duration<double>(intended - start).count(), us, status, entry});
+    };
+
+    // a failed exchange counts as an error and the worker reconnects
+    auto send = [&](Sender& sender, ReplayEntry& entry)
+    {
+        try
+        {
+            return sender(entry);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "client: " << e.what() << "\n";
+            sender = make_sender(options, repository.get());
+            return 0;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    BoundedQueue<std::pair<std::size_t, Clock::time_point>> arrivals(1 << 16);
+    std::atomic<std::size_t> next{0};
+    for (int w = 0; w < options.connections; ++w)
+    {
+        workers.emplace_back([&, w]
+        {
+            try
+            {
+                Sender sender = make_sender(options, repository.get());
+                if (closed)
+                {
+                    while (Clock::now() < stop)
+                    {
+                        const std::size_t i = next.fetch_add(1) % entries.size();
+                        const auto sent = Clock::now();
+                        const int status = send(sender, entries[i]);
+                        record(samples[w], i, sent, status);
+                    }
+                    return;
+                }
+
+                std::pair<std::size_t, Clock::time_point> arrival;
+                while (arrivals.pop(arrival))
+                {
+                    const int status = send(sender, entries[arrival.first]);
+                    record(samples[w], arrival.first, arrival.second, status);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                errors.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << "worker: " << e.what() << "\n";
+            }
+        });
+    }
+
+    // open loop: arrivals are scheduled up front and handed to whichever worker is free
+    std::size_t offered = 0;
+    if (!closed)
+    {
+        std::mt19937_64 rng(options.seed);
+        std::exponential_distribution<double> gap(options.rate);
+        double at = 0.0;
+        for (std::size_t n = 0;; ++n)
+        {
+            std::size_t i = n % entries.size();
+            if (options.mode == "trace")
+            {
+                if (n == entries.size()) break;                 // one pass, --duration does not apply
+                at = (entries[i].timestamp - entries[0].timestamp) / options.speed;
+            }
+            else
+            {
+                at = options.mode == "rate" ? n / options.rate : at + gap(rng);
+                if (at >= options.duration) break;
+            }
+
+            const auto when = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(at));
+            std::this_thread::sleep_until(when);
+            arrivals.push({i, when});
+            ++offered;
+        }
+        arrivals.close();
+    }
+    for (auto& t : workers) t.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (!options.latency_log.empty())
+    {
+        std::vector<ReplaySample> all;
+        for (auto& s : samples) all.insert(all.end(), s.begin(), s.end());
+        std::sort(all.begin(), all.end(), [](const ReplaySample& a, const ReplaySample& b) { return a.offset < b.offset; });
+
+        std::ofstream log(options.latency_log);
+        log << "offset_s,latency_us,status,model\n" << std::setprecision(6) << std::fixed;
+        for (const ReplaySample& s : all) log << s.offset << ',' << s.latency_us << ',' << s.status << ',' << entries[s.entry].model << '\n';
+        if (!log) throw std::runtime_error("cannot write " + options.latency_log);
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "replayed " << entries.size() << " trace request(s) " << (repository ? "in-process" : "against the server") << ", "
+              << options.connections << " worker(s), " << options.mode << " loop";
+    if (!closed) std::cout << ", offered " << offered << " (" << offered / elapsed << " req/s)";
+    std::cout << ", " << elapsed << " s\n";
+    std::cout << "requests: " << latency.count() << " (" << errors.load() << " errors), " << latency.count() / elapsed << " req/s\n";
+    std::cout << std::setprecision(3);
+    std::cout << "latency ms: p50 " << latency.quantile(0.5) / 1e3 << "  p90 " << latency.quantile(0.9) / 1e3
+              << "  p99 " << latency.quantile(0.99) / 1e3 << "  p99.9 " << latency.quantile(0.999) / 1e3
+              << "  max " << latency.max() / 1e3 << "\n";
+    return errors.load() ? 1 : 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--host=", 0) == 0)
+            options.host = arg.substr(7);
+        else if (arg.rfind("--port=", 0) == 0)
+            options.port = arg.substr(7);
+        else if (arg.rfind("--model=", 0) == 0)
+            options.model = arg.substr(8);
+        else if (arg.rfind("--connections=", 0) == 0)
+            options.connections = std::max(1, std::stoi(arg.substr(14)));
+        else if (arg.rfind("--duration=", 0) == 0)
+            options.duration = std::stod(arg.substr(11));
+        else if (arg == "--binary")
+            options.binary = true;
+        else if (arg.rfind("--shm-socket=", 0) == 0)
+            options.shm_socket = arg.substr(13);
+        else if (arg.rfind("--replay=", 0) == 0)
+            options.replay = arg.substr(9);
+        else if (arg.rfind("--mode=", 0) == 0)
+            options.mode = arg.substr(7);
+        else if (arg.rfind("--rate=", 0) == 0)
+            options.rate = std::stod(arg.substr(7));
+        else if (arg.rfind("--speed=", 0) == 0)
+            options.speed = std::stod(arg.substr(8));
+        else if (arg.rfind("--model-repository=", 0) == 0)
+            options.repository = arg.substr(19);
+        else if (arg.rfind("--latency-log=", 0) == 0)
+            options.latency_log = arg.substr(14);
+        else if (arg.rfind("--seed=", 0) == 0)
+            options.seed = std::stoull(arg.substr(7));
+    }
+
+    if (options.model.empty() && options.replay.empty())
+    {
+        std::cerr << "Usage: ./infera_loadgen --model=<name> [--host=127.0.0.1] [--port=8000] [--connections=4] [--duration=10] [--binary] [--shm-socket=<path>]\n"
+                     "       ./infera_loadgen --replay=<trace.jsonl> [--model=<default>] [--mode=closed|trace|rate|poisson] [--rate=100] [--speed=1]\n"
+                     "                        [--model-repository=<dir>] [--latency-log=<file.csv>] [--seed=42] [--connections=4] [--duration=10] [--binary]\n";
+        return 1;
+    }
+
+    try {
+        if (!options.replay.empty()) return run_replay(options);
+
+        std::string body;
+        Connection probe(options);
+        if (probe.exchange(http_request(options, "GET", "/v2/models/" + options.model, ""), body) != 200)
+            throw std::runtime_error("model metadata request failed: " + body);
+        const JsonValue metadata = JsonValue::parse(body);
+        const std::vector<InputSpec> inputs = random_inputs(metadata);
+        const std::string request = build_infer_request(options, inputs);
+
+        // first request loads the model; keep it out of the measurement
+        if (probe.exchange(request, body) != 200) throw std::runtime_error("warm-up request failed: " + body);
+
+        Histogram latency;
+        std::atomic<uint64_t> errors{0};
+        const auto start = std::chrono::steady_clock::now();
+        const auto stop = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.duration));
+
+        std::vector<std::thread> clients;
+        for (int c = 0; c < options.connections; ++c)
+        {
+            clients.emplace_back([&]
+            {
+                try
+                {
+                    if (!options.shm_socket.empty())
+                    {
+                        ShmRunner runner(options, inputs, metadata);
+                        while (std::chrono::steady_clock::now() < stop)
+                        {
+                            const auto sent = std::chrono::steady_clock::now();
+                            runner.run();
+                            latency.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sent).count());
+                        }
+                        return;
+                    }
+
+                    Connection connection(options);
+                    std::string response;
+                    while (std::chrono::steady_clock::now() < stop)
+                    {
+                        const auto sent = std::chrono::steady_clock::now();
+                        const int status = connection.exchange(request, response);
+                        latency.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sent).count());
+                        if (status != 200) errors.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                    std::cerr << "client: " << e.what() << "\n";
+                }
+            });
+        }
+        for (auto& t : clients) t.join();
+
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << options.connections << " connection(s), " << elapsed << " s, " << (!options.shm_socket.empty() ? "shared memory" : options.binary ? "binary" : "JSON") << " tensors\n";
+        std::cout << "requests: " << latency.count() << " (" << errors.load() << " errors), " << latency.count() / elapsed << " req/s\n";
+        std::cout << std::setprecision(3);
+        std::cout << "latency ms: p50 " << latency.quantile(0.5) / 1e3 << "  p90 " << latency.quantile(0.9) / 1e3
+                  << "  p99 " << latency.quantile(0.99) / 1e3 << "  p99.9 " << latency.quantile(0.999) / 1e3
+                  << "  max " << latency.max() / 1e3 << "\n";
+        return errors.load() ? 1 : 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,178 @@
+#ifndef ANY_TENSOR_H
+#define ANY_TENSOR_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include "data_type.h"
+#include "tensor.h"
+
+// type-erased tensor: one Tensor<T> of any supported element type plus its
+// runtime DataType tag. operators and the engine pass these around so int64
+// shapes, indices and half precision weights travel next to float activations
+class AnyTensor
+{
+public:
+    AnyTensor() = default;                                                   // empty float32
+
+    template <class T>
+    explicit AnyTensor(Tensor<T> tensor) : value_(std::move(tensor)) {}
+
+    // uninitialized tensor of a dtype only known at runtime
+    AnyTensor(DataType type, const std::vector<std::size_t>& shape)
+    {
+        switch (type)
+        {
+        case DataType::Float32:  value_ = Tensor<float>(shape); break;
+        case DataType::Float16:  value_ = Tensor<float16>(shape); break;
+        case DataType::BFloat16: value_ = Tensor<bfloat16>(shape); break;
+        case DataType::Int8:     value_ = Tensor<int8_t>(shape); break;
+        case DataType::UInt8:    value_ = Tensor<uint8_t>(shape); break;
+        case DataType::Int32:    value_ = Tensor<int32_t>(shape); break;
+        case DataType::Int64:    value_ = Tensor<int64_t>(shape); break;
+        case DataType::Bool:     value_ = Tensor<bool>(shape); break;
+        }
+    }
+
+    DataType dtype() const { return static_cast<DataType>(value_.index()); }
+
+    const std::vector<std::size_t>& shape() const
+    {
+        return std::visit([](const auto& t) -> const std::vector<std::size_t>& { return t.shape(); }, value_);
+    }
+
+    std::size_t size() const { return std::visit([](const auto& t) { return t.size(); }, value_); }
+    std::size_t bytes() const { return size() * data_type_size(dtype()); }
+    bool is_view() const { return std::visit([](const auto& t) { return t.is_view(); }, value_); }
+
+    // untyped buffer access for dtype-agnostic copies
+    void* raw() { return std::visit([](auto& t) { return static_cast<void*>(t.data()); }, value_); }
+    const void* raw() const { return std::visit([](const auto& t) { return static_cast<const void*>(t.data()); }, value_); }
+
+    template <class T>
+    bool is() const { return std::holds_alternative<Tensor<T>>(value_); }
+
+    // typed access, throws when the tensor holds another dtype
+    template <class T>
+    Tensor<T>& get()
+    {
+        check<T>();
+        return std::get<Tensor<T>>(value_);
+    }
+
+    template <class T>
+    const Tensor<T>& get() const
+    {
+        check<T>();
+        return std::get<Tensor<T>>(value_);
+    }
+
+    // switch to dtype T (dropping the contents if it held another one) for writing
+    template <class T>
+    Tensor<T>& emplace()
+    {
+        if (!is<T>()) value_ = Tensor<T>();
+        return std::get<Tensor<T>>(value_);
+    }
+
+    // same dtype as `like`, resized to `shape`
+    void reset_like(const AnyTensor& like, const std::vector<std::size_t>& shape)
+    {
+        if (dtype() != like.dtype()) *this = AnyTensor(like.dtype(), shape);
+        std::visit([&](auto& t) { t.resize(shape); }, value_);
+    }
+
+    // alias another tensor's buffer under a new shape, no copy. source must outlive this
+    void view_of(AnyTensor& source, const std::vector<std::size_t>& shape)
+    {
+        std::visit([&](auto& src)
+        {
+            using T = typename std::decay_t<decltype(src)>::value_type;
+            Tensor<T> view;
+            view.view(src.data(), shape);
+            value_ = std::move(view);
+        }, source.value_);
+    }
+
+    // alias raw memory holding elements of `type`, no copy. the memory must outlive this
+    void view_of_memory(DataType type, void* data, const std::vector<std::size_t>& shape)
+    {
+        auto alias = [&](auto element)
+        {
+            using T = decltype(element);
+            Tensor<T> view;
+            view.view(static_cast<T*>(data), shape);
+            value_ = std::move(view);
+        };
+        switch (type)
+        {
+        case DataType::Float32:  alias(float{}); break;
+        case DataType::Float16:  alias(float16{}); break;
+        case DataType::BFloat16: alias(bfloat16{}); break;
+        case DataType::Int8:     alias(int8_t{}); break;
+        case DataType::UInt8:    alias(uint8_t{}); break;
+        case DataType::Int32:    alias(int32_t{}); break;
+        case DataType::Int64:    alias(int64_t{}); break;
+        case DataType::Bool:     alias(bool{}); break;
+        }
+    }
+
+    // call fn(Tensor<T>&) with the held alternative
+    template <class Fn>
+    decltype(auto) visit(Fn&& fn) { return std::visit(std::forward<Fn>(fn), value_); }
+
+    template <class Fn>
+    decltype(auto) visit(Fn&& fn) const { return std::visit(std::forward<Fn>(fn), value_); }
+
+    // elementwise conversion, float16/bfloat16 round to nearest even
+    AnyTensor cast(DataType to) const
+    {
+        AnyTensor out(to, shape());
+        std::visit([&](const auto& src)
+        {
+            std::visit([&](auto& dst)
+            {
+                using To = typename std::decay_t<decltype(dst)>::value_type;
+                for (std::size_t i = 0; i < src.size(); ++i) dst.data()[i] = convert_value<To>(src.data()[i]);
+            }, out.value_);
+        }, value_);
+        return out;
+    }
+
+    // integer contents widened to int64, for shape and index inputs
+    std::vector<int64_t> to_int64() const
+    {
+        return std::visit([&](const auto& t)
+        {
+            using T = typename std::decay_t<decltype(t)>::value_type;
+            if constexpr (!std::is_integral_v<T> || std::is_same_v<T, bool>)
+            {
+                throw std::runtime_error(std::string("Tensor type error: expected an integer tensor but got ") + data_type_name(dtype()) + ".");
+                return std::vector<int64_t>{};
+            }
+            else
+            {
+                return std::vector<int64_t>(t.data(), t.data() + t.size());
+            }
+        }, value_);
+    }
+
+private:
+    template <class T>
+    void check() const
+    {
+        if (!is<T>())
+        {
+            throw std::runtime_error(std::string("Tensor type error: expected ") + data_type_name(DataTypeOf<T>::value) +
+                                     " but the tensor holds " + data_type_name(dtype()) + ".");
+        }
+    }
+
+    std::variant<Tensor<float>, Tensor<float16>, Tensor<bfloat16>, Tensor<int8_t>, Tensor<uint8_t>,
+                 Tensor<int32_t>, Tensor<int64_t>, Tensor<bool>> value_;
+};
+
+#endif
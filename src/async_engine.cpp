@@ -0,0 +1,187 @@
+#include "async_engine.h"
+#include "logger.h"
+#include <chrono>
+
+namespace
+{
+
+uint64_t now_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+AsyncEngine::AsyncEngine(const AsyncOptions& options) : options_(options)
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    queue_depth_ = &registry.gauge("infera_inference_queue_depth", "Requests waiting for an inference worker");
+    const char* help = "Requests failed without running";
+    rejected_full_ = &registry.counter("infera_inference_rejected_total", help, {{"reason", "queue_full"}});
+    rejected_deadline_ = &registry.counter("infera_inference_rejected_total", help, {{"reason", "deadline"}});
+    rejected_cancelled_ = &registry.counter("infera_inference_rejected_total", help, {{"reason", "cancelled"}});
+
+    if (options_.workers == 0) options_.workers = 1;
+    for (std::size_t i = 0; i < options_.workers; ++i) workers_.emplace_back([this] { worker_loop(); });
+}
+
+AsyncEngine::~AsyncEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+std::future<InferenceResult> AsyncEngine::submit(std::shared_ptr<Graph> graph, std::vector<AnyTensor> inputs, const RequestOptions& options)
+{
+    auto promise = std::make_shared<std::promise<InferenceResult>>();
+    std::future<InferenceResult> future = promise->get_future();
+    submit(std::move(graph), std::move(inputs), [promise](std::exception_ptr error, InferenceResult result)
+    {
+        if (error)
+            promise->set_exception(error);
+        else
+            promise->set_value(std::move(result));
+    }, options);
+    return future;
+}
+
+void AsyncEngine::submit(std::shared_ptr<Graph> graph, std::vector<AnyTensor> inputs, Callback done, const RequestOptions& options)
+{
+    const uint64_t queued = now_us();
+    auto request = std::make_shared<std::vector<AnyTensor>>(std::move(inputs));
+    auto callback = std::make_shared<Callback>(std::move(done));
+
+    post([graph = std::move(graph), request, callback, queued](InferenceEngine& engine)
+    {
+        InferenceResult result;
+        const uint64_t start = now_us();
+        result.queue_us = start - queued;
+
+        std::exception_ptr error;
+        try
+        {
+            std::vector<AnyTensor*> inputs;
+            for (AnyTensor& input : *request) inputs.push_back(&input);
+            result.outputs = engine.run_owned(*graph, inputs);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        result.compute_us = now_us() - start;
+        (*callback)(error, std::move(result));
+    },
+    [callback](std::exception_ptr error) { (*callback)(error, InferenceResult{}); }, options);
+}
+
+void AsyncEngine::post(Job job, Rejected rejected, const RequestOptions& options)
+{
+    Task task{std::move(job), std::move(rejected), options};
+
+    // dead on arrival
+    if (options.control.token.cancelled())
+        return fail(task, std::make_exception_ptr(RequestCancelled("before it was queued")), *rejected_cancelled_);
+    if (options.control.expired())
+        return fail(task, std::make_exception_ptr(DeadlineExceeded("before it was queued")), *rejected_deadline_);
+
+    Task victim;
+    bool dropped = false, accepted = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (options_.max_queue && queued_ >= options_.max_queue)
+        {
+            accepted = false;
+            if (options_.overflow == OverflowPolicy::DropOldest)
+            {
+                // least important class first, never one above the newcomer
+                for (int p = 2; p >= static_cast<int>(options.priority) && !dropped; --p)
+                {
+                    if (queues_[p].empty()) continue;
+                    victim = std::move(queues_[p].front());
+                    queues_[p].pop_front();
+                    --queued_;
+                    dropped = accepted = true;
+                }
+            }
+        }
+        if (accepted)
+        {
+            queues_[static_cast<int>(options.priority)].push_back(std::move(task));
+            ++queued_;
+        }
+    }
+
+    if (dropped) fail(victim, std::make_exception_ptr(QueueFull()), *rejected_full_);
+    if (!accepted) return fail(task, std::make_exception_ptr(QueueFull()), *rejected_full_);
+
+    if (!dropped) queue_depth_->add(1);
+    cv_.notify_one();
+}
+
+void AsyncEngine::fail(Task& task, std::exception_ptr error, Counter& reason)
+{
+    reason.inc();
+    try
+    {
+        if (task.reject) task.reject(error);
+    }
+    catch (const std::exception& e)
+    {
+        INFERA_LOG_ERROR("inference rejection handler threw: %s", e.what());
+    }
+}
+
+std::size_t AsyncEngine::queued() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_;
+}
+
+void AsyncEngine::worker_loop()
+{
+    InferenceEngine engine;
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+            if (queued_ == 0) return;                       // stopping and drained
+
+            int p = 0;
+            while (queues_[p].empty()) ++p;
+            task = std::move(queues_[p].front());
+            queues_[p].pop_front();
+            --queued_;
+        }
+        queue_depth_->add(-1);
+
+        // it may have expired or been abandoned while it waited
+        const RunControl& control = task.options.control;
+        if (control.token.cancelled())
+        {
+            fail(task, std::make_exception_ptr(RequestCancelled("while queued")), *rejected_cancelled_);
+            continue;
+        }
+        if (control.expired())
+        {
+            fail(task, std::make_exception_ptr(DeadlineExceeded("while queued")), *rejected_deadline_);
+            continue;
+        }
+
+        engine.set_run_control(&control);
+        try
+        {
+            task.run(engine);
+        }
+        catch (const std::exception& e)
+        {
+            INFERA_LOG_ERROR("inference job threw: %s", e.what());
+        }
+        engine.set_run_control(nullptr);
+    }
+}
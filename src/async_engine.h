@@ -0,0 +1,124 @@
+#ifndef ASYNC_ENGINE_H
+#define ASYNC_ENGINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "any_tensor.h"
+#include "graph.h"
+#include "inference_engine.h"
+#include "metrics.h"
+#include "run_control.h"
+
+// outputs of one asynchronous run, owned by the caller
+struct InferenceResult
+{
+    std::vector<AnyTensor> outputs;                         // graph output order
+    uint64_t queue_us = 0;                                  // waiting for a worker
+    uint64_t compute_us = 0;
+};
+
+// workers always take the most important waiting request; within a class, oldest first
+enum class Priority
+{
+    High = 0,
+    Normal,
+    Low
+};
+
+// what a full queue does with one more request
+enum class OverflowPolicy
+{
+    RejectNew,                                              // the newcomer fails with QueueFull
+    DropOldest                                              // the oldest request of the least important class not above it is failed instead
+};
+
+struct AsyncOptions
+{
+    std::size_t workers = 2;
+    std::size_t max_queue = 0;                              // waiting requests over all classes, 0 is unbounded
+    OverflowPolicy overflow = OverflowPolicy::RejectNew;
+};
+
+struct RequestOptions
+{
+    Priority priority = Priority::Normal;
+    RunControl control;                                     // deadline and cancellation
+};
+
+class QueueFull : public std::runtime_error
+{
+public:
+    QueueFull() : std::runtime_error("inference queue is full") {}
+};
+
+// non-blocking front of a set of worker threads, one InferenceEngine each. any
+// thread can keep many requests outstanding; each completes through a future or a
+// callback run on the worker that computed it. the graph is shared and kept alive
+// by the request, so it must have been prepared (topological_sort) before sharing.
+//
+// under overload requests are shed rather than queued without bound: a request
+// past its deadline or cancelled fails without running, is checked again when a
+// worker picks it up and stops between nodes once running
+class AsyncEngine
+{
+public:
+    using Callback = std::function<void(std::exception_ptr error, InferenceResult result)>;
+    using Job = std::function<void(InferenceEngine& engine)>;
+    using Rejected = std::function<void(std::exception_ptr error)>;
+
+    explicit AsyncEngine(const AsyncOptions& options = {});
+    ~AsyncEngine();                                         // runs what is queued, then joins
+
+    AsyncEngine(const AsyncEngine&) = delete;
+    AsyncEngine& operator=(const AsyncEngine&) = delete;
+
+    std::future<InferenceResult> submit(std::shared_ptr<Graph> graph, std::vector<AnyTensor> inputs, const RequestOptions& options = {});
+
+    // `done` must not block for long: it runs on the worker, or right here when
+    // the request is rejected on arrival
+    void submit(std::shared_ptr<Graph> graph, std::vector<AnyTensor> inputs, Callback done, const RequestOptions& options = {});
+
+    // arbitrary work on a worker's engine, for callers with their own request format.
+    // the engine honours the request's RunControl while `job` runs; `rejected`
+    // is called instead of `job` when the request is shed
+    void post(Job job, Rejected rejected, const RequestOptions& options = {});
+
+    std::size_t workers() const { return workers_.size(); }
+    std::size_t queued() const;
+private:
+    struct Task
+    {
+        Job run;
+        Rejected reject;
+        RequestOptions options;
+    };
+
+    void worker_loop();
+    void fail(Task& task, std::exception_ptr error, Counter& reason);
+
+    AsyncOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Task> queues_[3];                            // by Priority
+    std::size_t queued_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+
+    Gauge* queue_depth_;
+    Counter* rejected_full_;
+    Counter* rejected_deadline_;
+    Counter* rejected_cancelled_;
+};
+
+#endif
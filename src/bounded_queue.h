@@ -0,0 +1,58 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// blocking multi-producer multi-consumer queue between pipeline stages. a full
+// queue stalls its producers, so a slow stage caps the memory held by faster ones
+template <class T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+    // waits while full, false (item dropped) once closed
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // waits while empty, false once closed and drained
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // no more pushes; consumers still get what is queued
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+private:
+    std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ONNX multidirectional (numpy-style) broadcasting helpers
+
+// shape both inputs broadcast to, dims aligned from the right
+inline std::vector<std::size_t> broadcast_shape(const std::vector<std::size_t>& a, const std::vector<std::size_t>& b)
+{
+    const std::size_t rank = a.size() > b.size() ? a.size() : b.size();
+    std::vector<std::size_t> out(rank);
+
+    for (std::size_t i = 0; i < rank; ++i)
+    {
+        std::size_t da = i < rank - a.size() ? 1 : a[i - (rank - a.size())];
+        std::size_t db = i < rank - b.size() ? 1 : b[i - (rank - b.size())];
+
+        if (da != db && da != 1 && db != 1)
+        {
+            throw std::runtime_error("Broadcast error: dimensions " + std::to_string(da) + " and " + std::to_string(db) + " are incompatible.");
+        }
+        out[i] = da == 1 ? db : da;
+    }
+    return out;
+}
+
+// row-major element strides of `shape` seen through `out_shape`, 0 on broadcast dims
+inline std::vector<std::size_t> broadcast_strides(const std::vector<std::size_t>& shape, const std::vector<std::size_t>& out_shape)
+{
+    std::vector<std::size_t> strides(out_shape.size(), 0);
+    std::size_t stride = 1;
+
+    for (std::size_t i = shape.size(); i-- > 0;)
+    {
+        std::size_t out_i = i + (out_shape.size() - shape.size());
+        strides[out_i] = shape[i] == 1 ? 0 : stride;
+        stride *= shape[i];
+    }
+    return strides;
+}
+
+// walk a broadcast binary op as contiguous inner runs. dims of size 1 are dropped and
+// neighbouring dims merged while both inputs stay linear across them, so e.g.
+// [1,8,28,28] + [8,1,1] becomes 8 runs of 784. fn(a_offset, b_offset, y_offset, n,
+// a_step, b_step) is called per run, steps are 1 (contiguous) or 0 (broadcast)
+template <class Fn>
+void for_each_broadcast_run(const std::vector<std::size_t>& a_shape, const std::vector<std::size_t>& b_shape, Fn fn)
+{
+    const std::vector<std::size_t> out = broadcast_shape(a_shape, b_shape);
+    const std::vector<std::size_t> sa_full = broadcast_strides(a_shape, out);
+    const std::vector<std::size_t> sb_full = broadcast_strides(b_shape, out);
+
+    std::vector<std::size_t> dims, sa, sb;
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        if (out[i] == 1) continue;
+
+        // merge into the previous dim when both inputs are linear across the pair
+        if (!dims.empty() && sa.back() == sa_full[i] * out[i] && sb.back() == sb_full[i] * out[i])
+        {
+            dims.back() *= out[i];
+            sa.back() = sa_full[i];
+            sb.back() = sb_full[i];
+            continue;
+        }
+        dims.push_back(out[i]);
+        sa.push_back(sa_full[i]);
+        sb.push_back(sb_full[i]);
+    }
+
+    if (dims.empty())
+    {
+        fn(0, 0, 0, 1, 1, 1);
+        return;
+    }
+
+    const std::size_t inner = dims.back();
+    const std::size_t outer_rank = dims.size() - 1;
+    std::vector<std::size_t> index(outer_rank, 0);
+
+    std::size_t a_off = 0, b_off = 0, y_off = 0;
+    while (true)
+    {
+        fn(a_off, b_off, y_off, inner, sa.back(), sb.back());
+        y_off += inner;
+
+        // odometer increment over the outer dims
+        std::size_t d = outer_rank;
+        while (d > 0)
+        {
+            --d;
+            if (++index[d] < dims[d])
+            {
+                a_off += sa[d];
+                b_off += sb[d];
+                break;
+            }
+            a_off -= sa[d] * (dims[d] - 1);
+            b_off -= sb[d] * (dims[d] - 1);
+            index[d] = 0;
+            if (d == 0) return;
+        }
+        if (outer_rank == 0) return;
+    }
+}
+
+#endif
@@ -0,0 +1,397 @@
+#include "bulk_inference.h"
+#include "bounded_queue.h"
+#include "inference_engine.h"
+#include "logger.h"
+#include "postprocess.h"
+#include <glob.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t micros_since(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+// extensions stb_image decodes
+bool is_image_file(const fs::path& path)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* known : {".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".pgm", ".ppm", ".pnm", ".psd", ".hdr"})
+    {
+        if (ext == known) return true;
+    }
+    return false;
+}
+
+// images [first, first + count) of the input on their way to inference. the
+// tensor is handed back to the pool afterwards and reused
+struct Batch
+{
+    std::size_t index = 0;                                  // orders results for the writer
+    std::size_t first = 0;
+    std::size_t count = 0;
+    std::vector<std::string> errors;                        // per image, empty when it decoded
+    Tensor<float> pixels;
+};
+
+struct Prediction
+{
+    int64_t label = -1;                                     // -1 when the threshold dropped it
+    float probability = 0.0f;
+};
+
+struct BatchResult
+{
+    std::size_t index = 0;
+    std::size_t first = 0;
+    std::vector<std::string> errors;
+    std::vector<Prediction> predictions;
+};
+
+std::string json_escape(const std::string& s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        switch (c)
+        {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out += escaped;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+    return out;
+}
+
+// quoted only when it holds a separator, a quote or a line break
+std::string csv_field(const std::string& s)
+{
+    if (s.find_first_of(",\"\r\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s)
+    {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+void write_row(std::ostream& out, BulkFormat format, const Postprocessor& head, const std::string& path, const Prediction& prediction,
+               const std::string& error)
+{
+    if (format == BulkFormat::Csv)
+    {
+        out << csv_field(path) << ',';
+        if (error.empty())
+            out << csv_field(head.label(prediction.label)) << ',' << prediction.probability << ",\n";
+        else
+            out << ",," << csv_field(error) << '\n';
+        return;
+    }
+
+    out << "{\"path\":\"" << json_escape(path) << '"';
+    if (!error.empty())
+    {
+        out << ",\"error\":\"" << json_escape(error) << "\"}\n";
+        return;
+    }
+
+    // a number without a label file, like the class itself
+    out << ",\"class\":";
+    if (prediction.label < 0)
+        out << "null";
+    else if (head.labels().empty())
+        out << prediction.label;
+    else
+        out << '"' << json_escape(head.label(prediction.label)) << '"';
+    out << ",\"probability\":" << prediction.probability << "}\n";
+}
+
+}
+
+std::vector<std::string> expand_image_inputs(const std::string& spec)
+{
+    std::vector<std::string> paths;
+    if (!spec.empty() && spec[0] == '@')
+    {
+        std::ifstream list(spec.substr(1));
+        if (!list) throw std::runtime_error("Cannot open image list '" + spec.substr(1) + "'.");
+
+        // one path per line, blank lines and # comments skipped
+        for (std::string line; std::getline(list, line);)
+        {
+            while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.pop_back();
+            if (!line.empty() && line[0] != '#') paths.push_back(line);
+        }
+    }
+    else if (fs::is_directory(spec))
+    {
+        for (const auto& item : fs::directory_iterator(spec))
+        {
+            if (item.is_regular_file() && is_image_file(item.path())) paths.push_back(item.path().string());
+        }
+        std::sort(paths.begin(), paths.end());
+    }
+    else
+    {
+        // a glob pattern, or a single existing file
+        glob_t matches{};
+        if (glob(spec.c_str(), 0, nullptr, &matches) == 0)
+        {
+            for (std::size_t i = 0; i < matches.gl_pathc; ++i) paths.emplace_back(matches.gl_pathv[i]);
+        }
+        globfree(&matches);
+    }
+
+    if (paths.empty()) throw std::runtime_error("No images found for '" + spec + "'.");
+    return paths;
+}
+
+BulkFormat bulk_format_for(const std::string& path)
+{
+    const std::string ext = fs::path(path).extension().string();
+    return ext == ".jsonl" || ext == ".json" ? BulkFormat::Jsonl : BulkFormat::Csv;
+}
+
+BulkStats run_bulk_inference(Graph& graph, const BulkOptions& options)
+{
+    const std::vector<std::string>& inputs = options.inputs;
+    if (inputs.empty()) throw std::runtime_error("Bulk inference: no input images.");
+
+    PreprocessOptions preprocess = options.preprocess;
+    if (preprocess.width <= 0 || preprocess.height <= 0)
+    {
+        preprocess.width = graph.get_input_width();
+        preprocess.height = graph.get_input_height();
+    }
+    if (preprocess.width <= 0 || preprocess.height <= 0) throw std::runtime_error("Bulk inference: the model's input size is unknown.");
+
+    const Postprocessor head = options.postprocess.empty() ? Postprocessor::parse("softmax,argmax") : options.postprocess;
+
+    const std::size_t total = inputs.size();
+    const std::size_t batch_size = std::max<std::size_t>(options.batch_size, 1);
+    const std::size_t num_batches = (total + batch_size - 1) / batch_size;
+    const std::size_t image_size = static_cast<std::size_t>(preprocess.channels) * preprocess.height * preprocess.width;
+
+    std::size_t decoders = options.decode_threads;
+    if (decoders == 0) decoders = std::max<std::size_t>(std::thread::hardware_concurrency() / 2, 1);
+    decoders = std::min(decoders, num_batches);
+
+    std::ofstream file;
+    std::ostream* out = &std::cout;
+    if (!options.output.empty())
+    {
+        file.open(options.output);
+        if (!file) throw std::runtime_error("Cannot write predictions to '" + options.output + "'.");
+        out = &file;
+    }
+    if (options.format == BulkFormat::Csv) *out << "path,class,probability,error\n";
+
+    // every batch tensor is free, being decoded, queued or in inference, so the pool
+    // bounds memory; results are small and only wait for the writer
+    const std::size_t depth = std::max<std::size_t>(options.queue_depth, 1);
+    const std::size_t pool = depth + decoders + 1;
+    BoundedQueue<std::unique_ptr<Batch>> free_batches(pool), decoded(depth);
+    BoundedQueue<BatchResult> results(depth + 2);
+    for (std::size_t i = 0; i < pool; ++i) free_batches.push(std::make_unique<Batch>());
+
+    BulkStats stats;
+    std::atomic<std::size_t> next_batch{0};
+    std::atomic<std::size_t> decoders_left{decoders};
+    std::atomic<uint64_t> decode_us{0};
+    const auto start = Clock::now();
+
+    auto decode = [&]
+    {
+        std::unique_ptr<Batch> batch;
+        std::size_t k;
+        while ((k = next_batch.fetch_add(1)) < num_batches && free_batches.pop(batch))
+        {
+            const auto begin = Clock::now();
+            batch->index = k;
+            batch->first = k * batch_size;
+            batch->count = std::min(batch_size, total - batch->first);
+            batch->errors.assign(batch->count, std::string());
+
+            const std::size_t n = batch->count, c = preprocess.channels, h = preprocess.height, w = preprocess.width;
+            if (preprocess.layout == ImageLayout::NCHW)
+                batch->pixels.resize({n, c, h, w});
+            else
+                batch->pixels.resize({n, h, w, c});
+
+            // a bad image gets a zero slice and an error row, the rest of the batch runs
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                float* slice = batch->pixels.data() + i * image_size;
+                try
+                {
+                    ImageLoader::load_into(inputs[batch->first + i], preprocess, slice);
+                }
+                catch (const std::exception& e)
+                {
+                    batch->errors[i] = e.what();
+                    std::fill(slice, slice + image_size, 0.0f);
+                }
+            }
+
+            decode_us += micros_since(begin);
+            if (!decoded.push(std::move(batch))) break;
+        }
+        if (decoders_left.fetch_sub(1) == 1) decoded.close();
+    };
+
+    // rows go out in input order: results that arrive early wait for their turn
+    auto write = [&]
+    {
+        std::map<std::size_t, BatchResult> pending;
+        std::size_t next = 0;
+        BatchResult result;
+        while (results.pop(result))
+        {
+            pending.emplace(result.index, std::move(result));
+            for (auto it = pending.find(next); it != pending.end(); it = pending.find(++next))
+            {
+                const BatchResult& ready = it->second;
+                for (std::size_t i = 0; i < ready.predictions.size(); ++i)
+                {
+                    write_row(*out, options.format, head, inputs[ready.first + i], ready.predictions[i], ready.errors[i]);
+                    ++stats.images;
+                    if (!ready.errors[i].empty()) ++stats.failed;
+                }
+                pending.erase(it);
+            }
+        }
+    };
+
+    std::thread writer(write);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < decoders; ++i) workers.emplace_back(decode);
+
+    std::exception_ptr failure;
+    uint64_t inference_us = 0;
+    try
+    {
+        InferenceEngine engine;
+        BatchResult result;
+        std::vector<int64_t> top_classes;
+        std::vector<float> top_scores;
+
+        // the head's best class for `count` images starting at `first` of the batch
+        auto classify = [&](Tensor<float>& input, std::size_t first, std::size_t count)
+        {
+            std::vector<Tensor<float>*> outputs = engine.run(graph, {&input});
+            if (outputs.empty()) throw std::runtime_error("No output from engine.");
+
+            const Tensor<float>& scores = *outputs[0];
+            if (scores.size() % count != 0)
+                throw std::runtime_error("Bulk inference: the model's output does not split into one row per image.");
+            const std::size_t classes = scores.size() / count;
+            top_classes.resize(head.k(classes));
+            top_scores.resize(top_classes.size());
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (!result.errors[first + i].empty()) continue;
+                head.apply_row(scores.data() + i * classes, classes, top_classes.data(), top_scores.data());
+                result.predictions[first + i] = {top_classes[0], top_scores[0]};
+            }
+        };
+
+        // models exported with a fixed batch of 1 (a Reshape to [1, ...]) reject the
+        // first batch; from then on their images run one by one
+        bool one_at_a_time = false;
+        std::unique_ptr<Batch> batch;
+        while (decoded.pop(batch))
+        {
+            const auto begin = Clock::now();
+            result = BatchResult();
+            result.index = batch->index;
+            result.first = batch->first;
+            result.errors = std::move(batch->errors);
+            result.predictions.resize(batch->count);
+
+            bool batched = false;
+            if (!one_at_a_time && batch->count > 1)
+            {
+                try
+                {
+                    classify(batch->pixels, 0, batch->count);
+                    batched = true;
+                }
+                catch (const std::exception& e)
+                {
+                    INFERA_LOG_WARN("bulk: model rejected a batch of %zu (%s), scoring images one at a time", batch->count, e.what());
+                    one_at_a_time = true;
+                }
+            }
+            if (!batched)
+            {
+                std::vector<std::size_t> shape = batch->pixels.shape();
+                shape[0] = 1;
+                for (std::size_t i = 0; i < batch->count; ++i)
+                {
+                    Tensor<float> image;
+                    image.view(batch->pixels.data() + i * image_size, shape);
+                    classify(image, i, 1);
+                }
+            }
+
+            inference_us += micros_since(begin);
+            ++stats.batches;
+            free_batches.push(std::move(batch));
+            results.push(std::move(result));
+        }
+    }
+    catch (...)
+    {
+        failure = std::current_exception();
+        free_batches.close();
+        decoded.close();
+    }
+
+    for (auto& worker : workers) worker.join();
+    results.close();
+    writer.join();
+    if (failure) std::rethrow_exception(failure);
+
+    out->flush();
+    if (!*out) throw std::runtime_error("Failed writing predictions" + (options.output.empty() ? std::string() : " to '" + options.output + "'") + ".");
+
+    stats.seconds = micros_since(start) / 1e6;
+    stats.decode_seconds = decode_us.load() / 1e6;
+    stats.inference_seconds = inference_us / 1e6;
+    INFERA_LOG_INFO("bulk: %zu images in %zu batches, %zu decode threads", stats.images, stats.batches, decoders);
+    return stats;
+}
@@ -0,0 +1,62 @@
+#ifndef BULK_INFERENCE_H
+#define BULK_INFERENCE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "image_loader.h"
+#include "postprocess.h"
+
+// offline scoring of many images with one loaded model. images flow through
+//
+//   decode + preprocess (N threads) -> batched inference -> postprocessing head -> writer
+//
+// with bounded queues between the stages. decoders write each image straight into
+// its slice of a batch tensor taken from a fixed pool, so memory stays flat however
+// many images there are. rows are written in input order; images that fail to
+// decode get an error row and do not stop the run. a row holds the head's best
+// class, as its label when the head has a label file and empty when the
+// threshold dropped it, and its score
+
+enum class BulkFormat
+{
+    Csv,                                                    // path,class,probability,error
+    Jsonl                                                   // {"path":...,"class":...,"probability":...}
+};
+
+struct BulkOptions
+{
+    std::vector<std::string> inputs;
+    std::string output;                                     // empty writes to stdout
+    BulkFormat format = BulkFormat::Csv;
+    std::size_t batch_size = 32;
+    std::size_t decode_threads = 0;                         // 0 picks from the hardware
+    std::size_t queue_depth = 2;                            // decoded batches waiting for inference
+    PreprocessOptions preprocess;                           // width/height 0 take the model's input size
+    Postprocessor postprocess;                              // empty is softmax,argmax
+};
+
+struct BulkStats
+{
+    std::size_t images = 0;
+    std::size_t failed = 0;
+    std::size_t batches = 0;
+    double seconds = 0.0;                                   // wall clock, first decode to last row
+    double decode_seconds = 0.0;                            // summed over decode threads
+    double inference_seconds = 0.0;
+
+    double images_per_second() const { return seconds > 0.0 ? images / seconds : 0.0; }
+};
+
+// a directory (its image files, sorted), a glob pattern, or @file with one path per
+// line. throws when nothing matches
+std::vector<std::string> expand_image_inputs(const std::string& spec);
+
+// BulkFormat from an output file name: .jsonl / .json lines, anything else CSV
+BulkFormat bulk_format_for(const std::string& path);
+
+// score every input; throws if the model fails or the output cannot be written
+BulkStats run_bulk_inference(Graph& graph, const BulkOptions& options);
+
+#endif
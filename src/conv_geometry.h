@@ -0,0 +1,96 @@
+#ifndef CONV_GEOMETRY_H
+#define CONV_GEOMETRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "node.h"
+
+// resolved 2-D sliding window: sizes, pads and output extent
+struct ConvGeometry
+{
+    std::size_t kernel_h = 1, kernel_w = 1;
+    std::size_t stride_h = 1, stride_w = 1;
+    std::size_t dilation_h = 1, dilation_w = 1;
+    std::size_t pad_top = 0, pad_left = 0, pad_bottom = 0, pad_right = 0;
+    std::size_t out_h = 0, out_w = 0;
+};
+
+// window attributes shared by Conv and the pooling operators
+struct WindowAttributes
+{
+    std::vector<int64_t> kernel_shape, strides, dilations, pads;
+    std::string auto_pad = "NOTSET";
+    bool ceil_mode = false;
+
+    void parse(const Node& node)
+    {
+        kernel_shape = node.get_attribute<std::vector<int64_t>>("kernel_shape").value_or(std::vector<int64_t>{});
+        strides = node.get_attribute<std::vector<int64_t>>("strides").value_or(std::vector<int64_t>{});
+        dilations = node.get_attribute<std::vector<int64_t>>("dilations").value_or(std::vector<int64_t>{});
+        pads = node.get_attribute<std::vector<int64_t>>("pads").value_or(std::vector<int64_t>{});
+        auto_pad = node.get_attribute<std::string>("auto_pad").value_or("NOTSET");
+        ceil_mode = node.get_attribute<int64_t>("ceil_mode").value_or(0) != 0;
+    }
+
+    // kernel_h/kernel_w come from kernel_shape when set, else from the weights
+    ConvGeometry resolve(std::size_t in_h, std::size_t in_w, std::size_t kernel_h, std::size_t kernel_w) const
+    {
+        ConvGeometry g;
+        if (kernel_shape.size() == 2)
+        {
+            kernel_h = static_cast<std::size_t>(kernel_shape[0]);
+            kernel_w = static_cast<std::size_t>(kernel_shape[1]);
+        }
+        g.kernel_h = kernel_h;
+        g.kernel_w = kernel_w;
+        if (strides.size() == 2) { g.stride_h = strides[0]; g.stride_w = strides[1]; }
+        if (dilations.size() == 2) { g.dilation_h = dilations[0]; g.dilation_w = dilations[1]; }
+
+        resolve_axis(in_h, g.kernel_h, g.stride_h, g.dilation_h, 0, g.pad_top, g.pad_bottom, g.out_h);
+        resolve_axis(in_w, g.kernel_w, g.stride_w, g.dilation_w, 1, g.pad_left, g.pad_right, g.out_w);
+        return g;
+    }
+
+private:
+    void resolve_axis(std::size_t in, std::size_t kernel, std::size_t stride, std::size_t dilation, std::size_t axis,
+                      std::size_t& pad_begin, std::size_t& pad_end, std::size_t& out) const
+    {
+        if (stride == 0 || dilation == 0) throw std::runtime_error("Window error: strides and dilations must be positive.");
+        const std::size_t span = (kernel - 1) * dilation + 1;
+
+        // SAME keeps ceil(in / stride) outputs, the odd pad goes at the end (UPPER) or start (LOWER)
+        if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER")
+        {
+            out = (in + stride - 1) / stride;
+            std::size_t needed = (out - 1) * stride + span;
+            std::size_t total = needed > in ? needed - in : 0;
+            pad_begin = auto_pad == "SAME_UPPER" ? total / 2 : total - total / 2;
+            pad_end = total - pad_begin;
+            return;
+        }
+
+        pad_begin = pad_end = 0;
+        if (auto_pad == "NOTSET" && pads.size() == 4)
+        {
+            pad_begin = static_cast<std::size_t>(pads[axis]);
+            pad_end = static_cast<std::size_t>(pads[axis + 2]);
+        }
+        else if (auto_pad != "NOTSET" && auto_pad != "VALID")
+        {
+            throw std::runtime_error("Window error: unsupported auto_pad '" + auto_pad + "'.");
+        }
+
+        const std::size_t padded = in + pad_begin + pad_end;
+        if (padded < span) throw std::runtime_error("Window error: kernel is larger than the padded input.");
+
+        out = (padded - span + (ceil_mode ? stride - 1 : 0)) / stride + 1;
+
+        // with ceil_mode the last window has to start inside the input or left padding
+        if (ceil_mode && (out - 1) * stride >= in + pad_begin) --out;
+    }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "cpu_features.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define INFERA_X86 1
+#endif
+
+namespace
+{
+
+#ifdef INFERA_X86
+// read extended control register 0 (which register states the OS saves)
+uint64_t read_xcr0()
+{
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+#endif
+
+CpuFeatures probe()
+{
+    CpuFeatures f;
+
+#ifdef INFERA_X86
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return f;
+
+    f.sse42 = ecx & (1u << 20);
+    f.fma   = ecx & (1u << 12);
+    f.avx   = ecx & (1u << 28);
+    f.f16c  = ecx & (1u << 29);
+
+    // OS support is required before touching YMM/ZMM registers
+    bool osxsave = ecx & (1u << 27);
+    if (osxsave)
+    {
+        uint64_t xcr0 = read_xcr0();
+        f.os_avx    = (xcr0 & 0x6) == 0x6;      // SSE + AVX state
+        f.os_avx512 = (xcr0 & 0xE6) == 0xE6;    // + opmask, ZMM_Hi256, Hi16_ZMM
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        f.avx2     = ebx & (1u << 5);
+        f.avx512f  = ebx & (1u << 16);
+        f.avx512dq = ebx & (1u << 17);
+        f.avx512bw = ebx & (1u << 30);
+        f.avx512vl = ebx & (1u << 31);
+    }
+#endif
+
+    return f;
+}
+
+}
+
+const CpuFeatures& cpu_features()
+{
+    static const CpuFeatures features = probe();
+    return features;
+}
+
+bool isa_supported(Isa isa)
+{
+    const CpuFeatures& f = cpu_features();
+
+    switch (isa)
+    {
+    case Isa::Scalar:
+        return true;
+    case Isa::Sse42:
+        return f.sse42;
+    case Isa::Avx2:
+        return f.sse42 && f.avx && f.avx2 && f.fma && f.f16c && f.os_avx;
+    case Isa::Avx512:
+        return isa_supported(Isa::Avx2) && f.avx512f && f.avx512bw && f.avx512dq && f.avx512vl && f.os_avx512;
+    }
+    return false;
+}
+
+Isa best_supported_isa()
+{
+    if (isa_supported(Isa::Avx512)) return Isa::Avx512;
+    if (isa_supported(Isa::Avx2)) return Isa::Avx2;
+    if (isa_supported(Isa::Sse42)) return Isa::Sse42;
+    return Isa::Scalar;
+}
+
+const char* isa_name(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::Scalar: return "scalar";
+    case Isa::Sse42:  return "sse42";
+    case Isa::Avx2:   return "avx2";
+    case Isa::Avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool parse_isa(const char* name, Isa& isa)
+{
+    for (int i = static_cast<int>(Isa::Scalar); i <= static_cast<int>(Isa::Avx512); ++i)
+    {
+        Isa candidate = static_cast<Isa>(i);
+        if (std::strcmp(name, isa_name(candidate)) == 0)
+        {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,38 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// kept free of STL headers on purpose: this header is pulled into the
+// per-ISA kernel translation units (see kernels/kernels_impl.h)
+
+// kernel instruction set variants compiled into the binary, ordered from
+// least to most capable
+enum class Isa
+{
+    Scalar = 0,
+    Sse42,
+    Avx2,      // AVX2 + FMA + F16C
+    Avx512     // AVX-512 F/BW/DQ/VL
+};
+
+struct CpuFeatures
+{
+    bool sse42    = false;
+    bool avx      = false;
+    bool avx2     = false;
+    bool fma      = false;
+    bool f16c     = false;
+    bool avx512f  = false;
+    bool avx512bw = false;
+    bool avx512dq = false;
+    bool avx512vl = false;
+    bool os_avx    = false;   // OS saves YMM state (XCR0)
+    bool os_avx512 = false;   // OS saves ZMM/opmask state (XCR0)
+};
+
+const CpuFeatures& cpu_features();                       // probed once via CPUID
+bool isa_supported(Isa isa);                             // can this host run the variant
+Isa best_supported_isa();                                // most capable variant the host supports
+const char* isa_name(Isa isa);                           // "scalar", "sse42", "avx2", "avx512"
+bool parse_isa(const char* name, Isa& isa);              // inverse of isa_name, false if unknown
+
+#endif
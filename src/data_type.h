@@ -0,0 +1,203 @@
+#ifndef DATA_TYPE_H
+#define DATA_TYPE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// element types a tensor can hold at runtime. the order matches the
+// alternatives of AnyTensor's variant
+enum class DataType
+{
+    Float32 = 0,
+    Float16,
+    BFloat16,
+    Int8,
+    UInt8,
+    Int32,
+    Int64,
+    Bool
+};
+
+// 16-bit float storage, arithmetic is done after widening to float32
+struct float16
+{
+    uint16_t bits = 0;
+};
+
+struct bfloat16
+{
+    uint16_t bits = 0;
+};
+
+// float16 buffers as the raw bit pattern the kernels take
+static_assert(sizeof(float16) == sizeof(uint16_t), "float16 must be exactly its bits");
+inline const uint16_t* half_bits(const float16* p) { return reinterpret_cast<const uint16_t*>(p); }
+
+// IEEE 754 binary16 -> binary32, exact
+inline float half_to_float(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f)
+    {
+        bits = sign | 0x7f800000 | (mantissa << 13);               // inf / nan
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13); // normal, rebias 15 -> 127
+    }
+    else if (mantissa == 0)
+    {
+        bits = sign;                                               // signed zero
+    }
+    else
+    {
+        // subnormal: shift the leading one into the implicit bit
+        exponent = 113;
+        while (!(mantissa & 0x400))
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// binary32 -> binary16, round to nearest even, overflow goes to inf
+inline uint16_t float_to_half(float f)
+{
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+
+    const uint16_t sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    const uint32_t magnitude = x & 0x7fffffff;
+
+    if (magnitude >= 0x7f800000)                                   // inf / nan (keep it a quiet nan)
+        return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0);
+    if (magnitude >= 0x477ff000)                                   // >= 65520 rounds past the largest half
+        return sign | 0x7c00;
+    if (magnitude < 0x38800000)                                    // below 2^-14: subnormal half
+    {
+        float a;
+        std::memcpy(&a, &magnitude, sizeof(a));
+        return sign | static_cast<uint16_t>(std::nearbyint(a * 16777216.0f));   // units of 2^-24
+    }
+
+    uint32_t rebiased = magnitude - (112u << 23);
+    rebiased += 0xfff + ((rebiased >> 13) & 1);
+    return sign | static_cast<uint16_t>(rebiased >> 13);
+}
+
+inline float bfloat16_to_float(uint16_t b)
+{
+    uint32_t bits = static_cast<uint32_t>(b) << 16;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// truncate to the upper 16 bits with round to nearest even
+inline uint16_t float_to_bfloat16(float f)
+{
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    if ((x & 0x7fffffff) > 0x7f800000) return static_cast<uint16_t>((x >> 16) | 0x40);
+
+    x += 0x7fff + ((x >> 16) & 1);
+    return static_cast<uint16_t>(x >> 16);
+}
+
+// C++ type -> runtime tag
+template <class T> struct DataTypeOf;
+template <> struct DataTypeOf<float>    { static constexpr DataType value = DataType::Float32; };
+template <> struct DataTypeOf<float16>  { static constexpr DataType value = DataType::Float16; };
+template <> struct DataTypeOf<bfloat16> { static constexpr DataType value = DataType::BFloat16; };
+template <> struct DataTypeOf<int8_t>   { static constexpr DataType value = DataType::Int8; };
+template <> struct DataTypeOf<uint8_t>  { static constexpr DataType value = DataType::UInt8; };
+template <> struct DataTypeOf<int32_t>  { static constexpr DataType value = DataType::Int32; };
+template <> struct DataTypeOf<int64_t>  { static constexpr DataType value = DataType::Int64; };
+template <> struct DataTypeOf<bool>     { static constexpr DataType value = DataType::Bool; };
+
+inline const char* data_type_name(DataType type)
+{
+    switch (type)
+    {
+    case DataType::Float32:  return "float32";
+    case DataType::Float16:  return "float16";
+    case DataType::BFloat16: return "bfloat16";
+    case DataType::Int8:     return "int8";
+    case DataType::UInt8:    return "uint8";
+    case DataType::Int32:    return "int32";
+    case DataType::Int64:    return "int64";
+    case DataType::Bool:     return "bool";
+    }
+    return "unknown";
+}
+
+inline std::size_t data_type_size(DataType type)
+{
+    switch (type)
+    {
+    case DataType::Float32:  return 4;
+    case DataType::Float16:  return 2;
+    case DataType::BFloat16: return 2;
+    case DataType::Int8:     return 1;
+    case DataType::UInt8:    return 1;
+    case DataType::Int32:    return 4;
+    case DataType::Int64:    return 8;
+    case DataType::Bool:     return sizeof(bool);
+    }
+    return 0;
+}
+
+// onnx::TensorProto::DataType values
+inline bool data_type_from_onnx(int32_t onnx_type, DataType& type)
+{
+    switch (onnx_type)
+    {
+    case 1:  type = DataType::Float32;  return true;
+    case 2:  type = DataType::UInt8;    return true;
+    case 3:  type = DataType::Int8;     return true;
+    case 6:  type = DataType::Int32;    return true;
+    case 7:  type = DataType::Int64;    return true;
+    case 9:  type = DataType::Bool;     return true;
+    case 10: type = DataType::Float16;  return true;
+    case 16: type = DataType::BFloat16; return true;
+    default: return false;
+    }
+}
+
+// widen any element to double / narrow a double back, half types go through float
+template <class T> inline double to_double(T v) { return static_cast<double>(v); }
+inline double to_double(float16 v) { return half_to_float(v.bits); }
+inline double to_double(bfloat16 v) { return bfloat16_to_float(v.bits); }
+
+// element conversion with Cast semantics: integers convert directly, bool is != 0
+template <class To, class From>
+inline To convert_value(From v)
+{
+    if constexpr (std::is_same_v<To, From>)
+        return v;
+    else if constexpr (std::is_same_v<To, bool>)
+        return to_double(v) != 0.0;
+    else if constexpr (std::is_integral_v<To> && std::is_integral_v<From>)
+        return static_cast<To>(v);
+    else if constexpr (std::is_same_v<To, float16>)
+        return float16{float_to_half(static_cast<float>(to_double(v)))};
+    else if constexpr (std::is_same_v<To, bfloat16>)
+        return bfloat16{float_to_bfloat16(static_cast<float>(to_double(v)))};
+    else
+        return static_cast<To>(to_double(v));
+}
+
+#endif
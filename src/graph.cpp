@@ -1,72 +1,158 @@
 #include "graph.h"
 
 // constructor 
-Graph::Graph(const onnx::GraphProto& graph_proto) : input_height_(0), input_width_(0)
+Graph::Graph(const onnx::GraphProto& graph_proto) : name_(graph_proto.name()), input_height_(0), input_width_(0)
 {
     // load weights into nodes
     for (const auto& tensor_proto : graph_proto.initializer())
     {
-        std::vector<std::size_t> shape;
-        for (auto dim : tensor_proto.dims()) shape.push_back(dim);
-
-        auto tensor = std::make_unique<Tensor<float>>(shape);
-
-        // load raw bytes or float list
-        if (tensor_proto.has_raw_data()) 
-        {
-            const std::string& raw = tensor_proto.raw_data();
-            std::memcpy(tensor->data(), raw.data(), raw.size());
-        } 
-        else 
-        {
-            for (int i = 0; i < tensor_proto.float_data_size(); ++i)
-                tensor->data()[i] = tensor_proto.float_data(i);
-        }
-        initializers_[tensor_proto.name()] = std::move(tensor);
+        initializers_[tensor_proto.name()] = std::make_unique<AnyTensor>(load_tensor_proto(tensor_proto));
     }
 
-    // store input names
+    // store input names, older exporters also list every initializer as an input
     inputs_.reserve(graph_proto.input_size());
-    for (const auto& in : graph_proto.input()) inputs_.push_back(in.name());
+    for (const auto& in : graph_proto.input())
+    {
+        if (!has_initializer(in.name())) add_input(in.name(), load_value_info(in));
+    }
 
     // store output  names
     outputs_.reserve(graph_proto.output_size());
-    for (const auto& out : graph_proto.output()) outputs_.push_back(out.name());
-
-    // map tensor name -> node that produces it
-    std::unordered_map<std::string, Node*> tensor_to_producer;
+    for (const auto& out : graph_proto.output()) add_output(out.name(), load_value_info(out));
 
-    // create nodes and register outputs
+    // create nodes
     node_map_.reserve(graph_proto.node_size());
     for (const auto& node_proto : graph_proto.node()) 
     {
         auto node = std::make_unique<Node>(node_proto);
-        Node* node_ptr = node.get();
-        std::string name = node->get_name();
-
-        // handle nodes without a name
-        if (name.empty()) 
-            name = "node_" + std::to_string(node_map_.size());
 
-        // register each output tensor
-        for (const auto& output : node->get_outputs())
-            tensor_to_producer[output] = node_ptr;
+        // handle nodes without a name, edges are keyed by node name
+        if (node->get_name().empty()) 
+            node->set_name("node_" + std::to_string(node_map_.size()));
 
         // store the node in the map
+        std::string name = node->get_name();
         NodeInfo info;
         info.node = std::move(node);
         node_map_[name] = std::move(info);
     }
 
+    rebuild_edges();
+}
+
+AnyTensor load_tensor_proto(const onnx::TensorProto& proto)
+{
+    const std::string& name = proto.name();
+    std::vector<std::size_t> shape;
+    for (auto dim : proto.dims()) shape.push_back(static_cast<std::size_t>(dim));
+
+    if (proto.data_location() == onnx::TensorProto::EXTERNAL)
+    {
+        throw std::runtime_error("Initializer '" + name + "': external data is not supported.");
+    }
+
+    // no double kernels, narrow to float32 at load
+    if (proto.data_type() == onnx::TensorProto::DOUBLE)
+    {
+        Tensor<float> tensor(shape);
+        const std::string& raw = proto.raw_data();
+        const std::size_t count = proto.has_raw_data() ? raw.size() / sizeof(double) : proto.double_data_size();
+        if (count != tensor.size()) throw std::runtime_error("Initializer '" + name + "': element count does not match its shape.");
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            double v;
+            if (proto.has_raw_data()) std::memcpy(&v, raw.data() + i * sizeof(double), sizeof(double));
+            else v = proto.double_data(static_cast<int>(i));
+            tensor[i] = static_cast<float>(v);
+        }
+        return AnyTensor(std::move(tensor));
+    }
+
+    // hand-built protos often leave data_type UNDEFINED, keep treating them as float32
+    DataType type = DataType::Float32;
+    if (proto.data_type() != onnx::TensorProto::UNDEFINED && !data_type_from_onnx(proto.data_type(), type))
+    {
+        throw std::runtime_error("Initializer '" + name + "': unsupported data type " + std::to_string(proto.data_type()) + ".");
+    }
+
+    AnyTensor tensor(type, shape);
+
+    // raw bytes are little-endian in the element type itself
+    if (proto.has_raw_data())
+    {
+        const std::string& raw = proto.raw_data();
+        if (raw.size() != tensor.bytes())
+        {
+            throw std::runtime_error("Initializer '" + name + "': raw data holds " + std::to_string(raw.size()) + " bytes, expected " + std::to_string(tensor.bytes()) + ".");
+        }
+        std::memcpy(tensor.raw(), raw.data(), raw.size());
+        return tensor;
+    }
+
+    // typed fields: float_data, int64_data, everything narrower (incl. 16-bit float bits) in int32_data
+    auto check_count = [&](int count)
+    {
+        if (static_cast<std::size_t>(count) != tensor.size())
+            throw std::runtime_error("Initializer '" + name + "': element count does not match its shape.");
+    };
+
+    switch (type)
+    {
+    case DataType::Float32:
+        check_count(proto.float_data_size());
+        std::copy(proto.float_data().begin(), proto.float_data().end(), tensor.get<float>().data());
+        break;
+    case DataType::Int64:
+        check_count(proto.int64_data_size());
+        std::copy(proto.int64_data().begin(), proto.int64_data().end(), tensor.get<int64_t>().data());
+        break;
+    case DataType::Float16:
+        check_count(proto.int32_data_size());
+        for (int i = 0; i < proto.int32_data_size(); ++i) tensor.get<float16>()[i].bits = static_cast<uint16_t>(proto.int32_data(i));
+        break;
+    case DataType::BFloat16:
+        check_count(proto.int32_data_size());
+        for (int i = 0; i < proto.int32_data_size(); ++i) tensor.get<bfloat16>()[i].bits = static_cast<uint16_t>(proto.int32_data(i));
+        break;
+    default:
+    {
+        check_count(proto.int32_data_size());
+        Tensor<int32_t> wide(shape);
+        std::copy(proto.int32_data().begin(), proto.int32_data().end(), wide.data());
+        tensor = AnyTensor(std::move(wide)).cast(type);
+        break;
+    }
+    }
+    return tensor;
+}
+
+// recompute all parent/child links from tensor names
+void Graph::rebuild_edges()
+{
+    // map tensor name -> node that produces it
+    std::unordered_map<std::string, Node*> tensor_to_producer;
+
+    for (auto& [name, info] : node_map_)
+    {
+        info.children.clear();
+        info.parents.clear();
+
+        // register each output tensor
+        for (const auto& output : info.node->get_outputs())
+            tensor_to_producer[output] = info.node.get();
+    }
+
     // connect edges based on input/output tensors
     for (auto& [name, info] : node_map_) 
     {
         Node* current_node = info.node.get();
         for (const auto& input_name : current_node->get_inputs()) 
         {
-            if (tensor_to_producer.count(input_name)) 
+            auto it = tensor_to_producer.find(input_name);
+            if (it != tensor_to_producer.end()) 
             {
-                Node* parent = tensor_to_producer[input_name];
+                Node* parent = it->second;
                 
                 // link parent -> child
                 node_map_[parent->get_name()].children.push_back(current_node);
@@ -76,11 +162,18 @@ Graph::Graph(const onnx::GraphProto& graph_proto) : input_height_(0), input_widt
             }
         }
     }
+
+    // cached order is stale now
+    sorted_nodes_.clear();
 }
 
 // add new node to the graph
 void Graph::add_node(std::unique_ptr<Node> node)
 {
+    // handle nodes without a name, edges are keyed by node name
+    if (node->get_name().empty())
+        node->set_name("node_" + std::to_string(node_map_.size()));
+
     std::string name = node->get_name();
     Node* ptr = node.get();
 
@@ -90,6 +183,7 @@ void Graph::add_node(std::unique_ptr<Node> node)
 
     // update edges after adding
     update_edges(ptr);
+    sorted_nodes_.clear();
 }
 
 // update all edges of a node
@@ -145,6 +239,49 @@ void Graph::replace_node(Node* old_node, std::unique_ptr<Node> new_node)
     auto& info {node_map_[old_name]};
     new_node->set_name(old_name); 
     info.node = std::move(new_node);
+
+    // edges and cached order still point at the old node
+    rebuild_edges();
+}
+
+// remove node from the graph, its output tensors are no longer produced
+void Graph::remove_node(Node* node)
+{
+    if (node_map_.erase(node->get_name()) == 0)
+        return;
+
+    rebuild_edges();
+}
+
+// find the node producing a tensor, nullptr for graph inputs and initializers
+Node* Graph::get_producer(const std::string& tensor_name) const
+{
+    for (const auto& [name, info] : node_map_)
+    {
+        const auto& outputs = info.node->get_outputs();
+        if (std::find(outputs.begin(), outputs.end(), tensor_name) != outputs.end())
+            return info.node.get();
+    }
+    return nullptr;
+}
+
+// find every node reading a tensor
+std::vector<Node*> Graph::get_consumers(const std::string& tensor_name) const
+{
+    std::vector<Node*> consumers;
+    for (const auto& [name, info] : node_map_)
+    {
+        const auto& inputs = info.node->get_inputs();
+        if (std::find(inputs.begin(), inputs.end(), tensor_name) != inputs.end())
+            consumers.push_back(info.node.get());
+    }
+    return consumers;
+}
+
+// check if tensor is one of the graph outputs
+bool Graph::is_graph_output(const std::string& name) const
+{
+    return std::find(outputs_.begin(), outputs_.end(), name) != outputs_.end();
 }
 
 // get input name by index
@@ -199,29 +336,78 @@ bool Graph::has_initializer(const std::string& name) const
     return initializers_.find(name) != initializers_.end();
 }
 
-// get ptr to the initializer tensor by name
+// get ptr to the float32 initializer tensor by name
 Tensor<float>* Graph::get_initializer(const std::string& name) const 
 {
-    if (!has_initializer(name)) return nullptr;
-    return initializers_.at(name).get();
+    AnyTensor* tensor = get_any_initializer(name);
+    if (!tensor || !tensor->is<float>()) return nullptr;
+    return &tensor->get<float>();
+}
+
+// get ptr to the initializer tensor of any dtype by name
+AnyTensor* Graph::get_any_initializer(const std::string& name) const
+{
+    auto it = initializers_.find(name);
+    return it == initializers_.end() ? nullptr : it->second.get();
 }
 
-// add a new initializer tensor to the graph
+// add a new initializer tensor to the graph, takes ownership
 void Graph::add_initializer(const std::string& name, Tensor<float>* tensor) 
 {
-    initializers_[name] = std::unique_ptr<Tensor<float>>(tensor);
+    initializers_[name] = std::make_unique<AnyTensor>(std::move(*tensor));
+    delete tensor;
+}
+
+void Graph::add_initializer(const std::string& name, AnyTensor tensor)
+{
+    initializers_[name] = std::make_unique<AnyTensor>(std::move(tensor));
+}
+
+// drop an initializer tensor from the graph
+void Graph::remove_initializer(const std::string& name)
+{
+    initializers_.erase(name);
+}
+
+// total size of the stored weights
+std::size_t Graph::initializer_bytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& entry : initializers_) bytes += entry.second->bytes();
+    return bytes;
+}
+
+// element type and dims of a graph input/output, float32 when undeclared
+ValueInfo load_value_info(const onnx::ValueInfoProto& proto)
+{
+    ValueInfo info;
+    if (!proto.has_type() || !proto.type().has_tensor_type()) return info;
+
+    const auto& tensor_type = proto.type().tensor_type();
+    DataType dtype;
+    if (data_type_from_onnx(tensor_type.elem_type(), dtype)) info.dtype = dtype;
+
+    if (tensor_type.has_shape())
+    {
+        info.has_shape = true;
+        for (const auto& dim : tensor_type.shape().dim())
+            info.shape.push_back(dim.has_dim_value() ? dim.dim_value() : -1);
+    }
+    return info;
 }
 
 // add graph input by name
-void Graph::add_input(const std::string& name) 
+void Graph::add_input(const std::string& name, const ValueInfo& info) 
 {
     inputs_.push_back(name);
+    input_info_.push_back(info);
 }
 
 // add graph output by name.
-void Graph::add_output(const std::string& name) 
+void Graph::add_output(const std::string& name, const ValueInfo& info) 
 {
     outputs_.push_back(name);
+    output_info_.push_back(info);
 }
 
 
@@ -298,7 +484,7 @@ void Graph::infer_input_size()
                 this->input_width_ = side;
                 this->input_height_ = side;
                 
-                std::cout << "Inferred " << side << "x" << side << " input from weight '" << name << "' (dim=" << dim << ")\n";
+                std::cerr << "Inferred " << side << "x" << side << " input from weight '" << name << "' (dim=" << dim << ")\n";
                 
                 found = true;
                 break; 
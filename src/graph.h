@@ -13,9 +13,23 @@
 #include <cstring>
 
 #include "tensor.h"
+#include "any_tensor.h"
 #include "node.h"
 #include "onnx-ml.pb.h"
 
+// decode a TensorProto honoring its data_type (raw_data or the typed field)
+AnyTensor load_tensor_proto(const onnx::TensorProto& proto);
+
+// declared type of a graph input or output, -1 marks a symbolic or unknown dim
+struct ValueInfo
+{
+    DataType dtype = DataType::Float32;
+    std::vector<int64_t> shape;
+    bool has_shape = false;
+};
+
+ValueInfo load_value_info(const onnx::ValueInfoProto& proto);
+
 class Graph
 {
 public:
@@ -34,17 +48,30 @@ public:
     void print_graph() const;
     void add_node(std::unique_ptr<Node> node);
     void replace_node(Node* old_node, std::unique_ptr<Node> new_node);
+    void remove_node(Node* node);
+    void rebuild_edges();
+    Node* get_producer(const std::string& tensor_name) const;
+    std::vector<Node*> get_consumers(const std::string& tensor_name) const;
+    bool is_graph_output(const std::string& name) const;
     std::vector<Node*> topological_sort();
     bool has_initializer(const std::string& name) const ;
-    Tensor<float>* get_initializer(const std::string& name) const;
+    Tensor<float>* get_initializer(const std::string& name) const;          // nullptr unless it exists and is float32
+    AnyTensor* get_any_initializer(const std::string& name) const;
     void add_initializer(const std::string& name, Tensor<float>* tensor);
-    void add_input(const std::string& name);
-    void add_output(const std::string& name);
+    void add_initializer(const std::string& name, AnyTensor tensor);
+    void remove_initializer(const std::string& name);
+    std::size_t initializer_bytes() const;                                   // memory held by all initializers
+    void add_input(const std::string& name, const ValueInfo& info = {});
+    void add_output(const std::string& name, const ValueInfo& info = {});
+    const ValueInfo& get_input_info(std::size_t index) const { return input_info_.at(index); }
+    const ValueInfo& get_output_info(std::size_t index) const { return output_info_.at(index); }
     std::size_t get_input_size() const { return inputs_.size(); }
     std::size_t get_output_size() const { return outputs_.size(); }
     int get_input_height() const { return input_height_; }
     int get_input_width() const { return input_width_; }
     void infer_input_size();
+    const std::string& get_name() const { return name_; }
+    void set_name(const std::string& name) { name_ = name; }
 private:
     void update_edges(Node* node);
     void add_incoming_edges(Node* node);
@@ -53,9 +80,12 @@ private:
     bool is_input_node(Node* node) const;
     std::vector<std::string> inputs_;
     std::vector<std::string> outputs_;
+    std::vector<ValueInfo> input_info_;                     // parallel to inputs_ / outputs_
+    std::vector<ValueInfo> output_info_;
     std::unordered_map<std::string, NodeInfo> node_map_;
     std::vector<Node*> sorted_nodes_;
-    std::unordered_map<std::string, std::unique_ptr<Tensor<float>>> initializers_;
+    std::unordered_map<std::string, std::unique_ptr<AnyTensor>> initializers_;
+    std::string name_;
     int input_height_ {};
     int input_width_ {};
 };
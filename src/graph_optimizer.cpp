@@ -0,0 +1,632 @@
+#include "graph_optimizer.h"
+#include "kernels/kernels.h"
+#include "logger.h"
+#include "sparse.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+
+// node for an operator the optimizer inserts, with an optional INT attribute
+std::unique_ptr<Node> make_node(const std::string& op_type, const std::string& name, const std::string& input, const std::string& output,
+                                const std::string& attr_name = "", int64_t attr_value = 0)
+{
+    onnx::NodeProto proto;
+    proto.set_name(name);
+    proto.set_op_type(op_type);
+    proto.add_input(input);
+    proto.add_output(output);
+
+    if (!attr_name.empty())
+    {
+        auto* attr = proto.add_attribute();
+        attr->set_name(attr_name);
+        attr->set_type(onnx::AttributeProto::INT);
+        attr->set_i(attr_value);
+    }
+    return std::make_unique<Node>(proto);
+}
+
+// blocked copies of [OC, IC, KH, KW] weights: [OC/B, IC/B, KH, KW, B in, B out], zero padded
+Tensor<float>* block_conv_weights(const Tensor<float>& W, std::size_t block)
+{
+    const std::size_t OC = W.shape()[0], IC = W.shape()[1], KH = W.shape()[2], KW = W.shape()[3];
+    const std::size_t ocb = (OC + block - 1) / block, icb = (IC + block - 1) / block;
+
+    auto* blocked = new Tensor<float>({ocb, icb, KH, KW, block, block});
+    std::fill(blocked->data(), blocked->data() + blocked->size(), 0.0f);
+
+    for (std::size_t oc = 0; oc < OC; ++oc)
+        for (std::size_t ic = 0; ic < IC; ++ic)
+            for (std::size_t kh = 0; kh < KH; ++kh)
+                for (std::size_t kw = 0; kw < KW; ++kw)
+                {
+                    std::size_t dst = ((((oc / block * icb + ic / block) * KH + kh) * KW + kw) * block + ic % block) * block + oc % block;
+                    blocked->data()[dst] = W.data()[((oc * IC + ic) * KH + kh) * KW + kw];
+                }
+    return blocked;
+}
+
+// minimum weight sparsity worth trying the sparse kernel on, INFERA_SPARSITY overrides
+double sparsity_threshold()
+{
+    const char* value = std::getenv("INFERA_SPARSITY");
+    return value ? std::atof(value) : 0.7;
+}
+
+// best of a few timed runs of fn, in seconds
+template <class Fn>
+double best_time(Fn fn)
+{
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// time dense vs sparse on the real weights for a single row and a small batch
+bool sparse_is_faster(const Tensor<float>& W, std::size_t K, std::size_t N, bool trans_b, const BsrWeights& bsr, double& dense_ms, double& sparse_ms)
+{
+    const std::size_t rows = 16;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> A(rows * K), Y(rows * N);
+    for (auto& a : A) a = dist(rng);
+
+    const BsrMatrix B = bsr.view();
+    dense_ms = sparse_ms = 0.0;
+    for (std::size_t M : {std::size_t(1), rows})
+    {
+        dense_ms += 1e3 * best_time([&] { kernels().sgemm(false, trans_b, M, N, K, 1.0f, A.data(), K, W.data(), trans_b ? K : N, 0.0f, Y.data(), N); });
+        sparse_ms += 1e3 * best_time([&]
+        {
+            std::fill(Y.begin(), Y.begin() + M * N, 0.0f);
+            kernels().bsr_gemm(M, 1.0f, A.data(), K, B, Y.data(), N);
+        });
+    }
+    return sparse_ms < dense_ms;
+}
+
+}
+
+// run all load-time passes
+std::size_t GraphOptimizer::optimize(Graph& graph)
+{
+    std::size_t removed = 0;
+
+    std::size_t folded = fold_batch_norm(graph);
+    if (folded > 0)
+        INFERA_LOG_INFO("optimizer: folded %zu BatchNormalization node(s) into preceding weights", folded);
+    removed += folded;
+
+    std::size_t biases = fold_conv_add(graph);
+    if (biases > 0)
+        INFERA_LOG_INFO("optimizer: folded %zu bias Add node(s) into Conv", biases);
+    removed += biases;
+
+    std::size_t sparse = sparsify_weights(graph, sparsity_threshold());
+    if (sparse > 0)
+        INFERA_LOG_INFO("optimizer: moved %zu Gemm/MatMul node(s) to block-sparse weights", sparse);
+
+    std::size_t blocked = convert_to_nchwc(graph);
+    if (blocked > 0)
+        INFERA_LOG_INFO("optimizer: converted %zu node(s) to the NCHW%zuc layout", blocked, kernels().nchwc_block);
+
+    return removed;
+}
+
+// fold BatchNormalization nodes into the Conv/Gemm that feeds them
+std::size_t GraphOptimizer::fold_batch_norm(Graph& graph)
+{
+    std::size_t folded = 0;
+
+    // copy the order, the graph is edited while walking it
+    std::vector<Node*> nodes = graph.topological_sort();
+
+    for (Node* bn : nodes)
+    {
+        if (bn->get_optype() != "BatchNormalization") continue;
+
+        // training mode outputs (running mean/var) cannot be folded
+        if (bn->get_inputs().size() < 5 || bn->get_outputs().size() != 1) continue;
+
+        const std::string& input = bn->get_inputs()[0];
+        Node* producer = graph.get_producer(input);
+        if (!producer || producer->get_outputs().size() != 1) continue;
+
+        // the intermediate tensor must not be observed by anyone else
+        std::vector<Node*> consumers = graph.get_consumers(input);
+        if (consumers.size() != 1 || graph.is_graph_output(input)) continue;
+
+        std::vector<float> scale, shift;
+        if (!batch_norm_affine(graph, *bn, scale, shift)) continue;
+
+        bool ok = false;
+        if (producer->get_optype() == "Conv")
+            ok = fold_into_conv(graph, *producer, scale, shift);
+        else if (producer->get_optype() == "Gemm")
+            ok = fold_into_gemm(graph, *producer, scale, shift);
+
+        if (!ok) continue;
+
+        // producer now writes the BN output directly
+        std::vector<std::string> bn_params(bn->get_inputs().begin() + 1, bn->get_inputs().end());
+        producer->set_output(0, bn->get_outputs()[0]);
+        graph.remove_node(bn);
+
+        // free the BN parameters nobody else reads
+        for (const auto& name : bn_params)
+        {
+            if (graph.get_consumers(name).empty())
+                graph.remove_initializer(name);
+        }
+        ++folded;
+    }
+
+    return folded;
+}
+
+// Conv -> Add(bias) becomes Conv with that bias
+std::size_t GraphOptimizer::fold_conv_add(Graph& graph)
+{
+    std::size_t folded = 0;
+    std::vector<Node*> nodes = graph.topological_sort();
+
+    for (Node* add : nodes)
+    {
+        if (add->get_optype() != "Add" || add->get_inputs().size() != 2) continue;
+
+        // either side may be the convolution
+        for (std::size_t side = 0; side < 2; ++side)
+        {
+            const std::string& input = add->get_inputs()[side];
+            const std::string& constant = add->get_inputs()[1 - side];
+
+            Node* conv = graph.get_producer(input);
+            if (!conv || conv->get_optype() != "Conv" || conv->get_outputs().size() != 1) continue;
+            if (!is_exclusive_tensor(graph, input, *add)) continue;
+
+            const auto& conv_inputs = conv->get_inputs();
+            Tensor<float>* W = conv_inputs.size() > 1 ? graph.get_initializer(conv_inputs[1]) : nullptr;
+            Tensor<float>* C = graph.get_initializer(constant);
+            if (!W || !C || W->shape().size() != 4) continue;
+
+            // only a per-output-channel constant folds: [C,1,1] or [1,C,1,1]
+            const std::size_t channels = W->shape()[0];
+            const auto& shape = C->shape();
+            bool per_channel = (shape.size() == 3 || (shape.size() == 4 && shape[0] == 1)) && C->size() == channels &&
+                               shape[shape.size() - 3] == channels;
+            if (!per_channel) continue;
+
+            const bool has_bias = conv_inputs.size() > 2 && !conv_inputs[2].empty();
+            if (has_bias)
+            {
+                if (!is_exclusive_initializer(graph, conv_inputs[2], *conv)) continue;
+                Tensor<float>* bias = graph.get_initializer(conv_inputs[2]);
+                if (bias->size() != channels) continue;
+                for (std::size_t c = 0; c < channels; ++c) bias->data()[c] += C->data()[c];
+            }
+            else
+            {
+                auto* bias = new Tensor<float>({channels});
+                std::copy(C->data(), C->data() + channels, bias->data());
+
+                std::string bias_name = conv->get_name() + "_bias";
+                graph.add_initializer(bias_name, bias);
+                if (conv_inputs.size() == 2)
+                    conv->add_inputs(bias_name);
+                else
+                    conv->set_input(2, bias_name);
+            }
+
+            std::string constant_name = constant;
+            conv->set_output(0, add->get_outputs()[0]);
+            graph.remove_node(add);
+            if (graph.get_consumers(constant_name).empty()) graph.remove_initializer(constant_name);
+
+            ++folded;
+            break;
+        }
+    }
+
+    return folded;
+}
+
+std::size_t GraphOptimizer::convert_to_nchwc(Graph& graph)
+{
+    const std::size_t block = kernels().nchwc_block;
+    std::size_t converted = 0;
+
+    std::unordered_map<std::string, std::string> blocked;     // NCHW tensor -> its NCHWc twin
+    std::unordered_map<std::string, std::size_t> channels;    // NCHW tensor -> channel count
+    std::vector<std::string> restored;                        // outputs of inserted ReorderOutput nodes
+
+    // blocked twin of a plain tensor, reordering it once if nothing produces one yet
+    auto to_blocked = [&](const std::string& name, std::size_t count)
+    {
+        auto it = blocked.find(name);
+        if (it != blocked.end()) return it->second;
+
+        std::string twin = name + "_nchwc";
+        graph.add_node(make_node("ReorderInput", twin + "_reorder", name, twin));
+        blocked[name] = twin;
+        channels[name] = count;
+        return twin;
+    };
+
+    // node now writes its blocked twin; a ReorderOutput keeps the plain name alive for
+    // consumers that stay NCHW and is dropped again below if there are none
+    auto publish = [&](Node& node, std::size_t count)
+    {
+        std::string plain = node.get_outputs()[0];
+        std::string twin = plain + "_nchwc";
+        node.set_output(0, twin);
+        graph.add_node(make_node("ReorderOutput", plain + "_reorder", twin, plain, "channels", static_cast<int64_t>(count)));
+
+        blocked[plain] = twin;
+        channels[plain] = count;
+        restored.push_back(plain);
+        ++converted;
+    };
+
+    std::vector<Node*> nodes = graph.topological_sort();
+    for (Node* node : nodes)
+    {
+        const std::string op = node->get_optype();
+        const auto& inputs = node->get_inputs();
+        if (node->get_outputs().size() != 1 || inputs.empty()) continue;
+
+        if (op == "Conv")
+        {
+            if (node->get_attribute<int64_t>("group").value_or(1) != 1 || inputs.size() < 2) continue;
+            if (!is_exclusive_initializer(graph, inputs[1], *node)) continue;
+
+            Tensor<float>* W = graph.get_initializer(inputs[1]);
+            if (W->shape().size() != 4) continue;
+
+            const std::size_t OC = W->shape()[0], IC = W->shape()[1];
+            const bool has_bias = inputs.size() > 2 && !inputs[2].empty();
+            if (has_bias && (!is_exclusive_initializer(graph, inputs[2], *node) || graph.get_initializer(inputs[2])->size() != OC)) continue;
+
+            // reorder weights and pad the bias to whole blocks
+            std::string w_name = inputs[1] + "_nchwc";
+            graph.add_initializer(w_name, block_conv_weights(*W, block));
+            graph.remove_initializer(inputs[1]);
+            node->set_input(1, w_name);
+
+            if (has_bias)
+            {
+                Tensor<float>* bias = graph.get_initializer(inputs[2]);
+                auto* padded = new Tensor<float>({(OC + block - 1) / block * block});
+                std::fill(padded->data(), padded->data() + padded->size(), 0.0f);
+                std::copy(bias->data(), bias->data() + OC, padded->data());
+
+                std::string b_name = inputs[2] + "_nchwc";
+                graph.add_initializer(b_name, padded);
+                graph.remove_initializer(inputs[2]);
+                node->set_input(2, b_name);
+            }
+
+            node->set_optype("NchwcConv");
+            node->set_input(0, to_blocked(inputs[0], IC));
+            publish(*node, OC);
+        }
+        else if ((op == "Relu" || op == "MaxPool" || op == "AveragePool" || op == "GlobalAveragePool") && blocked.count(inputs[0]))
+        {
+            // Relu runs unchanged on the blocked buffer (padding stays zero), pooling has blocked kernels
+            const std::size_t count = channels[inputs[0]];
+            node->set_input(0, blocked[inputs[0]]);
+            if (op != "Relu") node->set_optype("Nchwc" + op);
+            publish(*node, count);
+        }
+        else if (op == "Add" && inputs.size() == 2 && blocked.count(inputs[0]) && blocked.count(inputs[1]) &&
+                 channels[inputs[0]] == channels[inputs[1]])
+        {
+            // same layout on both sides, so the plain elementwise Add applies
+            const std::size_t count = channels[inputs[0]];
+            node->set_input(0, blocked[inputs[0]]);
+            node->set_input(1, blocked[inputs[1]]);
+            publish(*node, count);
+        }
+    }
+
+    // drop the reorders nobody ended up reading
+    for (const auto& plain : restored)
+    {
+        if (graph.get_consumers(plain).empty() && !graph.is_graph_output(plain))
+            graph.remove_node(graph.get_producer(plain));
+    }
+
+    graph.rebuild_edges();
+    return converted;
+}
+
+std::size_t GraphOptimizer::sparsify_weights(Graph& graph, double threshold)
+{
+    const std::size_t block = kernels().bsr_block;
+    std::size_t converted = 0;
+
+    for (Node* node : graph.topological_sort())
+    {
+        const std::string op = node->get_optype();
+        const auto& inputs = node->get_inputs();
+        if ((op != "Gemm" && op != "MatMul") || inputs.size() < 2 || node->get_outputs().size() != 1) continue;
+        if (op == "Gemm" && node->get_attribute<int64_t>("transA").value_or(0) != 0) continue;
+        if (!is_exclusive_initializer(graph, inputs[1], *node)) continue;
+
+        Tensor<float>* W = graph.get_initializer(inputs[1]);
+        if (!W || W->shape().size() != 2 || W->size() == 0) continue;
+
+        const double zeros = sparsity(W->data(), W->size());
+        if (zeros < threshold) continue;
+
+        const bool trans_b = op == "Gemm" && node->get_attribute<int64_t>("transB").value_or(0) != 0;
+        const std::size_t K = trans_b ? W->cols() : W->rows();
+        const std::size_t N = trans_b ? W->rows() : W->cols();
+        BsrWeights bsr = make_bsr(W->data(), K, N, trans_b, block);
+
+        double dense_ms, sparse_ms;
+        const bool faster = sparse_is_faster(*W, K, N, trans_b, bsr, dense_ms, sparse_ms);
+        INFERA_LOG_INFO("optimizer: %s is %d%% sparse, dense %.3f ms vs sparse %.3f ms, %s", node->get_name().c_str(),
+                        static_cast<int>(zeros * 100), dense_ms, sparse_ms, faster ? "using sparse" : "keeping dense");
+        if (!faster) continue;
+
+        // BSR arrays become initializers so the node stays a plain graph node
+        const std::string base = inputs[1] + "_bsr";
+        const std::size_t tiles = bsr.row_index.size();
+
+        Tensor<float> values({tiles, block});
+        std::copy(bsr.values.begin(), bsr.values.end(), values.data());
+        Tensor<int32_t> row_index({tiles});
+        std::copy(bsr.row_index.begin(), bsr.row_index.end(), row_index.data());
+        Tensor<int32_t> col_ptr({bsr.col_ptr.size()});
+        std::copy(bsr.col_ptr.begin(), bsr.col_ptr.end(), col_ptr.data());
+
+        graph.add_initializer(base + "_values", AnyTensor(std::move(values)));
+        graph.add_initializer(base + "_row_index", AnyTensor(std::move(row_index)));
+        graph.add_initializer(base + "_col_ptr", AnyTensor(std::move(col_ptr)));
+
+        onnx::NodeProto proto;
+        proto.set_op_type("SparseGemm");
+        proto.add_input(inputs[0]);
+        proto.add_input(base + "_values");
+        proto.add_input(base + "_row_index");
+        proto.add_input(base + "_col_ptr");
+        if (inputs.size() > 2) proto.add_input(inputs[2]);
+        proto.add_output(node->get_outputs()[0]);
+
+        auto add_float = [&](const char* name, float value)
+        {
+            auto* attr = proto.add_attribute();
+            attr->set_name(name);
+            attr->set_type(onnx::AttributeProto::FLOAT);
+            attr->set_f(value);
+        };
+        add_float("alpha", op == "Gemm" ? node->get_attribute<float>("alpha").value_or(1.0f) : 1.0f);
+        add_float("beta", op == "Gemm" ? node->get_attribute<float>("beta").value_or(1.0f) : 1.0f);
+        for (auto dim : {std::make_pair("rows", K), std::make_pair("cols", N)})
+        {
+            auto* attr = proto.add_attribute();
+            attr->set_name(dim.first);
+            attr->set_type(onnx::AttributeProto::INT);
+            attr->set_i(static_cast<int64_t>(dim.second));
+        }
+
+        std::string dense_name = inputs[1];
+        graph.replace_node(node, std::make_unique<Node>(proto));
+        graph.remove_initializer(dense_name);
+        ++converted;
+    }
+
+    return converted;
+}
+
+std::size_t GraphOptimizer::convert_weights_to_fp16(Graph& graph)
+{
+    std::size_t converted = 0;
+
+    for (Node* node : graph.topological_sort())
+    {
+        const std::string op = node->get_optype();
+        if (op != "Gemm" && op != "MatMul" && op != "Conv" && op != "NchwcConv") continue;
+
+        const auto& inputs = node->get_inputs();
+        if (inputs.size() < 2) continue;
+
+        // already converted initializers are no longer float32 and are skipped here
+        Tensor<float>* W = graph.get_initializer(inputs[1]);
+        if (!W || W->size() == 0) continue;
+
+        // values past the half range would turn into inf
+        float peak = 0.0f;
+        for (std::size_t i = 0; i < W->size(); ++i) peak = std::max(peak, std::fabs(W->data()[i]));
+        if (!(peak <= 65504.0f))
+        {
+            INFERA_LOG_WARN("keeping '%s' in float32, values exceed the float16 range", inputs[1].c_str());
+            continue;
+        }
+
+        AnyTensor half = AnyTensor(std::move(*W)).cast(DataType::Float16);
+        graph.add_initializer(inputs[1], std::move(half));
+        ++converted;
+    }
+
+    return converted;
+}
+
+// tensor is read by this node only and is not a graph output
+bool GraphOptimizer::is_exclusive_tensor(const Graph& graph, const std::string& name, const Node& consumer)
+{
+    std::vector<Node*> consumers = graph.get_consumers(name);
+    return consumers.size() == 1 && consumers[0] == &consumer && !graph.is_graph_output(name);
+}
+
+// per-channel scale a = gamma / sqrt(var + eps) and shift b = beta - mean * a
+bool GraphOptimizer::batch_norm_affine(const Graph& graph, const Node& bn, std::vector<float>& scale, std::vector<float>& shift)
+{
+    const auto& inputs = bn.get_inputs();
+    Tensor<float>* params[4];
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        params[i] = graph.get_initializer(inputs[i + 1]);
+        if (!params[i]) return false;                                 // runtime-computed parameters
+    }
+
+    const std::size_t channels = params[0]->size();
+    for (auto* p : params)
+    {
+        if (p->size() != channels) return false;
+    }
+
+    const float epsilon = bn.get_attribute<float>("epsilon").value_or(1e-5f);
+    scale.resize(channels);
+    shift.resize(channels);
+
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        scale[c] = params[0]->data()[c] / std::sqrt(params[3]->data()[c] + epsilon);
+        shift[c] = params[1]->data()[c] - params[2]->data()[c] * scale[c];
+    }
+    return true;
+}
+
+// initializer exists and is read by this node only, so it can be rewritten in place
+bool GraphOptimizer::is_exclusive_initializer(const Graph& graph, const std::string& name, const Node& consumer)
+{
+    if (!graph.has_initializer(name)) return false;
+
+    std::vector<Node*> consumers = graph.get_consumers(name);
+    return consumers.size() == 1 && consumers[0] == &consumer;
+}
+
+// W'[oc] = a[oc] * W[oc], bias'[oc] = a[oc] * bias[oc] + b[oc]
+bool GraphOptimizer::fold_into_conv(Graph& graph, Node& conv, const std::vector<float>& scale, const std::vector<float>& shift)
+{
+    const auto& inputs = conv.get_inputs();
+    const std::size_t channels = scale.size();
+
+    if (inputs.size() < 2 || !is_exclusive_initializer(graph, inputs[1], conv)) return false;
+
+    Tensor<float>* W = graph.get_initializer(inputs[1]);
+    if (W->shape().empty() || W->shape()[0] != channels) return false;
+
+    const bool has_bias = inputs.size() > 2 && !inputs[2].empty();
+    if (has_bias)
+    {
+        if (!is_exclusive_initializer(graph, inputs[2], conv)) return false;
+        if (graph.get_initializer(inputs[2])->size() != channels) return false;
+    }
+
+    // scale every output channel's filter
+    const std::size_t filter_size = W->size() / channels;
+    for (std::size_t oc = 0; oc < channels; ++oc)
+    {
+        float* filter = W->data() + oc * filter_size;
+        for (std::size_t i = 0; i < filter_size; ++i) filter[i] *= scale[oc];
+    }
+
+    // fold the shift into the (possibly new) bias
+    if (has_bias)
+    {
+        float* bias = graph.get_initializer(inputs[2])->data();
+        for (std::size_t oc = 0; oc < channels; ++oc) bias[oc] = bias[oc] * scale[oc] + shift[oc];
+    }
+    else
+    {
+        auto* bias = new Tensor<float>({channels});
+        std::copy(shift.begin(), shift.end(), bias->data());
+
+        std::string bias_name = conv.get_name() + "_bn_bias";
+        graph.add_initializer(bias_name, bias);
+        if (inputs.size() == 2)
+            conv.add_inputs(bias_name);
+        else
+            conv.set_input(2, bias_name);
+    }
+    return true;
+}
+
+// Y = alpha * A * B + beta * C, channel axis is N: scale column n of op(B) by a[n],
+// C'[., n] = a[n] * C[., n] + b[n] / beta
+bool GraphOptimizer::fold_into_gemm(Graph& graph, Node& gemm, const std::vector<float>& scale, const std::vector<float>& shift)
+{
+    const auto& inputs = gemm.get_inputs();
+    const std::size_t channels = scale.size();
+
+    const float beta = gemm.get_attribute<float>("beta").value_or(1.0f);
+    const bool trans_b = gemm.get_attribute<int64_t>("transB").value_or(0) != 0;
+    if (beta == 0.0f) return false;
+
+    if (inputs.size() < 2 || !is_exclusive_initializer(graph, inputs[1], gemm)) return false;
+
+    Tensor<float>* B = graph.get_initializer(inputs[1]);
+    if (B->shape().size() != 2) return false;
+
+    const std::size_t K = trans_b ? B->cols() : B->rows();
+    const std::size_t N = trans_b ? B->rows() : B->cols();
+    if (N != channels) return false;
+
+    // bias must be per-column (or a scalar we can widen) to absorb a per-channel shift
+    const bool has_bias = inputs.size() > 2 && !inputs[2].empty();
+    Tensor<float>* C = nullptr;
+    if (has_bias)
+    {
+        if (!is_exclusive_initializer(graph, inputs[2], gemm)) return false;
+        C = graph.get_initializer(inputs[2]);
+        if (C->size() != 1 && (C->shape().empty() || C->shape().back() != N)) return false;
+    }
+
+    // scale weights
+    float* b = B->data();
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        for (std::size_t n = 0; n < N; ++n)
+        {
+            std::size_t idx = trans_b ? (n * K + k) : (k * N + n);
+            b[idx] *= scale[n];
+        }
+    }
+
+    // fold the shift into the bias
+    if (C && C->size() != 1)
+    {
+        float* c = C->data();
+        for (std::size_t i = 0; i < C->size(); ++i)
+        {
+            std::size_t n = i % N;
+            c[i] = c[i] * scale[n] + shift[n] / beta;
+        }
+        return true;
+    }
+
+    // scalar or missing bias becomes a [N] vector
+    const float c0 = C ? C->data()[0] : 0.0f;
+    auto* bias = new Tensor<float>({N});
+    for (std::size_t n = 0; n < N; ++n) bias->data()[n] = c0 * scale[n] + shift[n] / beta;
+
+    std::string bias_name = gemm.get_name() + "_bn_bias";
+    graph.add_initializer(bias_name, bias);
+    if (inputs.size() == 2)
+    {
+        gemm.add_inputs(bias_name);
+    }
+    else
+    {
+        std::string old_bias = inputs[2];
+        gemm.set_input(2, bias_name);
+        if (!old_bias.empty()) graph.remove_initializer(old_bias);
+    }
+
+    return true;
+}
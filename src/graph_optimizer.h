@@ -0,0 +1,50 @@
+#ifndef GRAPH_OPTIMIZER_H
+#define GRAPH_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+#include "graph.h"
+
+// load-time graph rewrites, run once after parsing and before inference
+class GraphOptimizer
+{
+public:
+    // run every pass, returns the number of nodes removed
+    static std::size_t optimize(Graph& graph);
+
+    // fold inference-mode BatchNormalization into the weights and bias of the
+    // Conv or Gemm producing its input, removing the node and one full
+    // activation read/write. returns the number of nodes folded
+    static std::size_t fold_batch_norm(Graph& graph);
+
+    // fold Add of a constant per-channel tensor ([C,1,1] or [1,C,1,1]) into the
+    // bias of the Conv feeding it. returns the number of Add nodes removed
+    static std::size_t fold_conv_add(Graph& graph);
+
+    // rewrite Conv (group 1) and the Relu/Add/pooling nodes downstream of it to
+    // the blocked NCHWc layout. weights are reordered once here, ReorderInput /
+    // ReorderOutput nodes are inserted only where plain NCHW tensors meet blocked
+    // ones. returns the number of nodes converted
+    static std::size_t convert_to_nchwc(Graph& graph);
+
+    // replace Gemm/MatMul whose constant 2-D weights have at least `threshold`
+    // zeros with SparseGemm on block-sparse (BSR) weights, but only where a
+    // quick benchmark of both kernels at load time shows the sparse one is
+    // faster. returns the number of nodes converted
+    static std::size_t sparsify_weights(Graph& graph, double threshold);
+
+    // store the weight operand of Gemm, MatMul, Conv and NchwcConv as float16,
+    // halving weight memory; Gemm/MatMul widen it inside the GEMM packing, the
+    // convolutions widen it per call. not part of optimize(), opt-in only.
+    // returns the number of initializers converted
+    static std::size_t convert_weights_to_fp16(Graph& graph);
+
+private:
+    static bool batch_norm_affine(const Graph& graph, const Node& bn, std::vector<float>& scale, std::vector<float>& shift);
+    static bool fold_into_conv(Graph& graph, Node& conv, const std::vector<float>& scale, const std::vector<float>& shift);
+    static bool fold_into_gemm(Graph& graph, Node& gemm, const std::vector<float>& scale, const std::vector<float>& shift);
+    static bool is_exclusive_tensor(const Graph& graph, const std::string& name, const Node& consumer);
+    static bool is_exclusive_initializer(const Graph& graph, const std::string& name, const Node& consumer);
+};
+
+#endif
@@ -1,5 +1,8 @@
 #include "image_loader.h"
-#include <iostream>
+#include "logger.h"
+#include "thread_pool.h"
+#include "kernels/kernels.h"
+#include <memory>
 #include <vector>
 #include <stdexcept>
 
@@ -15,48 +18,102 @@
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "stb_image_resize.h"
 
-Tensor<float>* ImageLoader::load_image(const std::string& filepath, int target_w, int target_h) 
+#pragma GCC diagnostic pop
+
+namespace
 {
-    int width, height, channels;
-    
-    // load image
-    unsigned char* img_data = stbi_load(filepath.c_str(), &width, &height, &channels, 1);
 
-    if (!img_data) 
+// interleaved 8-bit pixels -> normalized floats in the requested layout
+void normalize(const unsigned char* pixels, std::size_t count, const PreprocessOptions& options, float* out)
+{
+    const std::size_t channels = options.channels;
+    float scale[4], bias[4];
+    for (std::size_t c = 0; c < channels; ++c)
     {
-        throw std::runtime_error("Failed to load image: " + filepath + " (" + stbi_failure_reason() + ")");
+        scale[c] = 1.0f / (255.0f * options.std[c]);
+        bias[c] = -options.mean[c] / options.std[c];
+    }
+
+    if (channels == 1 || options.layout == ImageLayout::NHWC)
+    {
+        kernels().u8_to_float(pixels, out, count * channels, channels, scale, bias);
+        return;
     }
 
-    unsigned char* process_img = img_data;
-    std::vector<unsigned char> resized_buffer;
-    int final_w {width};
-    int final_h {height};
+    // NCHW: split the channels into planes first, then convert each plane
+    thread_local std::vector<unsigned char> planes;
+    planes.resize(count * channels);
+    for (std::size_t p = 0; p < count; ++p)
+    {
+        for (std::size_t c = 0; c < channels; ++c) planes[c * count + p] = pixels[p * channels + c];
+    }
+    for (std::size_t c = 0; c < channels; ++c)
+        kernels().u8_to_float(planes.data() + c * count, out + c * count, count, 1, &scale[c], &bias[c]);
+}
+
+}
+
+Tensor<float>* ImageLoader::load_image(const std::string& filepath, int target_w, int target_h) 
+{
+    PreprocessOptions options;
+    options.width = target_w;
+    options.height = target_h;
 
-    // handle resizing
-    if (width != target_w || height != target_h)
+    // keep the file's size: read it from the header
+    if (target_w <= 0 || target_h <= 0)
     {
-        std::cout << "Resizing image: " << width << "x" << height << " -> " << target_w << "x" << target_h << "\n";
-        
-        resized_buffer.resize(target_w * target_h);
-        stbir_resize_uint8(img_data, width, height, 0,  resized_buffer.data(), target_w, target_h, 0, 1);
-        
-        process_img = resized_buffer.data();
-        final_w = target_w;
-        final_h = target_h;
+        int channels;
+        if (!stbi_info(filepath.c_str(), &options.width, &options.height, &channels))
+            throw std::runtime_error("Failed to load image: " + filepath + " (" + stbi_failure_reason() + ")");
     }
 
-    // create tensor
-    auto* tensor = new Tensor<float>({1, 1, (size_t)final_h, (size_t)final_w});
-    float* tensor_data = tensor->data();
+    auto tensor = std::make_unique<Tensor<float>>(std::vector<std::size_t>{1, 1, (size_t)options.height, (size_t)options.width});
+    load_into(filepath, options, tensor->data());
+    return tensor.release();
+}
+
+void ImageLoader::load_into(const std::string& filepath, const PreprocessOptions& options, float* out)
+{
+    if (options.channels < 1 || options.channels > 4) throw std::runtime_error("Image preprocessing: channels must be 1 to 4.");
+    if (options.width <= 0 || options.height <= 0) throw std::runtime_error("Image preprocessing: target size must be positive.");
 
-    // normalize
-    int total_pixels = final_w * final_h;
-    for (int i = 0; i < total_pixels; ++i) 
+    // decode, forcing the requested channel count
+    int width, height, file_channels;
+    unsigned char* img_data = stbi_load(filepath.c_str(), &width, &height, &file_channels, options.channels);
+    if (!img_data) 
     {
-        tensor_data[i] = static_cast<float>(process_img[i]) / 255.0f;
+        throw std::runtime_error("Failed to load image: " + filepath + " (" + stbi_failure_reason() + ")");
     }
+    std::unique_ptr<unsigned char, void (*)(void*)> decoded(img_data, stbi_image_free);
+
+    // handle resizing, into a buffer each thread keeps between images
+    const unsigned char* pixels = img_data;
+    thread_local std::vector<unsigned char> resized_buffer;
+    if (width != options.width || height != options.height)
+    {
+        INFERA_LOG_DEBUG("resizing image %dx%d -> %dx%d", width, height, options.width, options.height);
 
-    stbi_image_free(img_data);
-    
-    return tensor;
+        resized_buffer.resize(static_cast<std::size_t>(options.width) * options.height * options.channels);
+        stbir_resize_uint8(img_data, width, height, 0, resized_buffer.data(), options.width, options.height, 0, options.channels);
+        pixels = resized_buffer.data();
+    }
+
+    normalize(pixels, static_cast<std::size_t>(options.width) * options.height, options, out);
+}
+
+void ImageLoader::load_batch(const std::vector<std::string>& paths, const PreprocessOptions& options, Tensor<float>& batch)
+{
+    const std::size_t n = paths.size(), h = options.height, w = options.width, c = options.channels;
+    if (options.layout == ImageLayout::NCHW)
+        batch.resize({n, c, h, w});
+    else
+        batch.resize({n, h, w, c});
+
+    // one image per work item, decoded by whichever thread claims it
+    const std::size_t image_size = c * h * w;
+    float* data = batch.data();
+    ThreadPool::instance().parallel_for(n, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i) load_into(paths[i], options, data + i * image_size);
+    });
 }
@@ -5,10 +5,39 @@
 #include <vector>
 #include "tensor.h"
 
-class ImageLoader 
+// memory order of a preprocessed image's channels
+enum class ImageLayout
+{
+    NCHW,                                                   // one plane per channel
+    NHWC                                                    // channels interleaved per pixel
+};
+
+// how a decoded image becomes model input: resized to width x height, scaled to
+// [0, 1], then (x - mean[c]) / std[c] per channel
+struct PreprocessOptions
+{
+    int width = 0;
+    int height = 0;
+    int channels = 1;                                       // 1 gray, 3 RGB, 4 RGBA
+    ImageLayout layout = ImageLayout::NCHW;
+    float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float std[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+class ImageLoader
 {
 public:
+    // one grayscale image as [1, 1, H, W]; a target size of 0 keeps the file's size
     static Tensor<float>* load_image(const std::string& filepath, int target_w = 0, int target_h = 0);
+
+    // decode, resize and normalize one image into `out`, which holds
+    // channels * height * width floats in the requested layout
+    static void load_into(const std::string& filepath, const PreprocessOptions& options, float* out);
+
+    // decode `paths` in parallel on the compute pool, each straight into its slice of
+    // `batch`. the batch becomes [N, C, H, W] or [N, H, W, C]; its buffer is reused
+    // when it already has that size
+    static void load_batch(const std::vector<std::string>& paths, const PreprocessOptions& options, Tensor<float>& batch);
 };
 
 #endif
@@ -1,10 +1,118 @@
 #include "inference_engine.h"
 #include "operator_registry.h" 
-#include <iostream>
+#include "logger.h"
+#include <chrono>
 #include <stdexcept>
 
-std::vector<Tensor<float>*> InferenceEngine::run(Graph& graph, const std::vector<Tensor<float>*>& inputs) 
+std::vector<Tensor<float>*> InferenceEngine::run(Graph& graph, const std::vector<Tensor<float>*>& inputs)
 {
+    // wrap caller tensors without copying
+    input_views_.clear();
+    std::vector<AnyTensor*> any_inputs;
+    for (Tensor<float>* input : inputs)
+    {
+        Tensor<float> view;
+        view.view(input->data(), input->shape());
+        input_views_.push_back(std::make_unique<AnyTensor>(std::move(view)));
+        any_inputs.push_back(input_views_.back().get());
+    }
+
+    std::vector<Tensor<float>*> results;
+    for (AnyTensor* output : run(graph, any_inputs))
+    {
+        if (!output->is<float>())
+        {
+            tensor_arena_.push_back(std::make_unique<AnyTensor>(output->cast(DataType::Float32)));
+            output = tensor_arena_.back().get();
+        }
+        results.push_back(&output->get<float>());
+    }
+    return results;
+}
+
+std::vector<AnyTensor> InferenceEngine::run_owned(Graph& graph, const std::vector<AnyTensor*>& inputs)
+{
+    std::vector<AnyTensor*> outputs = run(graph, inputs);
+
+    std::vector<AnyTensor> owned;
+    owned.reserve(outputs.size());
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        // a tensor listed twice as an output was already taken
+        std::size_t earlier = 0;
+        while (earlier < i && outputs[earlier] != outputs[i]) ++earlier;
+        if (earlier < i)
+        {
+            owned.push_back(owned[earlier]);
+            continue;
+        }
+
+        // the arena is rebuilt every run, so its tensors can be taken
+        bool ours = false;
+        if (!outputs[i]->is_view())
+            for (const auto& tensor : tensor_arena_) ours = ours || tensor.get() == outputs[i];
+
+        if (ours)
+            owned.push_back(std::move(*outputs[i]));
+        else
+            owned.push_back(*outputs[i]);
+    }
+    return owned;
+}
+
+void InferenceEngine::bind_metrics(const Graph& graph)
+{
+    const std::string model = graph.get_name().empty() ? "unnamed" : graph.get_name();
+    if (requests_ && model == metrics_model_) return;
+
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    metrics_model_ = model;
+    requests_ = &registry.counter("infera_inference_requests_total", "Inference runs started", {{"model", model}});
+    failures_ = &registry.counter("infera_inference_errors_total", "Inference runs that threw", {{"model", model}});
+    compute_seconds_.clear();
+}
+
+Histogram& InferenceEngine::compute_histogram(std::size_t batch_size)
+{
+    auto it = compute_seconds_.find(batch_size);
+    if (it != compute_seconds_.end()) return *it->second;
+
+    Histogram& histogram = MetricsRegistry::instance().histogram("infera_inference_compute_seconds", "Graph execution time per run",
+                                                                 {{"model", metrics_model_}, {"batch_size", std::to_string(batch_size)}});
+    compute_seconds_[batch_size] = &histogram;
+    return histogram;
+}
+
+std::vector<AnyTensor*> InferenceEngine::run(Graph& graph, const std::vector<AnyTensor*>& inputs)
+{
+    if (!record_metrics_) return execute(graph, inputs);
+
+    bind_metrics(graph);
+    requests_->inc();
+
+    // leading dim of the first input, 1 for scalars or missing inputs
+    std::size_t batch_size = 1;
+    if (!inputs.empty() && inputs[0] && !inputs[0]->shape().empty()) batch_size = inputs[0]->shape()[0];
+
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+        std::vector<AnyTensor*> results = execute(graph, inputs);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        compute_histogram(batch_size).record(static_cast<uint64_t>(elapsed.count()));
+        return results;
+    }
+    catch (...)
+    {
+        failures_->inc();
+        throw;
+    }
+}
+
+std::vector<AnyTensor*> InferenceEngine::execute(Graph& graph, const std::vector<AnyTensor*>& inputs) 
+{
+    const Profiler::Mark run_start = profiler_ ? profiler_->mark() : Profiler::Mark{};
+
     // reset state
     symbol_table_.clear();
     tensor_arena_.clear();
@@ -33,25 +141,28 @@ std::vector<Tensor<float>*> InferenceEngine::run(Graph& graph, const std::vector
             // if the graph owns this tensor, pull it in
             if (graph.has_initializer(input_name)) 
             {
-                symbol_table_[input_name] = graph.get_initializer(input_name);
+                symbol_table_[input_name] = graph.get_any_initializer(input_name);
             }
         }
     }
 
-    std::cout << "starting inference engine...\n";
+    INFERA_LOG_DEBUG("starting inference, %zu nodes", sorted_nodes.size());
 
     // execution loop
     for (Node* node : sorted_nodes) 
     {
+        // expired or abandoned work stops at the next node boundary
+        if (control_ && control_->should_stop()) control_->check("before node " + node->get_name());
+
         std::string op_type = node->get_optype(); 
-        std::cout << "Running Node: " << node->get_name() << " [" << op_type << "]" << std::endl;
+        INFERA_LOG_DEBUG("running node %s [%s]", node->get_name().c_str(), op_type.c_str());
 
         // create the operator from the registry
         auto op = OperatorRegistry::create_operator(op_type);
 
         if (!op)  
         {
-            std::cerr << " [warning] no implementation for operator: " << op_type << " (skipping)\n";
+            INFERA_LOG_WARN_ONCE("skip:" + op_type, "no implementation for operator %s, skipping its nodes", op_type.c_str());
             continue;
         }
 
@@ -59,9 +170,15 @@ std::vector<Tensor<float>*> InferenceEngine::run(Graph& graph, const std::vector
 
         // collect input tensors for this operator
 
-        std::vector<Tensor<float>*> op_inputs;
+        std::vector<AnyTensor*> op_inputs;
         for (const auto& name : node->get_inputs()) 
         {
+            // empty name marks an omitted optional input
+            if (name.empty())
+            {
+                op_inputs.push_back(nullptr);
+                continue;
+            }
             if (symbol_table_.find(name) == symbol_table_.end()) 
             {
                 throw std::runtime_error("runtime error: missing dependency '" + name + "' for node " + node->get_name());
@@ -70,23 +187,25 @@ std::vector<Tensor<float>*> InferenceEngine::run(Graph& graph, const std::vector
         }
 
         // allocate output tensors and register them
-        std::vector<Tensor<float>*> op_outputs;
+        std::vector<AnyTensor*> op_outputs;
 
         for (const auto& name : node->get_outputs()) 
         {
-            auto new_tensor = std::make_unique<Tensor<float>>(std::vector<std::size_t>{});
-            Tensor<float>* ptr = new_tensor.get();
+            auto new_tensor = std::make_unique<AnyTensor>();
+            AnyTensor* ptr = new_tensor.get();
 
             tensor_arena_.push_back(std::move(new_tensor));
             symbol_table_[name] = ptr;
             op_outputs.push_back(ptr);
         }
 
-        op->forward(op_inputs, op_outputs);
+        const Profiler::Mark start = profiler_ ? profiler_->mark() : Profiler::Mark{};
+        op->run(op_inputs, op_outputs);
+        if (profiler_) profiler_->record_node(*node, op_inputs, op_outputs, start);
     }
 
     // collect final graph outputs 
-    std::vector<Tensor<float>*> final_results;
+    std::vector<AnyTensor*> final_results;
 
     // loop by index since output names are index-based
     for (std::size_t i {}; i < graph.get_output_size(); ++i) 
@@ -103,5 +222,7 @@ std::vector<Tensor<float>*> InferenceEngine::run(Graph& graph, const std::vector
         }
     }
 
+    if (profiler_) profiler_->record_interval("run", run_start);
+
     return final_results;
 }
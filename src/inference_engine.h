@@ -7,16 +7,53 @@
 #include <memory>
 #include "graph.h"
 #include "tensor.h"
+#include "any_tensor.h"
 #include "operator_registry.h" 
+#include "profiler.h"
+#include "metrics.h"
+#include "run_control.h"
 
 class InferenceEngine
 {
 public:
     InferenceEngine() = default;
+
+    // inputs and outputs of any dtype. results stay valid until the next run()
+    std::vector<AnyTensor*> run(Graph& graph, const std::vector<AnyTensor*>& inputs);
+
+    // same, but the caller owns the results: buffers the engine allocated for them
+    // are moved out, outputs that alias inputs or weights are copied
+    std::vector<AnyTensor> run_owned(Graph& graph, const std::vector<AnyTensor*>& inputs);
+
+    // float32 convenience wrapper: inputs are aliased, not copied, and outputs of
+    // other dtypes are converted to float32
     std::vector<Tensor<float>*> run(Graph& graph, const std::vector<Tensor<float>*>& inputs);
+
+    // record per-node events into `profiler` (not owned), nullptr turns profiling off
+    void set_profiler(Profiler* profiler) { profiler_ = profiler; }
+
+    // deadline and cancellation checked between nodes (not owned), nullptr for none
+    void set_run_control(const RunControl* control) { control_ = control; }
+
+    // count runs in the metrics registry (on by default, off for warm-up runs)
+    void set_record_metrics(bool record) { record_metrics_ = record; }
 private:
-    std::unordered_map<std::string, Tensor<float>*> symbol_table_;  // map "tensor_name" -> ptr to Tensor data
-    std::vector<std::unique_ptr<Tensor<float>>> tensor_arena_;      // own the intermediate tensors created during inference.
+    std::vector<AnyTensor*> execute(Graph& graph, const std::vector<AnyTensor*>& inputs);
+    void bind_metrics(const Graph& graph);
+    Histogram& compute_histogram(std::size_t batch_size);
+
+    // metrics of the graph last run, looked up once per model and batch size
+    std::string metrics_model_;
+    Counter* requests_ = nullptr;
+    Counter* failures_ = nullptr;
+    std::unordered_map<std::size_t, Histogram*> compute_seconds_;
+
+    Profiler* profiler_ = nullptr;
+    const RunControl* control_ = nullptr;
+    bool record_metrics_ = true;
+    std::unordered_map<std::string, AnyTensor*> symbol_table_;      // map "tensor_name" -> ptr to Tensor data
+    std::vector<std::unique_ptr<AnyTensor>> tensor_arena_;          // own the intermediate tensors created during inference.
+    std::vector<std::unique_ptr<AnyTensor>> input_views_;           // float32 inputs wrapped for the typed run()
 };
 
 #endif
@@ -0,0 +1,75 @@
+#include "kernels.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+// table for a variant regardless of host support, nullptr if not compiled in
+const KernelTable* compiled_table(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::Scalar:
+        return &scalar_kernels();
+#if defined(__x86_64__) || defined(__i386__)
+    case Isa::Sse42:
+        return &sse42_kernels();
+    case Isa::Avx2:
+        return &avx2_kernels();
+    case Isa::Avx512:
+        return &avx512_kernels();
+#else
+    default:
+        break;
+#endif
+    }
+    return nullptr;
+}
+
+const KernelTable& select_kernels()
+{
+    Isa isa = best_supported_isa();
+
+    // INFERA_ISA=scalar|sse42|avx2|avx512 forces a variant (auto or unset = best)
+    const char* forced = std::getenv("INFERA_ISA");
+    if (forced && *forced && std::string(forced) != "auto")
+    {
+        Isa requested;
+        if (!parse_isa(forced, requested))
+        {
+            std::cerr << "Warning: unknown INFERA_ISA '" << forced << "', using " << isa_name(isa) << "\n";
+        }
+        else if (!isa_supported(requested) || !compiled_table(requested))
+        {
+            std::cerr << "Warning: INFERA_ISA '" << forced << "' not supported on this host, using " << isa_name(isa) << "\n";
+        }
+        else
+        {
+            isa = requested;
+        }
+    }
+
+    // fall back towards scalar if the best variant was not compiled in
+    const KernelTable* table = compiled_table(isa);
+    while (!table)
+    {
+        isa = static_cast<Isa>(static_cast<int>(isa) - 1);
+        table = compiled_table(isa);
+    }
+    return *table;
+}
+
+}
+
+const KernelTable& kernels()
+{
+    static const KernelTable& table = select_kernels();
+    return table;
+}
+
+const KernelTable* kernels_for(Isa isa)
+{
+    return isa_supported(isa) ? compiled_table(isa) : nullptr;
+}
@@ -0,0 +1,136 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../cpu_features.h"
+
+// NCHWc blocked activation layout: [N, ceil(C / B), H, W, B] where B is the
+// table's nchwc_block (8, or 16 with AVX-512). padding channels are zero
+
+// one output row of one output channel block of a direct convolution
+struct NchwcConvArgs
+{
+    const float* input;         // one image, [in_blocks, in_h, in_w, B]
+    const float* weights;       // one output block, [in_blocks, kernel_h, kernel_w, B in, B out]
+    const float* bias;          // B values, or nullptr
+    float* output;              // [out_w, B]
+    std::size_t in_blocks, in_h, in_w;
+    std::size_t kernel_h, kernel_w, stride_h, stride_w, dilation_h, dilation_w;
+    std::size_t pad_top, pad_left;
+    std::size_t out_row, out_w;
+};
+
+// one output row of one channel block of a pooling window
+struct NchwcPoolArgs
+{
+    const float* input;         // [in_h, in_w, B]
+    float* output;              // [out_w, B]
+    std::size_t in_h, in_w;
+    std::size_t kernel_h, kernel_w, stride_h, stride_w, dilation_h, dilation_w;
+    std::size_t pad_top, pad_left;
+    std::size_t out_row, out_w;
+    bool count_include_pad;     // average pooling only
+};
+
+// block-sparse K x N weight matrix with 1 x block tiles, grouped by column
+// block: column block cb (columns cb * block ..) keeps only its nonzero rows,
+// tiles col_ptr[cb] .. col_ptr[cb + 1], each holding row row_index[t] and
+// `block` values (zero padded past N)
+struct BsrMatrix
+{
+    const float* values;        // [tiles, block]
+    const int32_t* row_index;   // [tiles]
+    const int32_t* col_ptr;     // [ceil(cols / block) + 1]
+    std::size_t rows, cols, block;
+};
+
+// table of compute kernels for one instruction set variant. every variant is
+// compiled into the binary with its own -m flags and the best one the host
+// supports is picked once at startup (override with INFERA_ISA=<name>)
+struct KernelTable
+{
+    Isa isa;
+    const char* name;
+
+    // C = alpha * op(A) * op(B) + beta * C, row-major, op(A) is MxK, op(B) is KxN
+    void (*sgemm)(bool trans_a, bool trans_b, std::size_t M, std::size_t N, std::size_t K,
+                  float alpha, const float* A, std::size_t lda, const float* B, std::size_t ldb,
+                  float beta, float* C, std::size_t ldc);
+
+    // same, with B stored as IEEE half bits and widened to float while it is packed
+    // or streamed (vcvtph2ps on F16C hosts, bit manipulation elsewhere)
+    void (*sgemm_f16)(bool trans_a, bool trans_b, std::size_t M, std::size_t N, std::size_t K,
+                      float alpha, const float* A, std::size_t lda, const uint16_t* B, std::size_t ldb,
+                      float beta, float* C, std::size_t ldc);
+
+    // C += alpha * A * B for row-major A (M x K) and block-sparse B (K x N). each
+    // output tile accumulates in registers, vectorized along N. B.block must
+    // equal bsr_block
+    std::size_t bsr_block;
+    void (*bsr_gemm)(std::size_t M, float alpha, const float* A, std::size_t lda, const BsrMatrix& B, float* C, std::size_t ldc);
+
+    // conversion: y[i] = float(x[i]) for IEEE half bits
+    void (*half_to_float)(const uint16_t* x, float* y, std::size_t n);
+
+    // y[i] = x[i] * scale[c] + bias[c] with c = i % channels, for interleaved 8-bit
+    // pixels (channels <= 4) converted to normalized floats
+    void (*u8_to_float)(const uint8_t* x, float* y, std::size_t n, std::size_t channels, const float* scale, const float* bias);
+
+    // elementwise
+    void (*add)(const float* a, const float* b, float* y, std::size_t n);
+    void (*add_scalar)(const float* a, float b, float* y, std::size_t n);
+    void (*relu)(const float* x, float* y, std::size_t n);
+    void (*scale_shift)(const float* x, float scale, float shift, float* y, std::size_t n);   // y = scale * x + shift
+
+    // layout: dst[j * ldd + i] = src[i * lds + j] for a rows x cols source matrix
+    void (*transpose)(const float* src, std::size_t rows, std::size_t cols, std::size_t lds, float* dst, std::size_t ldd);
+
+    // NCHWc convolution and pooling
+    std::size_t nchwc_block;
+    void (*nchwc_conv)(const NchwcConvArgs& args);
+    void (*nchwc_max_pool)(const NchwcPoolArgs& args);
+    void (*nchwc_avg_pool)(const NchwcPoolArgs& args);
+
+    // activations, polynomial approximations (error bounds in kernels_impl.h)
+    void (*exp)(const float* x, float* y, std::size_t n);
+    void (*sigmoid)(const float* x, float* y, std::size_t n);
+    void (*tanh)(const float* x, float* y, std::size_t n);
+    void (*silu)(const float* x, float* y, std::size_t n);          // x * sigmoid(x)
+    void (*gelu)(const float* x, float* y, std::size_t n);          // erf form
+    void (*gelu_tanh)(const float* x, float* y, std::size_t n);     // tanh approximation
+
+    // normalize one contiguous row of n values
+    void (*softmax)(const float* x, float* y, std::size_t n);
+    void (*log_softmax)(const float* x, float* y, std::size_t n);
+
+    // 128-bit non-cryptographic hash of a byte buffer into out[0..1]. every variant
+    // computes the same value, the vector ones just run the lanes in parallel
+    void (*hash128)(const void* data, std::size_t bytes, uint64_t seed, uint64_t* out);
+};
+
+const KernelTable& kernels();                       // active table, selected on first use
+
+// sgemm on the active table, choosing the variant from B's storage
+inline void sgemm_any(bool trans_a, bool trans_b, std::size_t M, std::size_t N, std::size_t K, float alpha, const float* A, std::size_t lda,
+                      const float* B, std::size_t ldb, float beta, float* C, std::size_t ldc)
+{
+    kernels().sgemm(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+inline void sgemm_any(bool trans_a, bool trans_b, std::size_t M, std::size_t N, std::size_t K, float alpha, const float* A, std::size_t lda,
+                      const uint16_t* B, std::size_t ldb, float beta, float* C, std::size_t ldc)
+{
+    kernels().sgemm_f16(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+const KernelTable* kernels_for(Isa isa);            // nullptr if not compiled in or not supported by this host
+
+// per-variant tables, defined in kernels_<isa>.cpp
+const KernelTable& scalar_kernels();
+#if defined(__x86_64__) || defined(__i386__)
+const KernelTable& sse42_kernels();
+const KernelTable& avx2_kernels();
+const KernelTable& avx512_kernels();
+#endif
+
+#endif
@@ -0,0 +1,127 @@
+// built with -mavx2 -mfma -mf16c
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+#include "kernels_impl.h"
+
+namespace
+{
+
+struct VecAvx2
+{
+    using reg = __m256;
+    static constexpr std::size_t width   = 8;
+    static constexpr std::size_t mr      = 6;
+    static constexpr std::size_t nr_vecs = 2;
+
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg set1(float v) { return _mm256_set1_ps(v); }
+    static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static reg load_half(const uint16_t* p) { return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+    static reg load_u8(const uint8_t* p) { return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)))); }
+    static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static reg abs(reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+    static reg round(reg a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    static reg copysign(reg mag, reg sign)
+    {
+        const __m256 mask = _mm256_set1_ps(-0.0f);
+        return _mm256_or_ps(_mm256_andnot_ps(mask, mag), _mm256_and_ps(mask, sign));
+    }
+
+    static reg exp2i(reg n)
+    {
+        __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+    }
+
+    static float reduce_add(reg v)
+    {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        s = _mm_hadd_ps(s, s);
+        s = _mm_hadd_ps(s, s);
+        return _mm_cvtss_f32(s);
+    }
+
+    static float reduce_max(reg v)
+    {
+        __m128 s = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_max_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+    }
+
+    // 8x8: interleave pairs, then quads within 128-bit lanes, then swap lanes
+    static void transpose_block(const float* src, std::size_t lds, float* dst, std::size_t ldd)
+    {
+        __m256 r[8], t[8];
+        for (int i = 0; i < 8; ++i) r[i] = _mm256_loadu_ps(src + i * lds);
+
+        for (int i = 0; i < 8; i += 2)
+        {
+            t[i]     = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        for (int i = 0; i < 8; i += 4)
+        {
+            r[i]     = _mm256_shuffle_ps(t[i], t[i + 2], 0x44);
+            r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], 0xEE);
+            r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+            r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            _mm256_storeu_ps(dst + i * ldd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+            _mm256_storeu_ps(dst + (i + 4) * ldd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+        }
+    }
+
+    // four lanes per register
+    static void hash_accumulate(uint64_t* acc, const unsigned char* p, const uint64_t* keys, std::size_t stripes)
+    {
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + 4));
+        for (std::size_t s = 0; s < stripes; ++s, p += 64)
+        {
+            __m256i d0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+            __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + s)));
+            __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + s + 4)));
+            a0 = _mm256_add_epi64(a0, _mm256_add_epi64(_mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32)), _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+            a1 = _mm256_add_epi64(a1, _mm256_add_epi64(_mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32)), _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), a0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4), a1);
+    }
+
+    static void hash_scramble(uint64_t* acc, const uint64_t* keys)
+    {
+        const __m256i prime = _mm256_set1_epi64x(0x9E3779B1);
+        for (int r = 0; r < 2; ++r)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + 4 * r));
+            a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+            a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 4 * r)));
+            __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+            a = _mm256_add_epi64(_mm256_mul_epu32(a, prime), _mm256_slli_epi64(high, 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4 * r), a);
+        }
+    }
+};
+
+}
+
+const KernelTable& avx2_kernels()
+{
+    static const KernelTable table = make_kernel_table<VecAvx2>(Isa::Avx2);
+    return table;
+}
+
+#endif
@@ -0,0 +1,123 @@
+// built with -mavx512f -mavx512bw -mavx512dq -mavx512vl -mavx2 -mfma -mf16c
+#if defined(__x86_64__) || defined(__i386__)
+
+// GCC 12 reports the deliberately undefined vectors inside its own AVX-512 headers
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#include "kernels_impl.h"
+
+namespace
+{
+
+struct VecAvx512
+{
+    using reg = __m512;
+    static constexpr std::size_t width   = 16;
+    static constexpr std::size_t mr      = 8;
+    static constexpr std::size_t nr_vecs = 2;
+
+    static reg zero() { return _mm512_setzero_ps(); }
+    static reg set1(float v) { return _mm512_set1_ps(v); }
+    static reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static reg load_half(const uint16_t* p) { return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); }
+    static reg load_u8(const uint8_t* p) { return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))); }
+    static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+    static reg abs(reg a) { return _mm512_abs_ps(a); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static reg round(reg a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    static reg copysign(reg mag, reg sign)
+    {
+        const __m512 mask = _mm512_set1_ps(-0.0f);
+        return _mm512_or_ps(_mm512_andnot_ps(mask, mag), _mm512_and_ps(mask, sign));
+    }
+
+    static reg exp2i(reg n)
+    {
+        __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+    }
+
+    static float reduce_add(reg v) { return _mm512_reduce_add_ps(v); }
+    static float reduce_max(reg v) { return _mm512_reduce_max_ps(v); }
+
+    // 16x16: pairs and quads within 128-bit lanes as for AVX2, then two rounds of
+    // 128-bit lane shuffles across register pairs
+    static void transpose_block(const float* src, std::size_t lds, float* dst, std::size_t ldd)
+    {
+        __m512 r[16], t[16];
+        for (int i = 0; i < 16; ++i) r[i] = _mm512_loadu_ps(src + i * lds);
+
+        for (int i = 0; i < 16; i += 2)
+        {
+            t[i]     = _mm512_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm512_unpackhi_ps(r[i], r[i + 1]);
+        }
+        for (int i = 0; i < 16; i += 4)
+        {
+            r[i]     = _mm512_shuffle_ps(t[i], t[i + 2], 0x44);
+            r[i + 1] = _mm512_shuffle_ps(t[i], t[i + 2], 0xEE);
+            r[i + 2] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+            r[i + 3] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+        }
+        for (int i = 0; i < 16; i += 8)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                t[i + k]     = _mm512_shuffle_f32x4(r[i + k], r[i + k + 4], 0x88);
+                t[i + k + 4] = _mm512_shuffle_f32x4(r[i + k], r[i + k + 4], 0xDD);
+            }
+        }
+        for (int k = 0; k < 8; ++k)
+        {
+            _mm512_storeu_ps(dst + k * ldd, _mm512_shuffle_f32x4(t[k], t[k + 8], 0x88));
+            _mm512_storeu_ps(dst + (k + 8) * ldd, _mm512_shuffle_f32x4(t[k], t[k + 8], 0xDD));
+        }
+    }
+
+    // all eight lanes in one register
+    static void hash_accumulate(uint64_t* acc, const unsigned char* p, const uint64_t* keys, std::size_t stripes)
+    {
+        __m512i a = _mm512_loadu_si512(acc);
+        for (std::size_t s = 0; s < stripes; ++s, p += 64)
+        {
+            __m512i d = _mm512_loadu_si512(p);
+            __m512i k = _mm512_xor_si512(d, _mm512_loadu_si512(keys + s));
+            a = _mm512_add_epi64(a, _mm512_add_epi64(_mm512_mul_epu32(k, _mm512_srli_epi64(k, 32)), _mm512_shuffle_epi32(d, _MM_PERM_BADC)));
+        }
+        _mm512_storeu_si512(acc, a);
+    }
+
+    static void hash_scramble(uint64_t* acc, const uint64_t* keys)
+    {
+        const __m512i prime = _mm512_set1_epi64(0x9E3779B1);
+        __m512i a = _mm512_loadu_si512(acc);
+        a = _mm512_xor_si512(a, _mm512_srli_epi64(a, 47));
+        a = _mm512_xor_si512(a, _mm512_loadu_si512(keys));
+        __m512i high = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), prime);
+        _mm512_storeu_si512(acc, _mm512_add_epi64(_mm512_mul_epu32(a, prime), _mm512_slli_epi64(high, 32)));
+    }
+};
+
+}
+
+const KernelTable& avx512_kernels()
+{
+    static const KernelTable table = make_kernel_table<VecAvx512>(Isa::Avx512);
+    return table;
+}
+
+#endif
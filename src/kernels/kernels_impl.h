@@ -0,0 +1,1124 @@
+#ifndef KERNELS_IMPL_H
+#define KERNELS_IMPL_H
+
+// generic kernel bodies, written once against a small vector traits interface
+// and instantiated by every kernels_<isa>.cpp with that ISA's traits:
+//
+//   struct V {
+//       using reg = ...;                            // vector register type
+//       static constexpr std::size_t width;         // floats per register
+//       static constexpr std::size_t mr, nr_vecs;   // GEMM micro-tile: mr rows x (nr_vecs * width) cols
+//       static reg zero(); static reg set1(float);
+//       static reg load(const float*); static void store(float*, reg);
+//       static reg load_half(const uint16_t*);      // width IEEE half values widened to float
+//       static reg add(reg, reg); static reg sub(reg, reg); static reg mul(reg, reg); static reg div(reg, reg);
+//       static reg min(reg, reg); static reg max(reg, reg); static reg abs(reg);
+//       static reg fmadd(reg a, reg b, reg c);      // a * b + c
+//       static reg round(reg);                      // to nearest integer
+//       static reg exp2i(reg n);                    // 2^n for integral n in [-126, 127]
+//       static reg copysign(reg mag, reg sign);     // |mag| with the sign of sign
+//       static float reduce_add(reg); static float reduce_max(reg);
+//       static void transpose_block(const float* src, size_t lds, float* dst, size_t ldd);   // width x width tile
+//   };
+//
+// everything lives in an anonymous namespace and no STL templates are used,
+// so each ISA translation unit gets private copies and no code built with
+// wider -m flags can be picked by the linker for a caller in another unit
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include "kernels.h"
+
+namespace
+{
+
+using std::size_t;
+
+inline size_t min_size(size_t a, size_t b) { return a < b ? a : b; }
+inline size_t round_up(size_t v, size_t m) { return (v + m - 1) / m * m; }
+
+// IEEE binary16 -> binary32 without F16C, exact (subnormals renormalized)
+inline float half_bits_to_float(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f)
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    else if (exponent != 0)
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    else if (mantissa == 0)
+        bits = sign;
+    else
+    {
+        exponent = 113;
+        while (!(mantissa & 0x400))
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+
+    float f;
+    __builtin_memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// element loads for GEMM operands stored as float or half bits
+inline float load_scalar(const float* p) { return *p; }
+inline float load_scalar(const uint16_t* p) { return half_bits_to_float(*p); }
+
+template <class V> typename V::reg load_vector(const float* p) { return V::load(p); }
+template <class V> typename V::reg load_vector(const uint16_t* p) { return V::load_half(p); }
+
+// per-thread scratch space for packed GEMM panels
+struct ScratchBuffer
+{
+    float* data = nullptr;
+    size_t capacity = 0;
+
+    ~ScratchBuffer() { std::free(data); }
+
+    float* reserve(size_t count)
+    {
+        if (count > capacity)
+        {
+            std::free(data);
+            capacity = round_up(count, 16);
+            data = static_cast<float*>(std::aligned_alloc(64, capacity * sizeof(float)));
+        }
+        return data;
+    }
+};
+
+// ---------------------------------------------------------------- elementwise
+
+template <class V>
+void add(const float* a, const float* b, float* y, size_t n)
+{
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, V::add(V::load(a + i), V::load(b + i)));
+    for (; i < n; ++i)
+        y[i] = a[i] + b[i];
+}
+
+template <class V>
+void add_scalar(const float* a, float b, float* y, size_t n)
+{
+    const typename V::reg vb = V::set1(b);
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, V::add(V::load(a + i), vb));
+    for (; i < n; ++i)
+        y[i] = a[i] + b;
+}
+
+template <class V>
+void scale_shift(const float* x, float scale, float shift, float* y, size_t n)
+{
+    const typename V::reg vs = V::set1(scale);
+    const typename V::reg vt = V::set1(shift);
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, V::fmadd(V::load(x + i), vs, vt));
+    for (; i < n; ++i)
+        y[i] = x[i] * scale + shift;
+}
+
+template <class V>
+void relu(const float* x, float* y, size_t n)
+{
+    const typename V::reg zero = V::zero();
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, V::max(V::load(x + i), zero));
+    for (; i < n; ++i)
+        y[i] = x[i] > 0.0f ? x[i] : 0.0f;
+}
+
+template <class V>
+void half_to_float(const uint16_t* x, float* y, size_t n)
+{
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, V::load_half(x + i));
+    for (; i < n; ++i)
+        y[i] = half_bits_to_float(x[i]);
+}
+
+// channels interleaved in x repeat every `channels` registers, so one period of
+// per-lane scale and bias vectors covers any channel count up to 4
+template <class V>
+void u8_to_float(const uint8_t* x, float* y, size_t n, size_t channels, const float* scale, const float* bias)
+{
+    constexpr size_t W = V::width;
+    alignas(64) float lane_scale[4 * W], lane_bias[4 * W];
+    for (size_t j = 0; j < channels * W; ++j)
+    {
+        lane_scale[j] = scale[j % channels];
+        lane_bias[j] = bias[j % channels];
+    }
+
+    const size_t period = channels * W;
+    size_t i = 0;
+    for (; i + period <= n; i += period)
+    {
+        for (size_t r = 0; r < channels; ++r)
+            V::store(y + i + r * W, V::fmadd(V::load_u8(x + i + r * W), V::load(lane_scale + r * W), V::load(lane_bias + r * W)));
+    }
+    for (; i < n; ++i)
+        y[i] = static_cast<float>(x[i]) * scale[i % channels] + bias[i % channels];
+}
+
+// --------------------------------------------------------------------- layout
+
+// tile edge (floats) for the blocked transpose: one source and one destination
+// tile (2 x 64 x 64 x 4 bytes = 32 KiB) stay resident in L1 while it is walked
+constexpr size_t TRANSPOSE_TILE = 64;
+
+template <class V>
+void transpose(const float* src, size_t rows, size_t cols, size_t lds, float* dst, size_t ldd)
+{
+    constexpr size_t W = V::width;
+
+    for (size_t i0 = 0; i0 < rows; i0 += TRANSPOSE_TILE)
+    {
+        const size_t i1 = min_size(rows, i0 + TRANSPOSE_TILE);
+        for (size_t j0 = 0; j0 < cols; j0 += TRANSPOSE_TILE)
+        {
+            const size_t j1 = min_size(cols, j0 + TRANSPOSE_TILE);
+
+            // full register blocks, column tail of each block row done element-wise
+            size_t i = i0;
+            for (; i + W <= i1; i += W)
+            {
+                size_t j = j0;
+                for (; j + W <= j1; j += W)
+                    V::transpose_block(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+                for (; j < j1; ++j)
+                    for (size_t k = 0; k < W; ++k) dst[j * ldd + i + k] = src[(i + k) * lds + j];
+            }
+
+            // row tail
+            for (; i < i1; ++i)
+                for (size_t j = j0; j < j1; ++j) dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------- nchwc
+
+// channels per block: one register on AVX2/AVX-512, 8 (two or eight registers) below that
+template <class V>
+constexpr size_t nchwc_block() { return V::width < 8 ? 8 : V::width; }
+
+// input index read by output index `out` at kernel tap `tap`, -1 inside the padding
+inline long window_index(size_t out, size_t stride, size_t tap, size_t dilation, size_t pad, size_t extent)
+{
+    long i = static_cast<long>(out * stride + tap * dilation) - static_cast<long>(pad);
+    return i >= 0 && i < static_cast<long>(extent) ? i : -1;
+}
+
+// direct convolution: a tile of T output columns x B output channels is held in
+// registers while input pixels are broadcast against B-wide weight rows
+template <class V>
+void nchwc_conv(const NchwcConvArgs& a)
+{
+    constexpr size_t B = nchwc_block<V>();
+    constexpr size_t R = B / V::width;                 // registers per channel block
+    constexpr size_t T = R >= 8 ? 1 : 8 / R;           // output columns per tile
+
+    const size_t in_plane = a.in_h * a.in_w * B;
+    const size_t w_block  = a.kernel_h * a.kernel_w * B * B;
+
+    for (size_t ow0 = 0; ow0 < a.out_w; ow0 += T)
+    {
+        const size_t cols = min_size(T, a.out_w - ow0);
+
+        // every tap of every column in the tile reads inside the image
+        const bool interior = cols == T && ow0 * a.stride_w >= a.pad_left &&
+                              (ow0 + T - 1) * a.stride_w + (a.kernel_w - 1) * a.dilation_w < a.in_w + a.pad_left;
+
+        typename V::reg acc[T][R];
+#pragma GCC unroll 8
+        for (size_t t = 0; t < T; ++t)
+#pragma GCC unroll 8
+            for (size_t r = 0; r < R; ++r)
+                acc[t][r] = a.bias ? V::load(a.bias + r * V::width) : V::zero();
+
+        for (size_t icb = 0; icb < a.in_blocks; ++icb)
+        {
+            for (size_t kh = 0; kh < a.kernel_h; ++kh)
+            {
+                long ih = window_index(a.out_row, a.stride_h, kh, a.dilation_h, a.pad_top, a.in_h);
+                if (ih < 0) continue;
+
+                const float* x_row = a.input + icb * in_plane + static_cast<size_t>(ih) * a.in_w * B;
+                const float* w_row = a.weights + icb * w_block + kh * a.kernel_w * B * B;
+
+                for (size_t kw = 0; kw < a.kernel_w; ++kw)
+                {
+                    const float* w = w_row + kw * B * B;
+
+                    if (interior)
+                    {
+                        const float* x = x_row + (ow0 * a.stride_w + kw * a.dilation_w - a.pad_left) * B;
+                        const size_t x_step = a.stride_w * B;
+                        for (size_t ic = 0; ic < B; ++ic)
+                        {
+                            typename V::reg wv[R];
+#pragma GCC unroll 8
+                            for (size_t r = 0; r < R; ++r) wv[r] = V::load(w + ic * B + r * V::width);
+#pragma GCC unroll 8
+                            for (size_t t = 0; t < T; ++t)
+                            {
+                                typename V::reg xv = V::set1(x[t * x_step + ic]);
+#pragma GCC unroll 8
+                                for (size_t r = 0; r < R; ++r) acc[t][r] = V::fmadd(xv, wv[r], acc[t][r]);
+                            }
+                        }
+                        continue;
+                    }
+
+                    // border tile: check every column
+                    for (size_t t = 0; t < cols; ++t)
+                    {
+                        long iw = window_index(ow0 + t, a.stride_w, kw, a.dilation_w, a.pad_left, a.in_w);
+                        if (iw < 0) continue;
+
+                        const float* x = x_row + static_cast<size_t>(iw) * B;
+                        for (size_t ic = 0; ic < B; ++ic)
+                        {
+                            typename V::reg xv = V::set1(x[ic]);
+                            for (size_t r = 0; r < R; ++r)
+                                acc[t][r] = V::fmadd(xv, V::load(w + ic * B + r * V::width), acc[t][r]);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (size_t t = 0; t < cols; ++t)
+            for (size_t r = 0; r < R; ++r)
+                V::store(a.output + (ow0 + t) * B + r * V::width, acc[t][r]);
+    }
+}
+
+template <class V>
+void nchwc_max_pool(const NchwcPoolArgs& a)
+{
+    constexpr size_t B = nchwc_block<V>();
+    constexpr size_t R = B / V::width;
+
+    for (size_t ow = 0; ow < a.out_w; ++ow)
+    {
+        typename V::reg acc[R];
+        for (size_t r = 0; r < R; ++r) acc[r] = V::set1(-__builtin_huge_valf());
+
+        for (size_t kh = 0; kh < a.kernel_h; ++kh)
+        {
+            long ih = window_index(a.out_row, a.stride_h, kh, a.dilation_h, a.pad_top, a.in_h);
+            if (ih < 0) continue;
+            for (size_t kw = 0; kw < a.kernel_w; ++kw)
+            {
+                long iw = window_index(ow, a.stride_w, kw, a.dilation_w, a.pad_left, a.in_w);
+                if (iw < 0) continue;
+
+                const float* x = a.input + (static_cast<size_t>(ih) * a.in_w + static_cast<size_t>(iw)) * B;
+                for (size_t r = 0; r < R; ++r) acc[r] = V::max(acc[r], V::load(x + r * V::width));
+            }
+        }
+        for (size_t r = 0; r < R; ++r) V::store(a.output + ow * B + r * V::width, acc[r]);
+    }
+}
+
+template <class V>
+void nchwc_avg_pool(const NchwcPoolArgs& a)
+{
+    constexpr size_t B = nchwc_block<V>();
+    constexpr size_t R = B / V::width;
+
+    for (size_t ow = 0; ow < a.out_w; ++ow)
+    {
+        typename V::reg acc[R];
+        for (size_t r = 0; r < R; ++r) acc[r] = V::zero();
+
+        size_t count = 0;
+        for (size_t kh = 0; kh < a.kernel_h; ++kh)
+        {
+            long ih = window_index(a.out_row, a.stride_h, kh, a.dilation_h, a.pad_top, a.in_h);
+            if (ih < 0) continue;
+            for (size_t kw = 0; kw < a.kernel_w; ++kw)
+            {
+                long iw = window_index(ow, a.stride_w, kw, a.dilation_w, a.pad_left, a.in_w);
+                if (iw < 0) continue;
+
+                const float* x = a.input + (static_cast<size_t>(ih) * a.in_w + static_cast<size_t>(iw)) * B;
+                for (size_t r = 0; r < R; ++r) acc[r] = V::add(acc[r], V::load(x + r * V::width));
+                ++count;
+            }
+        }
+
+        // padded taps count as zeros only when asked to
+        if (a.count_include_pad) count = a.kernel_h * a.kernel_w;
+        const typename V::reg scale = V::set1(count ? 1.0f / static_cast<float>(count) : 0.0f);
+        for (size_t r = 0; r < R; ++r) V::store(a.output + ow * B + r * V::width, V::mul(acc[r], scale));
+    }
+}
+
+// ---------------------------------------------------------------- activations
+//
+// polynomial approximations, max error measured against double precision
+// libm over the stated ranges (see test/kernel_test.cpp):
+//
+//   exp      Cephes range reduction + degree 6 polynomial,
+//            relative error < 2e-7 on [-87.3, 88.0], inputs clamped to that range
+//   tanh     1 - 2 / (exp(2|x|) + 1) with the sign restored, absolute error < 3e-7
+//   erf      Abramowitz & Stegun 7.1.26, absolute error < 3e-7
+//   sigmoid  1 / (1 + exp(-x)), absolute error < 2e-7
+
+constexpr float EXP_HI = 88.0f;          // keeps 2^n finite (n <= 127)
+constexpr float EXP_LO = -87.3f;         // keeps 2^n normal (n >= -126)
+
+template <class V>
+typename V::reg exp_approx(typename V::reg x)
+{
+    using reg = typename V::reg;
+
+    x = V::min(V::max(x, V::set1(EXP_LO)), V::set1(EXP_HI));
+
+    // x = n * ln2 + r, |r| <= ln2 / 2, ln2 split in two for extra precision
+    reg n = V::round(V::mul(x, V::set1(1.44269504088896341f)));
+    reg r = V::fmadd(n, V::set1(-0.693359375f), x);
+    r = V::fmadd(n, V::set1(2.12194440e-4f), r);
+
+    reg p = V::set1(1.9875691500e-4f);
+    p = V::fmadd(p, r, V::set1(1.3981999507e-3f));
+    p = V::fmadd(p, r, V::set1(8.3334519073e-3f));
+    p = V::fmadd(p, r, V::set1(4.1665795894e-2f));
+    p = V::fmadd(p, r, V::set1(1.6666665459e-1f));
+    p = V::fmadd(p, r, V::set1(5.0000001201e-1f));
+    p = V::fmadd(p, V::mul(r, r), V::add(r, V::set1(1.0f)));
+
+    return V::mul(p, V::exp2i(n));
+}
+
+template <class V>
+typename V::reg sigmoid_approx(typename V::reg x)
+{
+    const typename V::reg one = V::set1(1.0f);
+    return V::div(one, V::add(one, exp_approx<V>(V::sub(V::zero(), x))));
+}
+
+template <class V>
+typename V::reg tanh_approx(typename V::reg x)
+{
+    const typename V::reg one = V::set1(1.0f);
+    typename V::reg e = exp_approx<V>(V::mul(V::abs(x), V::set1(2.0f)));
+    typename V::reg t = V::sub(one, V::div(V::set1(2.0f), V::add(e, one)));
+    return V::copysign(t, x);
+}
+
+template <class V>
+typename V::reg erf_approx(typename V::reg x)
+{
+    using reg = typename V::reg;
+
+    reg ax = V::abs(x);
+    reg t = V::div(V::set1(1.0f), V::fmadd(V::set1(0.3275911f), ax, V::set1(1.0f)));
+
+    reg p = V::set1(1.061405429f);
+    p = V::fmadd(p, t, V::set1(-1.453152027f));
+    p = V::fmadd(p, t, V::set1(1.421413741f));
+    p = V::fmadd(p, t, V::set1(-0.284496736f));
+    p = V::fmadd(p, t, V::set1(0.254829592f));
+    p = V::mul(p, t);
+
+    reg e = exp_approx<V>(V::sub(V::zero(), V::mul(ax, ax)));
+    reg y = V::sub(V::set1(1.0f), V::mul(p, e));
+    return V::copysign(y, x);
+}
+
+// functors so the elementwise driver below can inline them
+template <class V> struct ExpOp     { typename V::reg operator()(typename V::reg x) const { return exp_approx<V>(x); } };
+template <class V> struct SigmoidOp { typename V::reg operator()(typename V::reg x) const { return sigmoid_approx<V>(x); } };
+template <class V> struct TanhOp    { typename V::reg operator()(typename V::reg x) const { return tanh_approx<V>(x); } };
+
+template <class V>
+struct SiluOp
+{
+    typename V::reg operator()(typename V::reg x) const { return V::mul(x, sigmoid_approx<V>(x)); }
+};
+
+// 0.5 * x * (1 + erf(x / sqrt(2)))
+template <class V>
+struct GeluOp
+{
+    typename V::reg operator()(typename V::reg x) const
+    {
+        typename V::reg e = erf_approx<V>(V::mul(x, V::set1(0.70710678118654752f)));
+        return V::mul(V::mul(x, V::set1(0.5f)), V::add(e, V::set1(1.0f)));
+    }
+};
+
+// 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+template <class V>
+struct GeluTanhOp
+{
+    typename V::reg operator()(typename V::reg x) const
+    {
+        typename V::reg x3 = V::mul(V::mul(x, x), x);
+        typename V::reg inner = V::mul(V::fmadd(x3, V::set1(0.044715f), x), V::set1(0.79788456080286536f));
+        return V::mul(V::mul(x, V::set1(0.5f)), V::add(tanh_approx<V>(inner), V::set1(1.0f)));
+    }
+};
+
+// apply a vector functor over n floats; the tail goes through a padded register
+// so every element sees exactly the same arithmetic
+template <class V, class Op>
+void map_unary(const float* x, float* y, size_t n)
+{
+    const Op op{};
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, op(V::load(x + i)));
+
+    if (i < n)
+    {
+        alignas(64) float tail[V::width] = {};
+        for (size_t j = 0; i + j < n; ++j) tail[j] = x[i + j];
+        V::store(tail, op(V::load(tail)));
+        for (size_t j = 0; i + j < n; ++j) y[i + j] = tail[j];
+    }
+}
+
+template <class V> void exp_kernel(const float* x, float* y, size_t n)       { map_unary<V, ExpOp<V>>(x, y, n); }
+template <class V> void sigmoid_kernel(const float* x, float* y, size_t n)   { map_unary<V, SigmoidOp<V>>(x, y, n); }
+template <class V> void tanh_kernel(const float* x, float* y, size_t n)      { map_unary<V, TanhOp<V>>(x, y, n); }
+template <class V> void silu_kernel(const float* x, float* y, size_t n)      { map_unary<V, SiluOp<V>>(x, y, n); }
+template <class V> void gelu_kernel(const float* x, float* y, size_t n)      { map_unary<V, GeluOp<V>>(x, y, n); }
+template <class V> void gelu_tanh_kernel(const float* x, float* y, size_t n) { map_unary<V, GeluTanhOp<V>>(x, y, n); }
+
+// single read pass computing the row max and the normalizer together (online
+// softmax): lanes keep a running max m and sum s, rescaling s by exp(m_old - m_new)
+// once per block of four registers. returns max in *max_out, normalizer as value
+template <class V>
+float softmax_max_sum(const float* x, size_t n, float* max_out)
+{
+    using reg = typename V::reg;
+    constexpr size_t W = V::width;
+
+    reg m = V::set1(-3.402823466e38f);
+    reg s = V::zero();
+
+    size_t i = 0;
+    for (; i + 4 * W <= n; i += 4 * W)
+    {
+        reg x0 = V::load(x + i), x1 = V::load(x + i + W), x2 = V::load(x + i + 2 * W), x3 = V::load(x + i + 3 * W);
+        reg m_new = V::max(m, V::max(V::max(x0, x1), V::max(x2, x3)));
+
+        s = V::mul(s, exp_approx<V>(V::sub(m, m_new)));
+        s = V::add(s, V::add(V::add(exp_approx<V>(V::sub(x0, m_new)), exp_approx<V>(V::sub(x1, m_new))),
+                             V::add(exp_approx<V>(V::sub(x2, m_new)), exp_approx<V>(V::sub(x3, m_new)))));
+        m = m_new;
+    }
+    for (; i + W <= n; i += W)
+    {
+        reg xi = V::load(x + i);
+        reg m_new = V::max(m, xi);
+        s = V::fmadd(s, exp_approx<V>(V::sub(m, m_new)), exp_approx<V>(V::sub(xi, m_new)));
+        m = m_new;
+    }
+
+    // fold the lanes and the scalar tail into one (max, sum) pair
+    alignas(64) float lane_m[W];
+    alignas(64) float lane_s[W];
+    V::store(lane_m, m);
+    V::store(lane_s, s);
+
+    float mx = V::reduce_max(m);
+    for (size_t j = i; j < n; ++j) mx = x[j] > mx ? x[j] : mx;
+
+    float sum = 0.0f;
+    for (size_t l = 0; l < W; ++l) sum += lane_s[l] * __builtin_expf(lane_m[l] - mx);
+    for (size_t j = i; j < n; ++j) sum += __builtin_expf(x[j] - mx);
+
+    *max_out = mx;
+    return sum;
+}
+
+template <class V>
+void softmax_kernel(const float* x, float* y, size_t n)
+{
+    if (n == 0) return;
+
+    float mx;
+    float sum = softmax_max_sum<V>(x, n, &mx);
+
+    const typename V::reg vm = V::set1(mx);
+    const typename V::reg vinv = V::set1(1.0f / sum);
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, V::mul(exp_approx<V>(V::sub(V::load(x + i), vm)), vinv));
+    for (; i < n; ++i)
+        y[i] = __builtin_expf(x[i] - mx) / sum;
+}
+
+template <class V>
+void log_softmax_kernel(const float* x, float* y, size_t n)
+{
+    if (n == 0) return;
+
+    float mx;
+    float sum = softmax_max_sum<V>(x, n, &mx);
+
+    // y = x - (max + log(sum))
+    const typename V::reg shift = V::set1(mx + __builtin_logf(sum));
+    size_t i = 0;
+    for (; i + V::width <= n; i += V::width)
+        V::store(y + i, V::sub(V::load(x + i), shift));
+    for (; i < n; ++i)
+        y[i] = x[i] - (mx + __builtin_logf(sum));
+}
+
+// ----------------------------------------------------------------------- gemm
+
+// cache blocking (floats): KC x NR panels of B stay in L1, MC x KC block of A in L2
+constexpr size_t GEMM_KC = 256;
+constexpr size_t GEMM_MC = 144;
+constexpr size_t GEMM_NC = 2048;
+
+// C[i][j] *= beta for the MxN block, beta == 0 clears (ignores NaNs in C like BLAS)
+template <class V>
+void scale_c(size_t M, size_t N, float beta, float* C, size_t ldc)
+{
+    if (beta == 1.0f) return;
+
+    const typename V::reg vb = V::set1(beta);
+    for (size_t i = 0; i < M; ++i)
+    {
+        float* c = C + i * ldc;
+        size_t j = 0;
+        if (beta == 0.0f)
+        {
+            for (; j < N; ++j) c[j] = 0.0f;
+            continue;
+        }
+        for (; j + V::width <= N; j += V::width)
+            V::store(c + j, V::mul(V::load(c + j), vb));
+        for (; j < N; ++j)
+            c[j] *= beta;
+    }
+}
+
+// pack a kc x nc block of op(B) into NR-wide column panels, zero padded. half
+// precision B is widened here, once per panel, so the micro-kernel stays float
+template <class V, class TB>
+void pack_b(bool trans_b, const TB* B, size_t ldb, size_t p0, size_t j0, size_t kc, size_t nc, float* dst)
+{
+    constexpr size_t NR = V::nr_vecs * V::width;
+
+    for (size_t jr = 0; jr < nc; jr += NR)
+    {
+        size_t nr = min_size(NR, nc - jr);
+        for (size_t p = 0; p < kc; ++p)
+        {
+            // full panel rows of a row-major B convert a register at a time
+            if (!trans_b && nr == NR)
+            {
+                const TB* src = B + (p0 + p) * ldb + j0 + jr;
+#pragma GCC unroll 4
+                for (size_t j = 0; j < V::nr_vecs; ++j)
+                    V::store(dst + j * V::width, load_vector<V>(src + j * V::width));
+                dst += NR;
+                continue;
+            }
+            for (size_t j = 0; j < nr; ++j)
+            {
+                size_t row = p0 + p, col = j0 + jr + j;
+                dst[j] = load_scalar(trans_b ? B + col * ldb + row : B + row * ldb + col);
+            }
+            for (size_t j = nr; j < NR; ++j) dst[j] = 0.0f;
+            dst += NR;
+        }
+    }
+}
+
+// pack an mc x kc block of op(A) into MR-tall row panels, zero padded
+template <class V>
+void pack_a(bool trans_a, const float* A, size_t lda, size_t i0, size_t p0, size_t mc, size_t kc, float* dst)
+{
+    constexpr size_t MR = V::mr;
+
+    for (size_t ir = 0; ir < mc; ir += MR)
+    {
+        size_t mr = min_size(MR, mc - ir);
+        for (size_t p = 0; p < kc; ++p)
+        {
+            for (size_t i = 0; i < mr; ++i)
+            {
+                size_t row = i0 + ir + i, col = p0 + p;
+                dst[i] = trans_a ? A[col * lda + row] : A[row * lda + col];
+            }
+            for (size_t i = mr; i < MR; ++i) dst[i] = 0.0f;
+            dst += MR;
+        }
+    }
+}
+
+// C[mr x nr] += alpha * (packed A panel) * (packed B panel)
+template <class V>
+void micro_kernel(size_t kc, const float* a, const float* b, float* c, size_t ldc, size_t mr, size_t nr, float alpha)
+{
+    constexpr size_t MR = V::mr;
+    constexpr size_t NV = V::nr_vecs;
+    constexpr size_t W  = V::width;
+    constexpr size_t NR = NV * W;
+
+    typename V::reg acc[MR][NV];
+
+#pragma GCC unroll 16
+    for (size_t i = 0; i < MR; ++i)
+#pragma GCC unroll 4
+        for (size_t j = 0; j < NV; ++j)
+            acc[i][j] = V::zero();
+
+    for (size_t p = 0; p < kc; ++p)
+    {
+        typename V::reg bv[NV];
+#pragma GCC unroll 4
+        for (size_t j = 0; j < NV; ++j)
+            bv[j] = V::load(b + j * W);
+
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i)
+        {
+            typename V::reg av = V::set1(a[i]);
+#pragma GCC unroll 4
+            for (size_t j = 0; j < NV; ++j)
+                acc[i][j] = V::fmadd(av, bv[j], acc[i][j]);
+        }
+        a += MR;
+        b += NR;
+    }
+
+    const typename V::reg va = V::set1(alpha);
+
+    // full tile goes straight to C
+    if (mr == MR && nr == NR)
+    {
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i)
+#pragma GCC unroll 4
+            for (size_t j = 0; j < NV; ++j)
+            {
+                float* dst = c + i * ldc + j * W;
+                V::store(dst, V::fmadd(va, acc[i][j], V::load(dst)));
+            }
+        return;
+    }
+
+    // edge tile goes through a stack buffer
+    alignas(64) float tile[MR * NR];
+    for (size_t i = 0; i < MR; ++i)
+        for (size_t j = 0; j < NV; ++j)
+            V::store(tile + i * NR + j * W, V::mul(va, acc[i][j]));
+
+    for (size_t i = 0; i < mr; ++i)
+        for (size_t j = 0; j < nr; ++j)
+            c[i * ldc + j] += tile[i * NR + j];
+}
+
+// few rows of A: packing B costs as much as the multiply, so stream B directly
+template <class V, class TB>
+void sgemm_small_m(bool trans_a, bool trans_b, size_t M, size_t N, size_t K, float alpha,
+                   const float* A, size_t lda, const TB* B, size_t ldb, float* C, size_t ldc)
+{
+    constexpr size_t W = V::width;
+    static thread_local ScratchBuffer a_row_buffer;
+
+    for (size_t m = 0; m < M; ++m)
+    {
+        // gather row m of op(A) contiguously
+        const float* a = A + m * lda;
+        if (trans_a)
+        {
+            float* row = a_row_buffer.reserve(K);
+            for (size_t k = 0; k < K; ++k) row[k] = A[k * lda + m];
+            a = row;
+        }
+        float* c = C + m * ldc;
+
+        if (trans_b)
+        {
+            // B is N x K: every output is a dot product of contiguous rows
+            size_t n = 0;
+            for (; n + 4 <= N; n += 4)
+            {
+                const TB* b0 = B + (n + 0) * ldb;
+                const TB* b1 = B + (n + 1) * ldb;
+                const TB* b2 = B + (n + 2) * ldb;
+                const TB* b3 = B + (n + 3) * ldb;
+                typename V::reg s0 = V::zero(), s1 = V::zero(), s2 = V::zero(), s3 = V::zero();
+
+                size_t k = 0;
+                for (; k + W <= K; k += W)
+                {
+                    typename V::reg av = V::load(a + k);
+                    s0 = V::fmadd(av, load_vector<V>(b0 + k), s0);
+                    s1 = V::fmadd(av, load_vector<V>(b1 + k), s1);
+                    s2 = V::fmadd(av, load_vector<V>(b2 + k), s2);
+                    s3 = V::fmadd(av, load_vector<V>(b3 + k), s3);
+                }
+                float d0 = V::reduce_add(s0), d1 = V::reduce_add(s1), d2 = V::reduce_add(s2), d3 = V::reduce_add(s3);
+                for (; k < K; ++k)
+                {
+                    d0 += a[k] * load_scalar(b0 + k);
+                    d1 += a[k] * load_scalar(b1 + k);
+                    d2 += a[k] * load_scalar(b2 + k);
+                    d3 += a[k] * load_scalar(b3 + k);
+                }
+                c[n + 0] += alpha * d0;
+                c[n + 1] += alpha * d1;
+                c[n + 2] += alpha * d2;
+                c[n + 3] += alpha * d3;
+            }
+            for (; n < N; ++n)
+            {
+                const TB* b = B + n * ldb;
+                typename V::reg s = V::zero();
+                size_t k = 0;
+                for (; k + W <= K; k += W)
+                    s = V::fmadd(V::load(a + k), load_vector<V>(b + k), s);
+                float d = V::reduce_add(s);
+                for (; k < K; ++k) d += a[k] * load_scalar(b + k);
+                c[n] += alpha * d;
+            }
+        }
+        else
+        {
+            // B is K x N: accumulate scaled rows of B into the output row
+            for (size_t k = 0; k < K; ++k)
+            {
+                const float s = alpha * a[k];
+                if (s == 0.0f) continue;
+                const typename V::reg vs = V::set1(s);
+                const TB* b = B + k * ldb;
+                size_t n = 0;
+                for (; n + W <= N; n += W)
+                    V::store(c + n, V::fmadd(vs, load_vector<V>(b + n), V::load(c + n)));
+                for (; n < N; ++n)
+                    c[n] += s * load_scalar(b + n);
+            }
+        }
+    }
+}
+
+template <class V, class TB>
+void sgemm_impl(bool trans_a, bool trans_b, size_t M, size_t N, size_t K, float alpha,
+                const float* A, size_t lda, const TB* B, size_t ldb, float beta, float* C, size_t ldc)
+{
+    constexpr size_t MR = V::mr;
+    constexpr size_t NR = V::nr_vecs * V::width;
+
+    scale_c<V>(M, N, beta, C, ldc);
+    if (M == 0 || N == 0 || K == 0 || alpha == 0.0f) return;
+
+    if (M < MR)
+    {
+        sgemm_small_m<V, TB>(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, C, ldc);
+        return;
+    }
+
+    static thread_local ScratchBuffer a_buffer;
+    static thread_local ScratchBuffer b_buffer;
+    float* a_pack = a_buffer.reserve(round_up(GEMM_MC, MR) * GEMM_KC);
+    float* b_pack = b_buffer.reserve(GEMM_KC * round_up(GEMM_NC, NR));
+
+    for (size_t jc = 0; jc < N; jc += GEMM_NC)
+    {
+        size_t nc = min_size(GEMM_NC, N - jc);
+        for (size_t pc = 0; pc < K; pc += GEMM_KC)
+        {
+            size_t kc = min_size(GEMM_KC, K - pc);
+            pack_b<V, TB>(trans_b, B, ldb, pc, jc, kc, nc, b_pack);
+
+            for (size_t ic = 0; ic < M; ic += GEMM_MC)
+            {
+                size_t mc = min_size(GEMM_MC, M - ic);
+                pack_a<V>(trans_a, A, lda, ic, pc, mc, kc, a_pack);
+
+                for (size_t jr = 0; jr < nc; jr += NR)
+                {
+                    const float* b_panel = b_pack + (jr / NR) * NR * kc;
+                    for (size_t ir = 0; ir < mc; ir += MR)
+                    {
+                        const float* a_panel = a_pack + (ir / MR) * MR * kc;
+                        float* c = C + (ic + ir) * ldc + jc + jr;
+                        micro_kernel<V>(kc, a_panel, b_panel, c, ldc, min_size(MR, mc - ir), min_size(NR, nc - jr), alpha);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <class V>
+void sgemm(bool trans_a, bool trans_b, size_t M, size_t N, size_t K, float alpha,
+           const float* A, size_t lda, const float* B, size_t ldb, float beta, float* C, size_t ldc)
+{
+    sgemm_impl<V, float>(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template <class V>
+void sgemm_f16(bool trans_a, bool trans_b, size_t M, size_t N, size_t K, float alpha,
+               const float* A, size_t lda, const uint16_t* B, size_t ldb, float beta, float* C, size_t ldc)
+{
+    sgemm_impl<V, uint16_t>(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+// ----------------------------------------------------------------- sparse gemm
+
+// one register row (or two) per tile, so tiles match the NCHWc block width
+template <class V>
+constexpr size_t bsr_block() { return V::width < 8 ? 8 : V::width; }
+
+template <class V>
+void bsr_gemm(size_t M, float alpha, const float* A, size_t lda, const BsrMatrix& B, float* C, size_t ldc)
+{
+    constexpr size_t BW = bsr_block<V>();
+    constexpr size_t W  = V::width;
+    constexpr size_t R  = BW / W;                       // registers per tile row
+    constexpr size_t MB = 4;                            // rows of A sharing each tile load
+
+    const size_t blocks = (B.cols + BW - 1) / BW;
+    const typename V::reg va = V::set1(alpha);
+
+    for (size_t cb = 0; cb < blocks; ++cb)
+    {
+        const size_t t0 = static_cast<size_t>(B.col_ptr[cb]), t1 = static_cast<size_t>(B.col_ptr[cb + 1]);
+        const size_t n0 = cb * BW;
+        const size_t width = min_size(BW, B.cols - n0);
+
+        for (size_t m0 = 0; m0 < M; m0 += MB)
+        {
+            const size_t mb = min_size(MB, M - m0);
+            typename V::reg acc[MB][R];
+
+#pragma GCC unroll 4
+            for (size_t i = 0; i < MB; ++i)
+#pragma GCC unroll 4
+                for (size_t r = 0; r < R; ++r)
+                    acc[i][r] = V::zero();
+
+            const float* a = A + m0 * lda;
+            if (mb == MB)
+            {
+                for (size_t t = t0; t < t1; ++t)
+                {
+                    const size_t k = static_cast<size_t>(B.row_index[t]);
+                    const float* v = B.values + t * BW;
+#pragma GCC unroll 4
+                    for (size_t r = 0; r < R; ++r)
+                    {
+                        const typename V::reg bv = V::load(v + r * W);
+#pragma GCC unroll 4
+                        for (size_t i = 0; i < MB; ++i)
+                            acc[i][r] = V::fmadd(V::set1(a[i * lda + k]), bv, acc[i][r]);
+                    }
+                }
+            }
+            else
+            {
+                for (size_t t = t0; t < t1; ++t)
+                {
+                    const size_t k = static_cast<size_t>(B.row_index[t]);
+                    const float* v = B.values + t * BW;
+                    for (size_t r = 0; r < R; ++r)
+                    {
+                        const typename V::reg bv = V::load(v + r * W);
+                        for (size_t i = 0; i < mb; ++i)
+                            acc[i][r] = V::fmadd(V::set1(a[i * lda + k]), bv, acc[i][r]);
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < mb; ++i)
+            {
+                float* c = C + (m0 + i) * ldc + n0;
+                if (width == BW)
+                {
+                    for (size_t r = 0; r < R; ++r)
+                        V::store(c + r * W, V::fmadd(va, acc[i][r], V::load(c + r * W)));
+                    continue;
+                }
+
+                // last, partial tile goes through a stack buffer
+                alignas(64) float tile[BW];
+                for (size_t r = 0; r < R; ++r) V::store(tile + r * W, V::mul(va, acc[i][r]));
+                for (size_t j = 0; j < width; ++j) c[j] += tile[j];
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------- hashing
+
+// XXH3-style stripe hash (own constants, not XXH3-compatible): 8 64-bit lanes each
+// take a 32x32->64 product of (data ^ key) plus the neighbouring lane's raw data
+// for every 64-byte stripe, and are scrambled every 16 stripes. V supplies
+// hash_accumulate / hash_scramble over the 8 lanes
+constexpr size_t kHashStripe = 64;
+constexpr size_t kHashBlockStripes = 16;
+constexpr uint64_t kHashPrime32 = 0x9E3779B1u;
+constexpr uint64_t kHashPrime64a = 0x9E3779B185EBCA87ull;
+constexpr uint64_t kHashPrime64b = 0xC2B2AE3D27D4EB4Full;
+
+// stripe keys (16 + 7 used), scramble keys and finalization keys, from splitmix64
+struct HashKeys
+{
+    uint64_t k[kHashBlockStripes + 16];
+};
+
+constexpr HashKeys make_hash_keys()
+{
+    HashKeys keys{};
+    uint64_t x = 0x243F6A8885A308D3ull;
+    for (auto& k : keys.k)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        k = z ^ (z >> 31);
+    }
+    return keys;
+}
+
+constexpr HashKeys kHashKeys = make_hash_keys();
+
+inline void hash_accumulate_scalar(uint64_t* acc, const unsigned char* p, const uint64_t* keys, size_t stripes)
+{
+    for (size_t s = 0; s < stripes; ++s, p += kHashStripe)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            uint64_t v;
+            __builtin_memcpy(&v, p + 8 * i, sizeof(v));
+            const uint64_t k = v ^ keys[s + i];
+            acc[i ^ 1] += v;
+            acc[i] += (k & 0xffffffffull) * (k >> 32);
+        }
+    }
+}
+
+inline void hash_scramble_scalar(uint64_t* acc, const uint64_t* keys)
+{
+    for (size_t i = 0; i < 8; ++i)
+    {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= keys[i];
+        acc[i] = a * kHashPrime32;
+    }
+}
+
+inline uint64_t hash_fold(uint64_t a, uint64_t b)
+{
+    const __uint128_t m = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(m) ^ static_cast<uint64_t>(m >> 64);
+}
+
+inline uint64_t hash_avalanche(uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    return h ^ (h >> 32);
+}
+
+template <class V>
+void hash128(const void* data, size_t n, uint64_t seed, uint64_t* out)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const uint64_t* keys = kHashKeys.k;
+
+    alignas(64) uint64_t acc[8];
+    for (size_t i = 0; i < 8; ++i) acc[i] = keys[kHashBlockStripes + 8 + i] + (i & 1 ? ~seed : seed);
+
+    const size_t block = kHashStripe * kHashBlockStripes;
+    size_t done = 0;
+    for (; done + block <= n; done += block)
+    {
+        V::hash_accumulate(acc, p + done, keys, kHashBlockStripes);
+        V::hash_scramble(acc, keys + kHashBlockStripes);
+    }
+
+    const size_t stripes = (n - done) / kHashStripe;
+    V::hash_accumulate(acc, p + done, keys, stripes);
+    done += stripes * kHashStripe;
+
+    // zero-padded last stripe; the length below tells padding from real zeros
+    if (done < n)
+    {
+        alignas(64) unsigned char tail[kHashStripe] = {};
+        __builtin_memcpy(tail, p + done, n - done);
+        V::hash_accumulate(acc, tail, keys + stripes, 1);
+    }
+
+    uint64_t low = n * kHashPrime64a, high = ~n * kHashPrime64b;
+    for (size_t i = 0; i < 8; i += 2)
+    {
+        low += hash_fold(acc[i] ^ keys[kHashBlockStripes + i], acc[i + 1] ^ keys[kHashBlockStripes + i + 1]);
+        high += hash_fold(acc[i + 1] ^ keys[kHashBlockStripes + 8 + i], acc[i] ^ keys[kHashBlockStripes + 9 + i]);
+    }
+    out[0] = hash_avalanche(low);
+    out[1] = hash_avalanche(high ^ low);
+}
+
+// ---------------------------------------------------------------------- table
+
+template <class V>
+KernelTable make_kernel_table(Isa isa)
+{
+    KernelTable table{};
+    table.isa   = isa;
+    table.name  = isa_name(isa);
+    table.sgemm = &sgemm<V>;
+    table.sgemm_f16 = &sgemm_f16<V>;
+    table.half_to_float = &half_to_float<V>;
+    table.u8_to_float = &u8_to_float<V>;
+    table.bsr_block = bsr_block<V>();
+    table.bsr_gemm  = &bsr_gemm<V>;
+
+    table.add        = &add<V>;
+    table.add_scalar = &add_scalar<V>;
+    table.relu       = &relu<V>;
+    table.scale_shift = &scale_shift<V>;
+    table.transpose   = &transpose<V>;
+
+    table.nchwc_block    = nchwc_block<V>();
+    table.nchwc_conv     = &nchwc_conv<V>;
+    table.nchwc_max_pool = &nchwc_max_pool<V>;
+    table.nchwc_avg_pool = &nchwc_avg_pool<V>;
+
+    table.exp         = &exp_kernel<V>;
+    table.sigmoid     = &sigmoid_kernel<V>;
+    table.tanh        = &tanh_kernel<V>;
+    table.silu        = &silu_kernel<V>;
+    table.gelu        = &gelu_kernel<V>;
+    table.gelu_tanh   = &gelu_tanh_kernel<V>;
+    table.softmax     = &softmax_kernel<V>;
+    table.log_softmax = &log_softmax_kernel<V>;
+
+    table.hash128 = &hash128<V>;
+    return table;
+}
+
+}
+
+#endif
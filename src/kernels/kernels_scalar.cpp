@@ -0,0 +1,57 @@
+// portable fallback, built with the baseline compiler flags only
+#include "kernels_impl.h"
+
+namespace
+{
+
+struct VecScalar
+{
+    using reg = float;
+    static constexpr std::size_t width   = 1;
+    static constexpr std::size_t mr      = 4;
+    static constexpr std::size_t nr_vecs = 4;
+
+    static reg zero() { return 0.0f; }
+    static reg set1(float v) { return v; }
+    static reg load(const float* p) { return *p; }
+    static reg load_half(const uint16_t* p) { return half_bits_to_float(*p); }
+    static reg load_u8(const uint8_t* p) { return static_cast<float>(*p); }
+    static void store(float* p, reg v) { *p = v; }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+    static reg div(reg a, reg b) { return a / b; }
+    static reg min(reg a, reg b) { return a < b ? a : b; }
+    static reg max(reg a, reg b) { return a > b ? a : b; }
+    static reg abs(reg a) { return __builtin_fabsf(a); }
+    static reg fmadd(reg a, reg b, reg c) { return a * b + c; }
+    static reg round(reg a) { return __builtin_rintf(a); }
+    static reg copysign(reg mag, reg sign) { return __builtin_copysignf(mag, sign); }
+
+    static reg exp2i(reg n)
+    {
+        unsigned int bits = static_cast<unsigned int>(static_cast<int>(n) + 127) << 23;
+        float v;
+        __builtin_memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    static float reduce_add(reg v) { return v; }
+    static float reduce_max(reg v) { return v; }
+
+    static void transpose_block(const float* src, std::size_t, float* dst, std::size_t) { *dst = *src; }
+
+    static void hash_accumulate(uint64_t* acc, const unsigned char* p, const uint64_t* keys, std::size_t stripes)
+    {
+        hash_accumulate_scalar(acc, p, keys, stripes);
+    }
+    static void hash_scramble(uint64_t* acc, const uint64_t* keys) { hash_scramble_scalar(acc, keys); }
+};
+
+}
+
+const KernelTable& scalar_kernels()
+{
+    static const KernelTable table = make_kernel_table<VecScalar>(Isa::Scalar);
+    return table;
+}
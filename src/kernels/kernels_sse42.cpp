@@ -0,0 +1,121 @@
+// built with -msse4.2
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+#include "kernels_impl.h"
+
+namespace
+{
+
+struct VecSse42
+{
+    using reg = __m128;
+    static constexpr std::size_t width   = 4;
+    static constexpr std::size_t mr      = 6;
+    static constexpr std::size_t nr_vecs = 2;
+
+    static reg zero() { return _mm_setzero_ps(); }
+    static reg set1(float v) { return _mm_set1_ps(v); }
+    static reg load(const float* p) { return _mm_loadu_ps(p); }
+
+    // no F16C at this level: widen lane by lane
+    static reg load_half(const uint16_t* p)
+    {
+        return _mm_setr_ps(half_bits_to_float(p[0]), half_bits_to_float(p[1]), half_bits_to_float(p[2]), half_bits_to_float(p[3]));
+    }
+    static reg load_u8(const uint8_t* p)
+    {
+        int32_t bytes;
+        __builtin_memcpy(&bytes, p, sizeof(bytes));
+        return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+    }
+    static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+    static reg abs(reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }   // no FMA before AVX2
+    static reg round(reg a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    static reg copysign(reg mag, reg sign)
+    {
+        const __m128 mask = _mm_set1_ps(-0.0f);
+        return _mm_or_ps(_mm_andnot_ps(mask, mag), _mm_and_ps(mask, sign));
+    }
+
+    static reg exp2i(reg n)
+    {
+        __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+        return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+    }
+
+    static float reduce_add(reg v)
+    {
+        v = _mm_hadd_ps(v, v);
+        v = _mm_hadd_ps(v, v);
+        return _mm_cvtss_f32(v);
+    }
+
+    static float reduce_max(reg v)
+    {
+        v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+
+    static void transpose_block(const float* src, std::size_t lds, float* dst, std::size_t ldd)
+    {
+        __m128 r0 = _mm_loadu_ps(src), r1 = _mm_loadu_ps(src + lds);
+        __m128 r2 = _mm_loadu_ps(src + 2 * lds), r3 = _mm_loadu_ps(src + 3 * lds);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(dst, r0);
+        _mm_storeu_ps(dst + ldd, r1);
+        _mm_storeu_ps(dst + 2 * ldd, r2);
+        _mm_storeu_ps(dst + 3 * ldd, r3);
+    }
+
+    // two lanes per register
+    static void hash_accumulate(uint64_t* acc, const unsigned char* p, const uint64_t* keys, std::size_t stripes)
+    {
+        __m128i a[4];
+        for (int r = 0; r < 4; ++r) a[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + 2 * r));
+        for (std::size_t s = 0; s < stripes; ++s, p += 64)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * r));
+                __m128i k = _mm_xor_si128(d, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + s + 2 * r)));
+                __m128i product = _mm_mul_epu32(k, _mm_srli_epi64(k, 32));
+                a[r] = _mm_add_epi64(a[r], _mm_add_epi64(product, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+        for (int r = 0; r < 4; ++r) _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * r), a[r]);
+    }
+
+    static void hash_scramble(uint64_t* acc, const uint64_t* keys)
+    {
+        const __m128i prime = _mm_set1_epi64x(0x9E3779B1);
+        for (int r = 0; r < 4; ++r)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + 2 * r));
+            a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+            a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + 2 * r)));
+            __m128i high = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+            a = _mm_add_epi64(_mm_mul_epu32(a, prime), _mm_slli_epi64(high, 32));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * r), a);
+        }
+    }
+};
+
+}
+
+const KernelTable& sse42_kernels()
+{
+    static const KernelTable table = make_kernel_table<VecSse42>(Isa::Sse42);
+    return table;
+}
+
+#endif
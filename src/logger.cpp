@@ -0,0 +1,172 @@
+#include "logger.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+
+const auto start_time = std::chrono::steady_clock::now();
+
+uint32_t thread_number()
+{
+    static std::atomic<uint32_t> next{0};
+    thread_local uint32_t number = next++;
+    return number;
+}
+
+const char* level_tag(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info:  return "INFO ";
+    case LogLevel::Warn:  return "WARN ";
+    case LogLevel::Error: return "ERROR";
+    default:              return "     ";
+    }
+}
+
+}
+
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : slots_(new Slot[kSlots])
+{
+    for (std::size_t i = 0; i < kSlots; ++i) slots_[i].sequence.store(i, std::memory_order_relaxed);
+
+    LogLevel level;
+    const char* env = std::getenv("INFERA_LOG_LEVEL");
+    if (env && parse_level(env, level)) level_.store(level, std::memory_order_relaxed);
+
+    drainer_ = std::thread([this] { drain_loop(); });
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    drainer_.join();
+    flush();
+}
+
+bool Logger::parse_level(const std::string& name, LogLevel& level)
+{
+    if (name == "debug") level = LogLevel::Debug;
+    else if (name == "info") level = LogLevel::Info;
+    else if (name == "warn") level = LogLevel::Warn;
+    else if (name == "error") level = LogLevel::Error;
+    else if (name == "off") level = LogLevel::Off;
+    else return false;
+    return true;
+}
+
+// bounded MPMC queue (Vyukov): a slot is free for position p when its sequence is
+// p, and holds a message for the consumer when its sequence is p + 1
+void Logger::log(LogLevel level, const char* format, ...)
+{
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;)
+    {
+        slot = &slots_[pos & (kSlots - 1)];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0)
+        {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);         // full: never block the caller
+            return;
+        }
+        else
+        {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->thread = thread_number();
+    slot->time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(slot->text, kMessageSize, format, args);
+    va_end(args);
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+bool Logger::first_time(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(once_mutex_);
+    return seen_.insert(key).second;
+}
+
+void Logger::set_sink(Sink sink)
+{
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    sink_ = std::move(sink);
+}
+
+void Logger::flush()
+{
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    while (drain()) {}
+}
+
+// format and emit every ready message, returns whether anything was emitted
+bool Logger::drain()
+{
+    bool any = false;
+    char line[kMessageSize + 64];
+
+    for (;;)
+    {
+        Slot& slot = slots_[dequeue_pos_ & (kSlots - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) break;
+
+        std::snprintf(line, sizeof(line), "[%10.3f ms] %s t%u %s", slot.time_us * 1e-3, level_tag(slot.level), slot.thread, slot.text);
+        LogLevel level = slot.level;
+        slot.sequence.store(dequeue_pos_ + kSlots, std::memory_order_release);
+        ++dequeue_pos_;
+
+        if (sink_) sink_(level, line);
+        else std::fprintf(stderr, "%s\n", line);
+        any = true;
+    }
+
+    std::size_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_)
+    {
+        std::snprintf(line, sizeof(line), "log buffer full, %zu message(s) dropped", dropped - reported_dropped_);
+        reported_dropped_ = dropped;
+        if (sink_) sink_(LogLevel::Warn, line);
+        else std::fprintf(stderr, "%s\n", line);
+    }
+    return any;
+}
+
+void Logger::drain_loop()
+{
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (!stopping_)
+    {
+        // producers never signal (that would be a syscall on their side), poll instead
+        wake_.wait_for(lock, std::chrono::milliseconds(20));
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
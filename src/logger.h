@@ -0,0 +1,130 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+enum class LogLevel
+{
+    Debug = 0,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+// lowest level compiled in, lower levels expand to nothing (0 = debug, 1 = info, ...)
+#ifndef INFERA_MIN_LOG_LEVEL
+#define INFERA_MIN_LOG_LEVEL 1
+#endif
+
+// leveled asynchronous logger. callers format into a slot of a lock-free bounded
+// ring buffer and return; a background thread drains it to the sink, so logging
+// never blocks or does I/O on the calling thread. a full buffer drops messages
+// (counted and reported) instead of waiting
+class Logger
+{
+public:
+    using Sink = std::function<void(LogLevel level, const std::string& line)>;
+
+    static Logger& instance();
+
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // runtime threshold, initialized from INFERA_LOG_LEVEL (debug|info|warn|error|off)
+    void set_level(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    LogLevel level() const { return level_.load(std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= this->level(); }
+
+    // printf-style; the message is truncated to one slot
+    void log(LogLevel level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+    // true the first time `key` is seen, for warn-once call sites
+    bool first_time(const std::string& key);
+
+    // drain everything queued so far on the calling thread
+    void flush();
+
+    // replace the default stderr sink (nullptr restores it)
+    void set_sink(Sink sink);
+
+    std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    static bool parse_level(const std::string& name, LogLevel& level);
+
+private:
+    static constexpr std::size_t kSlots = 1024;                     // power of two
+    static constexpr std::size_t kMessageSize = 256;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        LogLevel level;
+        uint32_t thread;
+        uint64_t time_us;
+        char text[kMessageSize];
+    };
+
+    Logger();
+    void drain_loop();
+    bool drain();                                                   // consumer side, under drain_mutex_
+
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<std::size_t> enqueue_pos_{0};
+    std::size_t dequeue_pos_ = 0;
+    std::atomic<std::size_t> dropped_{0};
+    std::size_t reported_dropped_ = 0;
+    std::atomic<LogLevel> level_{LogLevel::Info};
+
+    std::mutex drain_mutex_;
+    Sink sink_;
+
+    std::mutex once_mutex_;
+    std::unordered_set<std::string> seen_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread drainer_;
+};
+
+#define INFERA_LOG(level, ...)                                                          \
+    do                                                                                  \
+    {                                                                                   \
+        if (Logger::instance().enabled(level)) Logger::instance().log(level, __VA_ARGS__); \
+    } while (0)
+
+// warn once per distinct key, e.g. per unsupported op type
+#define INFERA_LOG_WARN_ONCE(key, ...)                                                  \
+    do                                                                                  \
+    {                                                                                   \
+        if (Logger::instance().enabled(LogLevel::Warn) && Logger::instance().first_time(key)) \
+            Logger::instance().log(LogLevel::Warn, __VA_ARGS__);                        \
+    } while (0)
+
+#if INFERA_MIN_LOG_LEVEL <= 0
+#define INFERA_LOG_DEBUG(...) INFERA_LOG(LogLevel::Debug, __VA_ARGS__)
+#else
+#define INFERA_LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if INFERA_MIN_LOG_LEVEL <= 1
+#define INFERA_LOG_INFO(...) INFERA_LOG(LogLevel::Info, __VA_ARGS__)
+#else
+#define INFERA_LOG_INFO(...) do {} while (0)
+#endif
+
+#define INFERA_LOG_WARN(...) INFERA_LOG(LogLevel::Warn, __VA_ARGS__)
+#define INFERA_LOG_ERROR(...) INFERA_LOG(LogLevel::Error, __VA_ARGS__)
+
+#endif
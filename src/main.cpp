@@ -2,30 +2,119 @@
 #include <vector>
 #include <algorithm>
 #include <cmath> 
+#include <limits>
 #include "graph.h"
 #include "onnx_parser.h"
+#include "graph_optimizer.h"
 #include "image_loader.h"
+#include "bulk_inference.h"
 #include "inference_engine.h"
+#include "profiler.h"
+#include "metrics.h"
+#include "logger.h"
+#include "postprocess.h"
 #include "tensor.h"
+#include "kernels/kernels.h"
+
+// largest absolute / relative deviation of the fp16-weight run from the fp32 reference
+static void report_fp16_accuracy(const std::vector<float>& reference, const Tensor<float>& result, std::size_t fp32_bytes, std::size_t fp16_bytes)
+{
+    if (reference.size() != result.size())
+        throw std::runtime_error("fp16 accuracy report: output size changed between runs.");
+
+    float max_abs = 0.0f, max_rel = 0.0f;
+    for (std::size_t i {}; i < reference.size(); ++i)
+    {
+        float diff = std::fabs(result.data()[i] - reference[i]);
+        max_abs = std::max(max_abs, diff);
+        max_rel = std::max(max_rel, diff / std::max(std::fabs(reference[i]), 1e-6f));
+    }
+
+    auto top1 = [](const float* v, std::size_t n) { return std::max_element(v, v + n) - v; };
+    bool same_class = top1(reference.data(), reference.size()) == top1(result.data(), result.size());
+
+    std::cout << "\n=== FP16 Weights vs FP32 ===\n";
+    std::cout << "Weight memory: " << fp32_bytes / 1024 << " KiB -> " << fp16_bytes / 1024 << " KiB\n";
+    std::cout << "Max abs error: " << max_abs << "\n";
+    std::cout << "Max rel error: " << max_rel << "\n";
+    std::cout << "Top-1 match:   " << (same_class ? "yes" : "no") << "\n";
+}
+
+// a flag's number: digits only, within the range of `value`'s type
+template <typename T>
+static bool parse_count(const std::string& text, T& value)
+{
+    if (text.empty() || text.size() > 19 || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    const unsigned long long parsed = std::stoull(text);
+    if (parsed > static_cast<unsigned long long>(std::numeric_limits<T>::max())) return false;
+    value = static_cast<T>(parsed);
+    return true;
+}
 
 int main(int argc, char** argv)
 {
-    if (argc < 3) 
+    // positional model and image, plus optional flags
+    std::vector<std::string> args;
+    bool fp16_weights = false;
+    std::string trace_path;
+    std::string metrics_path;
+    bool perf_counters = false;
+    std::string bulk_spec;
+    std::string postprocess_spec;
+    BulkOptions bulk;
+    bool valid = true;
+    for (int i = 1; i < argc && valid; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--fp16-weights")
+            fp16_weights = true;
+        else if (arg == "--perf-counters")
+            perf_counters = true;
+        else if (arg.rfind("--profile=", 0) == 0)
+            trace_path = arg.substr(10);
+        else if (arg.rfind("--metrics=", 0) == 0)
+            metrics_path = arg.substr(10);
+        else if (arg.rfind("--bulk=", 0) == 0)
+            bulk_spec = arg.substr(7);
+        else if (arg.rfind("--output=", 0) == 0)
+            bulk.output = arg.substr(9);
+        else if (arg.rfind("--batch-size=", 0) == 0)
+            valid = parse_count(arg.substr(13), bulk.batch_size) && bulk.batch_size > 0;
+        else if (arg.rfind("--decode-threads=", 0) == 0)
+            valid = parse_count(arg.substr(17), bulk.decode_threads);
+        else if (arg.rfind("--postprocess=", 0) == 0)
+            postprocess_spec = arg.substr(14);
+        else
+            args.push_back(arg);
+
+        if (!valid) std::cerr << "Invalid value: " << arg << "\n";
+    }
+
+    if (!valid || args.size() < (bulk_spec.empty() ? 2u : 1u)) 
     {
-        std::cerr << "Usage: ./infera <model.onnx> <image.png>\n";
+        std::cerr << "Usage: ./infera <model.onnx> <image.png> [--fp16-weights] [--profile=<trace.json> [--perf-counters]] [--metrics=<file.prom>]\n"
+                     "                     [--postprocess=softmax,topk=5,threshold=0.1,labels=<file>]\n"
+                     "       ./infera <model.onnx> --bulk=<dir|glob|@list.txt> [--output=<preds.csv|preds.jsonl>] [--batch-size=32] [--decode-threads=N]\n";
         return 1;
     }
 
-    std::string model_path = argv[1];
-    std::string image_path = argv[2];
+    std::string model_path = args[0];
+    std::string image_path = bulk_spec.empty() ? args[1] : std::string();
 
     try {
+        // counters inherit into threads created later, so open them before the compute pool starts
+        Profiler profiler;
+        if (perf_counters && !trace_path.empty() && !profiler.enable_hardware_counters())
+            std::cerr << "Hardware counters " << profiler.hardware_status() << "\n";
+
         // build Graph
         Graph graph;
         OnnxParser parser;
 
-        std::cout << "Loading Model: " << model_path << "...\n";
+        (bulk_spec.empty() ? std::cout : std::cerr) << "Loading Model: " << model_path << "...\n";
         parser.parse(graph, model_path);
+        GraphOptimizer::optimize(graph);
+        Logger::instance().flush();     // load-time messages before the results
 
         // detect size dynamically
         graph.infer_input_size();
@@ -33,6 +122,25 @@ int main(int argc, char** argv)
         int req_h = graph.get_input_height();
         int req_w = graph.get_input_width();
 
+        // the head from --postprocess, else the one configured beside the model
+        Postprocessor head = !postprocess_spec.empty() ? Postprocessor::parse(postprocess_spec) : Postprocessor::for_model(model_path);
+
+        // bulk mode: predictions may go to stdout, so progress goes to stderr
+        if (!bulk_spec.empty())
+        {
+            bulk.inputs = expand_image_inputs(bulk_spec);
+            bulk.format = bulk_format_for(bulk.output);
+            bulk.postprocess = head;
+            std::cerr << "Model requires: " << req_w << "x" << req_h << ", scoring " << bulk.inputs.size() << " image(s)...\n";
+
+            BulkStats stats = run_bulk_inference(graph, bulk);
+            std::cerr << "Scored " << stats.images << " image(s) (" << stats.failed << " failed) in " << stats.seconds << " s: "
+                      << stats.images_per_second() << " images/s (decode " << stats.decode_seconds << " s across threads, inference "
+                      << stats.inference_seconds << " s)\n";
+            if (!metrics_path.empty()) MetricsRegistry::instance().write_prometheus(metrics_path);
+            return 0;
+        }
+
         std::cout << "Model requires: " << req_w << "x" << req_h << "\n";
 
         // load image
@@ -40,54 +148,64 @@ int main(int argc, char** argv)
         Tensor<float>* input_tensor = ImageLoader::load_image(image_path, req_w, req_h);
 
         InferenceEngine engine;
-        std::cout << "Running Inference...\n";
+        if (!trace_path.empty()) engine.set_profiler(&profiler);
+        std::cout << "Running Inference (" << kernels().name << " kernels)...\n";
 
         std::vector<Tensor<float>*> inputs = { input_tensor };
         std::vector<Tensor<float>*> outputs = engine.run(graph, inputs);
 
+        // rerun with half precision weights and compare against the fp32 result
+        if (fp16_weights && !outputs.empty())
+        {
+            std::vector<float> reference(outputs[0]->data(), outputs[0]->data() + outputs[0]->size());
+            std::size_t fp32_bytes = graph.initializer_bytes();
+
+            std::size_t converted = GraphOptimizer::convert_weights_to_fp16(graph);
+            std::cout << "Stored " << converted << " weight tensor(s) as float16, rerunning...\n";
+            outputs = engine.run(graph, inputs);
+
+            report_fp16_accuracy(reference, *outputs[0], fp32_bytes, graph.initializer_bytes());
+        }
+
         if (outputs.empty())
             throw std::runtime_error("No output from engine.");
 
+        // softmax over every class when nothing is configured
+        if (head.empty()) head = Postprocessor::parse("softmax");
         Tensor<float>* result = outputs[0];
-        const float* output_data = result->data();
+        const std::size_t num_classes = result->shape().empty() ? result->size() : result->shape().back();
+        std::vector<int64_t> classes(head.k(num_classes));
+        std::vector<float> scores(classes.size());
+        head.apply_row(result->data(), num_classes, classes.data(), scores.data());
 
-        // results using softmax
         std::cout << "\n=== Results ===\n";
-        
-        float sum {};
-        std::vector<float> exp_values(10);
-        
-        // get max logit for numerical stability
-        float max_logit = -1e9f;
-        for (int i {}; i < 10; ++i) 
+        for (std::size_t i {}; i < classes.size() && classes[i] >= 0; ++i)
         {
-            if (output_data[i] > max_logit) max_logit = output_data[i];
+            std::cout << "Class " << head.label(classes[i]) << ": ";
+            if (head.softmax()) std::cout << scores[i] * 100.0f << "%\n";
+            else std::cout << scores[i] << "\n";
         }
 
-        // exponentiate and sum
-        for (int i = 0; i < 10; ++i) 
+        if (classes[0] < 0)
+            std::cout << "\nPREDICTION: none above the threshold\n";
+        else if (head.softmax())
+            std::cout << "\nPREDICTION: " << head.label(classes[0]) << " (Confidence: " << (int)(scores[0] * 100) << "%)\n";
+        else
+            std::cout << "\nPREDICTION: " << head.label(classes[0]) << " (Score: " << scores[0] << ")\n";
+
+        if (!trace_path.empty())
         {
-            exp_values[i] = std::exp(output_data[i] - max_logit);
-            sum += exp_values[i];
+            std::cout << "\n=== Profile ===\n";
+            profiler.print_summary(std::cout);
+            profiler.write_chrome_trace(trace_path);
+            std::cout << "Chrome trace written to " << trace_path << "\n";
         }
 
-        int predicted_digit = -1;
-        float max_prob = -1.0f;
-
-        for (int i {}; i < 10; ++i) 
+        if (!metrics_path.empty())
         {
-            float probability = exp_values[i] / sum;
-            float percent = probability * 100.0f;
-            std::cout << "Digit " << i << ": " << percent << "%\n";
-
-            if (probability > max_prob) 
-            {
-                max_prob = probability;
-                predicted_digit = i;
-            }
+            MetricsRegistry::instance().write_prometheus(metrics_path);
+            std::cout << "Metrics written to " << metrics_path << "\n";
         }
-
-        std::cout << "\nPREDICTION: " << predicted_digit  << " (Confidence: " << (int)(max_prob * 100) << "%)\n";
         delete input_tensor; 
     } 
     catch (const std::exception& e) 
@@ -0,0 +1,248 @@
+#include "metrics.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace metrics_detail
+{
+
+std::size_t shard_index()
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t index = next++ % kShards;
+    return index;
+}
+
+}
+
+namespace
+{
+
+// label values escape backslash, quote and newline
+std::string render_labels(const MetricLabels& labels)
+{
+    if (labels.empty()) return "";
+
+    std::string out = "{";
+    for (std::size_t i = 0; i < labels.size(); ++i)
+    {
+        if (i) out += ",";
+        out += labels[i].first + "=\"";
+        for (char c : labels[i].second)
+        {
+            if (c == '\\') out += "\\\\";
+            else if (c == '"') out += "\\\"";
+            else if (c == '\n') out += "\\n";
+            else out += c;
+        }
+        out += "\"";
+    }
+    return out + "}";
+}
+
+// rendered label set with one more label appended
+std::string with_label(const std::string& labels, const std::string& name, const std::string& value)
+{
+    std::string extra = name + "=\"" + value + "\"";
+    if (labels.empty()) return "{" + extra + "}";
+    return labels.substr(0, labels.size() - 1) + "," + extra + "}";
+}
+
+std::string format_number(double v)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", v);
+    return buffer;
+}
+
+}
+
+uint64_t Counter::value() const
+{
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+Histogram::Histogram() : shards_(new Shard[kHistogramShards])
+{
+    for (std::size_t s = 0; s < kHistogramShards; ++s)
+        for (auto& bucket : shards_[s].buckets) bucket.store(0, std::memory_order_relaxed);
+}
+
+std::size_t Histogram::bucket_of(uint64_t value)
+{
+    constexpr uint64_t limit = (uint64_t(1) << kMaxBits) - 1;
+    if (value > limit) value = limit;
+    if (value < (uint64_t(1) << kSubBits)) return static_cast<std::size_t>(value);
+
+    // exponent e keeps the top kSubBits bits as the mantissa in [2^(S-1), 2^S)
+    const unsigned msb = 63 - __builtin_clzll(value);
+    const unsigned e = msb - (kSubBits - 1);
+    return (static_cast<std::size_t>(e) << (kSubBits - 1)) + static_cast<std::size_t>(value >> e);
+}
+
+uint64_t Histogram::bucket_lower(std::size_t bucket)
+{
+    if (bucket < (std::size_t(1) << kSubBits)) return bucket;
+
+    const std::size_t half = std::size_t(1) << (kSubBits - 1);
+    const unsigned e = static_cast<unsigned>(bucket / half) - 1;
+    const uint64_t mantissa = bucket % half + half;
+    return mantissa << e;
+}
+
+uint64_t Histogram::bucket_upper(std::size_t bucket)
+{
+    if (bucket + 1 >= kBuckets) return (uint64_t(1) << kMaxBits) - 1;
+    return bucket_lower(bucket + 1) - 1;
+}
+
+void Histogram::record(uint64_t value)
+{
+    Shard& shard = shards_[metrics_detail::shard_index() % kHistogramShards];
+    shard.buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+uint64_t Histogram::count() const
+{
+    uint64_t total = 0;
+    for (std::size_t s = 0; s < kHistogramShards; ++s) total += shards_[s].count.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t Histogram::sum() const
+{
+    uint64_t total = 0;
+    for (std::size_t s = 0; s < kHistogramShards; ++s) total += shards_[s].sum.load(std::memory_order_relaxed);
+    return total;
+}
+
+double Histogram::quantile(double q) const
+{
+    // snapshot the merged buckets, concurrent records may land on either side
+    std::vector<uint64_t> merged(kBuckets, 0);
+    uint64_t total = 0;
+    for (std::size_t s = 0; s < kHistogramShards; ++s)
+    {
+        for (std::size_t b = 0; b < kBuckets; ++b)
+        {
+            uint64_t n = shards_[s].buckets[b].load(std::memory_order_relaxed);
+            merged[b] += n;
+            total += n;
+        }
+    }
+    if (total == 0) return 0.0;
+    if (q >= 1.0) return static_cast<double>(max());
+    if (q < 0.0) q = 0.0;
+
+    // rank of the requested sample, 1-based
+    const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total)) + 1;
+    uint64_t seen = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b)
+    {
+        seen += merged[b];
+        if (seen >= rank)
+        {
+            const double mid = (static_cast<double>(bucket_lower(b)) + static_cast<double>(bucket_upper(b))) / 2.0;
+            const double top = static_cast<double>(max());
+            return mid < top ? mid : top;
+        }
+    }
+    return static_cast<double>(max());
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, Type type, const std::string& help)
+{
+    auto it = families_.find(name);
+    if (it == families_.end())
+    {
+        Family& created = families_[name];
+        created.type = type;
+        created.help = help;
+        return created;
+    }
+    if (it->second.type != type) throw std::runtime_error("metric '" + name + "' is already registered with another type");
+    return it->second;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, Type::Counter, help).counters[render_labels(labels)];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, Type::Gauge, help).gauges[render_labels(labels)];
+    if (!slot) slot = std::make_unique<Gauge>();
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const MetricLabels& labels, double scale)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& f = family(name, Type::Histogram, help);
+    if (f.histograms.empty()) f.scale = scale;
+
+    auto& slot = f.histograms[render_labels(labels)];
+    if (!slot) slot = std::make_unique<Histogram>();
+    return *slot;
+}
+
+void MetricsRegistry::write_prometheus(std::ostream& out) const
+{
+    static const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, f] : families_)
+    {
+        out << "# HELP " << name << " " << f.help << "\n";
+        switch (f.type)
+        {
+        case Type::Counter:
+            out << "# TYPE " << name << " counter\n";
+            for (const auto& [labels, c] : f.counters) out << name << labels << " " << c->value() << "\n";
+            break;
+        case Type::Gauge:
+            out << "# TYPE " << name << " gauge\n";
+            for (const auto& [labels, g] : f.gauges) out << name << labels << " " << g->value() << "\n";
+            break;
+        case Type::Histogram:
+            out << "# TYPE " << name << " summary\n";
+            for (const auto& [labels, h] : f.histograms)
+            {
+                for (double q : quantiles)
+                    out << name << with_label(labels, "quantile", format_number(q)) << " " << format_number(h->quantile(q) * f.scale) << "\n";
+                out << name << "_sum" << labels << " " << format_number(static_cast<double>(h->sum()) * f.scale) << "\n";
+                out << name << "_count" << labels << " " << h->count() << "\n";
+            }
+            break;
+        }
+    }
+}
+
+void MetricsRegistry::write_prometheus(const std::string& path) const
+{
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (!file) throw std::runtime_error("Could not write metrics to " + temporary);
+        write_prometheus(file);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) throw std::runtime_error("Could not move metrics into " + path);
+}
@@ -0,0 +1,131 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// in-process metrics exported in the Prometheus text format. updates are lock-free:
+// each metric is striped over cache-line sized shards picked by thread, so hot-path
+// increments from different threads never share a line. the registry lock is only
+// taken to create a metric or to export
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+namespace metrics_detail
+{
+constexpr std::size_t kShards = 16;
+
+// stripe used by the calling thread
+std::size_t shard_index();
+
+struct alignas(64) PaddedCounter
+{
+    std::atomic<uint64_t> value{0};
+};
+}
+
+// monotonically increasing count
+class Counter
+{
+public:
+    void inc(uint64_t n = 1) { shards_[metrics_detail::shard_index()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+private:
+    metrics_detail::PaddedCounter shards_[metrics_detail::kShards];
+};
+
+// value that goes up and down (queue depth, resident models)
+class Gauge
+{
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// HDR-style log-linear histogram of non-negative integers (latencies in
+// microseconds). values below 64 are exact, above that every power of two is split
+// into 32 linear buckets, so any quantile is within ~3% of the recorded value
+class Histogram
+{
+public:
+    static constexpr unsigned kSubBits = 6;
+    static constexpr unsigned kMaxBits = 40;                 // values clamp at 2^40 - 1 (~12 days in us)
+    static constexpr std::size_t kBuckets = (kMaxBits - kSubBits + 2) << (kSubBits - 1);
+
+    Histogram();
+
+    void record(uint64_t value);
+
+    uint64_t count() const;
+    uint64_t sum() const;
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    // value at quantile q in [0, 1] (bucket midpoint, exact max for q = 1), 0 when empty
+    double quantile(double q) const;
+
+    static std::size_t bucket_of(uint64_t value);
+    static uint64_t bucket_lower(std::size_t bucket);
+    static uint64_t bucket_upper(std::size_t bucket);        // inclusive
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> buckets[kBuckets];
+    };
+
+    static constexpr std::size_t kHistogramShards = 4;       // buckets are large, fewer stripes than counters
+    std::unique_ptr<Shard[]> shards_;
+    std::atomic<uint64_t> max_{0};
+};
+
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry& instance();
+
+    // get or create; the returned reference stays valid for the registry's lifetime,
+    // so hot paths look a metric up once and keep the pointer. a name keeps the type
+    // and help text it was first registered with
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    // histograms export as a Prometheus summary (quantiles, _sum, _count); recorded
+    // values are multiplied by `scale` on export, e.g. 1e-6 for microseconds -> seconds
+    Histogram& histogram(const std::string& name, const std::string& help, const MetricLabels& labels = {}, double scale = 1e-6);
+
+    void write_prometheus(std::ostream& out) const;
+
+    // dump for a textfile collector, written to a temporary and renamed into place
+    void write_prometheus(const std::string& path) const;
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Family
+    {
+        Type type;
+        std::string help;
+        double scale = 1.0;
+        std::map<std::string, std::unique_ptr<Counter>> counters;      // keyed by rendered labels
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const std::string& name, Type type, const std::string& help);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+#endif
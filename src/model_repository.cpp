@@ -0,0 +1,453 @@
+#include "model_repository.h"
+#include "graph_optimizer.h"
+#include "inference_engine.h"
+#include "logger.h"
+#include "onnx_parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// "<digits>.onnx" -> version, 0 otherwise
+int64_t version_of(const fs::path& file)
+{
+    const std::string stem = file.stem().string();
+    if (file.extension() != ".onnx" || stem.empty() || stem.size() > 18) return 0;
+    for (char c : stem)
+        if (c < '0' || c > '9') return 0;
+    return std::stoll(stem);
+}
+
+// a pinned version has to be the one that is served
+void check_served(const std::string& name, int64_t version, const LoadedModel& model)
+{
+    if (version != 0 && version != model.version)
+    {
+        throw std::runtime_error("Model '" + name + "' version " + std::to_string(version) + " is not served, current version is " +
+                                 std::to_string(model.version) + ".");
+    }
+}
+
+// one run on zeros, so lazy allocations and first-touch page faults happen before traffic
+void warm_up(LoadedModel& model)
+{
+    Graph& graph = model.graph;
+
+    // every input in its declared dtype and shape, dynamic dims as 1. inputs without
+    // a declared shape fall back to the [1, 1, H, W] guess from the weights
+    std::vector<AnyTensor> inputs;
+    for (std::size_t i = 0; i < graph.get_input_size(); ++i)
+    {
+        const ValueInfo& info = graph.get_input_info(i);
+        std::vector<std::size_t> shape;
+        if (info.has_shape)
+            for (int64_t d : info.shape) shape.push_back(d > 0 ? static_cast<std::size_t>(d) : 1);
+        else
+            shape = {1, 1, static_cast<std::size_t>(graph.get_input_height()), static_cast<std::size_t>(graph.get_input_width())};
+
+        inputs.emplace_back(info.dtype, shape);
+        std::memset(inputs.back().raw(), 0, inputs.back().bytes());
+    }
+    std::vector<AnyTensor*> bound;
+    for (AnyTensor& input : inputs) bound.push_back(&input);
+
+    InferenceEngine engine;
+    engine.set_record_metrics(false);
+    try
+    {
+        engine.run(graph, bound);
+    }
+    catch (const std::exception& e)
+    {
+        // zeros or a guessed shape may not be valid input, a failure here does not condemn the model
+        INFERA_LOG_WARN("warm-up of %s version %lld skipped: %s", model.name.c_str(), static_cast<long long>(model.version), e.what());
+    }
+}
+
+}
+
+std::vector<const AnyTensor*> LoadedModel::run(InferenceEngine& engine, const std::vector<AnyTensor*>& inputs, CachedOutputs& held)
+{
+    if (!cache && postprocess.empty())
+    {
+        std::vector<AnyTensor*> outputs = engine.run(graph, inputs);
+        return {outputs.begin(), outputs.end()};
+    }
+
+    CacheKey key;
+    if (cache)
+    {
+        key = ResultCache::key(inputs);
+        held = cache->lookup(key);
+    }
+    if (!held)
+    {
+        if (postprocess.empty())
+        {
+            held = std::make_shared<const std::vector<AnyTensor>>(engine.run_owned(graph, inputs));
+        }
+        else
+        {
+            std::vector<AnyTensor*> outputs = engine.run(graph, inputs);
+            if (outputs.empty()) throw std::runtime_error("No output from engine.");
+            held = std::make_shared<const std::vector<AnyTensor>>(postprocess.apply(*outputs[0]));
+        }
+        if (cache) cache->insert(key, held);
+    }
+
+    std::vector<const AnyTensor*> outputs;
+    for (const AnyTensor& tensor : *held) outputs.push_back(&tensor);
+    return outputs;
+}
+
+std::size_t LoadedModel::output_count() const
+{
+    return postprocess.empty() ? graph.get_output_size() : Postprocessor::output_names().size();
+}
+
+const std::string& LoadedModel::output_name(std::size_t i) const
+{
+    return postprocess.empty() ? graph.get_output_name(i) : Postprocessor::output_names()[i];
+}
+
+ValueInfo LoadedModel::output_info(std::size_t i) const
+{
+    return postprocess.empty() ? graph.get_output_info(i) : postprocess.output_info(i);
+}
+
+ModelRepository::ModelRepository(const std::string& root, std::size_t memory_budget) : root_(root), memory_budget_(memory_budget)
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    loads_ = &registry.counter("infera_repository_loads_total", "Models loaded into memory", {{"root", root}});
+    evictions_ = &registry.counter("infera_repository_evictions_total", "Models evicted under the memory budget", {{"root", root}});
+    swaps_ = &registry.counter("infera_repository_swaps_total", "Model versions hot-swapped in", {{"root", root}});
+    resident_gauge_ = &registry.gauge("infera_repository_resident_bytes", "Weight memory of resident models", {{"root", root}});
+    scan();
+}
+
+ModelRepository::~ModelRepository()
+{
+    std::vector<ModelFuture> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(background_);
+    }
+    for (auto& future : pending) future.wait();
+}
+
+std::size_t ModelRepository::scan()
+{
+    if (!fs::is_directory(root_)) throw std::runtime_error("Model repository '" + root_ + "' is not a directory.");
+
+    std::unordered_map<std::string, std::map<int64_t, std::string>> found;
+    for (const auto& item : fs::directory_iterator(root_))
+    {
+        const fs::path& path = item.path();
+        if (item.is_regular_file() && path.extension() == ".onnx")
+        {
+            found[path.stem().string()][1] = path.string();
+        }
+        else if (item.is_directory())
+        {
+            for (const auto& file : fs::directory_iterator(path))
+            {
+                int64_t version = file.is_regular_file() ? version_of(file.path()) : 0;
+                if (version > 0) found[path.filename().string()][version] = file.path().string();
+            }
+        }
+    }
+
+    std::vector<std::string> outdated;
+    std::size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // forget removed models, resident copies stay with whoever holds them
+        for (auto it = entries_.begin(); it != entries_.end();)
+        {
+            const bool swapping = it->second.swapping.valid() && it->second.swapping.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+            if (found.count(it->first) || it->second.loading.valid() || swapping)
+            {
+                ++it;
+                continue;
+            }
+            if (it->second.model)
+            {
+                resident_bytes_ -= it->second.model->bytes;
+                lru_.erase(it->second.lru);
+            }
+            it = entries_.erase(it);
+        }
+
+        for (auto& [name, versions] : found)
+        {
+            Entry& entry = entries_[name];
+            entry.versions = std::move(versions);
+            if (entry.model && entry.versions.rbegin()->first > entry.model->version) outdated.push_back(name);
+        }
+        resident_gauge_->set(static_cast<int64_t>(resident_bytes_));
+        count = entries_.size();
+    }
+
+    for (const auto& name : outdated) swap(name);
+    return count;
+}
+
+std::vector<std::string> ModelRepository::available() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    for (const auto& entry : entries_) names.push_back(entry.first);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool ModelRepository::contains(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(name) > 0;
+}
+
+std::vector<int64_t> ModelRepository::versions(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int64_t> out;
+    auto it = entries_.find(name);
+    if (it != entries_.end())
+        for (const auto& v : it->second.versions) out.push_back(v.first);
+    return out;
+}
+
+std::shared_ptr<LoadedModel> ModelRepository::load_model(const std::string& name, const std::string& path, int64_t version)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    auto model = std::make_shared<LoadedModel>();
+    model->name = name;
+    model->version = version;
+    model->path = path;
+    model->postprocess = Postprocessor::for_model(path);
+
+    OnnxParser parser;
+    parser.parse(model->graph, path);
+    model->graph.set_name(name);
+    GraphOptimizer::optimize(model->graph);
+    model->graph.infer_input_size();
+    model->graph.topological_sort();                        // cached, later runs only read it
+    model->bytes = model->graph.initializer_bytes();
+    warm_up(*model);
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    INFERA_LOG_INFO("loaded model %s version %lld (%zu KiB) in %.1f ms", name.c_str(), static_cast<long long>(version), model->bytes / 1024, elapsed.count());
+    return model;
+}
+
+// load_model plus the repository's per-version settings
+std::shared_ptr<LoadedModel> ModelRepository::load(const std::string& name, const std::string& path, int64_t version) const
+{
+    std::shared_ptr<LoadedModel> model = load_model(name, path, version);
+    if (const std::size_t cache_bytes = result_cache_bytes_.load())
+    {
+        model->cache = std::make_unique<ResultCache>(name, cache_bytes);
+        model->bytes += cache_bytes;
+    }
+    return model;
+}
+
+// file of `version`, 0 picks the highest and is replaced by it
+const std::string& ModelRepository::version_path(const Entry& entry, const std::string& name, int64_t& version) const
+{
+    if (version == 0) version = entry.versions.rbegin()->first;
+    auto it = entry.versions.find(version);
+    if (it == entry.versions.end()) throw std::runtime_error("Model '" + name + "' has no version " + std::to_string(version) + ".");
+    return it->second;
+}
+
+std::shared_ptr<LoadedModel> ModelRepository::get(const std::string& name, int64_t version)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end()) throw std::runtime_error("Model '" + name + "' is not in the repository.");
+
+    Entry& entry = it->second;
+    if (entry.model)
+    {
+        check_served(name, version, *entry.model);
+        lru_.splice(lru_.begin(), lru_, entry.lru);          // mark most recently used
+        return entry.model;
+    }
+
+    // someone else is loading it: wait for their result without holding the lock
+    if (entry.loading.valid())
+    {
+        auto pending = entry.loading;
+        lock.unlock();
+        auto model = pending.get();
+        check_served(name, version, *model);
+        return model;
+    }
+
+    // the highest version is served however the first request is pinned
+    int64_t load_version = 0;
+    const std::string path = version_path(entry, name, load_version);
+
+    std::promise<std::shared_ptr<LoadedModel>> promise;
+    entry.loading = promise.get_future().share();
+    lock.unlock();
+
+    std::shared_ptr<LoadedModel> model;
+    try
+    {
+        model = load(name, path, load_version);
+    }
+    catch (...)
+    {
+        lock.lock();
+        entries_[name].loading = {};
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    model = publish(name, std::move(model), false);
+    loads_->inc();
+    promise.set_value(model);
+    check_served(name, version, *model);                    // a swap may have published another version
+    return model;
+}
+
+// make `model` the served version of `name`, returns what is served afterwards. a
+// first load (replace = false) ends here, under the same lock that makes it visible,
+// and defers to a version a swap published meanwhile
+std::shared_ptr<LoadedModel> ModelRepository::publish(const std::string& name, std::shared_ptr<LoadedModel> model, bool replace)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[name];                          // a rescan may have rehashed the map
+
+    if (!replace) entry.loading = {};
+    if (entry.model && !replace) return entry.model;
+    if (entry.model)
+    {
+        // the old version stays alive until its last in-flight request lets go
+        resident_bytes_ -= entry.model->bytes;
+        lru_.splice(lru_.begin(), lru_, entry.lru);
+    }
+    else
+    {
+        lru_.push_front(name);
+        entry.lru = lru_.begin();
+    }
+    entry.model = std::move(model);
+    resident_bytes_ += entry.model->bytes;
+
+    evict_locked(name);
+    resident_gauge_->set(static_cast<int64_t>(resident_bytes_));
+    return entry.model;
+}
+
+std::shared_future<std::shared_ptr<LoadedModel>> ModelRepository::swap(const std::string& name, int64_t version)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end()) throw std::runtime_error("Model '" + name + "' is not in the repository.");
+
+    Entry& entry = it->second;
+    const std::string path = version_path(entry, name, version);
+
+    // a running swap: joined when it publishes this version, waited for otherwise
+    // so the swaps publish in the order they were asked for
+    ModelFuture previous;
+    if (entry.swapping.valid() && entry.swapping.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        if (entry.swapping_version == version) return entry.swapping;
+        previous = entry.swapping;
+    }
+
+    ModelFuture future = std::async(std::launch::async, [this, name, path, version, previous]
+    {
+        if (previous.valid()) previous.wait();
+
+        std::shared_ptr<LoadedModel> model;
+        try
+        {
+            model = load(name, path, version);
+        }
+        catch (const std::exception& e)
+        {
+            INFERA_LOG_ERROR("swap of %s to version %lld failed, keeping the current version: %s", name.c_str(), static_cast<long long>(version), e.what());
+            throw;
+        }
+
+        std::shared_ptr<LoadedModel> old;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            old = entries_[name].model;
+        }
+        model = publish(name, std::move(model), true);
+        swaps_->inc();
+        INFERA_LOG_INFO("serving %s version %lld (was %lld)", name.c_str(), static_cast<long long>(version), old ? static_cast<long long>(old->version) : 0ll);
+        return model;
+    }).share();
+
+    // drop finished swaps, keep the rest for the destructor
+    background_.erase(std::remove_if(background_.begin(), background_.end(), [](const ModelFuture& f)
+    {
+        return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), background_.end());
+    background_.push_back(future);
+
+    entry.swapping = future;
+    entry.swapping_version = version;
+    return future;
+}
+
+// drop least recently used models until under budget, never the one just requested
+void ModelRepository::evict_locked(const std::string& keep)
+{
+    if (memory_budget_ == 0) return;
+
+    auto it = lru_.end();
+    while (resident_bytes_ > memory_budget_ && it != lru_.begin())
+    {
+        --it;
+        if (*it == keep) continue;
+
+        Entry& victim = entries_[*it];
+        INFERA_LOG_INFO("evicting model %s (%zu KiB) to stay under the %zu KiB budget", it->c_str(), victim.model->bytes / 1024, memory_budget_ / 1024);
+        resident_bytes_ -= victim.model->bytes;
+        victim.model.reset();
+        evictions_->inc();
+        it = lru_.erase(it);
+    }
+}
+
+bool ModelRepository::unload(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end() || !it->second.model) return false;
+
+    resident_bytes_ -= it->second.model->bytes;
+    lru_.erase(it->second.lru);
+    it->second.model.reset();
+    resident_gauge_->set(static_cast<int64_t>(resident_bytes_));
+    return true;
+}
+
+std::vector<std::string> ModelRepository::resident() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<std::string>(lru_.begin(), lru_.end());
+}
+
+std::size_t ModelRepository::resident_bytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resident_bytes_;
+}
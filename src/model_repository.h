@@ -0,0 +1,134 @@
+#ifndef MODEL_REPOSITORY_H
+#define MODEL_REPOSITORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "graph.h"
+#include "inference_engine.h"
+#include "metrics.h"
+#include "postprocess.h"
+#include "result_cache.h"
+
+// a parsed, optimized and warmed model version, shared by every request running
+// it. the graph is topologically sorted at load, so concurrent runs only read it
+struct LoadedModel
+{
+    std::string name;
+    int64_t version = 1;
+    std::string path;
+    Graph graph;
+    std::size_t bytes = 0;                                  // resident weight memory, plus the cache budget
+    std::unique_ptr<ResultCache> cache;                     // null unless the repository caches results
+    Postprocessor postprocess;                              // from the model's .postprocess file, if any
+
+    // run on `engine`, or answer from the cache when it holds these exact inputs.
+    // with a postprocessing head the outputs are its classes and scores, and the
+    // cache stores those. outputs stay valid while `held` does when it is set,
+    // otherwise until the engine's next run
+    std::vector<const AnyTensor*> run(InferenceEngine& engine, const std::vector<AnyTensor*>& inputs, CachedOutputs& held);
+
+    // what run() returns: the graph's outputs or the head's
+    std::size_t output_count() const;
+    const std::string& output_name(std::size_t i) const;
+    ValueInfo output_info(std::size_t i) const;
+};
+
+// directory of ONNX models served from one process. a model is either a single
+// file <root>/<name>.onnx (version 1) or a directory of versions
+// <root>/<name>/<version>.onnx, the highest of which is served.
+//
+// models are loaded on first use and the least recently used ones are dropped once
+// resident memory passes the budget. new versions are swapped in RCU-style: the
+// version is loaded and warmed in the background while the old one keeps serving,
+// then the published pointer is replaced. handles are shared_ptrs, so requests
+// already running finish on the version they started with, and that version is
+// freed when the last of them drops its handle
+class ModelRepository
+{
+public:
+    // budget 0 means unlimited
+    explicit ModelRepository(const std::string& root, std::size_t memory_budget = 0);
+    ~ModelRepository();                                     // waits for background swaps
+
+    ModelRepository(const ModelRepository&) = delete;
+    ModelRepository& operator=(const ModelRepository&) = delete;
+
+    // rescan the directory. resident models whose directory gained a newer version
+    // are hot-swapped to it in the background. returns the number of models
+    std::size_t scan();
+
+    // model names found by the last scan, sorted
+    std::vector<std::string> available() const;
+    bool contains(const std::string& name) const;
+    std::vector<int64_t> versions(const std::string& name) const;
+
+    // handle to the served version, loading it now if needed. concurrent first
+    // requests for one model share a single load, which is always of the highest
+    // version. a nonzero `version` must be the one being served. throws if the name
+    // is unknown, the version is not served or the load fails
+    std::shared_ptr<LoadedModel> get(const std::string& name, int64_t version = 0);
+
+    // load `version` (0 = highest on disk) in the background, warm it and publish
+    // it. requests keep getting the current version until then; if the load fails
+    // the current version stays and the future holds the error. a swap requested
+    // while one to the same version is running shares it, one to another version
+    // starts after it
+    std::shared_future<std::shared_ptr<LoadedModel>> swap(const std::string& name, int64_t version = 0);
+
+    // drop a resident model (in-flight handles keep it alive), false if not resident
+    bool unload(const std::string& name);
+
+    std::vector<std::string> resident() const;              // most recently used first
+    std::size_t resident_bytes() const;
+    std::size_t memory_budget() const { return memory_budget_; }
+
+    // give every version loaded from now on an exact-match result cache of `bytes`
+    // (0 turns caching off); it counts against the memory budget
+    void set_result_cache_bytes(std::size_t bytes) { result_cache_bytes_ = bytes; }
+
+    // parse, optimize and warm one file, outside of any repository
+    static std::shared_ptr<LoadedModel> load_model(const std::string& name, const std::string& path, int64_t version = 1);
+private:
+    using ModelFuture = std::shared_future<std::shared_ptr<LoadedModel>>;
+
+    struct Entry
+    {
+        std::map<int64_t, std::string> versions;            // version -> file
+        std::shared_ptr<LoadedModel> model;                 // published version, null while not resident
+        ModelFuture loading;                                // first load in progress
+        ModelFuture swapping;                               // background swap in progress
+        int64_t swapping_version = 0;                       // the version it publishes
+        std::list<std::string>::iterator lru;               // valid while resident
+    };
+
+    std::shared_ptr<LoadedModel> load(const std::string& name, const std::string& path, int64_t version) const;
+    const std::string& version_path(const Entry& entry, const std::string& name, int64_t& version) const;
+    std::shared_ptr<LoadedModel> publish(const std::string& name, std::shared_ptr<LoadedModel> model, bool replace);
+    void evict_locked(const std::string& keep);
+
+    std::string root_;
+    std::size_t memory_budget_;
+    std::atomic<std::size_t> result_cache_bytes_{0};
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;                            // resident names, front is most recent
+    std::size_t resident_bytes_ = 0;
+    std::vector<ModelFuture> background_;                   // swaps to wait for on destruction
+
+    Counter* loads_;
+    Counter* evictions_;
+    Counter* swaps_;
+    Gauge* resident_gauge_;
+};
+
+#endif
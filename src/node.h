@@ -30,6 +30,9 @@ public:
     void add_inputs(std::string input) { inputs_.push_back(input);}
     void add_outputs(std::string output) {outputs_.push_back(output);};
     void set_name(const std::string& name) { name_ = name; }
+    void set_optype(const std::string& optype) { optype_ = optype; }
+    void set_input(std::size_t index, const std::string& input) { inputs_.at(index) = input; }
+    void set_output(std::size_t index, const std::string& output) { outputs_.at(index) = output; }
     
     template <typename T>
     std::optional<T> get_attribute(const std::string &name) const
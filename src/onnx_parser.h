@@ -3,11 +3,11 @@
 
 #include <string>
 #include <fstream>
-#include <iostream>
 #include <stdexcept>
 
 #include "onnx-ml.pb.h" 
 #include "graph.h"
+#include "logger.h"
 
 class OnnxParser 
 {
@@ -29,44 +29,24 @@ public:
         }
 
         const onnx::GraphProto& graph_proto = model_proto.graph();
-        std::cout << "Parsing Graph: " << graph_proto.name() << "\n";
+        INFERA_LOG_INFO("parsing graph %s from %s", graph_proto.name().c_str(), model_path.c_str());
+        graph.set_name(graph_proto.name());
 
-        // add input and output
+        // load initializers, each in its declared data type
+        for (const auto& initializer : graph_proto.initializer()) 
+        {
+            graph.add_initializer(initializer.name(), load_tensor_proto(initializer)); 
+        }
 
+        // add input and output, skipping initializers older exporters list as inputs
         for (const auto& input : graph_proto.input()) 
         {
-            graph.add_input(input.name()); 
+            if (!graph.has_initializer(input.name())) graph.add_input(input.name(), load_value_info(input)); 
         }
 
         for (const auto& output : graph_proto.output()) 
         {
-            graph.add_output(output.name());
-        }
-    
-        // load initializers
-        for (const auto& initializer : graph_proto.initializer()) 
-        {
-            std::vector<size_t> dims;
-            for (auto d : initializer.dims()) dims.push_back(d);
-            
-
-            auto* tensor = new Tensor<float>(dims);
-            
-
-            if (initializer.has_raw_data())  // handle raw data
-            {
-                const std::string& raw = initializer.raw_data();
-                std::memcpy(tensor->data(), raw.data(), raw.size());
-            }  
-            else // handle float data
-            {
-                for(int i=0; i<initializer.float_data_size(); ++i) 
-                {
-                    tensor->data()[i] = initializer.float_data(i);
-                }
-            }
-            
-            graph.add_initializer(initializer.name(), tensor); 
+            graph.add_output(output.name(), load_value_info(output));
         }
 
         // load nodes
@@ -1,17 +1,68 @@
 #ifndef OPERATOR_H
 #define OPERATOR_H
 
+#include <stdexcept>
 #include <vector>
 #include <string>
 #include "tensor.h"
+#include "any_tensor.h"
 #include "node.h"
+#include "kernels/kernels.h"
 
 class Operator 
 {
 public:
     virtual ~Operator() = default;                                                                                // virtual destructor
     virtual void set_attributes(const Node& node) { (void)node; }                                                 // load settings
-    virtual void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) = 0; // execute operator
+
+    // float32 compute path, implemented by most operators
+    virtual void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs)
+    {
+        (void)inputs;
+        (void)outputs;
+        throw std::runtime_error("operator has no float32 implementation");
+    }
+
+    // entry point used by the engine. the default hands float32 tensors to forward(),
+    // widening float16/bfloat16 inputs first; operators on other dtypes override it
+    virtual void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs)
+    {
+        std::vector<AnyTensor> widened(inputs.size());
+
+        std::vector<Tensor<float>*> float_inputs;
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+        {
+            float_inputs.push_back(inputs[i] ? float_input(*inputs[i], widened[i]) : nullptr);
+        }
+
+        std::vector<Tensor<float>*> float_outputs;
+        for (AnyTensor* output : outputs) float_outputs.push_back(&output->emplace<float>());
+
+        forward(float_inputs, float_outputs);
+    }
+
+protected:
+    // float32 contents of a float or half precision tensor, widened into `scratch` when needed
+    static Tensor<float>* float_input(AnyTensor& input, AnyTensor& scratch)
+    {
+        switch (input.dtype())
+        {
+        case DataType::Float32:
+            return &input.get<float>();
+        case DataType::Float16:
+        {
+            Tensor<float>& wide = scratch.emplace<float>();
+            wide.resize(input.shape());
+            kernels().half_to_float(half_bits(input.get<float16>().data()), wide.data(), wide.size());
+            return &wide;
+        }
+        case DataType::BFloat16:
+            scratch = input.cast(DataType::Float32);
+            return &scratch.get<float>();
+        default:
+            throw std::runtime_error(std::string("operator expects float tensors but got ") + data_type_name(input.dtype()) + ".");
+        }
+    }
 };
 
 #endif
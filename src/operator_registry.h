@@ -4,13 +4,29 @@
 #include <string>
 #include <memory>
 #include <stdexcept>
-#include <iostream>
 
 #include "operator.h"
+#include "logger.h"
+#include "ops/conv.h"
 #include "ops/flatten.h"
 #include "ops/gemm.h"
+#include "ops/matmul.h"
 #include "ops/relu.h"
 #include "ops/add.h"
+#include "ops/batch_norm.h"
+#include "ops/sigmoid.h"
+#include "ops/tanh.h"
+#include "ops/gelu.h"
+#include "ops/silu.h"
+#include "ops/softmax.h"
+#include "ops/transpose.h"
+#include "ops/pool.h"
+#include "ops/nchwc.h"
+#include "ops/sparse_gemm.h"
+#include "ops/reshape.h"
+#include "ops/shape.h"
+#include "ops/gather.h"
+#include "ops/cast.h"
 
 class OperatorRegistry
 {
@@ -22,6 +38,10 @@ public:
         {
             return std::make_unique<AddOperator>();
         }
+        else if (type == "BatchNormalization")
+        {
+            return std::make_unique<BatchNormalizationOperator>();
+        }
         if (type == "Flatten") 
         {
             return std::make_unique<FlattenOperator>();
@@ -30,11 +50,104 @@ public:
         {
             return std::make_unique<GemmOperator>();
         }
+        else if (type == "MatMul")
+        {
+            return std::make_unique<MatMulOperator>();
+        }
         else if (type == "Relu")
         {
             return std::make_unique<ReluOperator>();
         }
-        std::cerr << "Warning: Operator '" << type << "' not implemented yet." << std::endl; // else operator isn't registered/supported yet
+        else if (type == "Sigmoid")
+        {
+            return std::make_unique<SigmoidOperator>();
+        }
+        else if (type == "Tanh")
+        {
+            return std::make_unique<TanhOperator>();
+        }
+        else if (type == "Gelu")
+        {
+            return std::make_unique<GeluOperator>();
+        }
+        else if (type == "Silu")
+        {
+            return std::make_unique<SiluOperator>();
+        }
+        else if (type == "Softmax")
+        {
+            return std::make_unique<SoftmaxOperator>();
+        }
+        else if (type == "LogSoftmax")
+        {
+            return std::make_unique<LogSoftmaxOperator>();
+        }
+        else if (type == "Transpose")
+        {
+            return std::make_unique<TransposeOperator>();
+        }
+        else if (type == "Conv")
+        {
+            return std::make_unique<ConvOperator>();
+        }
+        else if (type == "MaxPool")
+        {
+            return std::make_unique<MaxPoolOperator>();
+        }
+        else if (type == "AveragePool")
+        {
+            return std::make_unique<AveragePoolOperator>();
+        }
+        else if (type == "GlobalAveragePool")
+        {
+            return std::make_unique<GlobalAveragePoolOperator>();
+        }
+        else if (type == "Reshape")
+        {
+            return std::make_unique<ReshapeOperator>();
+        }
+        else if (type == "Shape")
+        {
+            return std::make_unique<ShapeOperator>();
+        }
+        else if (type == "Gather")
+        {
+            return std::make_unique<GatherOperator>();
+        }
+        else if (type == "Cast")
+        {
+            return std::make_unique<CastOperator>();
+        }
+        // internal blocked-layout operators, inserted by the optimizer
+        else if (type == "ReorderInput")
+        {
+            return std::make_unique<ReorderInputOperator>();
+        }
+        else if (type == "ReorderOutput")
+        {
+            return std::make_unique<ReorderOutputOperator>();
+        }
+        else if (type == "NchwcConv")
+        {
+            return std::make_unique<NchwcConvOperator>();
+        }
+        else if (type == "NchwcMaxPool")
+        {
+            return std::make_unique<NchwcPoolOperator>(NchwcPoolOperator::Kind::Max);
+        }
+        else if (type == "NchwcAveragePool")
+        {
+            return std::make_unique<NchwcPoolOperator>(NchwcPoolOperator::Kind::Average);
+        }
+        else if (type == "SparseGemm")
+        {
+            return std::make_unique<SparseGemmOperator>();
+        }
+        else if (type == "NchwcGlobalAveragePool")
+        {
+            return std::make_unique<NchwcPoolOperator>(NchwcPoolOperator::Kind::GlobalAverage);
+        }
+        INFERA_LOG_WARN_ONCE("unimplemented:" + type, "operator '%s' not implemented yet", type.c_str()); // else operator isn't registered/supported yet
         return nullptr;
     }
 };
@@ -2,6 +2,9 @@
 #define OPS_ADD_H
 
 #include "../operator.h"
+#include "../broadcast.h"
+#include "../kernels/kernels.h"
+#include <algorithm>
 #include <stdexcept>
 
 class AddOperator : public Operator
@@ -16,33 +19,35 @@ public:
         
         const Tensor<float>* A = inputs[0];
         const Tensor<float>* B = inputs[1];
-
-        // check shape (ONNX does broadcasting, will impl later)
-        if (A->shape() != B->shape()) 
-        {
-            throw std::runtime_error("Add operator currently requires inputs to have identical shapes.");
-        }
-
-        // prep output
-        Tensor<float>* Y = new Tensor<float>(A->shape());
-        outputs.push_back(Y);
+        Tensor<float>* Y = outputs[0];
 
         // raw pointers
         const float* a_ptr = A->data();
         const float* b_ptr = B->data();
-        float* y_ptr       = Y->data();
 
-        std::size_t total_elements = 1;
-
-        for (std::size_t dim : A->shape()) 
+        // same shape: one flat pass
+        if (A->shape() == B->shape()) 
         {
-            total_elements *= dim;
+            Y->resize(A->shape());
+            kernels().add(a_ptr, b_ptr, Y->data(), A->size());
+            return;
         }
 
-        for (std::size_t i = 0; i < total_elements; ++i) 
+        // ONNX multidirectional broadcasting, e.g. bias [C,1,1] onto [N,C,H,W]
+        Y->resize(broadcast_shape(A->shape(), B->shape()));
+        float* y_ptr = Y->data();
+
+        for_each_broadcast_run(A->shape(), B->shape(), [&](std::size_t a_off, std::size_t b_off, std::size_t y_off, std::size_t n, std::size_t a_step, std::size_t b_step)
         {
-            y_ptr[i] = a_ptr[i] + b_ptr[i];
-        }
+            if (a_step && b_step)
+                kernels().add(a_ptr + a_off, b_ptr + b_off, y_ptr + y_off, n);
+            else if (a_step)
+                kernels().add_scalar(a_ptr + a_off, b_ptr[b_off], y_ptr + y_off, n);
+            else if (b_step)
+                kernels().add_scalar(b_ptr + b_off, a_ptr[a_off], y_ptr + y_off, n);
+            else
+                std::fill(y_ptr + y_off, y_ptr + y_off + n, a_ptr[a_off] + b_ptr[b_off]);
+        });
     }
 };
 
@@ -0,0 +1,75 @@
+#ifndef OPS_BATCH_NORM_H
+#define OPS_BATCH_NORM_H
+
+#include "../operator.h"
+#include "../kernels/kernels.h"
+#include <cmath>
+#include <stdexcept>
+
+// inference mode: y = scale * (x - mean) / sqrt(var + epsilon) + B per channel (axis 1),
+// applied as one fused multiply-add. usually folded away by GraphOptimizer
+class BatchNormalizationOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        epsilon_ = node.get_attribute<float>("epsilon").value_or(1e-5f);
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        if (inputs.size() < 5)
+        {
+            throw std::runtime_error("BatchNormalization operator expects 5 inputs (X, scale, B, mean, var).");
+        }
+
+        const Tensor<float>* X = inputs[0];
+        const std::vector<std::size_t>& shape = X->shape();
+        if (shape.size() < 2)
+        {
+            throw std::runtime_error("BatchNormalization operator: input must have a channel dimension.");
+        }
+
+        const std::size_t batch = shape[0];
+        const std::size_t channels = shape[1];
+        std::size_t spatial = 1;
+        for (std::size_t i = 2; i < shape.size(); ++i) spatial *= shape[i];
+
+        for (std::size_t i = 1; i < 5; ++i)
+        {
+            if (inputs[i]->size() != channels)
+            {
+                throw std::runtime_error("BatchNormalization operator: parameter size does not match channel count.");
+            }
+        }
+
+        const float* scale = inputs[1]->data();
+        const float* bias  = inputs[2]->data();
+        const float* mean  = inputs[3]->data();
+        const float* var   = inputs[4]->data();
+
+        Tensor<float>* Y = outputs[0];
+        Y->resize(shape);
+
+        const float* x = X->data();
+        float* y = Y->data();
+
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            // per-channel affine transform
+            const float a = scale[c] / std::sqrt(var[c] + epsilon_);
+            const float b = bias[c] - mean[c] * a;
+
+            for (std::size_t n = 0; n < batch; ++n)
+            {
+                std::size_t offset = (n * channels + c) * spatial;
+                kernels().scale_shift(x + offset, a, b, y + offset, spatial);
+            }
+        }
+    }
+
+private:
+    float epsilon_ = 1e-5f;
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef OPS_CAST_H
+#define OPS_CAST_H
+
+#include "../operator.h"
+#include <stdexcept>
+
+class CastOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        auto to = node.get_attribute<int64_t>("to");
+        if (!to) throw std::runtime_error("Cast operator: missing 'to' attribute.");
+        if (!data_type_from_onnx(static_cast<int32_t>(*to), to_))
+        {
+            throw std::runtime_error("Cast operator: unsupported target type " + std::to_string(*to) + ".");
+        }
+    }
+
+    void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs) override
+    {
+        AnyTensor* input = inputs[0];
+
+        // same dtype is a no-op view
+        if (input->dtype() == to_)
+        {
+            outputs[0]->view_of(*input, input->shape());
+            return;
+        }
+        *outputs[0] = input->cast(to_);
+    }
+
+private:
+    DataType to_ = DataType::Float32;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef OPS_CONV_H
+#define OPS_CONV_H
+
+#include "../operator.h"
+#include "../conv_geometry.h"
+#include "../thread_pool.h"
+#include "../kernels/kernels.h"
+#include <algorithm>
+#include <stdexcept>
+
+// 2-D convolution on NCHW tensors: im2col followed by one GEMM per group
+class ConvOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        window_.parse(node);
+        group_ = static_cast<std::size_t>(node.get_attribute<int64_t>("group").value_or(1));
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* X = inputs[0];
+        const Tensor<float>* W = inputs[1];
+        const Tensor<float>* B = inputs.size() > 2 ? inputs[2] : nullptr;
+        Tensor<float>* Y = outputs[0];
+
+        if (X->shape().size() != 4 || W->shape().size() != 4)
+        {
+            throw std::runtime_error("Conv operator: only 2-D convolution (4-D input and weights) is supported.");
+        }
+
+        const std::size_t N = X->shape()[0], C = X->shape()[1], H = X->shape()[2], Wd = X->shape()[3];
+        const std::size_t M = W->shape()[0], Cg = W->shape()[1];
+        if (group_ == 0 || C != Cg * group_ || M % group_ != 0)
+        {
+            throw std::runtime_error("Conv operator: channels do not match weights for group " + std::to_string(group_) + ".");
+        }
+
+        const ConvGeometry g = window_.resolve(H, Wd, W->shape()[2], W->shape()[3]);
+        Y->resize({N, M, g.out_h, g.out_w});
+
+        const std::size_t Mg = M / group_;
+        const std::size_t K = Cg * g.kernel_h * g.kernel_w;        // GEMM depth
+        const std::size_t S = g.out_h * g.out_w;                   // output pixels
+
+        // a 1x1 window without stride or padding reads the input as is
+        const bool pointwise = g.kernel_h == 1 && g.kernel_w == 1 && g.stride_h == 1 && g.stride_w == 1 &&
+                               g.pad_top == 0 && g.pad_left == 0 && g.pad_bottom == 0 && g.pad_right == 0;
+        if (!pointwise) col_.resize(K * S);
+
+        for (std::size_t n = 0; n < N; ++n)
+        {
+            for (std::size_t grp = 0; grp < group_; ++grp)
+            {
+                const float* x = X->data() + (n * C + grp * Cg) * H * Wd;
+                const float* cols = x;
+                if (!pointwise)
+                {
+                    im2col(x, Cg, H, Wd, g, col_.data());
+                    cols = col_.data();
+                }
+
+                float* y = Y->data() + (n * M + grp * Mg) * S;
+                gemm_columns(Mg, S, K, W->data() + grp * Mg * K, cols, y);
+
+                if (B)
+                {
+                    for (std::size_t m = 0; m < Mg; ++m)
+                        kernels().add_scalar(y + m * S, B->data()[grp * Mg + m], y + m * S, S);
+                }
+            }
+        }
+    }
+
+private:
+    // col[(c * kh + i) * kw + j][oh * out_w + ow] = x[c][ih][iw], zero in the padding
+    static void im2col(const float* x, std::size_t C, std::size_t H, std::size_t W, const ConvGeometry& g, float* col)
+    {
+        for (std::size_t c = 0; c < C; ++c)
+        {
+            for (std::size_t i = 0; i < g.kernel_h; ++i)
+            {
+                for (std::size_t j = 0; j < g.kernel_w; ++j)
+                {
+                    float* dst = col + ((c * g.kernel_h + i) * g.kernel_w + j) * g.out_h * g.out_w;
+                    for (std::size_t oh = 0; oh < g.out_h; ++oh)
+                    {
+                        long ih = static_cast<long>(oh * g.stride_h + i * g.dilation_h) - static_cast<long>(g.pad_top);
+                        float* row = dst + oh * g.out_w;
+                        if (ih < 0 || ih >= static_cast<long>(H))
+                        {
+                            std::fill(row, row + g.out_w, 0.0f);
+                            continue;
+                        }
+                        const float* src = x + (c * H + ih) * W;
+                        for (std::size_t ow = 0; ow < g.out_w; ++ow)
+                        {
+                            long iw = static_cast<long>(ow * g.stride_w + j * g.dilation_w) - static_cast<long>(g.pad_left);
+                            row[ow] = iw < 0 || iw >= static_cast<long>(W) ? 0.0f : src[iw];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Y[M x S] = W[M x K] * cols[K x S], large problems split by output columns
+    static void gemm_columns(std::size_t M, std::size_t S, std::size_t K, const float* W, const float* cols, float* Y)
+    {
+        ThreadPool& pool = ThreadPool::instance();
+        const std::size_t block = 256;
+        if (pool.size() == 1 || S < 2 * block || M * S * K < (1u << 20))
+        {
+            kernels().sgemm(false, false, M, S, K, 1.0f, W, K, cols, S, 0.0f, Y, S);
+            return;
+        }
+
+        pool.parallel_for((S + block - 1) / block, [&](std::size_t begin, std::size_t end)
+        {
+            std::size_t s0 = begin * block;
+            std::size_t s1 = std::min(S, end * block);
+            kernels().sgemm(false, false, M, s1 - s0, K, 1.0f, W, K, cols + s0, S, 0.0f, Y + s0, S);
+        });
+    }
+
+    WindowAttributes window_;
+    std::size_t group_ = 1;
+    std::vector<float> col_;
+};
+
+#endif
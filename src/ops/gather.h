@@ -0,0 +1,62 @@
+#ifndef OPS_GATHER_H
+#define OPS_GATHER_H
+
+#include "../operator.h"
+#include <cstring>
+#include <stdexcept>
+
+class GatherOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        axis_ = node.get_attribute<int64_t>("axis").value_or(0);
+    }
+
+    // output shape = data[:axis] + indices + data[axis+1:], copied slice by slice
+    void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs) override
+    {
+        const AnyTensor* data = inputs[0];
+        const std::vector<int64_t> indices = inputs[1]->to_int64();
+        const std::vector<std::size_t>& shape = data->shape();
+        const int64_t rank = static_cast<int64_t>(shape.size());
+
+        int64_t axis = axis_ < 0 ? axis_ + rank : axis_;
+        if (axis < 0 || axis >= rank) throw std::runtime_error("Gather operator: axis " + std::to_string(axis_) + " out of range.");
+
+        std::size_t outer = 1, inner = 1;
+        for (int64_t i = 0; i < axis; ++i) outer *= shape[i];
+        for (int64_t i = axis + 1; i < rank; ++i) inner *= shape[i];
+        const std::size_t dim = shape[axis];
+
+        std::vector<std::size_t> out_shape(shape.begin(), shape.begin() + axis);
+        const std::vector<std::size_t>& index_shape = inputs[1]->shape();
+        out_shape.insert(out_shape.end(), index_shape.begin(), index_shape.end());
+        out_shape.insert(out_shape.end(), shape.begin() + axis + 1, shape.end());
+
+        AnyTensor* output = outputs[0];
+        output->reset_like(*data, out_shape);
+
+        const std::size_t slice = inner * data_type_size(data->dtype());
+        const char* src = static_cast<const char*>(data->raw());
+        char* dst = static_cast<char*>(output->raw());
+
+        for (std::size_t o = 0; o < outer; ++o)
+        {
+            for (std::size_t k = 0; k < indices.size(); ++k)
+            {
+                int64_t index = indices[k] < 0 ? indices[k] + static_cast<int64_t>(dim) : indices[k];
+                if (index < 0 || index >= static_cast<int64_t>(dim))
+                {
+                    throw std::runtime_error("Gather operator: index " + std::to_string(indices[k]) + " out of range for dim " + std::to_string(dim) + ".");
+                }
+                std::memcpy(dst + (o * indices.size() + k) * slice, src + (o * dim + index) * slice, slice);
+            }
+        }
+    }
+
+private:
+    int64_t axis_ = 0;
+};
+
+#endif
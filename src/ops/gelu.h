@@ -0,0 +1,36 @@
+#ifndef OPS_GELU_H
+#define OPS_GELU_H
+
+#include "../operator.h"
+#include "../kernels/kernels.h"
+#include <stdexcept>
+
+class GeluOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        // ONNX default is the exact erf form
+        std::string approximate = node.get_attribute<std::string>("approximate").value_or("none");
+        if (approximate != "none" && approximate != "tanh")
+        {
+            throw std::runtime_error("Gelu operator: unsupported approximate mode '" + approximate + "'.");
+        }
+        tanh_approximation_ = approximate == "tanh";
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* input = inputs[0];
+        Tensor<float>* output = outputs[0];
+        output->resize(input->shape());
+
+        auto kernel = tanh_approximation_ ? kernels().gelu_tanh : kernels().gelu;
+        kernel(input->data(), output->data(), input->size());
+    }
+
+private:
+    bool tanh_approximation_ = false;
+};
+
+#endif
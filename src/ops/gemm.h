@@ -4,7 +4,9 @@
 #include "../operator.h"
 #include "../attribute.h"
 #include "../tensor.h"
-#include <cmath>
+#include "../kernels/kernels.h"
+#include <algorithm>
+#include <stdexcept>
 
 class GemmOperator : public Operator
 {
@@ -19,60 +21,89 @@ public:
 
     void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
     {
-        const auto* A = inputs[0];
-        const auto* B = inputs[1];
-        
-        std::size_t M = A->rows();
-        std::size_t K = A->cols();
-        
-        // handle transposeA (swap M and K if transA is on)
-        if (transA_) 
+        const Tensor<float>* C = inputs.size() > 2 ? inputs[2] : nullptr;
+        compute(*inputs[0], inputs[1]->shape(), inputs[1]->data(), C, *outputs[0]);
+    }
+
+    // float16 weights go to the kernel as they are and are widened while packed
+    void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs) override
+    {
+        if (inputs.size() < 2 || !inputs[1] || inputs[1]->dtype() != DataType::Float16)
         {
-            M = A->cols();
-            K = A->rows();
+            Operator::run(inputs, outputs);
+            return;
         }
 
-        std::size_t N = (B->cols() == K) ? B->rows() : B->cols(); 
-        bool transpose_B = (B->cols() == K); 
+        AnyTensor a_scratch, c_scratch;
+        const Tensor<float>* A = float_input(*inputs[0], a_scratch);
+        const Tensor<float>* C = inputs.size() > 2 && inputs[2] ? float_input(*inputs[2], c_scratch) : nullptr;
+        const Tensor<float16>& B = inputs[1]->get<float16>();
 
-        // prepare output
-        outputs[0]->resize({M, N});
-        
-        float* Y = outputs[0]->data();
-        const float* A_data = A->data();
-        const float* B_data = B->data();
+        compute(*A, B.shape(), half_bits(B.data()), C, outputs[0]->emplace<float>());
+    }
 
-        // check for empty matrices
-        if (M == 0 || N == 0 || K == 0) return;
+    // C is unidirectionally broadcastable to (M, N): scalar, (N), (1, N), (M, 1) or (M, N).
+    // shared with SparseGemm
+    static void broadcast_bias(const Tensor<float>& C, float* Y, std::size_t M, std::size_t N)
+    {
+        const float* c = C.data();
 
-        // matrix mult
-        for (std::size_t m = 0; m < M; ++m) 
+        if (C.size() == M * N)
+        {
+            std::copy(c, c + M * N, Y);
+        }
+        else if (C.size() == 1)
+        {
+            std::fill(Y, Y + M * N, c[0]);
+        }
+        else if (C.size() == N && C.shape().back() == N)
+        {
+            for (std::size_t m = 0; m < M; ++m) std::copy(c, c + N, Y + m * N);
+        }
+        else if (C.size() == M)
+        {
+            for (std::size_t m = 0; m < M; ++m) std::fill(Y + m * N, Y + (m + 1) * N, c[m]);
+        }
+        else
         {
-            for (std::size_t n = 0; n < N; ++n) 
-            {
-                float sum = 0.0f;
-                if (inputs.size() > 2) 
-                {
-                    // broadcast bias if it exists 
-                    if (inputs[2]->size() == N) 
-                        sum = inputs[2]->data()[n];
-                }
-
-                for (std::size_t k = 0; k < K; ++k) 
-                {
-                    // handle transpositions
-                    std::size_t a_idx = transA_ ? (k * M + m) : (m * K + k);
-                    std::size_t b_idx = transpose_B ? (n * K + k) : (k * N + n);
-
-                    sum += A_data[a_idx] * B_data[b_idx];
-                }
-                
-                Y[m * N + n] = alpha_ * sum; // apply alpha
-            }
+            throw std::runtime_error("Gemm operator: bias C is not broadcastable to the output shape.");
         }
     }
 
 private:
+    // TB is float or uint16_t (half bits)
+    template <class TB>
+    void compute(const Tensor<float>& A, const std::vector<std::size_t>& b_shape, const TB* B, const Tensor<float>* C, Tensor<float>& output)
+    {
+        // same rows/cols convention as Tensor
+        const std::size_t b_rows = b_shape.empty() ? 0 : b_shape[0];
+        const std::size_t b_cols = b_shape.size() < 2 ? 1 : b_shape[1];
+
+        // op(A) is M x K, op(B) is K x N
+        std::size_t M = transA_ ? A.cols() : A.rows();
+        std::size_t K = transA_ ? A.rows() : A.cols();
+        std::size_t N = transB_ ? b_rows : b_cols;
+
+        if ((transB_ ? b_cols : b_rows) != K)
+        {
+            throw std::runtime_error("Gemm operator: inner dimensions of A and B do not match.");
+        }
+
+        // prepare output
+        output.resize({M, N});
+        float* Y = output.data();
+
+        // seed Y with the broadcast bias so the kernel applies beta in place
+        float beta = 0.0f;
+        if (C && C->size() > 0)
+        {
+            broadcast_bias(*C, Y, M, N);
+            beta = beta_;
+        }
+
+        sgemm_any(transA_, transB_, M, N, K, alpha_, A.data(), A.cols(), B, b_cols, beta, Y, N);
+    }
+
     float alpha_ = 1.0f;
     float beta_  = 1.0f;
     bool transA_ = false;
@@ -0,0 +1,140 @@
+#ifndef OPS_MATMUL_H
+#define OPS_MATMUL_H
+
+#include "../operator.h"
+#include "../broadcast.h"
+#include "../thread_pool.h"
+#include "../kernels/kernels.h"
+#include <algorithm>
+#include <stdexcept>
+
+// numpy matmul semantics: N-D inputs are stacks of matrices in the last two dims,
+// leading (batch) dims broadcast, 1-D operands are promoted and the dim dropped again
+class MatMulOperator : public Operator
+{
+public:
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        if (inputs.size() != 2)
+        {
+            throw std::runtime_error("MatMul operator expects exactly 2 inputs.");
+        }
+        compute(*inputs[0], inputs[1]->shape(), inputs[1]->data(), *outputs[0]);
+    }
+
+    // float16 right-hand side (weights) is widened inside the GEMM kernel
+    void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs) override
+    {
+        if (inputs.size() != 2 || !inputs[1] || inputs[1]->dtype() != DataType::Float16)
+        {
+            Operator::run(inputs, outputs);
+            return;
+        }
+
+        AnyTensor a_scratch;
+        const Tensor<float>* A = float_input(*inputs[0], a_scratch);
+        const Tensor<float16>& B = inputs[1]->get<float16>();
+        compute(*A, B.shape(), half_bits(B.data()), outputs[0]->emplace<float>());
+    }
+
+private:
+    // TB is float or uint16_t (half bits)
+    template <class TB>
+    static void compute(const Tensor<float>& A, std::vector<std::size_t> b_shape, const TB* b_ptr, Tensor<float>& output)
+    {
+        std::vector<std::size_t> a_shape = A.shape();
+        if (a_shape.empty() || b_shape.empty())
+        {
+            throw std::runtime_error("MatMul operator does not accept scalar inputs.");
+        }
+
+        // promote vectors: [K] x ... -> [1, K], ... x [K] -> [K, 1]
+        const bool a_vector = a_shape.size() == 1;
+        const bool b_vector = b_shape.size() == 1;
+        if (a_vector) a_shape.insert(a_shape.begin(), 1);
+        if (b_vector) b_shape.push_back(1);
+
+        const std::size_t M = a_shape[a_shape.size() - 2];
+        const std::size_t K = a_shape.back();
+        const std::size_t N = b_shape.back();
+        if (b_shape[b_shape.size() - 2] != K)
+        {
+            throw std::runtime_error("MatMul operator: inner dimensions of A and B do not match.");
+        }
+
+        // broadcast the batch dims
+        const std::vector<std::size_t> a_batch(a_shape.begin(), a_shape.end() - 2);
+        const std::vector<std::size_t> b_batch(b_shape.begin(), b_shape.end() - 2);
+        const std::vector<std::size_t> batch_shape = broadcast_shape(a_batch, b_batch);
+
+        std::vector<std::size_t> out_shape = batch_shape;
+        if (!a_vector) out_shape.push_back(M);
+        if (!b_vector) out_shape.push_back(N);
+
+        output.resize(out_shape);
+
+        std::size_t batch = 1;
+        for (auto dim : batch_shape) batch *= dim;
+        std::size_t b_count = 1;
+        for (auto dim : b_batch) b_count *= dim;
+
+        if (output.size() == 0) return;
+
+        const float* a_ptr = A.data();
+        float* y_ptr = output.data();
+
+        // one shared right-hand matrix: the stack of A is one tall [batch * M, K]
+        // matrix and the whole batch collapses into a single large GEMM
+        if (b_count == 1)
+        {
+            gemm_rows(batch * M, N, K, a_ptr, b_ptr, y_ptr);
+            return;
+        }
+
+        // general case: one GEMM per output matrix, batches spread over the pool
+        const std::vector<std::size_t> a_strides = broadcast_strides(a_batch, batch_shape);
+        const std::vector<std::size_t> b_strides = broadcast_strides(b_batch, batch_shape);
+
+        ThreadPool::instance().parallel_for(batch, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t b = begin; b < end; ++b)
+            {
+                // map the flat batch index to each input's (possibly broadcast) matrix
+                std::size_t a_index = 0, b_index = 0, rest = b;
+                for (std::size_t d = batch_shape.size(); d-- > 0;)
+                {
+                    std::size_t i = rest % batch_shape[d];
+                    rest /= batch_shape[d];
+                    a_index += i * a_strides[d];
+                    b_index += i * b_strides[d];
+                }
+
+                sgemm_any(false, false, M, N, K, 1.0f, a_ptr + a_index * M * K, K, b_ptr + b_index * K * N, N, 0.0f, y_ptr + b * M * N, N);
+            }
+        });
+    }
+
+    // Y[rows x N] = A[rows x K] * B[K x N], large problems split into row blocks across the pool
+    template <class TB>
+    static void gemm_rows(std::size_t rows, std::size_t N, std::size_t K, const float* A, const TB* B, float* Y)
+    {
+        ThreadPool& pool = ThreadPool::instance();
+        const bool worth_splitting = pool.size() > 1 && rows >= 2 * pool.size() && rows * N * K >= (1u << 20);
+
+        if (!worth_splitting)
+        {
+            sgemm_any(false, false, rows, N, K, 1.0f, A, K, B, N, 0.0f, Y, N);
+            return;
+        }
+
+        const std::size_t block = 16;
+        pool.parallel_for((rows + block - 1) / block, [&](std::size_t begin, std::size_t end)
+        {
+            std::size_t r0 = begin * block;
+            std::size_t r1 = std::min(rows, end * block);
+            sgemm_any(false, false, r1 - r0, N, K, 1.0f, A + r0 * K, K, B, N, 0.0f, Y + r0 * N, N);
+        });
+    }
+};
+
+#endif
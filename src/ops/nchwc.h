@@ -0,0 +1,227 @@
+#ifndef OPS_NCHWC_H
+#define OPS_NCHWC_H
+
+#include "../operator.h"
+#include "../conv_geometry.h"
+#include "../thread_pool.h"
+#include "../kernels/kernels.h"
+#include <algorithm>
+#include <stdexcept>
+
+// operators on the blocked NCHWc layout (see kernels/kernels.h). they are never
+// in a model file, GraphOptimizer::convert_to_nchwc inserts them
+
+// NCHW -> [N, C/B, H, W, B], missing channels of the last block are zero
+class ReorderInputOperator : public Operator
+{
+public:
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* X = inputs[0];
+        Tensor<float>* Y = outputs[0];
+        if (X->shape().size() != 4) throw std::runtime_error("ReorderInput operator: expected a 4-D NCHW input.");
+
+        const std::size_t B = kernels().nchwc_block;
+        const std::size_t N = X->shape()[0], C = X->shape()[1], HW = X->shape()[2] * X->shape()[3];
+        const std::size_t blocks = (C + B - 1) / B;
+        Y->resize({N, blocks, X->shape()[2], X->shape()[3], B});
+
+        // each block is a [channels, HW] -> [HW, B] transpose
+        for (std::size_t n = 0; n < N; ++n)
+        {
+            for (std::size_t cb = 0; cb < blocks; ++cb)
+            {
+                const std::size_t channels = std::min(B, C - cb * B);
+                float* y = Y->data() + (n * blocks + cb) * HW * B;
+                if (channels < B) std::fill(y, y + HW * B, 0.0f);
+
+                kernels().transpose(X->data() + (n * C + cb * B) * HW, channels, HW, HW, y, B);
+            }
+        }
+    }
+};
+
+// [N, C/B, H, W, B] -> NCHW with the original channel count
+class ReorderOutputOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        auto channels = node.get_attribute<int64_t>("channels");
+        if (!channels) throw std::runtime_error("ReorderOutput operator: missing 'channels' attribute.");
+        channels_ = static_cast<std::size_t>(*channels);
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* X = inputs[0];
+        Tensor<float>* Y = outputs[0];
+        if (X->shape().size() != 5) throw std::runtime_error("ReorderOutput operator: expected a 5-D NCHWc input.");
+
+        const std::size_t N = X->shape()[0], blocks = X->shape()[1], B = X->shape()[4];
+        const std::size_t HW = X->shape()[2] * X->shape()[3];
+        if (channels_ > blocks * B) throw std::runtime_error("ReorderOutput operator: more channels than the blocked tensor holds.");
+        Y->resize({N, channels_, X->shape()[2], X->shape()[3]});
+
+        for (std::size_t n = 0; n < N; ++n)
+        {
+            for (std::size_t cb = 0; cb < blocks && cb * B < channels_; ++cb)
+            {
+                const std::size_t channels = std::min(B, channels_ - cb * B);
+                const float* x = X->data() + (n * blocks + cb) * HW * B;
+                kernels().transpose(x, HW, channels, B, Y->data() + (n * channels_ + cb * B) * HW, HW);
+            }
+        }
+    }
+
+private:
+    std::size_t channels_ = 0;
+};
+
+// Conv on blocked activations. weights are pre-blocked to [OC/B, IC/B, KH, KW, B, B]
+// and the bias padded to OC/B * B values by the layout pass
+class NchwcConvOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        window_.parse(node);
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* X = inputs[0];
+        const Tensor<float>* W = inputs[1];
+        const Tensor<float>* bias = inputs.size() > 2 ? inputs[2] : nullptr;
+        Tensor<float>* Y = outputs[0];
+
+        const std::size_t B = kernels().nchwc_block;
+        if (X->shape().size() != 5 || W->shape().size() != 6 || X->shape()[4] != B || W->shape()[1] != X->shape()[1])
+        {
+            throw std::runtime_error("NchwcConv operator: input or weights do not match the NCHWc block layout.");
+        }
+
+        const std::size_t N = X->shape()[0], in_blocks = X->shape()[1], H = X->shape()[2], Wd = X->shape()[3];
+        const std::size_t out_blocks = W->shape()[0];
+        const ConvGeometry g = window_.resolve(H, Wd, W->shape()[2], W->shape()[3]);
+        Y->resize({N, out_blocks, g.out_h, g.out_w, B});
+
+        const std::size_t w_block = in_blocks * g.kernel_h * g.kernel_w * B * B;
+
+        // one work item per output row of one output block
+        auto run = [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t item = begin; item < end; ++item)
+            {
+                const std::size_t oh = item % g.out_h;
+                const std::size_t ob = (item / g.out_h) % out_blocks;
+                const std::size_t n = item / (g.out_h * out_blocks);
+
+                NchwcConvArgs args{};
+                args.input = X->data() + n * in_blocks * H * Wd * B;
+                args.weights = W->data() + ob * w_block;
+                args.bias = bias ? bias->data() + ob * B : nullptr;
+                args.output = Y->data() + (((n * out_blocks + ob) * g.out_h + oh) * g.out_w) * B;
+                args.in_blocks = in_blocks;
+                args.in_h = H;
+                args.in_w = Wd;
+                args.kernel_h = g.kernel_h;
+                args.kernel_w = g.kernel_w;
+                args.stride_h = g.stride_h;
+                args.stride_w = g.stride_w;
+                args.dilation_h = g.dilation_h;
+                args.dilation_w = g.dilation_w;
+                args.pad_top = g.pad_top;
+                args.pad_left = g.pad_left;
+                args.out_row = oh;
+                args.out_w = g.out_w;
+                kernels().nchwc_conv(args);
+            }
+        };
+
+        const std::size_t rows = N * out_blocks * g.out_h;
+        if (rows * g.out_w * w_block >= (1u << 20))
+            ThreadPool::instance().parallel_for(rows, run);
+        else
+            run(0, rows);
+    }
+
+private:
+    WindowAttributes window_;
+};
+
+// MaxPool / AveragePool / GlobalAveragePool on blocked activations
+class NchwcPoolOperator : public Operator
+{
+public:
+    enum class Kind { Max, Average, GlobalAverage };
+
+    explicit NchwcPoolOperator(Kind kind) : kind_(kind) {}
+
+    void set_attributes(const Node& node) override
+    {
+        if (kind_ == Kind::GlobalAverage) return;
+        window_.parse(node);
+        count_include_pad_ = node.get_attribute<int64_t>("count_include_pad").value_or(0) != 0;
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* X = inputs[0];
+        Tensor<float>* Y = outputs[0];
+
+        const std::size_t B = kernels().nchwc_block;
+        if (X->shape().size() != 5 || X->shape()[4] != B)
+        {
+            throw std::runtime_error("NchwcPool operator: input does not match the NCHWc block layout.");
+        }
+
+        const std::size_t planes = X->shape()[0] * X->shape()[1], H = X->shape()[2], W = X->shape()[3];
+
+        // global pooling is one window covering the whole plane
+        ConvGeometry g;
+        if (kind_ == Kind::GlobalAverage)
+        {
+            g.kernel_h = H;
+            g.kernel_w = W;
+            g.out_h = g.out_w = 1;
+        }
+        else
+        {
+            g = window_.resolve(H, W, 0, 0);
+        }
+        Y->resize({X->shape()[0], X->shape()[1], g.out_h, g.out_w, B});
+
+        auto kernel = kind_ == Kind::Max ? kernels().nchwc_max_pool : kernels().nchwc_avg_pool;
+        for (std::size_t p = 0; p < planes; ++p)
+        {
+            for (std::size_t oh = 0; oh < g.out_h; ++oh)
+            {
+                NchwcPoolArgs args{};
+                args.input = X->data() + p * H * W * B;
+                args.output = Y->data() + ((p * g.out_h + oh) * g.out_w) * B;
+                args.in_h = H;
+                args.in_w = W;
+                args.kernel_h = g.kernel_h;
+                args.kernel_w = g.kernel_w;
+                args.stride_h = g.stride_h;
+                args.stride_w = g.stride_w;
+                args.dilation_h = g.dilation_h;
+                args.dilation_w = g.dilation_w;
+                args.pad_top = g.pad_top;
+                args.pad_left = g.pad_left;
+                args.out_row = oh;
+                args.out_w = g.out_w;
+                args.count_include_pad = count_include_pad_;
+                kernel(args);
+            }
+        }
+    }
+
+private:
+    Kind kind_;
+    WindowAttributes window_;
+    bool count_include_pad_ = false;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef OPS_POOL_H
+#define OPS_POOL_H
+
+#include "../operator.h"
+#include "../conv_geometry.h"
+#include <limits>
+#include <stdexcept>
+
+// MaxPool and AveragePool over NCHW tensors
+class PoolOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        window_.parse(node);
+        count_include_pad_ = node.get_attribute<int64_t>("count_include_pad").value_or(0) != 0;
+
+        if (window_.kernel_shape.size() != 2)
+        {
+            throw std::runtime_error(std::string(name()) + " operator: only 2-D kernel_shape is supported.");
+        }
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* X = inputs[0];
+        Tensor<float>* Y = outputs[0];
+        if (X->shape().size() != 4) throw std::runtime_error(std::string(name()) + " operator: expected a 4-D NCHW input.");
+
+        const std::size_t N = X->shape()[0], C = X->shape()[1], H = X->shape()[2], W = X->shape()[3];
+        const ConvGeometry g = window_.resolve(H, W, 0, 0);
+        Y->resize({N, C, g.out_h, g.out_w});
+
+        for (std::size_t plane = 0; plane < N * C; ++plane)
+        {
+            const float* x = X->data() + plane * H * W;
+            float* y = Y->data() + plane * g.out_h * g.out_w;
+
+            for (std::size_t oh = 0; oh < g.out_h; ++oh)
+            {
+                for (std::size_t ow = 0; ow < g.out_w; ++ow)
+                {
+                    float acc = max_ ? -std::numeric_limits<float>::infinity() : 0.0f;
+                    std::size_t count = 0;
+
+                    for (std::size_t i = 0; i < g.kernel_h; ++i)
+                    {
+                        long ih = static_cast<long>(oh * g.stride_h + i * g.dilation_h) - static_cast<long>(g.pad_top);
+                        if (ih < 0 || ih >= static_cast<long>(H)) continue;
+                        for (std::size_t j = 0; j < g.kernel_w; ++j)
+                        {
+                            long iw = static_cast<long>(ow * g.stride_w + j * g.dilation_w) - static_cast<long>(g.pad_left);
+                            if (iw < 0 || iw >= static_cast<long>(W)) continue;
+
+                            float v = x[ih * W + iw];
+                            acc = max_ ? (v > acc ? v : acc) : acc + v;
+                            ++count;
+                        }
+                    }
+
+                    if (!max_)
+                    {
+                        if (count_include_pad_) count = g.kernel_h * g.kernel_w;
+                        acc = count ? acc / static_cast<float>(count) : 0.0f;
+                    }
+                    y[oh * g.out_w + ow] = acc;
+                }
+            }
+        }
+    }
+
+protected:
+    explicit PoolOperator(bool max) : max_(max) {}
+
+private:
+    const char* name() const { return max_ ? "MaxPool" : "AveragePool"; }
+
+    WindowAttributes window_;
+    bool max_;
+    bool count_include_pad_ = false;
+};
+
+class MaxPoolOperator : public PoolOperator
+{
+public:
+    MaxPoolOperator() : PoolOperator(true) {}
+};
+
+class AveragePoolOperator : public PoolOperator
+{
+public:
+    AveragePoolOperator() : PoolOperator(false) {}
+};
+
+// mean over H and W, output [N, C, 1, 1]
+class GlobalAveragePoolOperator : public Operator
+{
+public:
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* X = inputs[0];
+        Tensor<float>* Y = outputs[0];
+        if (X->shape().size() != 4) throw std::runtime_error("GlobalAveragePool operator: expected a 4-D NCHW input.");
+
+        const std::size_t N = X->shape()[0], C = X->shape()[1], HW = X->shape()[2] * X->shape()[3];
+        Y->resize({N, C, 1, 1});
+
+        for (std::size_t plane = 0; plane < N * C; ++plane)
+        {
+            const float* x = X->data() + plane * HW;
+            float sum = 0.0f;
+            for (std::size_t i = 0; i < HW; ++i) sum += x[i];
+            Y->data()[plane] = HW ? sum / static_cast<float>(HW) : 0.0f;
+        }
+    }
+};
+
+#endif
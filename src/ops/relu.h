@@ -2,6 +2,7 @@
 #define OPS_RELU_H
 
 #include "../operator.h"
+#include "../kernels/kernels.h"
 
 class ReluOperator : public Operator
 {
@@ -12,17 +13,8 @@ public:
         Tensor<float>* output = outputs[0];     // get existing output tensor 
         output->resize(input->shape());         // resize tensor to match input
 
-        // pointers
-        const float* in_data = input->data();
-        float* out_data = output->data();
-        std::size_t size = input->size();
-
-        // apply ReLU element wise
-        for (std::size_t i = 0; i < size; ++i) 
-        {
-            float val = in_data[i];
-            out_data[i] = (val > 0.0f) ? val : 0.0f; // f(x) = max(0,x)
-        }
+        // apply ReLU element wise, f(x) = max(0,x)
+        kernels().relu(input->data(), output->data(), input->size());
     }
 };
 
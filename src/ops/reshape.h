@@ -0,0 +1,77 @@
+#ifndef OPS_RESHAPE_H
+#define OPS_RESHAPE_H
+
+#include "../operator.h"
+#include <stdexcept>
+
+class ReshapeOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        allowzero_ = node.get_attribute<int64_t>("allowzero").value_or(0) != 0;
+
+        // opset < 5 carried the target shape as an attribute
+        auto shape = node.get_attribute<std::vector<int64_t>>("shape");
+        has_shape_attr_ = shape.has_value();
+        if (has_shape_attr_) shape_attr_ = *shape;
+    }
+
+    // any dtype: the output aliases the input buffer under the new shape
+    void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs) override
+    {
+        AnyTensor* input = inputs[0];
+        std::vector<int64_t> target;
+        if (inputs.size() > 1 && inputs[1]) target = inputs[1]->to_int64();
+        else if (has_shape_attr_) target = shape_attr_;
+        else throw std::runtime_error("Reshape operator: missing target shape.");
+
+        const std::vector<std::size_t>& in_shape = input->shape();
+        std::vector<std::size_t> out_shape(target.size());
+        std::size_t known = 1;
+        int infer = -1;
+
+        for (std::size_t i = 0; i < target.size(); ++i)
+        {
+            if (target[i] == -1)
+            {
+                if (infer >= 0) throw std::runtime_error("Reshape operator: more than one -1 in target shape.");
+                infer = static_cast<int>(i);
+                continue;
+            }
+            if (target[i] < -1) throw std::runtime_error("Reshape operator: invalid dimension " + std::to_string(target[i]) + ".");
+
+            // 0 copies the input dim unless allowzero asks for a literal zero
+            if (target[i] == 0 && !allowzero_)
+            {
+                if (i >= in_shape.size()) throw std::runtime_error("Reshape operator: 0 refers past the input rank.");
+                out_shape[i] = in_shape[i];
+            }
+            else
+            {
+                out_shape[i] = static_cast<std::size_t>(target[i]);
+            }
+            known *= out_shape[i];
+        }
+
+        if (infer >= 0)
+        {
+            if (known == 0 || input->size() % known != 0) throw std::runtime_error("Reshape operator: cannot infer the -1 dimension.");
+            out_shape[infer] = input->size() / known;
+            known *= out_shape[infer];
+        }
+        if (known != input->size())
+        {
+            throw std::runtime_error("Reshape operator: cannot reshape " + std::to_string(input->size()) + " elements into " + std::to_string(known) + ".");
+        }
+
+        outputs[0]->view_of(*input, out_shape);
+    }
+
+private:
+    std::vector<int64_t> shape_attr_;
+    bool has_shape_attr_ = false;
+    bool allowzero_ = false;
+};
+
+#endif
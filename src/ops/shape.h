@@ -0,0 +1,40 @@
+#ifndef OPS_SHAPE_H
+#define OPS_SHAPE_H
+
+#include "../operator.h"
+
+class ShapeOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        start_ = node.get_attribute<int64_t>("start").value_or(0);
+        end_ = node.get_attribute<int64_t>("end");
+    }
+
+    // int64 1-D tensor with the input dims in [start, end)
+    void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs) override
+    {
+        const std::vector<std::size_t>& shape = inputs[0]->shape();
+        const int64_t rank = static_cast<int64_t>(shape.size());
+
+        auto clamp = [rank](int64_t axis)
+        {
+            if (axis < 0) axis += rank;
+            return axis < 0 ? 0 : (axis > rank ? rank : axis);
+        };
+        const int64_t begin = clamp(start_);
+        const int64_t end = end_ ? clamp(*end_) : rank;
+        const std::size_t count = end > begin ? static_cast<std::size_t>(end - begin) : 0;
+
+        Tensor<int64_t>& output = outputs[0]->emplace<int64_t>();
+        output.resize({count});
+        for (std::size_t i = 0; i < count; ++i) output.data()[i] = static_cast<int64_t>(shape[begin + i]);
+    }
+
+private:
+    int64_t start_ = 0;
+    std::optional<int64_t> end_;
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef OPS_SIGMOID_H
+#define OPS_SIGMOID_H
+
+#include "../operator.h"
+#include "../kernels/kernels.h"
+
+class SigmoidOperator : public Operator
+{
+public:
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* input = inputs[0];
+        Tensor<float>* output = outputs[0];
+        output->resize(input->shape());
+
+        // f(x) = 1 / (1 + exp(-x))
+        kernels().sigmoid(input->data(), output->data(), input->size());
+    }
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef OPS_SILU_H
+#define OPS_SILU_H
+
+#include "../operator.h"
+#include "../kernels/kernels.h"
+
+class SiluOperator : public Operator
+{
+public:
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* input = inputs[0];
+        Tensor<float>* output = outputs[0];
+        output->resize(input->shape());
+
+        // f(x) = x * sigmoid(x), not in the default ONNX domain (exporters emit Sigmoid + Mul)
+        kernels().silu(input->data(), output->data(), input->size());
+    }
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef OPS_SOFTMAX_H
+#define OPS_SOFTMAX_H
+
+#include "../operator.h"
+#include "../kernels/kernels.h"
+#include <stdexcept>
+
+// opset 13 semantics: normalize along one axis (default -1)
+class SoftmaxOperator : public Operator
+{
+public:
+    SoftmaxOperator() = default;
+
+    void set_attributes(const Node& node) override
+    {
+        axis_ = node.get_attribute<int64_t>("axis").value_or(-1);
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* input = inputs[0];
+        Tensor<float>* output = outputs[0];
+        output->resize(input->shape());
+
+        const std::vector<std::size_t>& shape = input->shape();
+        const long long rank = static_cast<long long>(shape.size());
+        long long axis = axis_ < 0 ? axis_ + rank : axis_;
+
+        if (rank == 0 || axis < 0 || axis >= rank)
+        {
+            throw std::runtime_error(std::string(name()) + " operator: axis out of range.");
+        }
+
+        // view the tensor as [outer, n, inner] with n the normalized axis
+        std::size_t outer = 1, inner = 1;
+        for (long long i = 0; i < axis; ++i) outer *= shape[i];
+        for (long long i = axis + 1; i < rank; ++i) inner *= shape[i];
+        const std::size_t n = shape[axis];
+
+        auto row_kernel = log_ ? kernels().log_softmax : kernels().softmax;
+        const float* x = input->data();
+        float* y = output->data();
+
+        // contiguous rows go straight to the kernel
+        if (inner == 1)
+        {
+            for (std::size_t o = 0; o < outer; ++o)
+                row_kernel(x + o * n, y + o * n, n);
+            return;
+        }
+
+        // strided axis: gather each column into a row, normalize, scatter back
+        std::vector<float> in_row(n), out_row(n);
+        for (std::size_t o = 0; o < outer; ++o)
+        {
+            for (std::size_t i = 0; i < inner; ++i)
+            {
+                const float* src = x + o * n * inner + i;
+                float* dst = y + o * n * inner + i;
+
+                for (std::size_t k = 0; k < n; ++k) in_row[k] = src[k * inner];
+                row_kernel(in_row.data(), out_row.data(), n);
+                for (std::size_t k = 0; k < n; ++k) dst[k * inner] = out_row[k];
+            }
+        }
+    }
+
+protected:
+    explicit SoftmaxOperator(bool log) : log_(log) {}
+
+private:
+    const char* name() const { return log_ ? "LogSoftmax" : "Softmax"; }
+
+    int64_t axis_ = -1;
+    bool log_ = false;
+};
+
+// log(softmax(x)) computed as x - max - log(sum(exp(x - max)))
+class LogSoftmaxOperator : public SoftmaxOperator
+{
+public:
+    LogSoftmaxOperator() : SoftmaxOperator(true) {}
+};
+
+#endif
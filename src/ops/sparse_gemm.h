@@ -0,0 +1,80 @@
+#ifndef OPS_SPARSE_GEMM_H
+#define OPS_SPARSE_GEMM_H
+
+#include "../operator.h"
+#include "../kernels/kernels.h"
+#include "gemm.h"
+#include <algorithm>
+#include <stdexcept>
+
+// internal operator the optimizer substitutes for Gemm/MatMul with pruned constant
+// weights: Y = alpha * A * B + beta * C where B is K x N in BSR form.
+// inputs: A [..., K], values [tiles, block], row_index [tiles] (int32),
+// col_ptr [column blocks + 1] (int32), optional C. attributes `rows` (K) and `cols` (N)
+class SparseGemmOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        alpha_ = node.get_attribute<float>("alpha").value_or(1.0f);
+        beta_  = node.get_attribute<float>("beta").value_or(1.0f);
+        rows_  = static_cast<std::size_t>(node.get_attribute<int64_t>("rows").value_or(0));
+        cols_  = static_cast<std::size_t>(node.get_attribute<int64_t>("cols").value_or(0));
+    }
+
+    void run(const std::vector<AnyTensor*>& inputs, std::vector<AnyTensor*>& outputs) override
+    {
+        if (inputs.size() < 4)
+        {
+            throw std::runtime_error("SparseGemm operator expects A, values, row_index and col_ptr inputs.");
+        }
+
+        AnyTensor a_scratch, c_scratch;
+        const Tensor<float>* A = float_input(*inputs[0], a_scratch);
+        const Tensor<float>& values = inputs[1]->get<float>();
+        const Tensor<int32_t>& row_index = inputs[2]->get<int32_t>();
+        const Tensor<int32_t>& col_ptr = inputs[3]->get<int32_t>();
+        const Tensor<float>* C = inputs.size() > 4 && inputs[4] ? float_input(*inputs[4], c_scratch) : nullptr;
+
+        const std::size_t block = values.shape().size() == 2 ? values.shape()[1] : 0;
+        if (block != kernels().bsr_block)
+        {
+            throw std::runtime_error("SparseGemm operator: weights were blocked for another kernel table.");
+        }
+
+        const std::size_t K = rows_;
+        if (A->shape().empty() || A->shape().back() != K || col_ptr.size() != (cols_ + block - 1) / block + 1)
+        {
+            throw std::runtime_error("SparseGemm operator: inner dimensions of A and B do not match.");
+        }
+
+        // [..., K] -> [..., N], leading dims flatten into rows
+        std::vector<std::size_t> out_shape = A->shape();
+        out_shape.back() = cols_;
+        const std::size_t M = A->size() / K;
+
+        Tensor<float>& Y = outputs[0]->emplace<float>();
+        Y.resize(out_shape);
+
+        if (C && C->size() > 0)
+        {
+            GemmOperator::broadcast_bias(*C, Y.data(), M, cols_);
+            if (beta_ != 1.0f) kernels().scale_shift(Y.data(), beta_, 0.0f, Y.data(), Y.size());
+        }
+        else
+        {
+            std::fill(Y.data(), Y.data() + Y.size(), 0.0f);
+        }
+
+        BsrMatrix B{values.data(), row_index.data(), col_ptr.data(), K, cols_, block};
+        kernels().bsr_gemm(M, alpha_, A->data(), K, B, Y.data(), cols_);
+    }
+
+private:
+    float alpha_ = 1.0f;
+    float beta_  = 1.0f;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+};
+
+#endif
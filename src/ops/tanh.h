@@ -0,0 +1,21 @@
+#ifndef OPS_TANH_H
+#define OPS_TANH_H
+
+#include "../operator.h"
+#include "../kernels/kernels.h"
+
+class TanhOperator : public Operator
+{
+public:
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        const Tensor<float>* input = inputs[0];
+        Tensor<float>* output = outputs[0];
+        output->resize(input->shape());
+
+        // f(x) = tanh(x)
+        kernels().tanh(input->data(), output->data(), input->size());
+    }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef OPS_TRANSPOSE_H
+#define OPS_TRANSPOSE_H
+
+#include "../operator.h"
+#include "../transpose.h"
+#include <stdexcept>
+
+class TransposeOperator : public Operator
+{
+public:
+    void set_attributes(const Node& node) override
+    {
+        // ONNX default reverses the dims
+        auto perm = node.get_attribute<std::vector<int64_t>>("perm");
+        has_perm_ = perm.has_value();
+        if (has_perm_) perm_ = *perm;
+    }
+
+    void forward(const std::vector<Tensor<float>*>& inputs, std::vector<Tensor<float>*>& outputs) override
+    {
+        Tensor<float>* input = inputs[0];
+        Tensor<float>* output = outputs[0];
+        const std::vector<std::size_t>& shape = input->shape();
+        const std::size_t rank = shape.size();
+
+        std::vector<std::size_t> perm(rank);
+        for (std::size_t i = 0; i < rank; ++i)
+        {
+            if (!has_perm_)
+            {
+                perm[i] = rank - 1 - i;
+                continue;
+            }
+            if (perm_.size() != rank || perm_[i] < 0)
+            {
+                throw std::runtime_error("Transpose operator: perm does not match input rank " + std::to_string(rank) + ".");
+            }
+            perm[i] = static_cast<std::size_t>(perm_[i]);
+        }
+
+        std::vector<std::size_t> out_shape(rank);
+        for (std::size_t i = 0; i < rank; ++i) out_shape[i] = shape[perm[i]];
+
+        // only size-1 dims move: same bytes, new shape, no copy
+        if (plan_transpose(shape, perm).is_identity())
+        {
+            output->view(input->data(), out_shape);
+            return;
+        }
+
+        output->resize(out_shape);
+        transpose_nd(input->data(), shape, perm, output->data());
+    }
+
+private:
+    std::vector<int64_t> perm_;
+    bool has_perm_ = false;
+};
+
+#endif
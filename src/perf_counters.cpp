@@ -0,0 +1,160 @@
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+bool PerfSample::any() const
+{
+    for (bool v : valid)
+        if (v) return true;
+    return false;
+}
+
+double PerfSample::ipc() const
+{
+    if (!valid[Cycles] || !valid[Instructions] || values[Cycles] == 0) return 0.0;
+    return static_cast<double>(values[Instructions]) / values[Cycles];
+}
+
+double PerfSample::miss_rate() const
+{
+    if (!valid[CacheReferences] || !valid[CacheMisses] || values[CacheReferences] == 0) return 0.0;
+    return static_cast<double>(values[CacheMisses]) / values[CacheReferences];
+}
+
+PerfSample PerfSample::operator-(const PerfSample& start) const
+{
+    PerfSample delta;
+    for (int e = 0; e < EventCount; ++e)
+    {
+        delta.valid[e] = valid[e] && start.valid[e];
+        delta.values[e] = delta.valid[e] && values[e] > start.values[e] ? values[e] - start.values[e] : 0;
+    }
+    return delta;
+}
+
+PerfSample& PerfSample::operator+=(const PerfSample& other)
+{
+    for (int e = 0; e < EventCount; ++e)
+    {
+        if (!other.valid[e]) continue;
+        values[e] += other.values[e];
+        valid[e] = true;
+    }
+    return *this;
+}
+
+const char* PerfSample::event_name(Event e)
+{
+    switch (e)
+    {
+    case Cycles:          return "cycles";
+    case Instructions:    return "instructions";
+    case CacheReferences: return "llc_references";
+    case CacheMisses:     return "llc_misses";
+    default:              return "unknown";
+    }
+}
+
+#ifdef __linux__
+
+namespace
+{
+
+const char* open_error(int error)
+{
+    switch (error)
+    {
+    case ENOENT:
+    case EOPNOTSUPP: return "not supported here";
+    case EACCES:
+    case EPERM:      return "not permitted, see perf_event_paranoid";
+    case ENOSYS:     return "perf_event_open not available";
+    default:         return std::strerror(error);
+    }
+}
+
+}
+
+PerfCounters::PerfCounters()
+{
+    static const uint64_t configs[PerfSample::EventCount] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+
+    // reasons per event, collapsed to one when every event failed the same way
+    std::string missing, reason;
+    bool same_reason = true;
+    for (int e = 0; e < PerfSample::EventCount; ++e)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[e];
+        attr.exclude_kernel = 1;                            // allowed at perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds_[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds_[e] >= 0) continue;
+
+        const std::string error = open_error(errno);
+        if (!reason.empty() && reason != error) same_reason = false;
+        reason = error;
+        missing += std::string(missing.empty() ? "" : ", ") + PerfSample::event_name(static_cast<PerfSample::Event>(e)) + " (" + error + ")";
+    }
+
+    if (missing.empty()) status_ = "all hardware counters available";
+    else if (!available() && same_reason) status_ = "unavailable: " + reason;
+    else status_ = "unavailable: " + missing;
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int fd : fds_)
+        if (fd >= 0) close(fd);
+}
+
+PerfSample PerfCounters::read() const
+{
+    PerfSample sample;
+    for (int e = 0; e < PerfSample::EventCount; ++e)
+    {
+        uint64_t data[3];                                   // value, time enabled, time running
+        if (fds_[e] < 0 || ::read(fds_[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+
+        double value = static_cast<double>(data[0]);
+        if (data[2] == 0) continue;                         // never scheduled on the PMU
+        if (data[2] < data[1]) value *= static_cast<double>(data[1]) / data[2];
+
+        sample.values[e] = static_cast<uint64_t>(value);
+        sample.valid[e] = true;
+    }
+    return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() : status_("unavailable: perf_event_open needs Linux")
+{
+    for (int& fd : fds_) fd = -1;
+}
+
+PerfCounters::~PerfCounters() {}
+
+PerfSample PerfCounters::read() const { return PerfSample(); }
+
+#endif
+
+bool PerfCounters::available() const
+{
+    for (int fd : fds_)
+        if (fd >= 0) return true;
+    return false;
+}
@@ -0,0 +1,58 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// hardware event counts over an interval. each event is optional: VMs and
+// containers often expose only some (or none) of them
+struct PerfSample
+{
+    enum Event
+    {
+        Cycles = 0,
+        Instructions,
+        CacheReferences,        // last-level cache references
+        CacheMisses,            // last-level cache misses
+        EventCount
+    };
+
+    uint64_t values[EventCount] = {};
+    bool valid[EventCount] = {};
+
+    bool any() const;
+    bool has(Event e) const { return valid[e]; }
+    double ipc() const;                                     // 0 without both cycles and instructions
+    double miss_rate() const;                               // LLC misses / references, 0 if unknown
+
+    PerfSample operator-(const PerfSample& start) const;    // counts between two reads
+    PerfSample& operator+=(const PerfSample& other);
+
+    static const char* event_name(Event e);
+};
+
+// per-process hardware counters through perf_event_open. counters are opened with
+// inherit, so threads created afterwards (the compute pool) are counted too; open
+// them before the first inference to cover the workers. when the kernel refuses an
+// event (no PMU, perf_event_paranoid, seccomp) it is left out and status() says
+// why, reads then simply carry fewer valid events
+class PerfCounters
+{
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const;                                 // at least one event is counting
+    const std::string& status() const { return status_; }
+
+    // running totals, scaled up when the kernel multiplexed the counters
+    PerfSample read() const;
+private:
+    int fds_[PerfSample::EventCount];
+    std::string status_;
+};
+
+#endif
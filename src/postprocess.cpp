@@ -0,0 +1,181 @@
+#include "postprocess.h"
+#include "kernels/kernels.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::string trim(const std::string& s)
+{
+    const std::size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+}
+
+bool is_version_file(const fs::path& file)
+{
+    const std::string stem = file.stem().string();
+    return !stem.empty() && std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+}
+
+Postprocessor Postprocessor::parse(const std::string& spec, const std::string& base_dir)
+{
+    Postprocessor head;
+    head.configured_ = true;
+
+    std::stringstream steps(spec);
+    for (std::string step; std::getline(steps, step, ',');)
+    {
+        step = trim(step);
+        if (step.empty()) continue;
+
+        const std::size_t equals = step.find('=');
+        const std::string name = trim(step.substr(0, equals));
+        const std::string value = equals == std::string::npos ? "" : trim(step.substr(equals + 1));
+        try
+        {
+            if (name == "softmax" && value.empty())
+            {
+                head.softmax_ = true;
+            }
+            else if (name == "argmax" && value.empty())
+            {
+                head.top_k_ = 1;
+            }
+            else if (name == "topk" && !value.empty())
+            {
+                head.top_k_ = std::stoul(value);
+                if (head.top_k_ == 0) throw std::runtime_error("k must be positive");
+            }
+            else if (name == "threshold" && !value.empty())
+            {
+                head.threshold_ = std::stof(value);
+            }
+            else if (name == "labels" && !value.empty())
+            {
+                fs::path path(value);
+                if (path.is_relative() && !base_dir.empty()) path = fs::path(base_dir) / path;
+                std::ifstream file(path);
+                if (!file) throw std::runtime_error("cannot open " + path.string());
+                head.labels_.clear();
+                for (std::string line; std::getline(file, line);) head.labels_.push_back(trim(line));
+                while (!head.labels_.empty() && head.labels_.back().empty()) head.labels_.pop_back();
+            }
+            else
+            {
+                throw std::runtime_error("unknown step");
+            }
+        }
+        catch (const std::exception& e)
+        {
+            throw std::runtime_error("Postprocessing step '" + step + "': " + e.what());
+        }
+    }
+    return head;
+}
+
+Postprocessor Postprocessor::for_model(const std::string& model_path)
+{
+    const fs::path model(model_path);
+    fs::path config = model.parent_path() / (model.stem().string() + ".postprocess");
+    if (!fs::is_regular_file(config) && is_version_file(model)) config = model.parent_path() / "postprocess";
+    if (!fs::is_regular_file(config)) return Postprocessor();
+
+    std::ifstream file(config);
+    std::string spec;
+    for (std::string line; std::getline(file, line);) spec += line.substr(0, line.find('#')) + ",";
+    return parse(spec, config.parent_path().string());
+}
+
+std::string Postprocessor::label(int64_t index) const
+{
+    if (index < 0) return "";
+    if (static_cast<std::size_t>(index) < labels_.size()) return labels_[index];
+    return std::to_string(index);
+}
+
+const std::vector<std::string>& Postprocessor::output_names()
+{
+    static const std::vector<std::string> names = {"classes", "scores"};
+    return names;
+}
+
+ValueInfo Postprocessor::output_info(std::size_t i) const
+{
+    ValueInfo info;
+    info.dtype = i == 0 ? DataType::Int64 : DataType::Float32;
+    info.shape = {-1, top_k_ ? static_cast<int64_t>(top_k_) : -1};
+    info.has_shape = true;
+    return info;
+}
+
+std::vector<AnyTensor> Postprocessor::apply(const AnyTensor& output) const
+{
+    if (!output.is<float>()) throw std::runtime_error("Postprocessing needs a float32 model output.");
+    const Tensor<float>& scores = output.get<float>();
+    const std::size_t classes = scores.shape().empty() ? scores.size() : scores.shape().back();
+    if (classes == 0 || scores.size() == 0) throw std::runtime_error("Postprocessing got an empty model output.");
+
+    const std::size_t rows = scores.size() / classes;
+    const std::size_t k = this->k(classes);
+    Tensor<int64_t> top_classes({rows, k});
+    Tensor<float> top_scores({rows, k});
+    for (std::size_t r = 0; r < rows; ++r) apply_row(scores.data() + r * classes, classes, top_classes.data() + r * k, top_scores.data() + r * k);
+
+    std::vector<AnyTensor> result;
+    result.emplace_back(std::move(top_classes));
+    result.emplace_back(std::move(top_scores));
+    return result;
+}
+
+void Postprocessor::apply_row(const float* row, std::size_t classes, int64_t* top_classes, float* top_scores) const
+{
+    thread_local std::vector<float> probabilities;
+    thread_local std::vector<uint32_t> order;
+
+    const float* values = row;
+    if (softmax_)
+    {
+        probabilities.resize(classes);
+        kernels().softmax(row, probabilities.data(), classes);
+        values = probabilities.data();
+    }
+
+    const std::size_t k = this->k(classes);
+    if (k == 1)
+    {
+        const std::size_t best = std::max_element(values, values + classes) - values;
+        top_classes[0] = static_cast<int64_t>(best);
+        top_scores[0] = values[best];
+    }
+    else
+    {
+        // partial selection: only the k best end up sorted, ties go to the lower class
+        order.resize(classes);
+        std::iota(order.begin(), order.end(), 0u);
+        auto better = [values](uint32_t a, uint32_t b) { return values[a] > values[b] || (values[a] == values[b] && a < b); };
+        if (k < classes) std::nth_element(order.begin(), order.begin() + (k - 1), order.end(), better);
+        std::sort(order.begin(), order.begin() + k, better);
+        for (std::size_t i = 0; i < k; ++i)
+        {
+            top_classes[i] = order[i];
+            top_scores[i] = values[order[i]];
+        }
+    }
+
+    for (std::size_t i = 0; i < k; ++i)
+    {
+        if (top_scores[i] >= threshold_) continue;
+        top_classes[i] = -1;
+        top_scores[i] = 0.0f;
+    }
+}
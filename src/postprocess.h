@@ -0,0 +1,65 @@
+#ifndef POSTPROCESS_H
+#define POSTPROCESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "any_tensor.h"
+#include "graph.h"
+
+// classification head run on a model's first output before results leave the
+// engine. the output is read as [rows, classes], classes being its last
+// dimension, so a batch is handled row by row, and it is replaced by
+//
+//   classes  INT64 [rows, k]    best first, -1 where the threshold dropped a slot
+//   scores   FP32  [rows, k]    probabilities with softmax, raw scores without
+//
+// configured by a spec of comma separated steps, e.g.
+//
+//   softmax,topk=5,threshold=0.1,labels=digits.txt
+//
+// "argmax" is topk=1. without topk every class comes back, sorted. labels are
+// one per line and only change how classes are presented
+class Postprocessor
+{
+public:
+    Postprocessor() = default;
+
+    // throws std::runtime_error on an unknown step or an unreadable label file.
+    // relative label paths are taken from `base_dir`
+    static Postprocessor parse(const std::string& spec, const std::string& base_dir = "");
+
+    // the spec configured for a model file: <stem>.postprocess next to it, or for a
+    // versioned model <name>/<version>.onnx also <name>/postprocess. # starts a
+    // comment and lines are joined as steps. empty when there is none
+    static Postprocessor for_model(const std::string& model_path);
+
+    bool empty() const { return !configured_; }
+    bool softmax() const { return softmax_; }
+    std::size_t top_k() const { return top_k_; }            // 0 keeps every class
+    const std::vector<std::string>& labels() const { return labels_; }
+
+    // label of a class; its number without a label file, "" for a dropped slot
+    std::string label(int64_t index) const;
+
+    // the tensors replacing the model's outputs, and their metadata
+    static const std::vector<std::string>& output_names();
+    ValueInfo output_info(std::size_t i) const;
+
+    // classes and scores for every row of a float32 output
+    std::vector<AnyTensor> apply(const AnyTensor& output) const;
+
+    // one row of `classes` scores into the best k(classes) (class, score) pairs
+    void apply_row(const float* row, std::size_t classes, int64_t* top_classes, float* top_scores) const;
+    std::size_t k(std::size_t classes) const { return top_k_ && top_k_ < classes ? top_k_ : classes; }
+private:
+    bool configured_ = false;
+    bool softmax_ = false;
+    std::size_t top_k_ = 0;
+    float threshold_ = -std::numeric_limits<float>::infinity();
+    std::vector<std::string> labels_;
+};
+
+#endif
@@ -0,0 +1,276 @@
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace
+{
+
+std::string shape_string(const std::vector<std::size_t>& shape)
+{
+    std::string s = "[";
+    for (std::size_t i = 0; i < shape.size(); ++i)
+    {
+        if (i) s += "x";
+        s += std::to_string(shape[i]);
+    }
+    return s + "]";
+}
+
+std::string shapes_string(const std::vector<std::vector<std::size_t>>& shapes)
+{
+    std::string s;
+    for (std::size_t i = 0; i < shapes.size(); ++i)
+    {
+        if (i) s += ", ";
+        s += shape_string(shapes[i]);
+    }
+    return s;
+}
+
+// JSON string body, quotes and control characters escaped
+std::string json_escape(const std::string& text)
+{
+    std::string out;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            out += buffer;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::size_t product(const std::vector<int64_t>& dims)
+{
+    std::size_t n = 1;
+    for (auto d : dims) n *= static_cast<std::size_t>(d);
+    return n;
+}
+
+}
+
+uint64_t Profiler::now_us() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin_).count();
+}
+
+Profiler::Mark Profiler::mark() const
+{
+    Mark m;
+    if (counters_) m.counters = counters_->read();
+    m.time_us = now_us();
+    return m;
+}
+
+bool Profiler::enable_hardware_counters()
+{
+    if (!counters_) counters_ = std::make_unique<PerfCounters>();
+    return counters_->available();
+}
+
+const std::string& Profiler::hardware_status() const
+{
+    static const std::string off = "hardware counters not enabled";
+    return counters_ ? counters_->status() : off;
+}
+
+uint32_t Profiler::thread_index()
+{
+    static std::atomic<uint32_t> next{0};
+    thread_local uint32_t index = next++;
+    return index;
+}
+
+void Profiler::record(Event event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    OpStats& stats = stats_[event.op_type];
+    stats.count++;
+    stats.total_us += event.duration_us;
+    stats.min_us = std::min(stats.min_us, event.duration_us);
+    stats.max_us = std::max(stats.max_us, event.duration_us);
+    stats.bytes += event.bytes;
+    stats.flops += event.flops;
+    stats.counters += event.counters;
+
+    events_.push_back(std::move(event));
+}
+
+void Profiler::record_node(const Node& node, const std::vector<AnyTensor*>& inputs, const std::vector<AnyTensor*>& outputs, const Mark& start)
+{
+    Event event;
+    if (counters_) event.counters = counters_->read() - start.counters;
+    event.duration_us = now_us() - start.time_us;
+    event.start_us = start.time_us;
+    event.name = node.get_name();
+    event.op_type = node.get_optype();
+    event.thread_id = thread_index();
+
+    for (const AnyTensor* t : inputs)
+    {
+        event.input_shapes.push_back(t ? t->shape() : std::vector<std::size_t>{});
+        if (t) event.bytes += t->bytes();
+    }
+    for (const AnyTensor* t : outputs)
+    {
+        event.output_shapes.push_back(t->shape());
+        event.bytes += t->bytes();
+    }
+    event.flops = estimate_flops(node, inputs, outputs);
+
+    record(std::move(event));
+}
+
+void Profiler::record_interval(const std::string& name, const Mark& start)
+{
+    Event event;
+    if (counters_) event.counters = counters_->read() - start.counters;
+    event.duration_us = now_us() - start.time_us;
+    event.start_us = start.time_us;
+    event.name = name;
+    event.op_type = name;
+    event.thread_id = thread_index();
+    record(std::move(event));
+}
+
+std::vector<Profiler::Event> Profiler::events() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+}
+
+std::unordered_map<std::string, Profiler::OpStats> Profiler::op_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    stats_.clear();
+}
+
+// complete ("X") events, one per node, in the Trace Event Format
+void Profiler::write_chrome_trace(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (std::size_t i = 0; i < events_.size(); ++i)
+    {
+        const Event& e = events_[i];
+        out << (i ? ",\n" : "\n");
+        out << "{\"name\":\"" << json_escape(e.name) << "\",\"cat\":\"" << json_escape(e.op_type) << "\",\"ph\":\"X\""
+            << ",\"ts\":" << e.start_us << ",\"dur\":" << e.duration_us << ",\"pid\":1,\"tid\":" << e.thread_id
+            << ",\"args\":{\"op_type\":\"" << json_escape(e.op_type) << "\",\"inputs\":\"" << shapes_string(e.input_shapes)
+            << "\",\"outputs\":\"" << shapes_string(e.output_shapes) << "\",\"bytes\":" << e.bytes << ",\"flops\":" << e.flops;
+        for (int c = 0; c < PerfSample::EventCount; ++c)
+        {
+            if (e.counters.valid[c]) out << ",\"" << PerfSample::event_name(static_cast<PerfSample::Event>(c)) << "\":" << e.counters.values[c];
+        }
+        out << "}}";
+    }
+    out << "\n]}\n";
+}
+
+void Profiler::write_chrome_trace(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("Profiler error: cannot write trace to '" + path + "'.");
+    write_chrome_trace(file);
+}
+
+void Profiler::print_summary(std::ostream& out) const
+{
+    std::vector<std::pair<std::string, OpStats>> rows;
+    uint64_t node_total = 0;
+    bool counted = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : stats_)
+        {
+            if (entry.first == "run") continue;
+            rows.push_back(entry);
+            node_total += entry.second.total_us;
+            counted = counted || entry.second.counters.any();
+        }
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.second.total_us > b.second.total_us; });
+
+    out << std::left << std::setw(24) << "op type" << std::right << std::setw(8) << "calls" << std::setw(12) << "total ms"
+        << std::setw(10) << "avg us" << std::setw(10) << "max us" << std::setw(8) << "%" << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s";
+    if (counted) out << std::setw(8) << "IPC" << std::setw(10) << "LLC miss%";
+    out << "\n";
+
+    auto old_flags = out.flags();
+    auto old_precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+    for (const auto& [op, s] : rows)
+    {
+        double seconds = s.total_us * 1e-6;
+        out << std::left << std::setw(24) << op << std::right << std::setw(8) << s.count << std::setw(12) << s.total_us * 1e-3
+            << std::setw(10) << static_cast<double>(s.total_us) / s.count << std::setw(10) << s.max_us
+            << std::setw(8) << (node_total ? 100.0 * s.total_us / node_total : 0.0)
+            << std::setw(10) << (seconds > 0 ? s.flops / seconds * 1e-9 : 0.0)
+            << std::setw(10) << (seconds > 0 ? s.bytes / seconds * 1e-9 : 0.0);
+        if (counted) out << std::setw(8) << s.counters.ipc() << std::setw(10) << 100.0 * s.counters.miss_rate();
+        out << "\n";
+    }
+    out.flags(old_flags);
+    out.precision(old_precision);
+    if (counters_ && !counters_->available()) out << "(" << counters_->status() << ")\n";
+}
+
+uint64_t Profiler::estimate_flops(const Node& node, const std::vector<AnyTensor*>& inputs, const std::vector<AnyTensor*>& outputs)
+{
+    if (outputs.empty() || inputs.empty() || !inputs[0]) return 0;
+
+    const std::string op = node.get_optype();
+    const uint64_t out = outputs[0]->size();
+    const std::vector<std::size_t>& a = inputs[0]->shape();
+
+    if (op == "Gemm" && inputs.size() > 1 && a.size() == 2)
+    {
+        std::size_t K = node.get_attribute<int64_t>("transA").value_or(0) ? a[0] : a[1];
+        return 2 * out * K;
+    }
+    if (op == "MatMul" && !a.empty())
+        return 2 * out * a.back();
+    if (op == "SparseGemm" && inputs.size() > 1 && !a.empty() && a.back() > 0)
+        return 2 * (inputs[0]->size() / a.back()) * inputs[1]->size();       // stored tiles only
+    if ((op == "Conv" || op == "NchwcConv") && inputs.size() > 1 && !inputs[1]->shape().empty())
+    {
+        // per output element: one multiply-add per weight of one output channel
+        const std::vector<std::size_t>& w = inputs[1]->shape();
+        std::size_t out_channels = op == "Conv" ? w[0] : w[0] * (w.size() == 6 ? w[5] : 1);
+        return out_channels ? 2 * out * (inputs[1]->size() / out_channels) : 0;
+    }
+    if (op == "MaxPool" || op == "AveragePool" || op == "NchwcMaxPool" || op == "NchwcAveragePool")
+        return out * product(node.get_attribute<std::vector<int64_t>>("kernel_shape").value_or(std::vector<int64_t>{}));
+    if (op == "GlobalAveragePool" || op == "NchwcGlobalAveragePool")
+        return inputs[0]->size();
+    if (op == "BatchNormalization")
+        return 2 * out;
+    if (op == "Add" || op == "Relu" || op == "Sigmoid" || op == "Tanh" || op == "Gelu" || op == "Silu" ||
+        op == "Softmax" || op == "LogSoftmax")
+        return out;
+    return 0;                                                               // reshapes, copies, casts
+}
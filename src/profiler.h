@@ -0,0 +1,90 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "any_tensor.h"
+#include "node.h"
+#include "perf_counters.h"
+
+// opt-in per-node profiler. the engine records one event per executed node (plus
+// one per run) with timing, thread, shapes, bytes touched and estimated FLOPs;
+// per-op-type totals accumulate across runs. events export as Chrome trace JSON
+// for chrome://tracing or ui.perfetto.dev
+class Profiler
+{
+public:
+    struct Event
+    {
+        std::string name;                                   // node name, "run" for a whole inference
+        std::string op_type;
+        uint64_t start_us = 0;                              // since the profiler was created
+        uint64_t duration_us = 0;
+        uint32_t thread_id = 0;
+        std::vector<std::vector<std::size_t>> input_shapes;
+        std::vector<std::vector<std::size_t>> output_shapes;
+        uint64_t bytes = 0;                                 // input + output tensor bytes
+        uint64_t flops = 0;
+        PerfSample counters;                                // hardware events, when enabled
+    };
+
+    struct OpStats
+    {
+        std::size_t count = 0;
+        uint64_t total_us = 0, min_us = UINT64_MAX, max_us = 0;
+        uint64_t bytes = 0, flops = 0;
+        PerfSample counters;
+    };
+
+    // start of a timed interval
+    struct Mark
+    {
+        uint64_t time_us = 0;
+        PerfSample counters;
+    };
+
+    Profiler() : origin_(std::chrono::steady_clock::now()) {}
+
+    uint64_t now_us() const;
+    Mark mark() const;
+
+    // also read cycles, instructions and LLC traffic around every event. returns
+    // whether any counter could be opened, hardware_status() explains the rest
+    bool enable_hardware_counters();
+    const std::string& hardware_status() const;
+
+    // thread-safe
+    void record(Event event);
+    void record_node(const Node& node, const std::vector<AnyTensor*>& inputs, const std::vector<AnyTensor*>& outputs, const Mark& start);
+    void record_interval(const std::string& name, const Mark& start);          // e.g. a whole run
+
+    std::vector<Event> events() const;
+    std::unordered_map<std::string, OpStats> op_stats() const;
+    void clear();                                           // drops events and totals
+
+    void write_chrome_trace(std::ostream& out) const;
+    void write_chrome_trace(const std::string& path) const;
+    void print_summary(std::ostream& out) const;            // per op type, most expensive first
+
+    // multiply-adds count as 2, elementwise ops as 1 per output, data movement as 0
+    static uint64_t estimate_flops(const Node& node, const std::vector<AnyTensor*>& inputs, const std::vector<AnyTensor*>& outputs);
+
+    // small stable id for the calling thread
+    static uint32_t thread_index();
+
+private:
+    std::chrono::steady_clock::time_point origin_;
+    std::unique_ptr<PerfCounters> counters_;
+    std::vector<Event> events_;
+    std::unordered_map<std::string, OpStats> stats_;
+    mutable std::mutex mutex_;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "result_cache.h"
+#include "kernels/kernels.h"
+
+namespace
+{
+
+// bookkeeping charged to an entry on top of its tensor data
+std::size_t entry_bytes(const std::vector<AnyTensor>& outputs)
+{
+    std::size_t bytes = 128;
+    for (const AnyTensor& tensor : outputs) bytes += sizeof(AnyTensor) + tensor.bytes() + tensor.shape().size() * sizeof(std::size_t);
+    return bytes;
+}
+
+}
+
+ResultCache::ResultCache(const std::string& model, std::size_t capacity_bytes, std::size_t shards)
+    : capacity_(capacity_bytes), shard_capacity_(capacity_bytes / (shards ? shards : 1)), shards_(shards ? shards : 1)
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    const char* help = "Result cache lookups";
+    hits_ = &registry.counter("infera_result_cache_requests_total", help, {{"model", model}, {"result", "hit"}});
+    misses_ = &registry.counter("infera_result_cache_requests_total", help, {{"model", model}, {"result", "miss"}});
+    evictions_ = &registry.counter("infera_result_cache_evictions_total", "Result cache entries dropped for space", {{"model", model}});
+    bytes_gauge_ = &registry.gauge("infera_result_cache_bytes", "Memory held by result caches", {{"model", model}});
+}
+
+ResultCache::~ResultCache()
+{
+    bytes_gauge_->add(-static_cast<int64_t>(bytes()));
+}
+
+CacheKey ResultCache::key(const std::vector<AnyTensor*>& inputs)
+{
+    // chained: every input's hash is seeded with everything before it
+    CacheKey key{0x6a09e667f3bcc908ull, 0xbb67ae8584caa73bull};
+    std::vector<uint64_t> header;
+    for (const AnyTensor* input : inputs)
+    {
+        header.assign({static_cast<uint64_t>(input->dtype()), input->shape().size()});
+        header.insert(header.end(), input->shape().begin(), input->shape().end());
+
+        uint64_t h[2];
+        kernels().hash128(header.data(), header.size() * sizeof(uint64_t), key.low, h);
+        kernels().hash128(input->raw(), input->bytes(), h[0] ^ h[1], h);
+        key = {h[0], h[1] ^ key.high};
+    }
+    return key;
+}
+
+CachedOutputs ResultCache::lookup(const CacheKey& key)
+{
+    Shard& shard = shard_of(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end())
+        {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            hits_->inc();
+            hits_count_.fetch_add(1, std::memory_order_relaxed);
+            return it->second->second;
+        }
+    }
+    misses_->inc();
+    misses_count_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void ResultCache::insert(const CacheKey& key, CachedOutputs outputs)
+{
+    const std::size_t bytes = entry_bytes(*outputs);
+    if (bytes > shard_capacity_) return;
+
+    Shard& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // a concurrent miss on the same inputs already stored it
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) erase_locked(shard, it->second);
+
+    while (!shard.lru.empty() && shard.bytes + bytes > shard_capacity_)
+    {
+        erase_locked(shard, std::prev(shard.lru.end()));
+        evictions_->inc();
+    }
+
+    shard.lru.emplace_front(key, std::move(outputs));
+    shard.index[key] = shard.lru.begin();
+    shard.bytes += bytes;
+    bytes_gauge_->add(static_cast<int64_t>(bytes));
+}
+
+void ResultCache::erase_locked(Shard& shard, std::list<Shard::Entry>::iterator it)
+{
+    const std::size_t bytes = entry_bytes(*it->second);
+    shard.bytes -= bytes;
+    bytes_gauge_->add(-static_cast<int64_t>(bytes));
+    shard.index.erase(it->first);
+    shard.lru.erase(it);
+}
+
+void ResultCache::clear()
+{
+    for (Shard& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        bytes_gauge_->add(-static_cast<int64_t>(shard.bytes));
+        shard.lru.clear();
+        shard.index.clear();
+        shard.bytes = 0;
+    }
+}
+
+std::size_t ResultCache::bytes() const
+{
+    std::size_t total = 0;
+    for (const Shard& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.bytes;
+    }
+    return total;
+}
+
+std::size_t ResultCache::entries() const
+{
+    std::size_t total = 0;
+    for (const Shard& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.lru.size();
+    }
+    return total;
+}
@@ -0,0 +1,91 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "any_tensor.h"
+#include "metrics.h"
+
+// 128-bit hash of a request's inputs: dtype, shape and bytes of each, in order
+struct CacheKey
+{
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const CacheKey& other) const { return low == other.low && high == other.high; }
+};
+
+struct CacheKeyHash
+{
+    std::size_t operator()(const CacheKey& key) const { return static_cast<std::size_t>(key.low); }
+};
+
+// outputs of one cached run, never modified once stored
+using CachedOutputs = std::shared_ptr<const std::vector<AnyTensor>>;
+
+// exact-match cache of model outputs, for models that see the same inputs over and
+// over (retries, popular items). keys are the hash alone, without the input bytes,
+// so two different requests would have to collide in 128 bits to get each other's
+// result. entries are spread over independently locked shards, each an LRU bounded
+// to its share of the byte budget. a cache belongs to one model version: a new
+// version starts with an empty one, which is the invalidation
+class ResultCache
+{
+public:
+    // `model` labels the metrics
+    ResultCache(const std::string& model, std::size_t capacity_bytes, std::size_t shards = 16);
+    ~ResultCache();
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    static CacheKey key(const std::vector<AnyTensor*>& inputs);
+
+    // the stored outputs, or null; counts a hit or a miss
+    CachedOutputs lookup(const CacheKey& key);
+
+    // store (or refresh) the outputs for `key`, evicting least recently used entries
+    // of its shard. results larger than a shard's budget are not kept
+    void insert(const CacheKey& key, CachedOutputs outputs);
+
+    void clear();
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t bytes() const;
+    std::size_t entries() const;
+    uint64_t hits() const { return hits_count_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_count_.load(std::memory_order_relaxed); }
+private:
+    struct Shard
+    {
+        using Entry = std::pair<CacheKey, CachedOutputs>;
+
+        mutable std::mutex mutex;
+        std::list<Entry> lru;                               // front is most recent
+        std::unordered_map<CacheKey, std::list<Entry>::iterator, CacheKeyHash> index;
+        std::size_t bytes = 0;
+    };
+
+    Shard& shard_of(const CacheKey& key) { return shards_[(key.high >> 32) % shards_.size()]; }
+    void erase_locked(Shard& shard, std::list<Shard::Entry>::iterator it);
+
+    std::size_t capacity_;
+    std::size_t shard_capacity_;
+    std::vector<Shard> shards_;
+    std::atomic<uint64_t> hits_count_{0};                   // this cache only, the counters span versions
+    std::atomic<uint64_t> misses_count_{0};
+
+    Counter* hits_;
+    Counter* misses_;
+    Counter* evictions_;
+    Gauge* bytes_gauge_;                                    // shared by every version of the model
+};
+
+#endif
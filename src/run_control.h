@@ -0,0 +1,60 @@
+#ifndef RUN_CONTROL_H
+#define RUN_CONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using Deadline = std::chrono::steady_clock::time_point;
+
+// shared cancel flag: copies observe the same cancel(). a default token is never
+// cancelled and costs nothing, make() creates one that can be
+class CancellationToken
+{
+public:
+    CancellationToken() = default;
+    static CancellationToken make()
+    {
+        CancellationToken token;
+        token.flag_ = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    void cancel() const { if (flag_) flag_->store(true, std::memory_order_release); }
+    bool cancelled() const { return flag_ && flag_->load(std::memory_order_acquire); }
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+class DeadlineExceeded : public std::runtime_error
+{
+public:
+    explicit DeadlineExceeded(const std::string& where) : std::runtime_error("deadline exceeded " + where) {}
+};
+
+class RequestCancelled : public std::runtime_error
+{
+public:
+    explicit RequestCancelled(const std::string& where) : std::runtime_error("request cancelled " + where) {}
+};
+
+// limits of one run, checked before it is scheduled and between graph nodes
+struct RunControl
+{
+    Deadline deadline = Deadline::max();
+    CancellationToken token;
+
+    bool expired() const { return deadline != Deadline::max() && std::chrono::steady_clock::now() >= deadline; }
+    bool should_stop() const { return token.cancelled() || expired(); }
+
+    // throws DeadlineExceeded / RequestCancelled; `where` finishes the message
+    void check(const std::string& where) const
+    {
+        if (token.cancelled()) throw RequestCancelled(where);
+        if (expired()) throw DeadlineExceeded(where);
+    }
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "http.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+std::string lowercase(std::string s)
+{
+    for (char& c : s)
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    return s;
+}
+
+std::string trim(const char* begin, const char* end)
+{
+    while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) --end;
+    return std::string(begin, end);
+}
+
+bool contains_token(const std::string& value, const char* token)
+{
+    return lowercase(value).find(token) != std::string::npos;
+}
+
+}
+
+const std::string* HttpRequest::header(const std::string& lowercase_name) const
+{
+    for (const auto& h : headers)
+        if (h.first == lowercase_name) return &h.second;
+    return nullptr;
+}
+
+HttpParse parse_http_request(const char* buffer, std::size_t size, const HttpLimits& limits, HttpRequest& request,
+                             std::size_t& consumed, int& status, std::string& error)
+{
+    auto fail = [&](int code, const char* message)
+    {
+        status = code;
+        error = message;
+        return HttpParse::Error;
+    };
+
+    // headers end at the first blank line
+    const char* end = buffer + size;
+    const char* header_end = nullptr;
+    for (const char* p = buffer; p + 3 < end; ++p)
+    {
+        if (p[0] == '\r' && p[1] == '\n' && p[2] == '\r' && p[3] == '\n')
+        {
+            header_end = p;
+            break;
+        }
+    }
+    if (!header_end)
+    {
+        if (size > limits.max_header_bytes) return fail(431, "request headers too large");
+        return HttpParse::Incomplete;
+    }
+    if (static_cast<std::size_t>(header_end - buffer) > limits.max_header_bytes) return fail(431, "request headers too large");
+
+    request = HttpRequest();
+
+    // request line: METHOD SP target SP HTTP/1.x
+    const char* line_end = static_cast<const char*>(std::memchr(buffer, '\r', header_end - buffer + 2));
+    const char* sp1 = static_cast<const char*>(std::memchr(buffer, ' ', line_end - buffer));
+    const char* sp2 = sp1 ? static_cast<const char*>(std::memchr(sp1 + 1, ' ', line_end - sp1 - 1)) : nullptr;
+    if (!sp1 || !sp2) return fail(400, "malformed request line");
+
+    request.method.assign(buffer, sp1);
+    std::string target(sp1 + 1, sp2);
+    std::string version(sp2 + 1, line_end);
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") return fail(505, "unsupported HTTP version");
+    request.keep_alive = version == "HTTP/1.1";
+
+    std::size_t question = target.find('?');
+    request.path = target.substr(0, question);
+    if (question != std::string::npos) request.query = target.substr(question + 1);
+
+    // header fields
+    const char* p = line_end + 2;
+    while (p < header_end + 2)
+    {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\r', header_end + 2 - p));
+        if (!eol) eol = header_end;
+        const char* colon = static_cast<const char*>(std::memchr(p, ':', eol - p));
+        if (!colon) return fail(400, "malformed header line");
+        request.headers.emplace_back(lowercase(std::string(p, colon)), trim(colon + 1, eol));
+        p = eol + 2;
+    }
+
+    if (const std::string* connection = request.header("connection"))
+    {
+        if (contains_token(*connection, "close")) request.keep_alive = false;
+        else if (contains_token(*connection, "keep-alive")) request.keep_alive = true;
+    }
+
+    if (const std::string* encoding = request.header("transfer-encoding"))
+    {
+        if (lowercase(*encoding) != "identity") return fail(411, "chunked request bodies are not supported, send Content-Length");
+    }
+
+    std::size_t body_size = 0;
+    if (const std::string* length = request.header("content-length"))
+    {
+        if (length->empty() || !std::all_of(length->begin(), length->end(), [](char c) { return c >= '0' && c <= '9'; }) || length->size() > 12)
+            return fail(400, "invalid Content-Length");
+        body_size = std::stoull(*length);
+        if (body_size > limits.max_body_bytes) return fail(413, "request body too large");
+    }
+
+    const std::size_t header_bytes = header_end + 4 - buffer;
+    if (size - header_bytes < body_size) return HttpParse::Incomplete;
+
+    request.body.assign(buffer + header_bytes, body_size);
+    consumed = header_bytes + body_size;
+    return HttpParse::Complete;
+}
+
+const char* http_status_text(int status)
+{
+    switch (status)
+    {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 411: return "Length Required";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    case 505: return "HTTP Version Not Supported";
+    default:  return "Unknown";
+    }
+}
+
+std::string http_response(int status, const std::string& content_type, const std::string& body, bool keep_alive,
+                          const std::string& extra_headers)
+{
+    std::string out;
+    out.reserve(body.size() + 160);
+    out += "HTTP/1.1 ";
+    out += std::to_string(status);
+    out += ' ';
+    out += http_status_text(status);
+    out += "\r\nContent-Type: ";
+    out += content_type;
+    out += "\r\nContent-Length: ";
+    out += std::to_string(body.size());
+    out += keep_alive ? "\r\nConnection: keep-alive\r\n" : "\r\nConnection: close\r\n";
+    out += extra_headers;
+    out += "\r\n";
+    out += body;
+    return out;
+}
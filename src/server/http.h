@@ -0,0 +1,49 @@
+#ifndef SERVER_HTTP_H
+#define SERVER_HTTP_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// HTTP/1.1 request framing for the server: Content-Length bodies, keep-alive and
+// pipelining. chunked request bodies are refused (411), which no inference client
+// in practice sends
+
+struct HttpRequest
+{
+    std::string method;
+    std::string path;                                       // target without the query string
+    std::string query;
+    std::vector<std::pair<std::string, std::string>> headers;   // names lowercased
+    std::string body;
+    bool keep_alive = true;
+
+    const std::string* header(const std::string& lowercase_name) const;
+};
+
+enum class HttpParse
+{
+    Incomplete,                                             // need more bytes
+    Complete,
+    Error
+};
+
+struct HttpLimits
+{
+    std::size_t max_header_bytes = 64 * 1024;
+    std::size_t max_body_bytes = 64 * 1024 * 1024;
+};
+
+// parse one request from the front of `buffer`. on Complete, `consumed` is its
+// length; on Error, `status` and `error` describe the response to send before closing
+HttpParse parse_http_request(const char* buffer, std::size_t size, const HttpLimits& limits, HttpRequest& request,
+                             std::size_t& consumed, int& status, std::string& error);
+
+// full response with Content-Length, `extra_headers` are "Name: value\r\n" lines
+std::string http_response(int status, const std::string& content_type, const std::string& body, bool keep_alive,
+                          const std::string& extra_headers = "");
+
+const char* http_status_text(int status);
+
+#endif
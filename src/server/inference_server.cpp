@@ -0,0 +1,668 @@
+#include "inference_server.h"
+#include "json.h"
+#include "kserve.h"
+#include "../logger.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace
+{
+
+uint64_t now_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string json_error(int status, const std::string& message, bool keep_alive)
+{
+    std::string body = "{\"error\":";
+    JsonValue::append_string(body, message);
+    body += "}";
+    return http_response(status, "application/json", body, keep_alive);
+}
+
+// overload and deadline failures keep their meaning for the client
+std::string failure_response(std::exception_ptr error, bool keep_alive)
+{
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch (const DeadlineExceeded& e)
+    {
+        return json_error(504, e.what(), keep_alive);
+    }
+    catch (const QueueFull& e)
+    {
+        return json_error(503, e.what(), keep_alive);
+    }
+    catch (const RequestCancelled& e)
+    {
+        return json_error(503, e.what(), keep_alive);
+    }
+    catch (const std::exception& e)
+    {
+        return json_error(500, e.what(), keep_alive);
+    }
+}
+
+// "/v2/models/<name>[/versions/<v>][/<action>]" split on '/'
+std::vector<std::string> split_path(const std::string& path)
+{
+    std::vector<std::string> parts;
+    std::size_t start = 1;
+    while (start <= path.size())
+    {
+        std::size_t slash = path.find('/', start);
+        if (slash == std::string::npos) slash = path.size();
+        if (slash > start) parts.push_back(path.substr(start, slash - start));
+        start = slash + 1;
+    }
+    return parts;
+}
+
+// X-Infera-Timeout-Ms and X-Infera-Priority, falling back to the server default timeout
+bool parse_request_options(const HttpRequest& request, uint64_t default_timeout_ms, RequestOptions& options, std::string& error)
+{
+    uint64_t timeout_ms = default_timeout_ms;
+    if (const std::string* value = request.header("x-infera-timeout-ms"))
+    {
+        if (value->empty() || value->size() > 12 || value->find_first_not_of("0123456789") != std::string::npos)
+        {
+            error = "invalid X-Infera-Timeout-Ms";
+            return false;
+        }
+        timeout_ms = std::stoull(*value);
+    }
+    if (timeout_ms) options.control.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    if (const std::string* value = request.header("x-infera-priority"))
+    {
+        if (*value == "high")
+            options.priority = Priority::High;
+        else if (*value == "normal")
+            options.priority = Priority::Normal;
+        else if (*value == "low")
+            options.priority = Priority::Low;
+        else
+        {
+            error = "X-Infera-Priority must be high, normal or low";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parse_version(const std::string& text, int64_t& version)
+{
+    if (text.empty() || text.size() > 18) return false;
+    for (char c : text)
+        if (c < '0' || c > '9') return false;
+    version = std::stoll(text);
+    return version > 0;
+}
+
+}
+
+struct InferenceServer::Connection
+{
+    int fd = -1;
+    uint64_t id = 0;
+    std::string in;
+    std::string out;
+    std::size_t out_offset = 0;
+    bool busy = false;                                      // a worker owes this connection a response
+    CancellationToken token;                                // of the request in flight, cancelled on close
+    bool close_after_write = false;
+    bool watching_writes = false;
+};
+
+struct InferenceServer::IoLoop
+{
+    int epoll_fd = -1;
+    int wake_fd = -1;                                       // eventfd: completions posted or stopping
+    std::thread thread;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+
+    std::mutex mutex;
+    std::vector<Completion> completions;
+};
+
+InferenceServer::InferenceServer(ModelRepository& repository, const ServerOptions& options) : repository_(repository), options_(options)
+{
+    if (options_.io_threads == 0) options_.io_threads = 1;
+    if (options_.workers == 0) options_.workers = 1;
+
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    connections_total_ = &registry.counter("infera_http_connections_total", "Accepted HTTP connections");
+    request_seconds_ = &registry.histogram("infera_http_request_seconds", "Time from a parsed request to its queued response");
+}
+
+InferenceServer::~InferenceServer()
+{
+    stop();
+}
+
+void InferenceServer::start()
+{
+    if (running_) return;
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options_.port);
+    if (inet_pton(AF_INET, options_.host.c_str(), &address.sin_addr) != 1)
+    {
+        close(listen_fd_);
+        throw std::runtime_error("Invalid listen address '" + options_.host + "'.");
+    }
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listen_fd_, 1024) < 0)
+    {
+        std::string error = std::strerror(errno);
+        close(listen_fd_);
+        throw std::runtime_error("Cannot listen on " + options_.host + ":" + std::to_string(options_.port) + ": " + error);
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    running_ = true;
+    AsyncOptions scheduling;
+    scheduling.workers = options_.workers;
+    scheduling.max_queue = options_.max_queue;
+    scheduling.overflow = options_.overflow;
+    workers_ = std::make_unique<AsyncEngine>(scheduling);
+
+    for (std::size_t i = 0; i < options_.io_threads; ++i)
+    {
+        auto loop = std::make_unique<IoLoop>();
+        loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;            // one loop wakes per new connection
+        event.data.fd = listen_fd_;
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, listen_fd_, &event);
+
+        event.events = EPOLLIN;
+        event.data.fd = loop->wake_fd;
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wake_fd, &event);
+
+        loops_.push_back(std::move(loop));
+    }
+    for (auto& loop : loops_)
+    {
+        IoLoop* raw = loop.get();
+        raw->thread = std::thread([this, raw] { io_loop(*raw); });
+    }
+
+    INFERA_LOG_INFO("serving on %s:%u with %zu I/O thread(s) and %zu worker(s)", options_.host.c_str(), port_, options_.io_threads, options_.workers);
+}
+
+void InferenceServer::stop()
+{
+    if (!running_.exchange(false)) return;
+
+    // loops first: once joined nothing can be inside submit(), so no new work reaches
+    // the workers while they shut down
+    for (auto& loop : loops_)
+    {
+        uint64_t one = 1;
+        if (write(loop->wake_fd, &one, sizeof(one)) < 0) {}
+        loop->thread.join();
+    }
+
+    // queued requests still finish; they post into loops that exist but no longer run
+    workers_.reset();
+
+    for (auto& loop : loops_)
+    {
+        loop->completions.clear();                          // answers nobody will send
+        for (auto& entry : loop->connections) close(entry.first);
+        close(loop->wake_fd);
+        close(loop->epoll_fd);
+    }
+    loops_.clear();
+
+    close(listen_fd_);
+    listen_fd_ = -1;
+}
+
+void InferenceServer::io_loop(IoLoop& loop)
+{
+    epoll_event events[64];
+    while (running_)
+    {
+        int ready = epoll_wait(loop.epoll_fd, events, 64, -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR) continue;
+            INFERA_LOG_ERROR("epoll_wait failed: %s", std::strerror(errno));
+            return;
+        }
+
+        for (int i = 0; i < ready && running_; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == listen_fd_)
+            {
+                accept_connections(loop);
+                continue;
+            }
+            if (fd == loop.wake_fd)
+            {
+                uint64_t count;
+                if (read(loop.wake_fd, &count, sizeof(count)) < 0) {}
+                drain_completions(loop);
+                continue;
+            }
+
+            auto it = loop.connections.find(fd);
+            if (it == loop.connections.end()) continue;
+            Connection& connection = *it->second;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                close_connection(loop, fd);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                flush(loop, connection);
+                if (!loop.connections.count(fd)) continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP)) read_connection(loop, connection);
+        }
+    }
+}
+
+void InferenceServer::accept_connections(IoLoop& loop)
+{
+    while (true)
+    {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) INFERA_LOG_WARN("accept failed: %s", std::strerror(errno));
+            return;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->id = next_connection_id_++;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        loop.connections[fd] = std::move(connection);
+        connections_total_->inc();
+    }
+}
+
+void InferenceServer::read_connection(IoLoop& loop, Connection& connection)
+{
+    const int fd = connection.fd;
+    char buffer[64 * 1024];
+    while (true)
+    {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0)
+        {
+            connection.in.append(buffer, static_cast<std::size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+        // orderly shutdown or error: any response still owed has nowhere to go
+        close_connection(loop, fd);
+        return;
+    }
+    process_requests(loop, connection);
+}
+
+void InferenceServer::process_requests(IoLoop& loop, Connection& connection)
+{
+    std::size_t offset = 0;
+
+    while (!connection.busy && !connection.close_after_write && offset < connection.in.size())
+    {
+        HttpRequest request;
+        std::size_t consumed = 0;
+        int status = 0;
+        std::string error;
+        HttpParse result = parse_http_request(connection.in.data() + offset, connection.in.size() - offset, options_.limits,
+                                              request, consumed, status, error);
+        if (result == HttpParse::Incomplete) break;
+        if (result == HttpParse::Error)
+        {
+            connection.out += json_error(status, error, false);
+            connection.close_after_write = true;
+            break;
+        }
+        offset += consumed;
+
+        const uint64_t start = now_us();
+        std::string response;
+        if (route(loop, connection, request, response))
+        {
+            connection.out += response;
+            if (!request.keep_alive) connection.close_after_write = true;
+            request_seconds_->record(now_us() - start);
+        }
+    }
+    connection.in.erase(0, offset);
+
+    flush(loop, connection);
+}
+
+void InferenceServer::flush(IoLoop& loop, Connection& connection)
+{
+    const int fd = connection.fd;
+    while (connection.out_offset < connection.out.size())
+    {
+        ssize_t n = send(fd, connection.out.data() + connection.out_offset, connection.out.size() - connection.out_offset, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            connection.out_offset += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        close_connection(loop, fd);
+        return;
+    }
+
+    const bool pending = connection.out_offset < connection.out.size();
+    if (!pending)
+    {
+        connection.out.clear();
+        connection.out_offset = 0;
+        if (connection.close_after_write)
+        {
+            close_connection(loop, fd);
+            return;
+        }
+    }
+
+    // only ask for EPOLLOUT while a write is blocked
+    if (pending != connection.watching_writes)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        event.data.fd = fd;
+        epoll_ctl(loop.epoll_fd, EPOLL_CTL_MOD, fd, &event);
+        connection.watching_writes = pending;
+    }
+}
+
+void InferenceServer::close_connection(IoLoop& loop, int fd)
+{
+    // nobody is left to read the answer: stop the work at its next check
+    auto it = loop.connections.find(fd);
+    if (it != loop.connections.end() && it->second->busy) it->second->token.cancel();
+
+    epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    loop.connections.erase(fd);
+}
+
+void InferenceServer::post(IoLoop& loop, Completion completion)
+{
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        loop.completions.push_back(std::move(completion));
+    }
+    uint64_t one = 1;
+    if (write(loop.wake_fd, &one, sizeof(one)) < 0) {}
+}
+
+void InferenceServer::drain_completions(IoLoop& loop)
+{
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        completions.swap(loop.completions);
+    }
+
+    for (Completion& completion : completions)
+    {
+        // the connection may be gone, or its fd reused by a newer one
+        auto it = loop.connections.find(completion.fd);
+        if (it == loop.connections.end() || it->second->id != completion.id) continue;
+
+        Connection& connection = *it->second;
+        connection.busy = false;
+        connection.out += completion.response;
+        if (!completion.keep_alive) connection.close_after_write = true;
+        process_requests(loop, connection);                 // pipelined requests waiting behind it
+    }
+}
+
+void InferenceServer::submit(IoLoop& loop, Connection& connection, bool keep_alive, RequestOptions options,
+                             std::function<std::string(InferenceEngine&)> work)
+{
+    connection.busy = true;
+    connection.token = CancellationToken::make();
+    options.control.token = connection.token;
+    const int fd = connection.fd;
+    const uint64_t id = connection.id;
+    const uint64_t start = now_us();
+
+    workers_->post([this, &loop, fd, id, keep_alive, start, work = std::move(work)](InferenceEngine& engine)
+    {
+        std::string response;
+        try
+        {
+            response = work(engine);
+        }
+        catch (...)
+        {
+            response = failure_response(std::current_exception(), keep_alive);
+        }
+        request_seconds_->record(now_us() - start);
+        post(loop, Completion{fd, id, std::move(response), keep_alive});
+    },
+    [this, &loop, fd, id, keep_alive](std::exception_ptr error)
+    {
+        // shed before it ran, possibly right here on the I/O thread
+        post(loop, Completion{fd, id, failure_response(error, keep_alive), keep_alive});
+    }, options);
+}
+
+bool InferenceServer::route(IoLoop& loop, Connection& connection, HttpRequest& request, std::string& response)
+{
+    const bool keep_alive = request.keep_alive;
+    const std::vector<std::string> parts = split_path(request.path);
+    const bool get = request.method == "GET" || request.method == "HEAD";
+    const bool post_method = request.method == "POST";
+    auto fail = [&](int status, const std::string& message)
+    {
+        response = json_error(status, message, keep_alive);
+        return true;
+    };
+
+    if (request.path == "/metrics")
+    {
+        if (!get) return fail(405, "use GET");
+        std::ostringstream text;
+        MetricsRegistry::instance().write_prometheus(text);
+        response = http_response(200, "text/plain; version=0.0.4", text.str(), keep_alive);
+        return true;
+    }
+
+    if (parts.empty() || parts[0] != "v2") return fail(404, "no route for " + request.path);
+
+    if (parts.size() == 1)
+    {
+        if (!get) return fail(405, "use GET");
+        response = http_response(200, "application/json", "{\"name\":\"infera\",\"version\":\"0.1.0\",\"extensions\":[\"binary_tensor_data\"]}", keep_alive);
+        return true;
+    }
+
+    if (parts[1] == "health" && parts.size() == 3 && (parts[2] == "live" || parts[2] == "ready"))
+    {
+        response = http_response(200, "application/json", "", keep_alive);
+        return true;
+    }
+
+    if (parts[1] != "models" || parts.size() < 3) return fail(404, "no route for " + request.path);
+
+    // models/<name>[/versions/<v>][/ready|/infer]
+    const std::string name = parts[2];
+    std::size_t next = 3;
+    int64_t version = 0;
+    if (parts.size() > 4 && parts[3] == "versions")
+    {
+        if (!parse_version(parts[4], version)) return fail(400, "invalid version '" + parts[4] + "'");
+        next = 5;
+    }
+    if (parts.size() > next + 1) return fail(404, "no route for " + request.path);
+    const std::string action = parts.size() > next ? parts[next] : "";
+
+    const std::vector<int64_t> versions = repository_.versions(name);
+    if (versions.empty()) return fail(404, "unknown model '" + name + "'");
+    if (version && std::find(versions.begin(), versions.end(), version) == versions.end())
+        return fail(404, "model '" + name + "' has no version " + std::to_string(version));
+
+    if (action == "ready")
+    {
+        response = http_response(200, "application/json", "", keep_alive);
+        return true;
+    }
+
+    if (action.empty())
+    {
+        if (!get) return fail(405, "use GET");
+        submit(loop, connection, keep_alive, RequestOptions{}, [this, name, version, versions, keep_alive](InferenceEngine&)
+        {
+            auto model = repository_.get(name, version);
+            return http_response(200, "application/json", model_metadata(*model, versions).dump(), keep_alive);
+        });
+        return false;
+    }
+
+    if (action == "infer")
+    {
+        if (!post_method) return fail(405, "use POST");
+        RequestOptions request_options;
+        std::string error;
+        if (!parse_request_options(request, options_.default_timeout_ms, request_options, error)) return fail(400, error);
+        const uint64_t queued = now_us();
+        auto shared = std::make_shared<HttpRequest>(std::move(request));
+        submit(loop, connection, keep_alive, request_options, [this, name, version, shared, keep_alive, queued](InferenceEngine& engine)
+        {
+            return infer(name, version, *shared, keep_alive, engine, queued);
+        });
+        return false;
+    }
+
+    return fail(404, "no route for " + request.path);
+}
+
+std::string InferenceServer::infer(const std::string& name, int64_t version, const HttpRequest& request, bool keep_alive,
+                                   InferenceEngine& engine, uint64_t queued_us)
+{
+    // per-model queue time, histograms looked up once per worker
+    thread_local std::unordered_map<std::string, Histogram*> queue_seconds;
+    Histogram*& queue = queue_seconds[name];
+    if (!queue) queue = &MetricsRegistry::instance().histogram("infera_inference_queue_seconds", "Time a request waited for a worker", {{"model", name}});
+    queue->record(now_us() - queued_us);
+
+    std::shared_ptr<LoadedModel> model;
+    try
+    {
+        model = repository_.get(name, version);
+    }
+    catch (const std::exception& e)
+    {
+        return json_error(503, e.what(), keep_alive);
+    }
+
+    InferRequest decoded;
+    std::size_t json_bytes = request.body.size();
+    if (const std::string* header = request.header("inference-header-content-length"))
+    {
+        try
+        {
+            json_bytes = std::stoull(*header);
+        }
+        catch (const std::exception&)
+        {
+            return json_error(400, "invalid Inference-Header-Content-Length", keep_alive);
+        }
+    }
+
+    try
+    {
+        decoded = decode_infer_request(request.body, json_bytes);
+    }
+    catch (const std::exception& e)
+    {
+        return json_error(400, e.what(), keep_alive);
+    }
+
+    // bind request inputs to graph inputs by name
+    Graph& graph = model->graph;
+    std::vector<AnyTensor*> inputs;
+    for (std::size_t i = 0; i < graph.get_input_size(); ++i)
+    {
+        AnyTensor* bound = nullptr;
+        for (InferInput& input : decoded.inputs)
+            if (input.name == graph.get_input_name(i)) bound = &input.tensor;
+        if (!bound) return json_error(400, "missing input '" + graph.get_input_name(i) + "'", keep_alive);
+        inputs.push_back(bound);
+    }
+    if (decoded.inputs.size() != inputs.size()) return json_error(400, "request has inputs the model does not take", keep_alive);
+
+    InferResponse encoded;
+    try
+    {
+        CachedOutputs held;
+        encoded = encode_infer_response(*model, decoded, model->run(engine, inputs, held));
+    }
+    catch (const std::invalid_argument& e)
+    {
+        return json_error(400, e.what(), keep_alive);
+    }
+    catch (const DeadlineExceeded&)
+    {
+        throw;
+    }
+    catch (const RequestCancelled&)
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        return json_error(400, std::string("inference failed: ") + e.what(), keep_alive);
+    }
+
+    if (encoded.json_bytes == encoded.body.size()) return http_response(200, "application/json", encoded.body, keep_alive);
+    return http_response(200, "application/octet-stream", encoded.body, keep_alive,
+                         "Inference-Header-Content-Length: " + std::to_string(encoded.json_bytes) + "\r\n");
+}
@@ -0,0 +1,115 @@
+#ifndef SERVER_INFERENCE_SERVER_H
+#define SERVER_INFERENCE_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "http.h"
+#include "../async_engine.h"
+#include "../inference_engine.h"
+#include "../metrics.h"
+#include "../model_repository.h"
+
+struct ServerOptions
+{
+    std::string host = "0.0.0.0";
+    uint16_t port = 8000;                                   // 0 picks a free port, see port()
+    std::size_t io_threads = 2;
+    std::size_t workers = 2;                                // inference threads, one engine each
+    std::size_t max_queue = 0;                              // requests waiting for a worker, 0 is unbounded
+    OverflowPolicy overflow = OverflowPolicy::RejectNew;
+    uint64_t default_timeout_ms = 0;                        // deadline for requests without X-Infera-Timeout-Ms
+    HttpLimits limits;
+};
+
+// KServe v2 HTTP front-end over a ModelRepository.
+//
+// a fixed set of I/O threads each run an epoll loop over non-blocking sockets; the
+// listening socket is shared with EPOLLEXCLUSIVE so a new connection wakes one loop,
+// which then owns it for its lifetime. cheap endpoints (health, server metadata,
+// /metrics) are answered on the I/O thread; model metadata and inference go to the
+// worker threads, whose responses come back through the owning loop's eventfd.
+// requests pipelined on one connection are answered in order, one at a time.
+//
+// inference requests may carry X-Infera-Timeout-Ms (504 once past it, whether
+// queued or running) and X-Infera-Priority: high|normal|low. with a bounded queue
+// a full server answers 503, and a closed connection cancels its request.
+//
+//   GET  /v2, /v2/health/live, /v2/health/ready
+//   GET  /v2/models/<name>[/versions/<v>]            model metadata
+//   GET  /v2/models/<name>[/versions/<v>]/ready
+//   POST /v2/models/<name>[/versions/<v>]/infer      JSON or binary tensor data
+//   GET  /metrics                                    Prometheus text format
+class InferenceServer
+{
+public:
+    InferenceServer(ModelRepository& repository, const ServerOptions& options = {});
+    ~InferenceServer();
+
+    InferenceServer(const InferenceServer&) = delete;
+    InferenceServer& operator=(const InferenceServer&) = delete;
+
+    // bind, listen and start the threads; throws if the address is unavailable
+    void start();
+
+    // stop accepting, finish queued work and join every thread
+    void stop();
+
+    uint16_t port() const { return port_; }
+
+    // the inference worker pool, between start() and stop()
+    AsyncEngine& workers() { return *workers_; }
+private:
+    struct Connection;
+    struct IoLoop;
+
+    // a response produced off the I/O thread, for connection `id` on `fd`
+    struct Completion
+    {
+        int fd;
+        uint64_t id;
+        std::string response;
+        bool keep_alive;
+    };
+
+    void io_loop(IoLoop& loop);
+
+    void accept_connections(IoLoop& loop);
+    void read_connection(IoLoop& loop, Connection& connection);
+    void process_requests(IoLoop& loop, Connection& connection);
+    void flush(IoLoop& loop, Connection& connection);
+    void close_connection(IoLoop& loop, int fd);
+    void drain_completions(IoLoop& loop);
+
+    // answer now (true) or hand the request to a worker (false)
+    bool route(IoLoop& loop, Connection& connection, HttpRequest& request, std::string& response);
+
+    void submit(IoLoop& loop, Connection& connection, bool keep_alive, RequestOptions options,
+                std::function<std::string(InferenceEngine&)> work);
+    void post(IoLoop& loop, Completion completion);
+
+    std::string infer(const std::string& model, int64_t version, const HttpRequest& request, bool keep_alive,
+                      InferenceEngine& engine, uint64_t queued_us);
+
+    ModelRepository& repository_;
+    ServerOptions options_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> next_connection_id_{1};
+
+    std::vector<std::unique_ptr<IoLoop>> loops_;
+
+    std::unique_ptr<AsyncEngine> workers_;
+
+    Counter* connections_total_;
+    Histogram* request_seconds_;
+};
+
+#endif
@@ -0,0 +1,412 @@
+#include "json.h"
+#include <charconv>
+#include <cmath>
+
+namespace
+{
+
+class Parser
+{
+public:
+    Parser(const char* data, std::size_t size) : p_(data), begin_(data), end_(data + size) {}
+
+    JsonValue document()
+    {
+        JsonValue value = parse_value(0);
+        skip_space();
+        if (p_ != end_) fail("trailing characters");
+        return value;
+    }
+private:
+    static constexpr int kMaxDepth = 128;
+
+    [[noreturn]] void fail(const char* what) const
+    {
+        throw std::runtime_error(std::string("JSON error at byte ") + std::to_string(p_ - begin_) + ": " + what);
+    }
+
+    void skip_space()
+    {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+    }
+
+    void expect(const char* word)
+    {
+        for (; *word; ++word, ++p_)
+            if (p_ == end_ || *p_ != *word) fail("invalid literal");
+    }
+
+    JsonValue parse_value(int depth)
+    {
+        if (depth > kMaxDepth) fail("nesting too deep");
+        skip_space();
+        if (p_ == end_) fail("unexpected end of input");
+
+        switch (*p_)
+        {
+        case '{': return parse_object(depth);
+        case '[': return parse_array(depth);
+        case '"': return JsonValue(parse_string());
+        case 't': expect("true"); return JsonValue(true);
+        case 'f': expect("false"); return JsonValue(false);
+        case 'n': expect("null"); return JsonValue();
+        default: return JsonValue(parse_number());
+        }
+    }
+
+    JsonValue parse_object(int depth)
+    {
+        JsonValue object = JsonValue::object();
+        ++p_;
+        skip_space();
+        if (p_ != end_ && *p_ == '}')
+        {
+            ++p_;
+            return object;
+        }
+        while (true)
+        {
+            skip_space();
+            if (p_ == end_ || *p_ != '"') fail("expected a member name");
+            std::string key = parse_string();
+            skip_space();
+            if (p_ == end_ || *p_ != ':') fail("expected ':'");
+            ++p_;
+            object.set(key, parse_value(depth + 1));
+            skip_space();
+            if (p_ == end_) fail("unterminated object");
+            if (*p_ == ',') { ++p_; continue; }
+            if (*p_ == '}') { ++p_; return object; }
+            fail("expected ',' or '}'");
+        }
+    }
+
+    JsonValue parse_array(int depth)
+    {
+        JsonValue array = JsonValue::array();
+        ++p_;
+        skip_space();
+        if (p_ != end_ && *p_ == ']')
+        {
+            ++p_;
+            return array;
+        }
+        while (true)
+        {
+            array.push(parse_value(depth + 1));
+            skip_space();
+            if (p_ == end_) fail("unterminated array");
+            if (*p_ == ',') { ++p_; continue; }
+            if (*p_ == ']') { ++p_; return array; }
+            fail("expected ',' or ']'");
+        }
+    }
+
+    double parse_number()
+    {
+        // validate the JSON grammar, from_chars alone would accept e.g. "01" or "+1"
+        const char* start = p_;
+        if (p_ != end_ && *p_ == '-') ++p_;
+        if (p_ == end_ || *p_ < '0' || *p_ > '9') fail("invalid value");
+        if (*p_ == '0') ++p_;
+        else while (p_ != end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        if (p_ != end_ && *p_ == '.')
+        {
+            ++p_;
+            if (p_ == end_ || *p_ < '0' || *p_ > '9') fail("digit expected after '.'");
+            while (p_ != end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        }
+        if (p_ != end_ && (*p_ == 'e' || *p_ == 'E'))
+        {
+            ++p_;
+            if (p_ != end_ && (*p_ == '+' || *p_ == '-')) ++p_;
+            if (p_ == end_ || *p_ < '0' || *p_ > '9') fail("digit expected in exponent");
+            while (p_ != end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        }
+
+        double value = 0.0;
+        auto result = std::from_chars(start, p_, value);
+        if (result.ec == std::errc::result_out_of_range) fail("number out of range");
+        return value;
+    }
+
+    unsigned parse_hex4()
+    {
+        if (end_ - p_ < 4) fail("truncated \\u escape");
+        unsigned code = 0;
+        for (int i = 0; i < 4; ++i, ++p_)
+        {
+            char c = *p_;
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= c - '0';
+            else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+            else fail("invalid \\u escape");
+        }
+        return code;
+    }
+
+    static void append_utf8(std::string& out, unsigned code)
+    {
+        if (code < 0x80)
+        {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else
+        {
+            out += static_cast<char>(0xf0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    std::string parse_string()
+    {
+        ++p_;                                               // opening quote
+        std::string out;
+        while (true)
+        {
+            // copy the run up to the next quote or escape in one go
+            const char* run = p_;
+            while (p_ != end_ && *p_ != '"' && *p_ != '\\')
+            {
+                if (static_cast<unsigned char>(*p_) < 0x20) fail("control character in string");
+                ++p_;
+            }
+            out.append(run, p_);
+            if (p_ == end_) fail("unterminated string");
+            if (*p_ == '"')
+            {
+                ++p_;
+                return out;
+            }
+
+            ++p_;                                           // backslash
+            if (p_ == end_) fail("unterminated escape");
+            char c = *p_++;
+            switch (c)
+            {
+            case '"':  out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/'; break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u':
+            {
+                unsigned code = parse_hex4();
+                if (code >= 0xd800 && code < 0xdc00)        // surrogate pair
+                {
+                    if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') fail("lone surrogate");
+                    p_ += 2;
+                    unsigned low = parse_hex4();
+                    if (low < 0xdc00 || low >= 0xe000) fail("invalid surrogate pair");
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                }
+                append_utf8(out, code);
+                break;
+            }
+            default: fail("invalid escape");
+            }
+        }
+    }
+
+    const char* p_;
+    const char* begin_;
+    const char* end_;
+};
+
+}
+
+JsonValue JsonValue::array()
+{
+    JsonValue v;
+    v.type_ = Type::Array;
+    return v;
+}
+
+JsonValue JsonValue::object()
+{
+    JsonValue v;
+    v.type_ = Type::Object;
+    return v;
+}
+
+JsonValue JsonValue::parse(const char* data, std::size_t size)
+{
+    return Parser(data, size).document();
+}
+
+bool JsonValue::as_bool() const
+{
+    if (type_ != Type::Bool) throw std::runtime_error("JSON value is not a boolean");
+    return bool_;
+}
+
+double JsonValue::as_number() const
+{
+    if (type_ != Type::Number) throw std::runtime_error("JSON value is not a number");
+    return number_;
+}
+
+int64_t JsonValue::as_int() const
+{
+    double n = as_number();
+    if (n != std::floor(n) || std::fabs(n) > 9007199254740992.0) throw std::runtime_error("JSON number is not an integer");
+    return static_cast<int64_t>(n);
+}
+
+const std::string& JsonValue::as_string() const
+{
+    if (type_ != Type::String) throw std::runtime_error("JSON value is not a string");
+    return string_;
+}
+
+const std::vector<JsonValue>& JsonValue::as_array() const
+{
+    if (type_ != Type::Array) throw std::runtime_error("JSON value is not an array");
+    return array_;
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const
+{
+    if (type_ != Type::Object) return nullptr;
+    for (const auto& member : object_)
+        if (member.first == key) return &member.second;
+    return nullptr;
+}
+
+const JsonValue& JsonValue::at(const std::string& key) const
+{
+    const JsonValue* value = find(key);
+    if (!value) throw std::runtime_error("JSON object has no member '" + key + "'");
+    return *value;
+}
+
+JsonValue& JsonValue::set(const std::string& key, JsonValue value)
+{
+    if (type_ != Type::Object) throw std::runtime_error("JSON value is not an object");
+    for (auto& member : object_)
+    {
+        if (member.first == key)
+        {
+            member.second = std::move(value);
+            return member.second;
+        }
+    }
+    object_.emplace_back(key, std::move(value));
+    return object_.back().second;
+}
+
+const std::vector<std::pair<std::string, JsonValue>>& JsonValue::members() const
+{
+    if (type_ != Type::Object) throw std::runtime_error("JSON value is not an object");
+    return object_;
+}
+
+JsonValue& JsonValue::push(JsonValue value)
+{
+    if (type_ != Type::Array) throw std::runtime_error("JSON value is not an array");
+    array_.push_back(std::move(value));
+    return array_.back();
+}
+
+std::size_t JsonValue::size() const
+{
+    if (type_ == Type::Array) return array_.size();
+    if (type_ == Type::Object) return object_.size();
+    return 0;
+}
+
+void JsonValue::append_number(std::string& out, double value)
+{
+    if (!std::isfinite(value))
+    {
+        out += "null";                                      // JSON has no inf / nan
+        return;
+    }
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void JsonValue::append_string(std::string& out, const std::string& value)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out += "\\u00";
+                out += hex[(c >> 4) & 0xf];
+                out += hex[c & 0xf];
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+void JsonValue::dump(std::string& out) const
+{
+    switch (type_)
+    {
+    case Type::Null:   out += "null"; break;
+    case Type::Bool:   out += bool_ ? "true" : "false"; break;
+    case Type::Number: append_number(out, number_); break;
+    case Type::String: append_string(out, string_); break;
+    case Type::Array:
+        out += '[';
+        for (std::size_t i = 0; i < array_.size(); ++i)
+        {
+            if (i) out += ',';
+            array_[i].dump(out);
+        }
+        out += ']';
+        break;
+    case Type::Object:
+        out += '{';
+        for (std::size_t i = 0; i < object_.size(); ++i)
+        {
+            if (i) out += ',';
+            append_string(out, object_[i].first);
+            out += ':';
+            object_[i].second.dump(out);
+        }
+        out += '}';
+        break;
+    }
+}
+
+std::string JsonValue::dump() const
+{
+    std::string out;
+    dump(out);
+    return out;
+}
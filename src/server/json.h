@@ -0,0 +1,82 @@
+#ifndef SERVER_JSON_H
+#define SERVER_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// minimal JSON document model for the server protocol: parse (RFC 8259, UTF-8
+// passed through, \u escapes decoded) and compact serialization. objects keep
+// member order, lookups are linear which is fine for protocol-sized objects
+class JsonValue
+{
+public:
+    enum class Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    JsonValue() = default;
+    JsonValue(bool b) : type_(Type::Bool), bool_(b) {}
+    JsonValue(double n) : type_(Type::Number), number_(n) {}
+    JsonValue(int n) : type_(Type::Number), number_(n) {}
+    JsonValue(int64_t n) : type_(Type::Number), number_(static_cast<double>(n)) {}
+    JsonValue(std::size_t n) : type_(Type::Number), number_(static_cast<double>(n)) {}
+    JsonValue(const char* s) : type_(Type::String), string_(s) {}
+    JsonValue(std::string s) : type_(Type::String), string_(std::move(s)) {}
+
+    static JsonValue array();
+    static JsonValue object();
+
+    // throws std::runtime_error with the byte offset of the problem
+    static JsonValue parse(const char* data, std::size_t size);
+    static JsonValue parse(const std::string& text) { return parse(text.data(), text.size()); }
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::Null; }
+    bool is_bool() const { return type_ == Type::Bool; }
+    bool is_number() const { return type_ == Type::Number; }
+    bool is_string() const { return type_ == Type::String; }
+    bool is_array() const { return type_ == Type::Array; }
+    bool is_object() const { return type_ == Type::Object; }
+
+    // typed access, throws on a type mismatch
+    bool as_bool() const;
+    double as_number() const;
+    int64_t as_int() const;                                 // number that must be integral
+    const std::string& as_string() const;
+    const std::vector<JsonValue>& as_array() const;
+
+    // object members: nullptr / throwing lookups and insertion (replaces an existing key)
+    const JsonValue* find(const std::string& key) const;
+    const JsonValue& at(const std::string& key) const;
+    JsonValue& set(const std::string& key, JsonValue value);
+    const std::vector<std::pair<std::string, JsonValue>>& members() const;
+
+    JsonValue& push(JsonValue value);                       // append to an array
+    std::size_t size() const;                               // array items or object members
+
+    std::string dump() const;
+    void dump(std::string& out) const;
+
+    // shortest round-trip form of a number, integers without a fraction
+    static void append_number(std::string& out, double value);
+    static void append_string(std::string& out, const std::string& value);
+private:
+    Type type_ = Type::Null;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::vector<std::pair<std::string, JsonValue>> object_;
+};
+
+#endif
@@ -0,0 +1,359 @@
+#include "kserve.h"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+
+// nested or flat "data" arrays, row-major
+void flatten(const JsonValue& value, std::vector<const JsonValue*>& out)
+{
+    if (value.is_array())
+    {
+        for (const JsonValue& item : value.as_array()) flatten(item, out);
+        return;
+    }
+    out.push_back(&value);
+}
+
+template <class T>
+T json_element(const JsonValue& v)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        if (v.is_bool()) return v.as_bool();
+        return v.as_number() != 0.0;
+    }
+    else if constexpr (std::is_same_v<T, float16>)
+    {
+        return float16{float_to_half(static_cast<float>(v.as_number()))};
+    }
+    else if constexpr (std::is_same_v<T, bfloat16>)
+    {
+        return bfloat16{float_to_bfloat16(static_cast<float>(v.as_number()))};
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        return static_cast<T>(v.as_int());
+    }
+    else
+    {
+        return static_cast<T>(v.as_number());
+    }
+}
+
+template <class T>
+void append_json_element(std::string& out, T value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+        out += value ? "true" : "false";
+    else if constexpr (std::is_same_v<T, float16> || std::is_same_v<T, bfloat16>)
+        JsonValue::append_number(out, to_double(value));
+    else if constexpr (std::is_same_v<T, float>)
+        JsonValue::append_number(out, static_cast<double>(value));     // shortest double form of the float
+    else
+        out += std::to_string(value);
+}
+
+// the labels of a postprocessing head's classes as a BYTES output. binary BYTES
+// elements are each a 4-byte little-endian length and the bytes
+void append_labels(std::string& out, std::string& binary, const Postprocessor& head, const AnyTensor& classes, bool as_binary)
+{
+    out += "{\"name\":\"labels\",\"datatype\":\"BYTES\",\"shape\":[";
+    for (std::size_t d = 0; d < classes.shape().size(); ++d)
+    {
+        if (d) out += ',';
+        out += std::to_string(classes.shape()[d]);
+    }
+    out += ']';
+
+    const int64_t* index = classes.get<int64_t>().data();
+    if (as_binary)
+    {
+        const std::size_t start = binary.size();
+        for (std::size_t i = 0; i < classes.size(); ++i)
+        {
+            const std::string label = head.label(index[i]);
+            const uint32_t length = static_cast<uint32_t>(label.size());
+            for (int b = 0; b < 4; ++b) binary += static_cast<char>((length >> (8 * b)) & 0xff);
+            binary += label;
+        }
+        out += ",\"parameters\":{\"binary_data_size\":" + std::to_string(binary.size() - start) + "}}";
+        return;
+    }
+
+    out += ",\"data\":[";
+    for (std::size_t i = 0; i < classes.size(); ++i)
+    {
+        if (i) out += ',';
+        JsonValue::append_string(out, head.label(index[i]));
+    }
+    out += "]}";
+}
+
+JsonValue tensor_info(const std::string& name, const ValueInfo& info)
+{
+    JsonValue entry = JsonValue::object();
+    entry.set("name", name);
+    entry.set("datatype", kserve_datatype(info.dtype));
+    JsonValue shape = JsonValue::array();
+    if (info.has_shape)
+        for (int64_t d : info.shape) shape.push(d);
+    else
+        shape.push(-1);
+    entry.set("shape", std::move(shape));
+    return entry;
+}
+
+bool flag(const JsonValue* parameters, const char* name)
+{
+    if (!parameters) return false;
+    const JsonValue* value = parameters->find(name);
+    return value && value->is_bool() && value->as_bool();
+}
+
+}
+
+const char* kserve_datatype(DataType type)
+{
+    switch (type)
+    {
+    case DataType::Float32:  return "FP32";
+    case DataType::Float16:  return "FP16";
+    case DataType::BFloat16: return "BF16";
+    case DataType::Int8:     return "INT8";
+    case DataType::UInt8:    return "UINT8";
+    case DataType::Int32:    return "INT32";
+    case DataType::Int64:    return "INT64";
+    case DataType::Bool:     return "BOOL";
+    }
+    return "UNKNOWN";
+}
+
+bool parse_kserve_datatype(const std::string& name, DataType& type)
+{
+    static const DataType all[] = {DataType::Float32, DataType::Float16, DataType::BFloat16, DataType::Int8,
+                                   DataType::UInt8, DataType::Int32, DataType::Int64, DataType::Bool};
+    for (DataType t : all)
+    {
+        if (name == kserve_datatype(t))
+        {
+            type = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+InferRequest decode_infer_request(const std::string& body, std::size_t json_bytes)
+{
+    if (json_bytes > body.size()) throw std::invalid_argument("Inference-Header-Content-Length exceeds the body");
+
+    JsonValue document;
+    try
+    {
+        document = JsonValue::parse(body.data(), json_bytes);
+    }
+    catch (const std::runtime_error& e)
+    {
+        throw std::invalid_argument(e.what());
+    }
+    if (!document.is_object()) throw std::invalid_argument("inference request must be a JSON object");
+
+    InferRequest request;
+    std::size_t binary_offset = json_bytes;
+    try
+    {
+        if (const JsonValue* id = document.find("id")) request.id = id->as_string();
+        request.all_binary = flag(document.find("parameters"), "binary_data_output");
+
+        for (const JsonValue& input : document.at("inputs").as_array())
+        {
+            InferInput decoded;
+            decoded.name = input.at("name").as_string();
+
+            DataType dtype;
+            if (!parse_kserve_datatype(input.at("datatype").as_string(), dtype))
+                throw std::invalid_argument("input '" + decoded.name + "' has unsupported datatype " + input.at("datatype").as_string());
+
+            // a shape whose size wraps around would pass the length checks below
+            std::vector<std::size_t> shape;
+            std::size_t count = 1, expected_bytes = 0;
+            bool overflow = false;
+            for (const JsonValue& d : input.at("shape").as_array())
+            {
+                int64_t dim = d.as_int();
+                if (dim < 0) throw std::invalid_argument("input '" + decoded.name + "' has a negative dimension");
+                shape.push_back(static_cast<std::size_t>(dim));
+                overflow |= __builtin_mul_overflow(count, static_cast<std::size_t>(dim), &count);
+            }
+            overflow |= __builtin_mul_overflow(count, data_type_size(dtype), &expected_bytes);
+            if (overflow) throw std::invalid_argument("shape of input '" + decoded.name + "' overflows");
+
+            // the data is checked against the shape before the tensor is allocated
+            const JsonValue* parameters = input.find("parameters");
+            const JsonValue* binary_size = parameters ? parameters->find("binary_data_size") : nullptr;
+            if (binary_size)
+            {
+                // raw bytes follow the JSON header in input order
+                const std::size_t bytes = static_cast<std::size_t>(binary_size->as_int());
+                if (bytes != expected_bytes)
+                    throw std::invalid_argument("input '" + decoded.name + "' has " + std::to_string(bytes) + " binary bytes, expected " + std::to_string(expected_bytes));
+                if (bytes > body.size() - binary_offset) throw std::invalid_argument("binary data of input '" + decoded.name + "' is truncated");
+                decoded.tensor = AnyTensor(dtype, shape);
+                if (bytes) std::memcpy(decoded.tensor.raw(), body.data() + binary_offset, bytes);
+                binary_offset += bytes;
+            }
+            else
+            {
+                std::vector<const JsonValue*> values;
+                flatten(input.at("data"), values);
+                if (values.size() != count)
+                    throw std::invalid_argument("input '" + decoded.name + "' has " + std::to_string(values.size()) + " values for " + std::to_string(count) + " elements");
+
+                decoded.tensor = AnyTensor(dtype, shape);
+                decoded.tensor.visit([&](auto& t)
+                {
+                    using T = typename std::decay_t<decltype(t)>::value_type;
+                    for (std::size_t i = 0; i < count; ++i) t.data()[i] = json_element<T>(*values[i]);
+                });
+            }
+            request.inputs.push_back(std::move(decoded));
+        }
+
+        if (const JsonValue* outputs = document.find("outputs"))
+        {
+            for (const JsonValue& output : outputs->as_array())
+            {
+                const std::string& name = output.at("name").as_string();
+                request.outputs.push_back(name);
+                if (flag(output.find("parameters"), "binary_data")) request.binary_outputs.insert(name);
+            }
+        }
+    }
+    catch (const std::invalid_argument&)
+    {
+        throw;
+    }
+    catch (const std::runtime_error& e)
+    {
+        throw std::invalid_argument(e.what());              // missing members, wrong JSON types
+    }
+
+    if (binary_offset != body.size()) throw std::invalid_argument("unused binary data after the last input");
+    return request;
+}
+
+InferResponse encode_infer_response(const LoadedModel& model, const InferRequest& request, const std::vector<const AnyTensor*>& outputs)
+{
+    // requested outputs by name, all of them by default. a head with a label file
+    // adds "labels", encoded from the classes output after the tensors
+    const bool labeled = !model.postprocess.labels().empty();
+    std::vector<std::size_t> selected;
+    if (request.outputs.empty())
+    {
+        for (std::size_t i = 0; i < outputs.size(); ++i) selected.push_back(i);
+        if (labeled) selected.push_back(outputs.size());
+    }
+    else
+    {
+        for (const std::string& name : request.outputs)
+        {
+            std::size_t i = 0;
+            while (i < model.output_count() && model.output_name(i) != name) ++i;
+            if (i == model.output_count() && !(labeled && name == "labels"))
+                throw std::invalid_argument("model '" + model.name + "' has no output '" + name + "'");
+            selected.push_back(i == model.output_count() ? outputs.size() : i);
+        }
+    }
+
+    InferResponse response;
+    std::string& out = response.body;
+    std::string binary;
+
+    out += "{\"model_name\":";
+    JsonValue::append_string(out, model.name);
+    out += ",\"model_version\":\"" + std::to_string(model.version) + "\"";
+    if (!request.id.empty())
+    {
+        out += ",\"id\":";
+        JsonValue::append_string(out, request.id);
+    }
+    out += ",\"outputs\":[";
+
+    for (std::size_t k = 0; k < selected.size(); ++k)
+    {
+        if (k) out += ',';
+        if (selected[k] == outputs.size())
+        {
+            append_labels(out, binary, model.postprocess, *outputs[0], request.all_binary || request.binary_outputs.count("labels"));
+            continue;
+        }
+
+        const std::string& name = model.output_name(selected[k]);
+        const AnyTensor& tensor = *outputs[selected[k]];
+
+        out += "{\"name\":";
+        JsonValue::append_string(out, name);
+        out += ",\"datatype\":\"";
+        out += kserve_datatype(tensor.dtype());
+        out += "\",\"shape\":[";
+        for (std::size_t d = 0; d < tensor.shape().size(); ++d)
+        {
+            if (d) out += ',';
+            out += std::to_string(tensor.shape()[d]);
+        }
+        out += ']';
+
+        if (request.all_binary || request.binary_outputs.count(name))
+        {
+            out += ",\"parameters\":{\"binary_data_size\":" + std::to_string(tensor.bytes()) + "}}";
+            binary.append(static_cast<const char*>(tensor.raw()), tensor.bytes());
+            continue;
+        }
+
+        out += ",\"data\":[";
+        tensor.visit([&](const auto& t)
+        {
+            for (std::size_t i = 0; i < t.size(); ++i)
+            {
+                if (i) out += ',';
+                append_json_element(out, t.data()[i]);
+            }
+        });
+        out += "]}";
+    }
+    out += "]}";
+
+    response.json_bytes = out.size();
+    out += binary;
+    return response;
+}
+
+JsonValue model_metadata(const LoadedModel& model, const std::vector<int64_t>& versions)
+{
+    const Graph& graph = model.graph;
+
+    JsonValue metadata = JsonValue::object();
+    metadata.set("name", model.name);
+    JsonValue version_list = JsonValue::array();
+    for (int64_t v : versions) version_list.push(std::to_string(v));
+    metadata.set("versions", std::move(version_list));
+    metadata.set("platform", "onnx");
+
+    JsonValue inputs = JsonValue::array();
+    for (std::size_t i = 0; i < graph.get_input_size(); ++i) inputs.push(tensor_info(graph.get_input_name(i), graph.get_input_info(i)));
+    metadata.set("inputs", std::move(inputs));
+
+    JsonValue outputs = JsonValue::array();
+    for (std::size_t i = 0; i < model.output_count(); ++i) outputs.push(tensor_info(model.output_name(i), model.output_info(i)));
+    if (!model.postprocess.labels().empty())
+    {
+        JsonValue entry = tensor_info("labels", model.output_info(0));
+        entry.set("datatype", "BYTES");
+        outputs.push(std::move(entry));
+    }
+    metadata.set("outputs", std::move(outputs));
+    return metadata;
+}
@@ -0,0 +1,51 @@
+#ifndef SERVER_KSERVE_H
+#define SERVER_KSERVE_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "json.h"
+#include "../any_tensor.h"
+#include "../data_type.h"
+#include "../model_repository.h"
+
+// KServe v2 (Open Inference Protocol) request/response encoding, including the
+// binary tensor data extension: the JSON header is followed by raw little-endian
+// tensor bytes, its length given by the Inference-Header-Content-Length header
+
+struct InferInput
+{
+    std::string name;
+    AnyTensor tensor;
+};
+
+struct InferRequest
+{
+    std::string id;
+    std::vector<InferInput> inputs;
+    std::vector<std::string> outputs;                       // requested names, empty means all
+    std::unordered_set<std::string> binary_outputs;         // outputs to return as raw bytes
+    bool all_binary = false;                                // "binary_data_output": true
+};
+
+struct InferResponse
+{
+    std::string body;
+    std::size_t json_bytes = 0;                             // < body.size() when binary data follows
+};
+
+// "FP32" <-> DataType
+const char* kserve_datatype(DataType type);
+bool parse_kserve_datatype(const std::string& name, DataType& type);
+
+// `json_bytes` is the header length for binary requests, body.size() otherwise.
+// throws std::invalid_argument on malformed requests
+InferRequest decode_infer_request(const std::string& body, std::size_t json_bytes);
+
+// outputs in graph order; only the requested ones are encoded
+InferResponse encode_infer_response(const LoadedModel& model, const InferRequest& request, const std::vector<const AnyTensor*>& outputs);
+
+JsonValue model_metadata(const LoadedModel& model, const std::vector<int64_t>& versions);
+
+#endif
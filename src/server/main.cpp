@@ -0,0 +1,127 @@
+#include <csignal>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <string>
+#include "inference_server.h"
+#include "shm_transport.h"
+#include "../logger.h"
+#include "../model_repository.h"
+
+// a flag's number: digits only, within the range of `value`'s type
+template <typename T>
+static bool parse_count(const std::string& text, T& value)
+{
+    if (text.empty() || text.size() > 19 || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    const unsigned long long parsed = std::stoull(text);
+    if (parsed > static_cast<unsigned long long>(std::numeric_limits<T>::max())) return false;
+    value = static_cast<T>(parsed);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::string root;
+    ServerOptions options;
+    std::size_t budget_mb = 0;
+    std::size_t cache_mb = 0;
+    long poll_seconds = 0;
+    std::string shm_socket;
+    bool valid = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--model-repository=", 0) == 0)
+            root = arg.substr(19);
+        else if (arg.rfind("--host=", 0) == 0)
+            options.host = arg.substr(7);
+        else if (arg.rfind("--port=", 0) == 0)
+            valid = parse_count(arg.substr(7), options.port);
+        else if (arg.rfind("--io-threads=", 0) == 0)
+            valid = parse_count(arg.substr(13), options.io_threads) && options.io_threads > 0;
+        else if (arg.rfind("--workers=", 0) == 0)
+            valid = parse_count(arg.substr(10), options.workers) && options.workers > 0;
+        else if (arg.rfind("--memory-budget-mb=", 0) == 0)
+            valid = parse_count(arg.substr(19), budget_mb);
+        else if (arg.rfind("--result-cache-mb=", 0) == 0)
+            valid = parse_count(arg.substr(18), cache_mb);
+        else if (arg.rfind("--max-queue=", 0) == 0)
+            valid = parse_count(arg.substr(12), options.max_queue);
+        else if (arg == "--overflow=reject")
+            options.overflow = OverflowPolicy::RejectNew;
+        else if (arg == "--overflow=drop-oldest")
+            options.overflow = OverflowPolicy::DropOldest;
+        else if (arg.rfind("--default-timeout-ms=", 0) == 0)
+            valid = parse_count(arg.substr(21), options.default_timeout_ms);
+        else if (arg.rfind("--shm-socket=", 0) == 0)
+            shm_socket = arg.substr(13);
+        else if (arg.rfind("--poll-interval=", 0) == 0)
+            valid = parse_count(arg.substr(16), poll_seconds);
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            root.clear();
+            break;
+        }
+
+        if (!valid)
+        {
+            std::cerr << "Invalid value: " << arg << "\n";
+            root.clear();
+            break;
+        }
+    }
+
+    if (root.empty())
+    {
+        std::cerr << "Usage: ./infera-server --model-repository=<dir> [--host=0.0.0.0] [--port=8000] [--io-threads=2] [--workers=2]"
+                     " [--memory-budget-mb=0] [--result-cache-mb=0] [--poll-interval=<seconds>] [--shm-socket=<path>]"
+                     " [--max-queue=0] [--overflow=reject|drop-oldest] [--default-timeout-ms=0]\n";
+        return 1;
+    }
+
+    // block the shutdown signals before any thread starts, so only sigwait sees them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try {
+        ModelRepository repository(root, budget_mb * 1024 * 1024);
+        repository.set_result_cache_bytes(cache_mb * 1024 * 1024);
+        InferenceServer server(repository, options);
+        server.start();
+
+        // co-located clients can skip HTTP and pass tensors through shared memory
+        ShmServer shm_server(repository, shm_socket);
+        if (!shm_socket.empty()) shm_server.start();
+        std::cout << "Serving " << repository.available().size() << " model(s) from " << root << " on port " << server.port() << "\n";
+
+        // rescan the repository for new versions every poll interval until signalled
+        while (true)
+        {
+            if (poll_seconds <= 0)
+            {
+                int signal = 0;
+                sigwait(&signals, &signal);
+                break;
+            }
+            timespec timeout{poll_seconds, 0};
+            if (sigtimedwait(&signals, nullptr, &timeout) > 0) break;
+            repository.scan();
+        }
+
+        std::cout << "Shutting down...\n";
+        shm_server.stop();
+        server.stop();
+        Logger::instance().flush();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,565 @@
+#include "shm_transport.h"
+#include "../logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <poll.h>
+#include <stdexcept>
+#include <thread>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace
+{
+
+constexpr int kSpins = 256;                                 // a few us of polling before sleeping
+constexpr int kSleepMs = 100;                               // futex timeout between hangup checks
+
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// shared (not FUTEX_PRIVATE) operations: the word lives in memory mapped by two processes
+long futex(std::atomic<uint32_t>& word, int op, uint32_t value, const timespec* timeout)
+{
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value, timeout, nullptr, 0);
+}
+
+void publish(std::atomic<uint32_t>& word, uint32_t state)
+{
+    word.store(state, std::memory_order_release);
+    futex(word, FUTEX_WAKE, 1, nullptr);
+}
+
+// spin, then sleep on the word until done(state) holds; false after timeout_ms without it
+template <class Done>
+bool wait_for(std::atomic<uint32_t>& word, Done done, int timeout_ms)
+{
+    // on a single core spinning only delays the peer we are waiting for
+    static const int spins = std::thread::hardware_concurrency() > 1 ? kSpins : 0;
+    for (int i = 0; i < spins; ++i)
+    {
+        if (done(word.load(std::memory_order_acquire))) return true;
+        cpu_relax();
+    }
+
+    const timespec timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+    uint32_t state = word.load(std::memory_order_acquire);
+    while (!done(state))
+    {
+        if (futex(word, FUTEX_WAIT, state, &timeout) < 0 && errno == ETIMEDOUT) return done(word.load(std::memory_order_acquire));
+        state = word.load(std::memory_order_acquire);
+    }
+    return true;
+}
+
+bool peer_closed(int fd)
+{
+    pollfd p{fd, POLLRDHUP, 0};
+    return poll(&p, 1, 0) > 0 && (p.revents & (POLLRDHUP | POLLHUP | POLLERR));
+}
+
+// one message plus an optional descriptor, fd is -1 when none came with it
+bool receive_message(int socket, shm::RegionMessage& message, int& fd)
+{
+    char control[CMSG_SPACE(sizeof(int))];
+    iovec io{&message, sizeof(message)};
+    msghdr header{};
+    header.msg_iov = &io;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+
+    fd = -1;
+    ssize_t n = recvmsg(socket, &header, MSG_CMSG_CLOEXEC);
+    if (n != static_cast<ssize_t>(sizeof(message))) return false;
+    for (cmsghdr* c = CMSG_FIRSTHDR(&header); c; c = CMSG_NXTHDR(&header, c))
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) std::memcpy(&fd, CMSG_DATA(c), sizeof(int));
+    return true;
+}
+
+void send_message(int socket, const shm::RegionMessage& message, int fd)
+{
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    iovec io{const_cast<shm::RegionMessage*>(&message), sizeof(message)};
+    msghdr header{};
+    header.msg_iov = &io;
+    header.msg_iovlen = 1;
+    if (fd >= 0)
+    {
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+        cmsghdr* c = CMSG_FIRSTHDR(&header);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(c), &fd, sizeof(int));
+    }
+    if (sendmsg(socket, &header, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(message)))
+        throw std::runtime_error(std::string("shared memory channel: sendmsg failed: ") + std::strerror(errno));
+}
+
+// map `size` bytes of fd read-write; the mapping keeps the object alive after close
+char* map_region(int fd, std::size_t size)
+{
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<std::size_t>(info.st_size) < size) return nullptr;
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+}
+
+void copy_name(char (&to)[shm::kNameBytes], const std::string& from)
+{
+    if (from.size() >= shm::kNameBytes) throw std::runtime_error("shared memory channel: name '" + from + "' is too long.");
+    std::memset(to, 0, sizeof(to));
+    std::memcpy(to, from.data(), from.size());
+}
+
+std::string read_name(const char (&from)[shm::kNameBytes])
+{
+    return std::string(from, strnlen(from, shm::kNameBytes));
+}
+
+}
+
+// ---- server ----
+
+struct ShmServer::Channel
+{
+    struct Region
+    {
+        char* mapping = nullptr;
+        std::size_t mapped = 0;
+        char* data = nullptr;                               // mapping, past the control block for region 0
+        std::size_t size = 0;
+    };
+
+    int socket = -1;
+    shm::ControlBlock* control = nullptr;
+    std::unordered_map<uint32_t, Region> regions;
+    std::vector<AnyTensor> views;                           // reused input views, one per graph input
+    std::thread thread;
+    std::atomic<bool> done{false};
+
+    ~Channel()
+    {
+        for (auto& entry : regions) munmap(entry.second.mapping, entry.second.mapped);
+        if (socket >= 0) close(socket);
+    }
+};
+
+ShmServer::ShmServer(ModelRepository& repository, const std::string& socket_path) : repository_(repository), socket_path_(socket_path)
+{
+}
+
+ShmServer::~ShmServer()
+{
+    stop();
+}
+
+void ShmServer::start()
+{
+    if (running_) return;
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(address.sun_path)) throw std::runtime_error("Socket path '" + socket_path_ + "' is too long.");
+    std::memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    unlink(socket_path_.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listen_fd_, 64) < 0)
+    {
+        std::string error = std::strerror(errno);
+        close(listen_fd_);
+        throw std::runtime_error("Cannot listen on " + socket_path_ + ": " + error);
+    }
+
+    wake_fd_ = eventfd(0, EFD_CLOEXEC);
+    running_ = true;
+    acceptor_ = std::thread([this] { accept_loop(); });
+    INFERA_LOG_INFO("shared memory channels on %s", socket_path_.c_str());
+}
+
+void ShmServer::stop()
+{
+    if (!running_.exchange(false)) return;
+
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {}
+    acceptor_.join();
+
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    for (auto& channel : channels_)
+    {
+        // a client that never sent its channel leaves serve() blocked on the socket
+        shutdown(channel->socket, SHUT_RDWR);
+        if (channel->control) futex(channel->control->state, FUTEX_WAKE, 1, nullptr);
+        channel->thread.join();
+    }
+    channels_.clear();
+
+    close(listen_fd_);
+    close(wake_fd_);
+    unlink(socket_path_.c_str());
+}
+
+void ShmServer::accept_loop()
+{
+    pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    while (running_)
+    {
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) return;
+        if (!running_ || fds[1].revents) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+
+        // reap channels whose client went away
+        for (std::size_t i = 0; i < channels_.size();)
+        {
+            if (!channels_[i]->done) { ++i; continue; }
+            channels_[i]->thread.join();
+            channels_.erase(channels_.begin() + i);
+        }
+
+        channels_.push_back(std::make_unique<Channel>());
+        Channel* channel = channels_.back().get();
+        channel->socket = fd;
+        channel->thread = std::thread([this, channel] { serve(*channel); });
+    }
+}
+
+void ShmServer::serve(Channel& channel)
+{
+    // the first message hands over the channel memfd itself
+    shm::RegionMessage message;
+    int fd = -1;
+    if (receive_message(channel.socket, message, fd) && fd >= 0 && message.op == 1 && message.region == 0 && message.byte_size > shm::kDataOffset)
+    {
+        char* base = map_region(fd, message.byte_size);
+        if (base && reinterpret_cast<shm::ControlBlock*>(base)->magic == shm::kMagic)
+        {
+            channel.control = reinterpret_cast<shm::ControlBlock*>(base);
+            channel.regions[0] = {base, message.byte_size, base + shm::kDataOffset, message.byte_size - shm::kDataOffset};
+        }
+        else if (base)
+        {
+            munmap(base, message.byte_size);
+        }
+    }
+    if (fd >= 0) close(fd);
+    if (!channel.control)
+    {
+        INFERA_LOG_WARN("rejected a shared memory channel without a valid control block");
+        channel.done = true;
+        return;
+    }
+
+    InferenceEngine engine;
+    std::atomic<uint32_t>& state = channel.control->state;
+    auto pending = [](uint32_t s) { return s == shm::Request || s == shm::Control; };
+
+    while (running_)
+    {
+        if (!wait_for(state, pending, kSleepMs))
+        {
+            if (peer_closed(channel.socket)) break;
+            continue;
+        }
+
+        if (state.load(std::memory_order_acquire) == shm::Control)
+        {
+            handle_control(channel);
+            publish(state, shm::Idle);
+        }
+        else
+        {
+            run_request(channel, engine);
+            publish(state, shm::Response);
+        }
+    }
+    channel.done = true;
+}
+
+void ShmServer::handle_control(Channel& channel)
+{
+    shm::ControlBlock& control = *channel.control;
+    auto fail = [&](int status, const std::string& message)
+    {
+        control.status = status;
+        std::snprintf(control.error, sizeof(control.error), "%s", message.c_str());
+    };
+
+    shm::RegionMessage message;
+    int fd = -1;
+    if (!receive_message(channel.socket, message, fd)) return fail(400, "no region message on the socket");
+
+    if (message.op == 2)
+    {
+        auto it = channel.regions.find(message.region);
+        if (message.region == 0 || it == channel.regions.end()) return fail(404, "unknown region " + std::to_string(message.region));
+        munmap(it->second.mapping, it->second.mapped);
+        channel.regions.erase(it);
+        control.status = 200;
+        return;
+    }
+
+    if (message.op != 1 || message.region == 0 || channel.regions.count(message.region))
+    {
+        if (fd >= 0) close(fd);
+        return fail(400, "invalid region registration");
+    }
+
+    // POSIX shm is opened here by name; a memfd arrives as the attached descriptor
+    const std::string key = read_name(message.key);
+    if (fd < 0 && !key.empty()) fd = shm_open(key.c_str(), O_RDWR, 0);
+    if (fd < 0) return fail(404, "cannot open shared memory '" + key + "': " + std::strerror(errno));
+
+    char* mapping = map_region(fd, message.byte_size);
+    close(fd);
+    if (!mapping) return fail(400, "region " + std::to_string(message.region) + " is smaller than " + std::to_string(message.byte_size) + " bytes");
+
+    channel.regions[message.region] = {mapping, message.byte_size, mapping, message.byte_size};
+    control.status = 200;
+}
+
+void ShmServer::run_request(Channel& channel, InferenceEngine& engine)
+{
+    shm::ControlBlock& control = *channel.control;
+    auto fail = [&](int status, const std::string& message)
+    {
+        control.status = status;
+        std::snprintf(control.error, sizeof(control.error), "%s", message.c_str());
+    };
+
+    // validated view of a descriptor's bytes
+    auto locate = [&](const shm::TensorDesc& desc, std::size_t bytes, std::size_t alignment) -> char*
+    {
+        auto it = channel.regions.find(desc.region);
+        if (it == channel.regions.end()) return nullptr;
+        if (desc.offset > it->second.size || bytes > it->second.size - desc.offset || desc.offset % alignment) return nullptr;
+        return it->second.data + desc.offset;
+    };
+
+    const std::string name = read_name(control.model);
+    std::shared_ptr<LoadedModel> model;
+    try
+    {
+        model = repository_.get(name, control.version);
+    }
+    catch (const std::exception& e)
+    {
+        return fail(repository_.versions(name).empty() ? 404 : 503, e.what());
+    }
+
+    Graph& graph = model->graph;
+    if (control.num_inputs != graph.get_input_size() || control.num_inputs > shm::kMaxTensors)
+        return fail(400, "model '" + name + "' takes " + std::to_string(graph.get_input_size()) + " input(s)");
+    if (control.num_outputs == 0 || control.num_outputs > shm::kMaxTensors) return fail(400, "between 1 and 8 outputs must be requested");
+
+    // non-owning views over the client's memory, bound to graph inputs by name
+    channel.views.resize(graph.get_input_size());
+    std::vector<AnyTensor*> inputs(graph.get_input_size(), nullptr);
+    for (uint32_t i = 0; i < control.num_inputs; ++i)
+    {
+        const shm::TensorDesc& desc = control.inputs[i];
+        const std::string input = read_name(desc.name);
+        std::size_t index = 0;
+        while (index < graph.get_input_size() && graph.get_input_name(index) != input) ++index;
+        if (index == graph.get_input_size() || inputs[index]) return fail(400, "unexpected input '" + input + "'");
+        if (desc.dtype > static_cast<uint32_t>(DataType::Bool) || desc.rank > shm::kMaxRank) return fail(400, "bad descriptor for input '" + input + "'");
+
+        const DataType type = static_cast<DataType>(desc.dtype);
+        std::vector<std::size_t> shape(desc.shape, desc.shape + desc.rank);
+        // a shape whose size wraps around would pass the region checks below
+        std::size_t elements = 1, bytes = 0;
+        bool overflow = false;
+        for (auto d : shape) overflow |= __builtin_mul_overflow(elements, d, &elements);
+        overflow |= __builtin_mul_overflow(elements, data_type_size(type), &bytes);
+        if (overflow) return fail(400, "shape of input '" + input + "' overflows");
+
+        char* data = desc.byte_size == bytes ? locate(desc, bytes, data_type_size(type)) : nullptr;
+        if (!data) return fail(400, "input '" + input + "' does not fit its region, size or alignment");
+
+        channel.views[index].view_of_memory(type, data, shape);
+        inputs[index] = &channel.views[index];
+    }
+
+    std::vector<const AnyTensor*> outputs;
+    CachedOutputs held;
+    try
+    {
+        outputs = model->run(engine, inputs, held);
+    }
+    catch (const std::exception& e)
+    {
+        return fail(400, std::string("inference failed: ") + e.what());
+    }
+
+    // copy the requested outputs into the client's regions
+    for (uint32_t i = 0; i < control.num_outputs; ++i)
+    {
+        shm::TensorDesc& desc = control.outputs[i];
+        const std::string output = read_name(desc.name);
+        std::size_t index = 0;
+        while (index < model->output_count() && model->output_name(index) != output) ++index;
+        if (index == outputs.size()) return fail(400, "unknown output '" + output + "'");
+
+        const AnyTensor& tensor = *outputs[index];
+        if (tensor.shape().size() > shm::kMaxRank) return fail(400, "output '" + output + "' has too many dimensions");
+        char* data = tensor.bytes() <= desc.byte_size ? locate(desc, tensor.bytes(), 1) : nullptr;
+        if (!data) return fail(400, "output '" + output + "' needs " + std::to_string(tensor.bytes()) + " bytes in its region");
+
+        std::memcpy(data, tensor.raw(), tensor.bytes());
+        desc.dtype = static_cast<uint32_t>(tensor.dtype());
+        desc.rank = static_cast<uint32_t>(tensor.shape().size());
+        for (std::size_t d = 0; d < desc.rank; ++d) desc.shape[d] = tensor.shape()[d];
+        desc.byte_size = tensor.bytes();
+    }
+    control.status = 200;
+}
+
+// ---- client ----
+
+ShmClient::ShmClient(const std::string& socket_path, std::size_t bytes)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) throw std::runtime_error("Socket path '" + socket_path + "' is too long.");
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    socket_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socket_fd_ < 0 || connect(socket_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        std::string error = std::strerror(errno);
+        if (socket_fd_ >= 0) close(socket_fd_);
+        throw std::runtime_error("Cannot connect to " + socket_path + ": " + error);
+    }
+
+    size_ = shm::kDataOffset + bytes;
+    memfd_ = memfd_create("infera-channel", MFD_CLOEXEC);
+    if (memfd_ < 0 || ftruncate(memfd_, static_cast<off_t>(size_)) < 0 || !(base_ = map_region(memfd_, size_)))
+    {
+        std::string error = std::strerror(errno);
+        if (memfd_ >= 0) close(memfd_);
+        close(socket_fd_);
+        throw std::runtime_error("Cannot create shared memory channel: " + error);
+    }
+
+    shm::ControlBlock* control = new (base_) shm::ControlBlock();
+    control->magic = shm::kMagic;
+    control->state.store(shm::Idle, std::memory_order_release);
+
+    shm::RegionMessage message{};
+    message.op = 1;
+    message.byte_size = size_;
+    send_message(socket_fd_, message, memfd_);
+}
+
+ShmClient::~ShmClient()
+{
+    munmap(base_, size_);
+    close(memfd_);
+    close(socket_fd_);
+}
+
+void ShmClient::wait_for_server(uint32_t pending)
+{
+    std::atomic<uint32_t>& state = reinterpret_cast<shm::ControlBlock*>(base_)->state;
+    while (!wait_for(state, [pending](uint32_t s) { return s != pending; }, kSleepMs))
+    {
+        if (peer_closed(socket_fd_)) throw std::runtime_error("shared memory channel: the server closed the connection.");
+    }
+}
+
+uint32_t ShmClient::send_region(shm::RegionMessage message, int fd)
+{
+    shm::ControlBlock& control = *reinterpret_cast<shm::ControlBlock*>(base_);
+    send_message(socket_fd_, message, fd);
+    publish(control.state, shm::Control);
+    wait_for_server(shm::Control);
+
+    if (control.status != 200) throw std::runtime_error("shared memory channel: " + std::string(control.error));
+    return message.region;
+}
+
+uint32_t ShmClient::register_region(int fd, std::size_t byte_size)
+{
+    shm::RegionMessage message{};
+    message.op = 1;
+    message.region = next_region_++;
+    message.byte_size = byte_size;
+    return send_region(message, fd);
+}
+
+uint32_t ShmClient::register_region(const std::string& shm_key, std::size_t byte_size)
+{
+    shm::RegionMessage message{};
+    message.op = 1;
+    message.region = next_region_++;
+    message.byte_size = byte_size;
+    copy_name(message.key, shm_key);
+    return send_region(message, -1);
+}
+
+void ShmClient::unregister_region(uint32_t region)
+{
+    shm::RegionMessage message{};
+    message.op = 2;
+    message.region = region;
+    send_region(message, -1);
+}
+
+void ShmClient::infer(const std::string& model, const std::vector<TensorRef>& inputs, std::vector<TensorRef>& outputs, int64_t version)
+{
+    if (inputs.size() > shm::kMaxTensors || outputs.size() > shm::kMaxTensors)
+        throw std::runtime_error("shared memory channel: at most 8 inputs and 8 outputs per request.");
+
+    shm::ControlBlock& control = *reinterpret_cast<shm::ControlBlock*>(base_);
+    copy_name(control.model, model);
+    control.version = version;
+
+    auto describe = [](shm::TensorDesc& desc, const TensorRef& tensor)
+    {
+        if (tensor.shape.size() > shm::kMaxRank) throw std::runtime_error("shared memory channel: tensor '" + tensor.name + "' has too many dimensions.");
+        copy_name(desc.name, tensor.name);
+        desc.dtype = static_cast<uint32_t>(tensor.dtype);
+        desc.rank = static_cast<uint32_t>(tensor.shape.size());
+        for (std::size_t d = 0; d < tensor.shape.size(); ++d) desc.shape[d] = tensor.shape[d];
+        desc.region = tensor.region;
+        desc.offset = tensor.offset;
+        desc.byte_size = tensor.byte_size;
+    };
+    control.num_inputs = static_cast<uint32_t>(inputs.size());
+    for (std::size_t i = 0; i < inputs.size(); ++i) describe(control.inputs[i], inputs[i]);
+    control.num_outputs = static_cast<uint32_t>(outputs.size());
+    for (std::size_t i = 0; i < outputs.size(); ++i) describe(control.outputs[i], outputs[i]);
+
+    publish(control.state, shm::Request);
+    wait_for_server(shm::Request);
+
+    if (control.status != 200) throw std::runtime_error(std::string(control.error));
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        const shm::TensorDesc& desc = control.outputs[i];
+        outputs[i].dtype = static_cast<DataType>(desc.dtype);
+        outputs[i].shape.assign(desc.shape, desc.shape + desc.rank);
+        outputs[i].byte_size = desc.byte_size;
+    }
+}
@@ -0,0 +1,165 @@
+#ifndef SERVER_SHM_TRANSPORT_H
+#define SERVER_SHM_TRANSPORT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../data_type.h"
+#include "../inference_engine.h"
+#include "../model_repository.h"
+
+// shared-memory inference for clients on the same host.
+//
+// a client creates a memfd "channel" and hands it to the server over a unix socket
+// (SCM_RIGHTS). the channel starts with a Control block; the rest, plus any further
+// memfd or POSIX shm regions the client registers, holds tensor data. the client
+// writes inputs in place, describes them in the Control block and flips its state
+// word; the server runs the model on non-owning views of that memory, copies the
+// outputs into the regions the client named and flips the word back. both sides
+// spin briefly and then sleep on the state word with a futex, so a request costs
+// no syscalls when the other side is quick and no CPU when it is idle.
+//
+// each channel is served by its own thread and engine: one request in flight per
+// channel, open more channels for concurrency
+
+namespace shm
+{
+
+constexpr uint32_t kMagic = 0x494e4652;                     // "INFR"
+constexpr std::size_t kMaxTensors = 8;
+constexpr std::size_t kMaxRank = 8;
+constexpr std::size_t kNameBytes = 64;
+constexpr std::size_t kDataOffset = 4096;                   // tensor data starts a page into the channel
+
+enum State : uint32_t
+{
+    Idle = 0,
+    Request,                                                // client -> server: run the described request
+    Response,                                               // server -> client: outputs written, status set
+    Control                                                 // client -> server: a message waits on the socket
+};
+
+struct TensorDesc
+{
+    char name[kNameBytes];
+    uint32_t dtype;                                         // DataType; set by the server for outputs
+    uint32_t rank;
+    uint64_t shape[kMaxRank];
+    uint32_t region;                                        // 0 is the channel itself
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t byte_size;                                     // outputs: capacity in, bytes written out
+};
+
+struct ControlBlock
+{
+    uint32_t magic;
+    std::atomic<uint32_t> state;
+    int32_t status;                                         // HTTP-style: 200, 400, 404, 503
+    uint32_t reserved;
+    char model[kNameBytes];
+    int64_t version;                                        // 0 is the served version
+    uint32_t num_inputs;
+    uint32_t num_outputs;
+    TensorDesc inputs[kMaxTensors];
+    TensorDesc outputs[kMaxTensors];
+    char error[256];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "the futex word must be a plain 32-bit integer");
+static_assert(sizeof(ControlBlock) <= kDataOffset, "control block must fit before the tensor data");
+
+// socket messages after the channel itself: add or drop a data region
+struct RegionMessage
+{
+    uint32_t op;                                            // 1 register (memfd attached or POSIX shm key), 2 unregister
+    uint32_t region;
+    uint64_t byte_size;
+    char key[kNameBytes];                                   // shm_open name when no fd is attached
+};
+
+}
+
+class ShmServer
+{
+public:
+    ShmServer(ModelRepository& repository, const std::string& socket_path);
+    ~ShmServer();
+
+    ShmServer(const ShmServer&) = delete;
+    ShmServer& operator=(const ShmServer&) = delete;
+
+    // bind the unix socket (replacing a stale one) and start accepting channels
+    void start();
+    void stop();
+private:
+    struct Channel;
+
+    void accept_loop();
+    void serve(Channel& channel);
+    void handle_control(Channel& channel);
+    void run_request(Channel& channel, InferenceEngine& engine);
+
+    ModelRepository& repository_;
+    std::string socket_path_;
+    int listen_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread acceptor_;
+
+    std::mutex channels_mutex_;
+    std::vector<std::unique_ptr<Channel>> channels_;
+};
+
+// client side of a channel, for co-located processes
+class ShmClient
+{
+public:
+    // data already in a region: inputs before infer(), and where outputs should
+    // go (byte_size is the capacity) on the way in
+    struct TensorRef
+    {
+        std::string name;
+        DataType dtype = DataType::Float32;
+        std::vector<std::size_t> shape;
+        uint32_t region = 0;
+        std::size_t offset = 0;
+        std::size_t byte_size = 0;
+    };
+
+    // `bytes` of tensor space in the channel, addressed from data()
+    ShmClient(const std::string& socket_path, std::size_t bytes);
+    ~ShmClient();
+
+    ShmClient(const ShmClient&) = delete;
+    ShmClient& operator=(const ShmClient&) = delete;
+
+    // the channel's tensor space; offsets in region 0 are relative to it
+    void* data() { return base_ + shm::kDataOffset; }
+    std::size_t capacity() const { return size_ - shm::kDataOffset; }
+
+    // extra regions: a memfd (or any mappable fd) or a POSIX shm object by name
+    uint32_t register_region(int fd, std::size_t byte_size);
+    uint32_t register_region(const std::string& shm_key, std::size_t byte_size);
+    void unregister_region(uint32_t region);
+
+    // synchronous; outputs get their dtype, shape and written size filled in.
+    // throws std::runtime_error with the server's message on failure
+    void infer(const std::string& model, const std::vector<TensorRef>& inputs, std::vector<TensorRef>& outputs, int64_t version = 0);
+private:
+    uint32_t send_region(shm::RegionMessage message, int fd);
+    void wait_for_server(uint32_t pending);
+
+    int socket_fd_ = -1;
+    int memfd_ = -1;
+    char* base_ = nullptr;
+    std::size_t size_ = 0;
+    uint32_t next_region_ = 1;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "kernels/kernels.h"
+
+// block-sparse (BSR) weights for the sparse GEMM kernel, see BsrMatrix
+
+// fraction of exact zeros in w
+inline double sparsity(const float* w, std::size_t n)
+{
+    if (n == 0) return 0.0;
+    std::size_t zeros = 0;
+    for (std::size_t i = 0; i < n; ++i) zeros += w[i] == 0.0f;
+    return static_cast<double>(zeros) / static_cast<double>(n);
+}
+
+// owning storage behind a BsrMatrix
+struct BsrWeights
+{
+    std::vector<float> values;
+    std::vector<int32_t> row_index;
+    std::vector<int32_t> col_ptr;
+    std::size_t rows = 0, cols = 0, block = 0;
+
+    BsrMatrix view() const { return {values.data(), row_index.data(), col_ptr.data(), rows, cols, block}; }
+};
+
+// op(B) as K x N in 1 x block tiles; B is row-major N x K when trans_b, K x N otherwise
+inline BsrWeights make_bsr(const float* B, std::size_t K, std::size_t N, bool trans_b, std::size_t block)
+{
+    BsrWeights bsr;
+    bsr.rows = K;
+    bsr.cols = N;
+    bsr.block = block;
+
+    const std::size_t blocks = (N + block - 1) / block;
+    bsr.col_ptr.reserve(blocks + 1);
+    bsr.col_ptr.push_back(0);
+
+    auto at = [&](std::size_t k, std::size_t n) { return trans_b ? B[n * K + k] : B[k * N + n]; };
+
+    for (std::size_t cb = 0; cb < blocks; ++cb)
+    {
+        const std::size_t n0 = cb * block;
+        const std::size_t width = N - n0 < block ? N - n0 : block;
+
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            bool nonzero = false;
+            for (std::size_t j = 0; j < width && !nonzero; ++j) nonzero = at(k, n0 + j) != 0.0f;
+            if (!nonzero) continue;
+
+            bsr.row_index.push_back(static_cast<int32_t>(k));
+            for (std::size_t j = 0; j < block; ++j) bsr.values.push_back(j < width ? at(k, n0 + j) : 0.0f);
+        }
+        bsr.col_ptr.push_back(static_cast<int32_t>(bsr.row_index.size()));
+    }
+    return bsr;
+}
+
+#endif
@@ -11,10 +11,12 @@ template <typename T>
 class Tensor
 {
 public:
+    using value_type = T;
+
     // constructors
-    Tensor() : data_(nullptr), size_(0) {}
+    Tensor() : data_(nullptr), size_(0), owns_(true) {}
 
-    Tensor(const std::vector<size_t> &shape) : shape_(shape)
+    Tensor(const std::vector<size_t> &shape) : shape_(shape), owns_(true)
     {
         size_ = 1;
         for (auto dim : shape_)
@@ -25,21 +27,22 @@ public:
     // destructors
     ~Tensor()
     {
-        delete[] data_;
+        if (owns_) delete[] data_;
     }
 
-    // copy constructor
-    Tensor(const Tensor &other) : shape_(other.shape_), size_(other.size_)
+    // copy constructor, always produces an owning tensor
+    Tensor(const Tensor &other) : shape_(other.shape_), size_(other.size_), owns_(true)
     {
         data_ = new T[size_];
         std::copy(other.data_, other.data_ + size_, data_);
     }
 
     // move constructor
-    Tensor(Tensor &&other) noexcept : data_(other.data_), shape_(std::move(other.shape_)), size_(other.size_)
+    Tensor(Tensor &&other) noexcept : data_(other.data_), shape_(std::move(other.shape_)), size_(other.size_), owns_(other.owns_)
     {
         other.data_ = nullptr;
         other.size_ = 0;
+        other.owns_ = true;
     }
 
     // copy-assignment operator
@@ -50,11 +53,12 @@ public:
         if (this != &other)
         {
             // clean existing memory
-            delete[] data_;
+            if (owns_) delete[] data_;
 
             // copy metadata
             shape_ = other.shape_;
             size_ = other.size_;
+            owns_ = true;
 
             // alloc and copy new data
             data_ = new T[size_];
@@ -70,16 +74,18 @@ public:
         if (this != &other)
         {
             // clean up existing memory
-            delete[] data_;
+            if (owns_) delete[] data_;
 
             // move resources
             data_ = other.data_;
             shape_ = std::move(other.shape_);
             size_ = other.size_;
+            owns_ = other.owns_;
 
             // reset source object
             other.data_ = nullptr;
             other.size_ = 0;
+            other.owns_ = true;
         }
         return *this;
     }
@@ -133,17 +139,33 @@ public:
             new_total_size *= dim;
         }
 
-        // reallocate if size changes
-        if (new_total_size != size_) 
+        // reallocate if size changes, a view never writes through to borrowed memory
+        if (new_total_size != size_ || !owns_) 
         {
-            delete[] data_;
+            if (owns_) delete[] data_;
             data_ = new T[new_total_size];
             size_ = new_total_size;
+            owns_ = true;
         }
 
         shape_ = new_shape;
     }
 
+    // alias existing memory without copying, the caller keeps it alive
+    void view(T* data, const std::vector<std::size_t>& shape)
+    {
+        std::size_t total = 1;
+        for (auto dim : shape) total *= dim;
+
+        if (owns_) delete[] data_;
+        data_ = data;
+        shape_ = shape;
+        size_ = total;
+        owns_ = false;
+    }
+
+    bool is_view() const { return !owns_; }
+
     // multi-dimension getter
     T &at(const std::vector<std::size_t> &indices)
     {
@@ -178,6 +200,7 @@ private:
     T *data_;
     std::vector<std::size_t> shape_;
     std::size_t size_;
+    bool owns_;     // false for views of another tensor's buffer
 };
 
 #endif
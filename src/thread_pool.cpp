@@ -0,0 +1,132 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+
+namespace
+{
+thread_local bool in_worker = false;
+}
+
+ThreadPool::ThreadPool(std::size_t num_threads)
+{
+    // the calling thread always participates, so spawn one fewer
+    for (std::size_t i = 1; i < num_threads; ++i)
+    {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) worker.join();
+}
+
+ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool([] {
+        const char* env = std::getenv("INFERA_NUM_THREADS");
+        long requested = env ? std::strtol(env, nullptr, 10) : 0;
+        if (requested > 0) return static_cast<std::size_t>(requested);
+
+        unsigned hw = std::thread::hardware_concurrency();
+        return static_cast<std::size_t>(hw ? hw : 1);
+    }());
+    return pool;
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::worker_loop()
+{
+    in_worker = true;
+
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+            if (stopping_ && tasks_.empty()) return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t, std::size_t)>& fn)
+{
+    if (count == 0) return;
+
+    // nothing to share, or nested inside another parallel region
+    std::size_t num_chunks = std::min(count, size());
+    if (num_chunks <= 1 || in_worker)
+    {
+        fn(0, count);
+        return;
+    }
+
+    // chunks are claimed from a shared counter by helpers and the caller alike
+    struct State
+    {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<State>();
+
+    const std::size_t chunk = (count + num_chunks - 1) / num_chunks;
+
+    auto run_chunks = [state, chunk, count, num_chunks, &fn] {
+        std::size_t index;
+        while ((index = state->next.fetch_add(1)) < num_chunks)
+        {
+            std::size_t begin = index * chunk;
+            std::size_t end = std::min(count, begin + chunk);
+            try
+            {
+                if (begin < end) fn(begin, end);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+
+            if (state->done.fetch_add(1) + 1 == num_chunks)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    for (std::size_t i = 1; i < num_chunks; ++i) submit(run_chunks);
+    run_chunks();
+
+    // helpers still hold a reference to fn, wait for every chunk before returning
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->done.load() == num_chunks; });
+
+    if (state->error) std::rethrow_exception(state->error);
+}
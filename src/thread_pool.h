@@ -0,0 +1,44 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads used by operators for intra-op parallelism
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // shared compute pool, sized by INFERA_NUM_THREADS or the hardware thread count
+    static ThreadPool& instance();
+
+    std::size_t size() const { return workers_.size() + 1; }   // workers + calling thread
+
+    // run fn(begin, end) over [0, count) split into chunks and block until all are
+    // done. the caller works on chunks too; calls from inside a worker run inline
+    void parallel_for(std::size_t count, const std::function<void(std::size_t, std::size_t)>& fn);
+
+    // fire-and-forget task
+    void submit(std::function<void()> task);
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+#endif
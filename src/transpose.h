@@ -0,0 +1,168 @@
+#ifndef TRANSPOSE_H
+#define TRANSPOSE_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "kernels/kernels.h"
+#include "thread_pool.h"
+
+// N-d permutation helpers, y has shape[perm[i]] as its i-th dim
+
+// permutation reduced to its essential form: size-1 dims dropped and input axes
+// that stay adjacent (in order) in the output merged, so e.g. NCHW -> NHWC becomes
+// a batch of [C, H*W] -> [H*W, C] matrix transposes
+struct TransposePlan
+{
+    std::vector<std::size_t> dims;      // collapsed input dims
+    std::vector<std::size_t> perm;      // collapsed permutation
+
+    // no data movement needed, the output is the input with a new shape
+    bool is_identity() const
+    {
+        for (std::size_t i = 0; i < perm.size(); ++i)
+            if (perm[i] != i) return false;
+        return true;
+    }
+};
+
+inline TransposePlan plan_transpose(const std::vector<std::size_t>& shape, const std::vector<std::size_t>& perm)
+{
+    const std::size_t rank = shape.size();
+    if (perm.size() != rank) throw std::runtime_error("Transpose error: perm has " + std::to_string(perm.size()) + " entries for a rank " + std::to_string(rank) + " tensor.");
+
+    std::vector<bool> seen(rank, false);
+    for (auto p : perm)
+    {
+        if (p >= rank || seen[p]) throw std::runtime_error("Transpose error: perm is not a permutation.");
+        seen[p] = true;
+    }
+
+    // drop size-1 axes and renumber the rest
+    std::vector<std::size_t> index(rank, 0);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < rank; ++i)
+        if (shape[i] != 1) index[i] = kept++;
+
+    std::vector<std::size_t> squeezed;
+    for (auto p : perm)
+        if (shape[p] != 1) squeezed.push_back(p);
+
+    // group runs of consecutive input axes in output order
+    std::vector<std::size_t> group_of(rank, 0), group_start;
+    for (std::size_t i = 0; i < squeezed.size(); ++i)
+    {
+        bool continues = i > 0 && index[squeezed[i]] == index[squeezed[i - 1]] + 1;
+        if (!continues) group_start.push_back(squeezed[i]);
+        group_of[squeezed[i]] = group_start.size() - 1;
+    }
+
+    // each group becomes one input axis, numbered by where it starts in the input
+    const std::size_t groups = group_start.size();
+    std::vector<std::size_t> input_order;
+    for (std::size_t i = 0; i < rank; ++i)
+    {
+        if (shape[i] != 1 && group_start[group_of[i]] == i) input_order.push_back(group_of[i]);
+    }
+
+    TransposePlan plan;
+    plan.dims.assign(groups, 1);
+    plan.perm.assign(groups, 0);
+
+    std::vector<std::size_t> new_axis(groups, 0);
+    for (std::size_t a = 0; a < groups; ++a) new_axis[input_order[a]] = a;
+
+    for (std::size_t i = 0; i < rank; ++i)
+        if (shape[i] != 1) plan.dims[new_axis[group_of[i]]] *= shape[i];
+    for (std::size_t g = 0; g < groups; ++g) plan.perm[g] = new_axis[g];
+
+    return plan;
+}
+
+// y = transpose(x, perm); x and y must not overlap
+inline void transpose_nd(const float* x, const std::vector<std::size_t>& shape, const std::vector<std::size_t>& perm, float* y)
+{
+    const TransposePlan plan = plan_transpose(shape, perm);
+    const std::vector<std::size_t>& d = plan.dims;
+    const std::vector<std::size_t>& p = plan.perm;
+    const std::size_t rank = d.size();
+
+    std::size_t total = 1;
+    for (auto dim : d) total *= dim;
+
+    if (total == 0) return;
+    if (plan.is_identity())
+    {
+        std::memcpy(y, x, total * sizeof(float));
+        return;
+    }
+
+    // row-major strides of the input and of the output (indexed by output axis)
+    std::vector<std::size_t> in_stride(rank, 1), out_stride(rank, 1);
+    for (std::size_t i = rank - 1; i-- > 0;) in_stride[i] = in_stride[i + 1] * d[i + 1];
+    for (std::size_t i = rank - 1; i-- > 0;) out_stride[i] = out_stride[i + 1] * d[p[i + 1]];
+
+    // the input's innermost axis lands at output axis q; together with the input
+    // axis a that becomes the output's innermost one it forms a 2-D transpose
+    const std::size_t a = p[rank - 1];
+    std::size_t q = 0;
+    while (p[q] != rank - 1) ++q;
+
+    // remaining output axes enumerate a batch of those matrices
+    std::vector<std::size_t> batch_dims, batch_in, batch_out;
+    for (std::size_t i = 0; i < rank - 1; ++i)
+    {
+        if (i == q) continue;
+        batch_dims.push_back(d[p[i]]);
+        batch_in.push_back(in_stride[p[i]]);
+        batch_out.push_back(out_stride[i]);
+    }
+
+    std::size_t batch = 1;
+    for (auto dim : batch_dims) batch *= dim;
+
+    // innermost axis stays in place: the batch is made of contiguous runs
+    const bool runs = a == rank - 1;
+
+    // work items are (matrix, row block) pairs so a single large matrix still splits
+    const std::size_t rows = runs ? 1 : d[a], cols = d[rank - 1];
+    const std::size_t lds = in_stride[a], ldd = out_stride[q];
+    const std::size_t block = 64;
+    const std::size_t row_blocks = (rows + block - 1) / block;
+
+    auto run = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t item = begin; item < end; ++item)
+        {
+            std::size_t rest = item / row_blocks;
+            std::size_t in_off = 0, out_off = 0;
+            for (std::size_t k = batch_dims.size(); k-- > 0;)
+            {
+                std::size_t i = rest % batch_dims[k];
+                rest /= batch_dims[k];
+                in_off += i * batch_in[k];
+                out_off += i * batch_out[k];
+            }
+
+            if (runs)
+            {
+                std::memcpy(y + out_off, x + in_off, cols * sizeof(float));
+                continue;
+            }
+
+            std::size_t r0 = (item % row_blocks) * block;
+            std::size_t r1 = r0 + block < rows ? r0 + block : rows;
+            kernels().transpose(x + in_off + r0 * lds, r1 - r0, cols, lds, y + out_off + r0, ldd);
+        }
+    };
+
+    const std::size_t items = batch * row_blocks;
+    if (total >= (1u << 16))
+        ThreadPool::instance().parallel_for(items, run);
+    else
+        run(0, items);
+}
+
+#endif
@@ -0,0 +1,814 @@
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/graph.h"
+#include "../src/graph_optimizer.h"
+#include "../src/inference_engine.h"
+#include "../src/kernels/kernels.h"
+#include "../src/logger.h"
+#include "../src/onnx-ml.pb.h"
+#include "../src/onnx_parser.h"
+#include "../src/operator_registry.h"
+#include "../src/sparse.h"
+
+// operator conformance and kernel accuracy harness.
+//
+//   run_conformance_tests [--onnx-dir=<dir>] [--rtol=1e-3] [--atol=1e-5] [--iterations=25] [--seed=1234]
+//
+// node tests: every test_* directory under --onnx-dir (or $INFERA_ONNX_NODE_TESTS)
+// in the layout of the ONNX backend node tests, model.onnx next to
+// test_data_set_*/{input,output}_<i>.pb, is run through the engine twice, as
+// parsed and after GraphOptimizer, and every output compared within
+// |actual - expected| <= atol + rtol * |expected|. models using an operator the
+// registry lacks are skipped. without a directory a few generated cases in the
+// same layout exercise the harness itself.
+//
+// differential: every kernel of every ISA table this host runs is compared with
+// a naive reference on randomized shapes, so a faster kernel cannot quietly lose
+// accuracy. reductions are held to a bound that grows with their length
+
+namespace fs = std::filesystem;
+
+struct Tolerance
+{
+    double rtol = 1e-3;                                     // the ONNX backend test defaults
+    double atol = 1e-5;
+};
+
+struct Summary
+{
+    std::size_t passed = 0;
+    std::size_t failed = 0;
+    std::size_t skipped = 0;
+};
+
+// ---- node tests ----
+
+AnyTensor read_tensor(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    onnx::TensorProto proto;
+    if (!file || !proto.ParseFromIstream(&file)) throw std::runtime_error("cannot read tensor " + path.string());
+    return load_tensor_proto(proto);
+}
+
+// first mismatch of `actual` against `expected`, "" when they agree
+std::string compare(const AnyTensor& actual, const AnyTensor& expected, const Tolerance& tol)
+{
+    if (actual.dtype() != expected.dtype()) return "dtype " + std::to_string(static_cast<int>(actual.dtype())) + ", expected " + std::to_string(static_cast<int>(expected.dtype()));
+    if (actual.size() != expected.size()) return "size " + std::to_string(actual.size()) + ", expected " + std::to_string(expected.size());
+
+    // integers and bools must match exactly
+    if (actual.dtype() != DataType::Float32 && actual.dtype() != DataType::Float16 && actual.dtype() != DataType::BFloat16)
+    {
+        const std::vector<int64_t> a = actual.to_int64(), e = expected.to_int64();
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (a[i] != e[i]) return "element " + std::to_string(i) + " is " + std::to_string(a[i]) + ", expected " + std::to_string(e[i]);
+        return "";
+    }
+
+    const AnyTensor a = actual.cast(DataType::Float32), e = expected.cast(DataType::Float32);
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        const double x = a.get<float>()[i], y = e.get<float>()[i];
+        if (std::isnan(y) ? std::isnan(x) : std::fabs(x - y) <= tol.atol + tol.rtol * std::fabs(y)) continue;
+        return "element " + std::to_string(i) + " is " + std::to_string(x) + ", expected " + std::to_string(y);
+    }
+    return "";
+}
+
+// files <prefix>0.pb, <prefix>1.pb, ... until one is missing
+std::vector<AnyTensor> read_numbered(const fs::path& dir, const std::string& prefix)
+{
+    std::vector<AnyTensor> tensors;
+    for (std::size_t i = 0; fs::exists(dir / (prefix + std::to_string(i) + ".pb")); ++i) tensors.push_back(read_tensor(dir / (prefix + std::to_string(i) + ".pb")));
+    return tensors;
+}
+
+enum class Outcome { Pass, Fail, Skip };
+
+Outcome run_node_test(const fs::path& dir, const Tolerance& tol, std::string& detail)
+{
+    for (bool optimize : {false, true})
+    {
+        Graph graph;
+        OnnxParser parser;
+        parser.parse(graph, (dir / "model.onnx").string());
+        for (Node* node : graph.topological_sort())
+        {
+            if (OperatorRegistry::create_operator(node->get_optype())) continue;
+            detail = "no " + node->get_optype() + " operator";
+            return Outcome::Skip;
+        }
+        if (optimize) GraphOptimizer::optimize(graph);
+
+        std::vector<fs::path> data_sets;
+        for (const auto& item : fs::directory_iterator(dir))
+            if (item.is_directory() && item.path().filename().string().rfind("test_data_set_", 0) == 0) data_sets.push_back(item.path());
+        std::sort(data_sets.begin(), data_sets.end());
+        if (data_sets.empty())
+        {
+            detail = "no test_data_set_*";
+            return Outcome::Skip;
+        }
+
+        InferenceEngine engine;
+        engine.set_record_metrics(false);
+        for (const fs::path& data : data_sets)
+        {
+            std::vector<AnyTensor> inputs = read_numbered(data, "input_");
+            const std::vector<AnyTensor> expected = read_numbered(data, "output_");
+            std::vector<AnyTensor*> bound;
+            for (AnyTensor& input : inputs) bound.push_back(&input);
+
+            const std::string where = (optimize ? "optimized, " : "") + data.filename().string() + ": ";
+            std::vector<AnyTensor*> outputs;
+            try
+            {
+                outputs = engine.run(graph, bound);
+            }
+            catch (const std::exception& e)
+            {
+                detail = where + e.what();
+                return Outcome::Fail;
+            }
+            if (outputs.size() != expected.size())
+            {
+                detail = where + std::to_string(outputs.size()) + " outputs, expected " + std::to_string(expected.size());
+                return Outcome::Fail;
+            }
+            for (std::size_t i = 0; i < outputs.size(); ++i)
+            {
+                const std::string mismatch = compare(*outputs[i], expected[i], tol);
+                if (mismatch.empty()) continue;
+                detail = where + "output " + std::to_string(i) + " " + mismatch;
+                return Outcome::Fail;
+            }
+        }
+    }
+    return Outcome::Pass;
+}
+
+Summary run_node_tests(const fs::path& root, const Tolerance& tol, bool listed)
+{
+    std::vector<fs::path> cases;
+    for (const auto& item : fs::directory_iterator(root))
+        if (item.is_directory() && fs::exists(item.path() / "model.onnx")) cases.push_back(item.path());
+    std::sort(cases.begin(), cases.end());
+
+    Summary summary;
+    for (const fs::path& dir : cases)
+    {
+        std::string detail;
+        Outcome outcome;
+        try
+        {
+            outcome = run_node_test(dir, tol, detail);
+        }
+        catch (const std::exception& e)
+        {
+            outcome = Outcome::Fail;
+            detail = e.what();
+        }
+
+        // listed: every case on its own line; otherwise only failures are
+        const std::string name = dir.filename().string();
+        if (outcome == Outcome::Pass)
+        {
+            ++summary.passed;
+            if (listed) std::cout << "    pass  " << name << "\n";
+        }
+        else if (outcome == Outcome::Skip)
+        {
+            ++summary.skipped;
+            if (listed) std::cout << "    skip  " << name << ": " << detail << "\n";
+        }
+        else
+        {
+            ++summary.failed;
+            std::cout << (listed ? "    fail  " : "  [FAIL] ") << name << ": " << detail << "\n";
+        }
+    }
+    std::cout << "  " << root.string() << ": " << summary.passed << " passed, " << summary.failed << " failed, " << summary.skipped << " skipped\n";
+    return summary;
+}
+
+// ---- generated node tests ----
+
+onnx::TensorProto tensor_proto(const std::string& name, const std::vector<std::size_t>& shape, const std::vector<float>& values)
+{
+    onnx::TensorProto proto;
+    proto.set_name(name);
+    proto.set_data_type(onnx::TensorProto::FLOAT);
+    for (auto d : shape) proto.add_dims(static_cast<int64_t>(d));
+    proto.set_raw_data(values.data(), values.size() * sizeof(float));
+    return proto;
+}
+
+void add_value_info(onnx::ValueInfoProto* info, const std::string& name, const std::vector<std::size_t>& shape)
+{
+    info->set_name(name);
+    auto* tensor = info->mutable_type()->mutable_tensor_type();
+    tensor->set_elem_type(onnx::TensorProto::FLOAT);
+    for (auto d : shape) tensor->mutable_shape()->add_dim()->set_dim_value(static_cast<int64_t>(d));
+}
+
+struct GeneratedTensor
+{
+    std::string name;
+    std::vector<std::size_t> shape;
+    std::vector<float> values;
+};
+
+// one single-node model in the backend test layout
+void write_case(const fs::path& dir, const std::string& op_type, const std::vector<GeneratedTensor>& inputs, const std::vector<GeneratedTensor>& weights,
+                const GeneratedTensor& output, const std::vector<onnx::AttributeProto>& attributes = {})
+{
+    fs::create_directories(dir / "test_data_set_0");
+
+    onnx::ModelProto model;
+    model.set_ir_version(8);
+    model.add_opset_import()->set_version(13);
+    onnx::GraphProto* graph = model.mutable_graph();
+    graph->set_name(dir.filename().string());
+
+    onnx::NodeProto* node = graph->add_node();
+    node->set_name(op_type);
+    node->set_op_type(op_type);
+    for (const auto& attribute : attributes) *node->add_attribute() = attribute;
+
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        node->add_input(inputs[i].name);
+        add_value_info(graph->add_input(), inputs[i].name, inputs[i].shape);
+        std::ofstream file(dir / "test_data_set_0" / ("input_" + std::to_string(i) + ".pb"), std::ios::binary);
+        tensor_proto(inputs[i].name, inputs[i].shape, inputs[i].values).SerializeToOstream(&file);
+    }
+    for (const GeneratedTensor& weight : weights)
+    {
+        node->add_input(weight.name);
+        *graph->add_initializer() = tensor_proto(weight.name, weight.shape, weight.values);
+    }
+
+    node->add_output(output.name);
+    add_value_info(graph->add_output(), output.name, output.shape);
+    std::ofstream out(dir / "test_data_set_0" / "output_0.pb", std::ios::binary);
+    tensor_proto(output.name, output.shape, output.values).SerializeToOstream(&out);
+
+    std::ofstream file(dir / "model.onnx", std::ios::binary);
+    model.SerializeToOstream(&file);
+}
+
+onnx::AttributeProto ints_attribute(const std::string& name, const std::vector<int64_t>& values)
+{
+    onnx::AttributeProto attribute;
+    attribute.set_name(name);
+    attribute.set_type(onnx::AttributeProto::INTS);
+    for (int64_t v : values) attribute.add_ints(v);
+    return attribute;
+}
+
+std::vector<float> random_vector(std::size_t n, std::mt19937& rng, float lo = -1.0f, float hi = 1.0f)
+{
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+// expected outputs come from straightforward double precision loops
+void generate_node_tests(const fs::path& root, std::mt19937& rng)
+{
+    fs::remove_all(root);
+
+    {
+        GeneratedTensor x{"x", {2, 3, 5}, random_vector(30, rng)}, y{"y", {2, 3, 5}, {}};
+        for (float v : x.values) y.values.push_back(std::max(v, 0.0f));
+        write_case(root / "test_relu", "Relu", {x}, {}, y);
+
+        // the same case with a wrong expectation must be caught
+        y.values[7] += 0.5f;
+        write_case(root / "test_relu_wrong_expectation", "Relu", {x}, {}, y);
+    }
+    {
+        GeneratedTensor a{"a", {2, 3, 4}, random_vector(24, rng)}, b{"b", {4}, random_vector(4, rng)}, y{"y", {2, 3, 4}, {}};
+        for (std::size_t i = 0; i < 24; ++i) y.values.push_back(a.values[i] + b.values[i % 4]);
+        write_case(root / "test_add_bcast", "Add", {a, b}, {}, y);
+    }
+    {
+        const std::size_t M = 3, K = 37, N = 11;
+        GeneratedTensor a{"a", {M, K}, random_vector(M * K, rng)}, b{"b", {K, N}, random_vector(K * N, rng)}, y{"y", {M, N}, {}};
+        for (std::size_t m = 0; m < M; ++m)
+        {
+            for (std::size_t n = 0; n < N; ++n)
+            {
+                double sum = 0.0;
+                for (std::size_t k = 0; k < K; ++k) sum += static_cast<double>(a.values[m * K + k]) * b.values[k * N + n];
+                y.values.push_back(static_cast<float>(sum));
+            }
+        }
+        write_case(root / "test_matmul_2d", "MatMul", {a, b}, {}, y);
+    }
+    {
+        GeneratedTensor x{"x", {3, 7}, random_vector(21, rng, -5.0f, 5.0f)}, y{"y", {3, 7}, {}};
+        for (std::size_t r = 0; r < 3; ++r)
+        {
+            const float* row = x.values.data() + r * 7;
+            const double mx = *std::max_element(row, row + 7);
+            double sum = 0.0;
+            for (std::size_t i = 0; i < 7; ++i) sum += std::exp(row[i] - mx);
+            for (std::size_t i = 0; i < 7; ++i) y.values.push_back(static_cast<float>(std::exp(row[i] - mx) / sum));
+        }
+        write_case(root / "test_softmax_axis_1", "Softmax", {x}, {}, y);
+    }
+    {
+        // weights as initializers, so the optimized run takes the blocked convolution
+        const std::size_t C = 3, H = 9, W = 9, O = 5, KH = 3, KW = 3, stride = 2, pad = 1;
+        const std::size_t OH = (H + 2 * pad - KH) / stride + 1, OW = (W + 2 * pad - KW) / stride + 1;
+        GeneratedTensor x{"x", {1, C, H, W}, random_vector(C * H * W, rng)};
+        GeneratedTensor w{"w", {O, C, KH, KW}, random_vector(O * C * KH * KW, rng)}, bias{"bias", {O}, random_vector(O, rng)};
+        GeneratedTensor y{"y", {1, O, OH, OW}, {}};
+        for (std::size_t o = 0; o < O; ++o)
+        {
+            for (std::size_t oh = 0; oh < OH; ++oh)
+            {
+                for (std::size_t ow = 0; ow < OW; ++ow)
+                {
+                    double sum = bias.values[o];
+                    for (std::size_t c = 0; c < C; ++c)
+                    {
+                        for (std::size_t kh = 0; kh < KH; ++kh)
+                        {
+                            for (std::size_t kw = 0; kw < KW; ++kw)
+                            {
+                                const long ih = static_cast<long>(oh * stride + kh) - static_cast<long>(pad);
+                                const long iw = static_cast<long>(ow * stride + kw) - static_cast<long>(pad);
+                                if (ih < 0 || iw < 0 || ih >= static_cast<long>(H) || iw >= static_cast<long>(W)) continue;
+                                sum += static_cast<double>(x.values[(c * H + ih) * W + iw]) * w.values[((o * C + c) * KH + kh) * KW + kw];
+                            }
+                        }
+                    }
+                    y.values.push_back(static_cast<float>(sum));
+                }
+            }
+        }
+        write_case(root / "test_conv_with_strides_padding", "Conv", {x}, {w, bias}, y,
+                   {ints_attribute("kernel_shape", {3, 3}), ints_attribute("strides", {2, 2}), ints_attribute("pads", {1, 1, 1, 1})});
+    }
+    {
+        GeneratedTensor x{"x", {4}, {1.0f, -2.0f, 0.5f, 3.0f}}, y{"y", {4}, {1.0f, -0.86466473f, 0.5f, 3.0f}};
+        write_case(root / "test_celu", "Celu", {x}, {}, y);
+    }
+}
+
+void test_node_conformance(const std::string& onnx_dir, const Tolerance& tol, unsigned seed, Summary& total)
+{
+    std::cout << "Running ONNX Node Conformance...\n";
+
+    if (!onnx_dir.empty())
+    {
+        Summary s = run_node_tests(onnx_dir, tol, false);
+        total.passed += s.passed;
+        total.failed += s.failed;
+        total.skipped += s.skipped;
+        return;
+    }
+
+    // generated cases: all pass except the planted wrong expectation, the unknown operator is skipped
+    std::mt19937 rng(seed);
+    const fs::path root = fs::temp_directory_path() / "infera_conformance_test";
+    generate_node_tests(root, rng);
+
+    Summary s = run_node_tests(root, tol, true);
+    assert(s.passed == 5 && s.failed == 1 && s.skipped == 1);
+    fs::remove_all(root);
+    ++total.passed;
+    std::cout << "  [PASS] generated node tests, including a caught mismatch and a skipped operator\n";
+}
+
+// ---- differential kernels ----
+
+std::vector<const KernelTable*> available_tables()
+{
+    std::vector<const KernelTable*> tables;
+    for (Isa isa : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512})
+    {
+        if (const KernelTable* table = kernels_for(isa)) tables.push_back(table);
+    }
+    return tables;
+}
+
+// records the worst error of one kernel and whether it stayed within bounds
+class Differential
+{
+public:
+    Differential(const KernelTable& table, const char* kernel) : table_(table), kernel_(kernel) {}
+
+    // |actual - expected| <= bound, with the case described on the first failure
+    void check(double actual, double expected, double bound, const std::string& shape)
+    {
+        if (actual == expected || (std::isnan(actual) && std::isnan(expected))) return;       // also equal infinities
+        const double error = std::fabs(actual - expected);
+        worst_ = std::max(worst_, error / std::max(bound, 1e-30));
+        if (error <= bound || failed_) return;
+        failed_ = true;
+        std::cout << "  [FAIL] " << kernel_ << " " << table_.name << " " << shape << ": " << actual << ", expected " << expected << " (bound " << bound << ")\n";
+    }
+
+    bool failed() const { return failed_; }
+    double worst() const { return worst_; }                 // largest error as a fraction of its bound
+private:
+    const KernelTable& table_;
+    const char* kernel_;
+    bool failed_ = false;
+    double worst_ = 0.0;
+};
+
+// float32 accumulation of n products drifts by about n * eps of their magnitude
+double reduction_bound(std::size_t n, double magnitude)
+{
+    return 2.0 * static_cast<double>(n + 4) * 5.96e-8 * magnitude + 1e-6;
+}
+
+std::size_t pick(std::mt19937& rng, std::size_t lo, std::size_t hi)
+{
+    return std::uniform_int_distribution<std::size_t>(lo, hi)(rng);
+}
+
+std::string dims(std::initializer_list<std::size_t> values)
+{
+    std::string s = "[";
+    for (auto v : values) s += (s.size() > 1 ? "," : "") + std::to_string(v);
+    return s + "]";
+}
+
+void differential_gemm(const KernelTable& table, std::mt19937& rng, std::size_t iterations, Differential& f32, Differential& f16, Differential& bsr)
+{
+    for (std::size_t it = 0; it < iterations; ++it)
+    {
+        const std::size_t M = pick(rng, 1, 70), N = pick(rng, 1, 90), K = pick(rng, 1, 300);
+        const bool ta = pick(rng, 0, 1), tb = pick(rng, 0, 1);
+        const std::size_t lda = (ta ? M : K) + pick(rng, 0, 3), ldb = (tb ? K : N) + pick(rng, 0, 3), ldc = N + pick(rng, 0, 3);
+        const float alpha = std::uniform_real_distribution<float>(-2.0f, 2.0f)(rng), beta = pick(rng, 0, 2) * 0.5f;
+        const std::string shape = dims({M, N, K}) + (ta ? " A^T" : "") + (tb ? " B^T" : "");
+
+        auto A = random_vector((ta ? K : M) * lda, rng);
+        auto B = random_vector((tb ? N : K) * ldb, rng);
+        auto C = random_vector(M * ldc, rng);
+        std::vector<uint16_t> half(B.size());
+        std::vector<float> widened(B.size());
+        for (std::size_t i = 0; i < B.size(); ++i)
+        {
+            half[i] = float_to_half(B[i]);
+            widened[i] = half_to_float(half[i]);
+        }
+
+        auto reference = [&](const std::vector<float>& b, std::size_t m, std::size_t n, double& magnitude)
+        {
+            double sum = 0.0;
+            magnitude = std::fabs(beta * C[m * ldc + n]);
+            for (std::size_t k = 0; k < K; ++k)
+            {
+                const double product = static_cast<double>(ta ? A[k * lda + m] : A[m * lda + k]) * (tb ? b[n * ldb + k] : b[k * ldb + n]);
+                sum += product;
+                magnitude += std::fabs(alpha * product);
+            }
+            return alpha * sum + beta * C[m * ldc + n];
+        };
+
+        std::vector<float> y = C, y16 = C;
+        table.sgemm(ta, tb, M, N, K, alpha, A.data(), lda, B.data(), ldb, beta, y.data(), ldc);
+        table.sgemm_f16(ta, tb, M, N, K, alpha, A.data(), lda, half.data(), ldb, beta, y16.data(), ldc);
+        for (std::size_t m = 0; m < M; ++m)
+        {
+            for (std::size_t n = 0; n < N; ++n)
+            {
+                double magnitude;
+                double expected = reference(B, m, n, magnitude);
+                f32.check(y[m * ldc + n], expected, reduction_bound(K, magnitude), shape);
+                expected = reference(widened, m, n, magnitude);
+                f16.check(y16[m * ldc + n], expected, reduction_bound(K, magnitude), shape);
+            }
+        }
+
+        // block-sparse B: dense K x N, mostly zeros, accumulated into C
+        std::vector<float> dense(K * N);
+        std::uniform_real_distribution<float> keep(0.0f, 1.0f);
+        for (std::size_t i = 0; i < dense.size(); ++i) dense[i] = keep(rng) < 0.8f ? 0.0f : B[i % B.size()];
+        BsrWeights weights = make_bsr(dense.data(), K, N, false, table.bsr_block);
+        auto rows = random_vector(M * K, rng);
+        std::vector<float> z(C.begin(), C.begin() + M * N);
+        table.bsr_gemm(M, alpha, rows.data(), K, weights.view(), z.data(), N);
+        for (std::size_t m = 0; m < M; ++m)
+        {
+            for (std::size_t n = 0; n < N; ++n)
+            {
+                double sum = 0.0, magnitude = std::fabs(C[m * N + n]);
+                for (std::size_t k = 0; k < K; ++k)
+                {
+                    const double product = static_cast<double>(alpha) * rows[m * K + k] * dense[k * N + n];
+                    sum += product;
+                    magnitude += std::fabs(product);
+                }
+                bsr.check(z[m * N + n], C[m * N + n] + sum, reduction_bound(K, magnitude), dims({M, N, K}));
+            }
+        }
+    }
+}
+
+void differential_elementwise(const KernelTable& table, std::mt19937& rng, std::size_t iterations, Differential& exact, Differential& activations, Differential& softmax)
+{
+    for (std::size_t it = 0; it < iterations; ++it)
+    {
+        const std::size_t n = pick(rng, 1, 3000);
+        const std::string shape = dims({n});
+        auto a = random_vector(n, rng, -20.0f, 20.0f);
+        auto b = random_vector(n, rng, -20.0f, 20.0f);
+        const float s = b[0], t = a[0];
+        std::vector<float> y(n);
+
+        table.add(a.data(), b.data(), y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) exact.check(y[i], a[i] + b[i], 0.0, shape);
+        table.add_scalar(a.data(), s, y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) exact.check(y[i], a[i] + s, 0.0, shape);
+        table.relu(a.data(), y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) exact.check(y[i], std::max(a[i], 0.0f), 0.0, shape);
+        table.scale_shift(a.data(), s, t, y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) exact.check(y[i], static_cast<double>(s) * a[i] + t, 2.4e-7 * (std::fabs(s * a[i]) + std::fabs(t)), shape);
+
+        const std::size_t rows = pick(rng, 1, 40), cols = pick(rng, 1, 70), lds = cols + pick(rng, 0, 5), ldd = rows + pick(rng, 0, 5);
+        auto src = random_vector(rows * lds, rng);
+        std::vector<float> dst(cols * ldd);
+        table.transpose(src.data(), rows, cols, lds, dst.data(), ldd);
+        for (std::size_t i = 0; i < rows; ++i)
+            for (std::size_t j = 0; j < cols; ++j) exact.check(dst[j * ldd + i], src[i * lds + j], 0.0, dims({rows, cols}));
+
+        // polynomial activations, within the documented bounds plus rounding
+        struct Activation { void (*kernel)(const float*, float*, std::size_t); double (*ref)(double); double rel; };
+        const Activation activation_list[] = {
+            {table.exp, [](double v) { return std::exp(v); }, 3e-7},
+            {table.sigmoid, [](double v) { return 1.0 / (1.0 + std::exp(-v)); }, 3e-7},
+            {table.tanh, [](double v) { return std::tanh(v); }, 4e-7},
+            {table.silu, [](double v) { return v / (1.0 + std::exp(-v)); }, 3e-6},
+            {table.gelu, [](double v) { return 0.5 * v * (1.0 + std::erf(v / std::sqrt(2.0))); }, 3e-6},
+            {table.gelu_tanh, [](double v) { return 0.5 * v * (1.0 + std::tanh(0.7978845608028654 * (v + 0.044715 * v * v * v))); }, 3e-6},
+        };
+        for (const Activation& act : activation_list)
+        {
+            act.kernel(a.data(), y.data(), n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const double expected = act.ref(a[i]);
+                activations.check(y[i], expected, act.rel * std::max(1.0, std::fabs(expected)), shape);
+            }
+        }
+
+        std::vector<float> log_y(n);
+        table.softmax(a.data(), y.data(), n);
+        table.log_softmax(a.data(), log_y.data(), n);
+        const double mx = *std::max_element(a.begin(), a.end());
+        double sum = 0.0;
+        for (float v : a) sum += std::exp(v - mx);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            softmax.check(y[i], std::exp(a[i] - mx) / sum, 1e-6, shape);
+            softmax.check(log_y[i], a[i] - mx - std::log(sum), 1e-5 * std::max(1.0, std::fabs(a[i] - mx)), shape);
+        }
+    }
+}
+
+void differential_nchwc(const KernelTable& table, std::mt19937& rng, std::size_t iterations, Differential& conv, Differential& pool)
+{
+    const std::size_t B = table.nchwc_block;
+    for (std::size_t it = 0; it < iterations; ++it)
+    {
+        NchwcConvArgs c{};
+        c.in_blocks = pick(rng, 1, 3);
+        c.kernel_h = pick(rng, 1, 5);
+        c.kernel_w = pick(rng, 1, 5);
+        c.stride_h = pick(rng, 1, 3);
+        c.stride_w = pick(rng, 1, 3);
+        c.dilation_h = pick(rng, 1, 2);
+        c.dilation_w = pick(rng, 1, 2);
+        c.pad_top = pick(rng, 0, c.kernel_h - 1);
+        c.pad_left = pick(rng, 0, c.kernel_w - 1);
+        const std::size_t span_h = (c.kernel_h - 1) * c.dilation_h + 1, span_w = (c.kernel_w - 1) * c.dilation_w + 1;
+        c.in_h = pick(rng, std::max<std::size_t>(1, span_h - std::min(span_h - 1, 2 * c.pad_top)), 14);
+        c.in_w = pick(rng, std::max<std::size_t>(1, span_w - std::min(span_w - 1, 2 * c.pad_left)), 14);
+        const std::size_t out_h = (c.in_h + 2 * c.pad_top - span_h) / c.stride_h + 1;
+        c.out_w = (c.in_w + 2 * c.pad_left - span_w) / c.stride_w + 1;
+        c.out_row = pick(rng, 0, out_h - 1);
+        const std::string shape = dims({c.in_blocks * B, c.in_h, c.in_w}) + " k" + dims({c.kernel_h, c.kernel_w}) + " s" + dims({c.stride_h, c.stride_w}) +
+                                  " d" + dims({c.dilation_h, c.dilation_w}) + " p" + dims({c.pad_top, c.pad_left});
+
+        auto input = random_vector(c.in_blocks * c.in_h * c.in_w * B, rng);
+        auto weights = random_vector(c.in_blocks * c.kernel_h * c.kernel_w * B * B, rng);
+        auto bias = random_vector(B, rng);
+        std::vector<float> output(c.out_w * B);
+        c.input = input.data();
+        c.weights = weights.data();
+        c.bias = pick(rng, 0, 1) ? bias.data() : nullptr;
+        c.output = output.data();
+        table.nchwc_conv(c);
+
+        for (std::size_t ow = 0; ow < c.out_w; ++ow)
+        {
+            for (std::size_t bo = 0; bo < B; ++bo)
+            {
+                double sum = c.bias ? c.bias[bo] : 0.0, magnitude = std::fabs(sum);
+                for (std::size_t ib = 0; ib < c.in_blocks; ++ib)
+                {
+                    for (std::size_t kh = 0; kh < c.kernel_h; ++kh)
+                    {
+                        for (std::size_t kw = 0; kw < c.kernel_w; ++kw)
+                        {
+                            const long ih = static_cast<long>(c.out_row * c.stride_h + kh * c.dilation_h) - static_cast<long>(c.pad_top);
+                            const long iw = static_cast<long>(ow * c.stride_w + kw * c.dilation_w) - static_cast<long>(c.pad_left);
+                            if (ih < 0 || iw < 0 || ih >= static_cast<long>(c.in_h) || iw >= static_cast<long>(c.in_w)) continue;
+                            for (std::size_t bi = 0; bi < B; ++bi)
+                            {
+                                const double product = static_cast<double>(input[((ib * c.in_h + ih) * c.in_w + iw) * B + bi]) *
+                                                       weights[(((ib * c.kernel_h + kh) * c.kernel_w + kw) * B + bi) * B + bo];
+                                sum += product;
+                                magnitude += std::fabs(product);
+                            }
+                        }
+                    }
+                }
+                conv.check(output[ow * B + bo], sum, reduction_bound(c.in_blocks * B * c.kernel_h * c.kernel_w, magnitude), shape);
+            }
+        }
+
+        // pooling over one plane with the same window
+        NchwcPoolArgs p{};
+        p.in_h = c.in_h;
+        p.in_w = c.in_w;
+        p.kernel_h = c.kernel_h;
+        p.kernel_w = c.kernel_w;
+        p.stride_h = c.stride_h;
+        p.stride_w = c.stride_w;
+        p.dilation_h = c.dilation_h;
+        p.dilation_w = c.dilation_w;
+        p.pad_top = c.pad_top;
+        p.pad_left = c.pad_left;
+        p.out_row = c.out_row;
+        p.out_w = c.out_w;
+        p.count_include_pad = pick(rng, 0, 1);
+        p.input = input.data();
+        std::vector<float> max_out(p.out_w * B), avg_out(p.out_w * B);
+        p.output = max_out.data();
+        table.nchwc_max_pool(p);
+        p.output = avg_out.data();
+        table.nchwc_avg_pool(p);
+
+        for (std::size_t ow = 0; ow < p.out_w; ++ow)
+        {
+            for (std::size_t b = 0; b < B; ++b)
+            {
+                double mx = -INFINITY, sum = 0.0;
+                std::size_t count = 0;
+                for (std::size_t kh = 0; kh < p.kernel_h; ++kh)
+                {
+                    for (std::size_t kw = 0; kw < p.kernel_w; ++kw)
+                    {
+                        const long ih = static_cast<long>(p.out_row * p.stride_h + kh * p.dilation_h) - static_cast<long>(p.pad_top);
+                        const long iw = static_cast<long>(ow * p.stride_w + kw * p.dilation_w) - static_cast<long>(p.pad_left);
+                        if (ih < 0 || iw < 0 || ih >= static_cast<long>(p.in_h) || iw >= static_cast<long>(p.in_w)) continue;
+                        const float v = input[(ih * p.in_w + iw) * B + b];
+                        mx = std::max<double>(mx, v);
+                        sum += v;
+                        ++count;
+                    }
+                }
+                if (p.count_include_pad) count = p.kernel_h * p.kernel_w;
+                pool.check(max_out[ow * B + b], mx, 0.0, shape);
+                pool.check(avg_out[ow * B + b], count ? sum / count : 0.0, reduction_bound(p.kernel_h * p.kernel_w, 1.0), shape);
+            }
+        }
+    }
+}
+
+// conversions and the hash, where the scalar table is the definition
+void differential_conversions(const KernelTable& table, std::mt19937& rng, std::size_t iterations, Differential& exact)
+{
+    const KernelTable& scalar = scalar_kernels();
+    for (std::size_t it = 0; it < iterations; ++it)
+    {
+        const std::size_t n = pick(rng, 1, 2000), channels = pick(rng, 1, 4);
+        std::vector<uint8_t> pixels(n);
+        std::vector<uint16_t> half(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            pixels[i] = static_cast<uint8_t>(rng());
+            half[i] = float_to_half(std::uniform_real_distribution<float>(-70000.0f, 70000.0f)(rng));
+        }
+        auto scale = random_vector(4, rng), bias = random_vector(4, rng);
+
+        std::vector<float> y(n);
+        table.u8_to_float(pixels.data(), y.data(), n, channels, scale.data(), bias.data());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double expected = static_cast<double>(pixels[i]) * scale[i % channels] + bias[i % channels];
+            exact.check(y[i], expected, 2.4e-7 * (255.0 + 1.0), dims({n, channels}));
+        }
+        table.half_to_float(half.data(), y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) exact.check(y[i], half_to_float(half[i]), 0.0, dims({n}));
+
+        uint64_t expected[2], actual[2];
+        const uint64_t seed = rng();
+        scalar.hash128(pixels.data(), n, seed, expected);
+        table.hash128(pixels.data(), n, seed, actual);
+        exact.check(actual[0] == expected[0] && actual[1] == expected[1] ? 0.0 : 1.0, 0.0, 0.0, "hash128 " + dims({n}));
+    }
+}
+
+void test_differential_kernels(std::size_t iterations, unsigned seed, Summary& total)
+{
+    std::cout << "\nRunning Differential Kernel Test (seed " << seed << ", " << iterations << " randomized cases per kernel)...\n";
+
+    for (const KernelTable* table : available_tables())
+    {
+        std::mt19937 rng(seed);
+        Differential sgemm(*table, "sgemm"), sgemm_f16(*table, "sgemm_f16"), bsr_gemm(*table, "bsr_gemm");
+        Differential exact(*table, "elementwise/transpose"), activations(*table, "activations"), softmax(*table, "softmax");
+        Differential conv(*table, "nchwc_conv"), pool(*table, "nchwc_pool"), conversions(*table, "conversions/hash");
+
+        differential_gemm(*table, rng, iterations, sgemm, sgemm_f16, bsr_gemm);
+        differential_elementwise(*table, rng, iterations, exact, activations, softmax);
+        differential_nchwc(*table, rng, iterations, conv, pool);
+        differential_conversions(*table, rng, iterations, conversions);
+
+        bool failed = false;
+        double worst = 0.0;
+        for (const Differential* d : {&sgemm, &sgemm_f16, &bsr_gemm, &exact, &activations, &softmax, &conv, &pool, &conversions})
+        {
+            failed |= d->failed();
+            if (!d->failed()) worst = std::max(worst, d->worst());
+        }
+        if (failed)
+        {
+            ++total.failed;
+            continue;
+        }
+        ++total.passed;
+        std::cout << "  [PASS] " << table->name << " matches the references, worst error " << worst * 100.0 << "% of its bound\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string onnx_dir = std::getenv("INFERA_ONNX_NODE_TESTS") ? std::getenv("INFERA_ONNX_NODE_TESTS") : "";
+    Tolerance tol;
+    std::size_t iterations = 25;
+    unsigned seed = 1234;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--onnx-dir=", 0) == 0)
+            onnx_dir = arg.substr(11);
+        else if (arg.rfind("--rtol=", 0) == 0)
+            tol.rtol = std::stod(arg.substr(7));
+        else if (arg.rfind("--atol=", 0) == 0)
+            tol.atol = std::stod(arg.substr(7));
+        else if (arg.rfind("--iterations=", 0) == 0)
+            iterations = std::stoul(arg.substr(13));
+        else if (arg.rfind("--seed=", 0) == 0)
+            seed = static_cast<unsigned>(std::stoul(arg.substr(7)));
+        else
+        {
+            std::cerr << "Usage: run_conformance_tests [--onnx-dir=<dir>] [--rtol=1e-3] [--atol=1e-5] [--iterations=25] [--seed=1234]\n";
+            return 1;
+        }
+    }
+
+    // unsupported operators are reported as skips, not warnings
+    Logger::instance().set_level(LogLevel::Error);
+
+    try
+    {
+        Summary total;
+        test_node_conformance(onnx_dir, tol, seed, total);
+        test_differential_kernels(iterations, seed, total);
+        if (total.failed)
+        {
+            std::cerr << "\nConformance failed: " << total.failed << " failure(s)\n";
+            return 1;
+        }
+        std::cout << "\nCONFORMANCE TESTS PASSED!\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Conformance test failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
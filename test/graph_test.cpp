@@ -146,6 +146,45 @@ void test_topological_sort()
     std::cout << " [PASS] Topological sort respects dependencies.\n";
 }
 
+void test_typed_initializers()
+{
+    std::cout << "\nRunning Typed Initializer Test...\n";
+
+    onnx::GraphProto graph_proto;
+    graph_proto.add_input()->set_name("x");
+    graph_proto.add_input()->set_name("shape");        // initializer listed as an input too (old exporters)
+    *graph_proto.add_node() = create_node_proto("reshape", "Reshape", {"x", "shape"}, {"y"});
+
+    // int64 in raw_data
+    auto* shape = graph_proto.add_initializer();
+    shape->set_name("shape");
+    shape->set_data_type(onnx::TensorProto::INT64);
+    shape->add_dims(2);
+    int64_t dims[] = {1, -1};
+    shape->set_raw_data(std::string(reinterpret_cast<const char*>(dims), sizeof(dims)));
+
+    // float16 in int32_data (one value per entry)
+    auto* half = graph_proto.add_initializer();
+    half->set_name("half");
+    half->set_data_type(onnx::TensorProto::FLOAT16);
+    half->add_dims(2);
+    half->add_int32_data(0x3c00);
+    half->add_int32_data(0xc000);
+
+    Graph graph(graph_proto);
+    assert(graph.get_input_size() == 1 && graph.get_input_name(0) == "x");
+
+    AnyTensor* s = graph.get_any_initializer("shape");
+    assert(s && s->dtype() == DataType::Int64);
+    assert((s->to_int64() == std::vector<int64_t>{1, -1}));
+    assert(graph.get_initializer("shape") == nullptr);  // not float32
+
+    AnyTensor h = graph.get_any_initializer("half")->cast(DataType::Float32);
+    assert(h.get<float>()[0] == 1.0f && h.get<float>()[1] == -2.0f);
+
+    std::cout << " [PASS] int64/float16 initializers keep their dtype.\n";
+}
+
 int main() 
 {
     try 
@@ -153,6 +192,7 @@ int main()
         test_graph_construction();
         test_load_from_file();
         test_topological_sort();
+        test_typed_initializers();
         std::cout << "\nGRAPH TESTS PASSED!\n";
     } 
     catch (const std::exception& e) 
@@ -0,0 +1,401 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "../src/cpu_features.h"
+#include "../src/kernels/kernels.h"
+#include "../src/data_type.h"
+#include "../src/sparse.h"
+
+// every ISA variant this host can run
+std::vector<const KernelTable*> available_tables()
+{
+    std::vector<const KernelTable*> tables;
+    for (Isa isa : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512})
+    {
+        if (const KernelTable* table = kernels_for(isa)) tables.push_back(table);
+    }
+    return tables;
+}
+
+std::vector<float> random_vector(std::size_t n, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+// naive reference for C = alpha * op(A) * op(B) + beta * C
+void reference_gemm(bool ta, bool tb, std::size_t M, std::size_t N, std::size_t K, float alpha, const float* A, const float* B, float beta, float* C)
+{
+    for (std::size_t m = 0; m < M; ++m)
+    {
+        for (std::size_t n = 0; n < N; ++n)
+        {
+            double sum = 0.0;
+            for (std::size_t k = 0; k < K; ++k)
+            {
+                float a = ta ? A[k * M + m] : A[m * K + k];
+                float b = tb ? B[n * K + k] : B[k * N + n];
+                sum += static_cast<double>(a) * b;
+            }
+            C[m * N + n] = static_cast<float>(alpha * sum + beta * C[m * N + n]);
+        }
+    }
+}
+
+void test_cpu_features()
+{
+    std::cout << "Running CPU Feature Test...\n";
+
+    Isa parsed;
+    assert(parse_isa("avx2", parsed) && parsed == Isa::Avx2);
+    assert(!parse_isa("neon", parsed));
+    assert(isa_supported(Isa::Scalar));
+    assert(isa_supported(best_supported_isa()));
+
+    std::cout << "  Best ISA: " << isa_name(best_supported_isa()) << ", active kernels: " << kernels().name << "\n";
+    std::cout << "  [PASS] CPU features\n";
+}
+
+void test_sgemm_variants()
+{
+    std::cout << "\nRunning SGEMM Variant Test...\n";
+
+    std::mt19937 rng(42);
+    const std::size_t shapes[][3] = {{1, 10, 784}, {1, 128, 784}, {3, 17, 9}, {6, 32, 64}, {37, 45, 300}, {150, 70, 260}};
+
+    for (const KernelTable* table : available_tables())
+    {
+        for (const auto& shape : shapes)
+        {
+            std::size_t M = shape[0], N = shape[1], K = shape[2];
+            for (int ta = 0; ta < 2; ++ta)
+            {
+                for (int tb = 0; tb < 2; ++tb)
+                {
+                    auto A = random_vector(M * K, rng);
+                    auto B = random_vector(K * N, rng);
+                    auto C = random_vector(M * N, rng);
+                    auto expected = C;
+
+                    reference_gemm(ta, tb, M, N, K, 0.5f, A.data(), B.data(), 2.0f, expected.data());
+                    table->sgemm(ta, tb, M, N, K, 0.5f, A.data(), ta ? M : K, B.data(), tb ? K : N, 2.0f, C.data(), N);
+
+                    for (std::size_t i = 0; i < C.size(); ++i)
+                    {
+                        assert(std::fabs(C[i] - expected[i]) < 1e-3f * (1.0f + std::fabs(expected[i])));
+                    }
+                }
+            }
+        }
+        std::cout << "  [PASS] sgemm " << table->name << "\n";
+    }
+}
+
+void test_sgemm_f16_variants()
+{
+    std::cout << "\nRunning FP16-Weight SGEMM Test...\n";
+
+    // every half bit pattern widens exactly like the reference conversion
+    std::vector<uint16_t> all(1 << 16);
+    for (std::size_t i = 0; i < all.size(); ++i) all[i] = static_cast<uint16_t>(i);
+
+    std::mt19937 rng(7);
+    const std::size_t shapes[][3] = {{1, 10, 784}, {2, 33, 70}, {37, 45, 300}, {150, 70, 260}};
+
+    for (const KernelTable* table : available_tables())
+    {
+        std::vector<float> wide(all.size());
+        table->half_to_float(all.data(), wide.data(), all.size());
+        for (std::size_t i = 0; i < all.size(); ++i)
+        {
+            // F16C quiets signaling NaNs, so NaNs only need to stay NaN
+            float expected = half_to_float(all[i]);
+            assert(std::isnan(expected) ? std::isnan(wide[i]) : std::memcmp(&wide[i], &expected, sizeof(float)) == 0);
+        }
+
+        // fp16 B must give the fp32 result of the widened weights
+        for (const auto& shape : shapes)
+        {
+            std::size_t M = shape[0], N = shape[1], K = shape[2];
+            for (int tb = 0; tb < 2; ++tb)
+            {
+                auto A = random_vector(M * K, rng);
+                auto B = random_vector(K * N, rng);
+                auto C = random_vector(M * N, rng);
+
+                std::vector<uint16_t> half(B.size());
+                for (std::size_t i = 0; i < B.size(); ++i)
+                {
+                    half[i] = float_to_half(B[i]);
+                    B[i] = half_to_float(half[i]);
+                }
+
+                auto expected = C;
+                reference_gemm(false, tb, M, N, K, 1.0f, A.data(), B.data(), 1.0f, expected.data());
+                table->sgemm_f16(false, tb, M, N, K, 1.0f, A.data(), K, half.data(), tb ? K : N, 1.0f, C.data(), N);
+
+                for (std::size_t i = 0; i < C.size(); ++i)
+                {
+                    assert(std::fabs(C[i] - expected[i]) < 1e-3f * (1.0f + std::fabs(expected[i])));
+                }
+            }
+        }
+        std::cout << "  [PASS] sgemm_f16 " << table->name << "\n";
+    }
+}
+
+void test_bsr_gemm_variants()
+{
+    std::cout << "\nRunning Block-Sparse GEMM Test...\n";
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> keep(0.0f, 1.0f);
+    const std::size_t shapes[][3] = {{1, 10, 784}, {6, 37, 50}, {16, 64, 128}};
+
+    for (const KernelTable* table : available_tables())
+    {
+        for (const auto& shape : shapes)
+        {
+            std::size_t M = shape[0], N = shape[1], K = shape[2];
+            for (int tb = 0; tb < 2; ++tb)
+            {
+                // ~85% zeros, N not a multiple of the block exercises the partial tile
+                auto A = random_vector(M * K, rng);
+                auto B = random_vector(K * N, rng);
+                for (auto& b : B) if (keep(rng) < 0.85f) b = 0.0f;
+                auto C = random_vector(M * N, rng);
+
+                auto expected = C;
+                reference_gemm(false, tb, M, N, K, 0.5f, A.data(), B.data(), 1.0f, expected.data());
+
+                BsrWeights bsr = make_bsr(B.data(), K, N, tb, table->bsr_block);
+                assert(bsr.col_ptr.size() == (N + table->bsr_block - 1) / table->bsr_block + 1);
+                assert(bsr.values.size() == bsr.row_index.size() * table->bsr_block);
+                table->bsr_gemm(M, 0.5f, A.data(), K, bsr.view(), C.data(), N);
+
+                for (std::size_t i = 0; i < C.size(); ++i)
+                {
+                    assert(std::fabs(C[i] - expected[i]) < 1e-4f * (1.0f + std::fabs(expected[i])));
+                }
+            }
+        }
+        std::cout << "  [PASS] bsr_gemm " << table->name << "\n";
+    }
+}
+
+void test_elementwise_variants()
+{
+    std::cout << "\nRunning Elementwise Variant Test...\n";
+
+    std::mt19937 rng(7);
+    const std::size_t n = 1000 + 3;  // exercise the scalar tail
+    auto a = random_vector(n, rng);
+    auto b = random_vector(n, rng);
+
+    for (const KernelTable* table : available_tables())
+    {
+        std::vector<float> y(n);
+
+        table->add(a.data(), b.data(), y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) assert(y[i] == a[i] + b[i]);
+
+        table->relu(a.data(), y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) assert(y[i] == std::max(a[i], 0.0f));
+
+        std::cout << "  [PASS] add/relu " << table->name << "\n";
+    }
+}
+
+void test_u8_to_float_variants()
+{
+    std::cout << "\nRunning uint8 Conversion Variant Test...\n";
+
+    std::mt19937 rng(5);
+    std::vector<uint8_t> x(1000);
+    for (auto& v : x) v = static_cast<uint8_t>(rng());
+    const float scale[4] = {1.0f / 255, 2.0f, -0.5f, 0.25f}, bias[4] = {0.0f, -1.0f, 3.0f, 0.5f};
+
+    for (const KernelTable* table : available_tables())
+    {
+        for (std::size_t channels = 1; channels <= 4; ++channels)
+        {
+            for (std::size_t n : {1, 3, 17, 96, 1000})
+            {
+                std::vector<float> y(n);
+                table->u8_to_float(x.data(), y.data(), n, channels, scale, bias);
+                for (std::size_t i = 0; i < n; ++i)
+                    assert(std::fabs(y[i] - (x[i] * scale[i % channels] + bias[i % channels])) < 1e-4f);
+            }
+        }
+        std::cout << "  [PASS] u8_to_float " << table->name << "\n";
+    }
+}
+
+void test_transpose_variants()
+{
+    std::cout << "\nRunning Transpose Variant Test...\n";
+
+    std::mt19937 rng(11);
+    // odd sizes cover partial register blocks and partial tiles
+    const std::size_t shapes[][2] = {{1, 1}, {3, 5}, {16, 16}, {37, 70}, {130, 67}};
+
+    for (const KernelTable* table : available_tables())
+    {
+        for (const auto& s : shapes)
+        {
+            const std::size_t rows = s[0], cols = s[1], lds = cols + 3, ldd = rows + 1;
+            auto src = random_vector(rows * lds, rng);
+            std::vector<float> dst(cols * ldd, 0.0f);
+
+            table->transpose(src.data(), rows, cols, lds, dst.data(), ldd);
+            for (std::size_t i = 0; i < rows; ++i)
+                for (std::size_t j = 0; j < cols; ++j) assert(dst[j * ldd + i] == src[i * lds + j]);
+        }
+        std::cout << "  [PASS] transpose " << table->name << "\n";
+    }
+}
+
+// max error of a kernel against a double precision reference over [lo, hi]
+template <class Ref>
+double max_error(void (*kernel)(const float*, float*, std::size_t), Ref ref, float lo, float hi, bool relative)
+{
+    const std::size_t n = 20011;
+    std::vector<float> x(n), y(n);
+    for (std::size_t i = 0; i < n; ++i) x[i] = lo + (hi - lo) * static_cast<float>(i) / (n - 1);
+
+    kernel(x.data(), y.data(), n);
+
+    double worst = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double expected = ref(static_cast<double>(x[i]));
+        double err = std::fabs(y[i] - expected);
+        if (relative) err /= std::fabs(expected);
+        worst = std::max(worst, err);
+    }
+    return worst;
+}
+
+void test_activation_accuracy()
+{
+    std::cout << "\nRunning Activation Accuracy Test...\n";
+
+    for (const KernelTable* table : available_tables())
+    {
+        double exp_err  = max_error(table->exp, [](double v) { return std::exp(v); }, -87.0f, 88.0f, true);
+        double sig_err  = max_error(table->sigmoid, [](double v) { return 1.0 / (1.0 + std::exp(-v)); }, -30.0f, 30.0f, false);
+        double tanh_err = max_error(table->tanh, [](double v) { return std::tanh(v); }, -10.0f, 10.0f, false);
+        double gelu_err = max_error(table->gelu, [](double v) { return 0.5 * v * (1.0 + std::erf(v / std::sqrt(2.0))); }, -6.0f, 6.0f, false);
+        double silu_err = max_error(table->silu, [](double v) { return v / (1.0 + std::exp(-v)); }, -6.0f, 6.0f, false);
+
+        std::cout << "  " << table->name << ": exp rel " << exp_err << ", sigmoid " << sig_err << ", tanh " << tanh_err
+                  << ", gelu " << gelu_err << ", silu " << silu_err << "\n";
+
+        assert(exp_err < 2e-7);
+        assert(sig_err < 2e-7);
+        assert(tanh_err < 3e-7);
+        assert(gelu_err < 2e-6);   // erf error scaled by |x| / 2
+        assert(silu_err < 2e-6);
+    }
+    std::cout << "  [PASS] activation error bounds\n";
+}
+
+void test_softmax_variants()
+{
+    std::cout << "\nRunning Softmax Variant Test...\n";
+
+    std::mt19937 rng(3);
+    for (const KernelTable* table : available_tables())
+    {
+        for (std::size_t n : {1, 3, 10, 16, 67, 1000})
+        {
+            auto x = random_vector(n, rng);
+            for (auto& v : x) v *= 20.0f;
+
+            double mx = *std::max_element(x.begin(), x.end());
+            double sum = 0.0;
+            for (float v : x) sum += std::exp(v - mx);
+
+            std::vector<float> y(n), log_y(n);
+            table->softmax(x.data(), y.data(), n);
+            table->log_softmax(x.data(), log_y.data(), n);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double p = std::exp(x[i] - mx) / sum;
+                assert(std::fabs(y[i] - p) < 1e-6);
+                assert(std::fabs(log_y[i] - (x[i] - mx - std::log(sum))) < 1e-5);
+            }
+        }
+        std::cout << "  [PASS] softmax/log_softmax " << table->name << "\n";
+    }
+}
+
+void test_hash_variants()
+{
+    std::cout << "\nRunning Hash Variant Test...\n";
+
+    std::mt19937 rng(4);
+    std::vector<unsigned char> data(5000);
+    for (auto& b : data) b = static_cast<unsigned char>(rng());
+
+    const KernelTable* reference = kernels_for(Isa::Scalar);
+    for (const KernelTable* table : available_tables())
+    {
+        // every variant agrees on lengths around the stripe and block edges
+        for (std::size_t n : {0, 1, 7, 63, 64, 65, 127, 1023, 1024, 1025, 4096, 5000})
+        {
+            uint64_t expected[2], actual[2];
+            reference->hash128(data.data(), n, 42, expected);
+            table->hash128(data.data(), n, 42, actual);
+            assert(expected[0] == actual[0] && expected[1] == actual[1]);
+        }
+        std::cout << "  [PASS] hash128 " << table->name << "\n";
+    }
+
+    // the seed, one flipped bit and a trailing zero byte all change the hash
+    uint64_t base[2], other[2];
+    kernels().hash128(data.data(), 3000, 0, base);
+    kernels().hash128(data.data(), 3000, 1, other);
+    assert(base[0] != other[0] && base[1] != other[1]);
+
+    data[1234] ^= 0x10;
+    kernels().hash128(data.data(), 3000, 0, other);
+    assert(base[0] != other[0] && base[1] != other[1]);
+
+    std::vector<unsigned char> padded = {1, 2, 3, 0};
+    kernels().hash128(padded.data(), 3, 0, base);
+    kernels().hash128(padded.data(), 4, 0, other);
+    assert(base[0] != other[0] && base[1] != other[1]);
+    std::cout << "  [PASS] seed, data and length change the hash\n";
+}
+
+int main()
+{
+    try
+    {
+        test_cpu_features();
+        test_sgemm_variants();
+        test_sgemm_f16_variants();
+        test_bsr_gemm_variants();
+        test_elementwise_variants();
+        test_u8_to_float_variants();
+        test_transpose_variants();
+        test_activation_accuracy();
+        test_softmax_variants();
+        test_hash_variants();
+        std::cout << "\nKERNEL TESTS PASSED!\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Kernel test failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
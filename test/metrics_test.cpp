@@ -0,0 +1,90 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/metrics.h"
+
+void test_counters()
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    Counter& hits = registry.counter("test_hits_total", "Hits", {{"model", "a"}});
+    assert(&hits == &registry.counter("test_hits_total", "Hits", {{"model", "a"}}));
+    assert(&hits != &registry.counter("test_hits_total", "Hits", {{"model", "b"}}));
+
+    // striped increments from several threads add up
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&] { for (int i = 0; i < 10000; ++i) hits.inc(); });
+    for (auto& t : threads) t.join();
+    assert(hits.value() == 80000);
+
+    bool threw = false;
+    try { registry.gauge("test_hits_total", "Hits"); }
+    catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    std::cout << "  [PASS] striped counters and type checks\n";
+}
+
+void test_histogram()
+{
+    // buckets tile the value range without gaps
+    for (std::size_t b = 0; b + 1 < Histogram::kBuckets; ++b)
+        assert(Histogram::bucket_upper(b) + 1 == Histogram::bucket_lower(b + 1));
+    for (uint64_t v : {0ull, 1ull, 63ull, 64ull, 65ull, 1000ull, 123456789ull})
+    {
+        std::size_t b = Histogram::bucket_of(v);
+        assert(Histogram::bucket_lower(b) <= v && v <= Histogram::bucket_upper(b));
+    }
+
+    // uniform 1..100000 us: quantiles within the bucket resolution
+    Histogram h;
+    for (uint64_t v = 1; v <= 100000; ++v) h.record(v);
+    assert(h.count() == 100000);
+    assert(h.max() == 100000);
+    for (double q : {0.5, 0.9, 0.99, 0.999})
+    {
+        double expected = q * 100000;
+        assert(std::fabs(h.quantile(q) - expected) / expected < 0.035);
+    }
+    assert(h.quantile(1.0) == 100000.0);
+    std::cout << "  [PASS] log-linear buckets and quantiles\n";
+}
+
+void test_prometheus_text()
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    registry.gauge("test_depth", "Queue depth").set(3);
+    Histogram& latency = registry.histogram("test_latency_seconds", "Latency", {{"model", "m\"1"}});
+    for (int i = 0; i < 10; ++i) latency.record(2000);      // 2 ms, reported within the 1984..2015 bucket
+
+    std::ostringstream out;
+    registry.write_prometheus(out);
+    const std::string text = out.str();
+
+    assert(text.find("# TYPE test_depth gauge\ntest_depth 3\n") != std::string::npos);
+    assert(text.find("# TYPE test_latency_seconds summary") != std::string::npos);
+    assert(text.find("test_latency_seconds{model=\"m\\\"1\",quantile=\"0.99\"} 0.00199") != std::string::npos);
+    assert(text.find("test_latency_seconds_count{model=\"m\\\"1\"} 10") != std::string::npos);
+    assert(text.find("test_latency_seconds_sum{model=\"m\\\"1\"} 0.02") != std::string::npos);
+    std::cout << "  [PASS] Prometheus text exposition\n";
+}
+
+int main()
+{
+    try
+    {
+        test_counters();
+        test_histogram();
+        test_prometheus_text();
+        std::cout << "\nMETRICS TESTS PASSED!\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Metrics test failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
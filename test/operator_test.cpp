@@ -0,0 +1,435 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "../src/operator_registry.h"
+#include "../src/node.h"
+#include "../src/onnx-ml.pb.h"
+
+// build a node of the given type with optional INT attribute
+Node make_node(const std::string& op_type, const std::string& attr_name = "", int64_t attr_value = 0)
+{
+    onnx::NodeProto proto;
+    proto.set_name("test_" + op_type);
+    proto.set_op_type(op_type);
+
+    if (!attr_name.empty())
+    {
+        auto* attr = proto.add_attribute();
+        attr->set_name(attr_name);
+        attr->set_type(onnx::AttributeProto::INT);
+        attr->set_i(attr_value);
+    }
+    return Node(proto);
+}
+
+// build a node with one INTS attribute
+Node make_node_ints(const std::string& op_type, const std::string& attr_name, const std::vector<int64_t>& values)
+{
+    onnx::NodeProto proto;
+    proto.set_name("test_" + op_type);
+    proto.set_op_type(op_type);
+
+    auto* attr = proto.add_attribute();
+    attr->set_name(attr_name);
+    attr->set_type(onnx::AttributeProto::INTS);
+    for (auto v : values) attr->add_ints(v);
+    return Node(proto);
+}
+
+// append an INTS attribute to a node proto
+void add_ints(onnx::NodeProto& proto, const std::string& name, const std::vector<int64_t>& values)
+{
+    auto* attr = proto.add_attribute();
+    attr->set_name(name);
+    attr->set_type(onnx::AttributeProto::INTS);
+    for (auto v : values) attr->add_ints(v);
+}
+
+// run one operator on the given inputs and return its first output
+Tensor<float> run_operator(const Node& node, const std::vector<Tensor<float>*>& inputs)
+{
+    auto op = OperatorRegistry::create_operator(node.get_optype());
+    assert(op);
+    op->set_attributes(node);
+
+    Tensor<float> output(std::vector<std::size_t>{});
+    std::vector<Tensor<float>*> outputs = {&output};
+    op->forward(inputs, outputs);
+    return output;
+}
+
+// run one operator through the typed entry point
+AnyTensor run_any(const Node& node, const std::vector<AnyTensor*>& inputs)
+{
+    auto op = OperatorRegistry::create_operator(node.get_optype());
+    assert(op);
+    op->set_attributes(node);
+
+    AnyTensor output;
+    std::vector<AnyTensor*> outputs = {&output};
+    op->run(inputs, outputs);
+    return output;
+}
+
+void test_softmax_axis()
+{
+    std::cout << "Running Softmax Axis Test...\n";
+
+    // [2, 3, 4] input, normalize along the middle axis
+    Tensor<float> x({2, 3, 4});
+    for (std::size_t i = 0; i < x.size(); ++i) x[i] = 0.1f * static_cast<float>(i % 7) - 0.3f;
+
+    Tensor<float> y = run_operator(make_node("Softmax", "axis", 1), {&x});
+    Tensor<float> log_y = run_operator(make_node("LogSoftmax", "axis", 1), {&x});
+    assert(y.shape() == x.shape());
+
+    for (std::size_t o = 0; o < 2; ++o)
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            double sum = 0.0;
+            for (std::size_t k = 0; k < 3; ++k) sum += std::exp(x.at({o, k, i}));
+
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                double p = std::exp(x.at({o, k, i})) / sum;
+                assert(std::fabs(y.at({o, k, i}) - p) < 1e-6);
+                assert(std::fabs(log_y.at({o, k, i}) - std::log(p)) < 1e-5);
+            }
+        }
+    }
+    std::cout << "  [PASS] Softmax/LogSoftmax along axis 1\n";
+}
+
+void test_elementwise_activations()
+{
+    std::cout << "\nRunning Activation Operator Test...\n";
+
+    Tensor<float> x({2, 5});
+    for (std::size_t i = 0; i < x.size(); ++i) x[i] = static_cast<float>(i) - 4.5f;
+
+    Tensor<float> sig = run_operator(make_node("Sigmoid"), {&x});
+    Tensor<float> th = run_operator(make_node("Tanh"), {&x});
+    Tensor<float> gelu = run_operator(make_node("Gelu"), {&x});
+
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        double v = x[i];
+        assert(std::fabs(sig[i] - 1.0 / (1.0 + std::exp(-v))) < 1e-6);
+        assert(std::fabs(th[i] - std::tanh(v)) < 1e-6);
+        assert(std::fabs(gelu[i] - 0.5 * v * (1.0 + std::erf(v / std::sqrt(2.0)))) < 1e-5);
+    }
+    std::cout << "  [PASS] Sigmoid/Tanh/Gelu\n";
+}
+
+// fill with a deterministic, non-trivial pattern
+void fill_pattern(Tensor<float>& t, float scale)
+{
+    for (std::size_t i = 0; i < t.size(); ++i) t[i] = scale * static_cast<float>((i * 7) % 11) - 0.5f;
+}
+
+void test_add_broadcast()
+{
+    std::cout << "\nRunning Add Broadcast Test...\n";
+
+    // conv bias style: [1, 2, 3, 4] + [2, 1, 1]
+    Tensor<float> x({1, 2, 3, 4});
+    Tensor<float> bias({2, 1, 1});
+    fill_pattern(x, 0.25f);
+    bias[0] = 10.0f;
+    bias[1] = -10.0f;
+
+    Tensor<float> y = run_operator(make_node("Add"), {&x, &bias});
+    assert(y.shape() == x.shape());
+    for (std::size_t c = 0; c < 2; ++c)
+        for (std::size_t h = 0; h < 3; ++h)
+            for (std::size_t w = 0; w < 4; ++w)
+                assert(y.at({0, c, h, w}) == x.at({0, c, h, w}) + bias[c]);
+
+    // both sides broadcast: [3, 1] + [1, 4] -> [3, 4]
+    Tensor<float> col({3, 1});
+    Tensor<float> row({1, 4});
+    fill_pattern(col, 1.0f);
+    fill_pattern(row, 2.0f);
+
+    Tensor<float> outer = run_operator(make_node("Add"), {&col, &row});
+    assert((outer.shape() == std::vector<std::size_t>{3, 4}));
+    for (std::size_t i = 0; i < 3; ++i)
+        for (std::size_t j = 0; j < 4; ++j)
+            assert(outer.at({i, j}) == col[i] + row[j]);
+
+    std::cout << "  [PASS] Add broadcasting\n";
+}
+
+// reference batched matmul over explicit broadcast indices
+float matmul_reference(const Tensor<float>& A, const Tensor<float>& B, std::size_t a_batch, std::size_t b_batch, std::size_t m, std::size_t n)
+{
+    const std::size_t M = A.shape()[A.shape().size() - 2], K = A.shape().back(), N = B.shape().back();
+    float sum = 0.0f;
+    for (std::size_t k = 0; k < K; ++k) sum += A[a_batch * M * K + m * K + k] * B[b_batch * K * N + k * N + n];
+    return sum;
+}
+
+void test_matmul_batched()
+{
+    std::cout << "\nRunning MatMul Batched Test...\n";
+
+    // [2, 1, 5, 3] x [4, 3, 6] -> [2, 4, 5, 6]
+    Tensor<float> A({2, 1, 5, 3});
+    Tensor<float> B({4, 3, 6});
+    fill_pattern(A, 0.5f);
+    fill_pattern(B, 0.25f);
+
+    Tensor<float> Y = run_operator(make_node("MatMul"), {&A, &B});
+    assert((Y.shape() == std::vector<std::size_t>{2, 4, 5, 6}));
+
+    for (std::size_t i = 0; i < 2; ++i)
+        for (std::size_t j = 0; j < 4; ++j)
+            for (std::size_t m = 0; m < 5; ++m)
+                for (std::size_t n = 0; n < 6; ++n)
+                    assert(std::fabs(Y.at({i, j, m, n}) - matmul_reference(A, B, i, j, m, n)) < 1e-5f);
+    std::cout << "  [PASS] broadcast batch dims\n";
+
+    // shared weight: [3, 7, 8] x [8, 2] collapses into one GEMM
+    Tensor<float> X({3, 7, 8});
+    Tensor<float> W({8, 2});
+    fill_pattern(X, 0.1f);
+    fill_pattern(W, 0.3f);
+
+    Tensor<float> Z = run_operator(make_node("MatMul"), {&X, &W});
+    assert((Z.shape() == std::vector<std::size_t>{3, 7, 2}));
+    for (std::size_t b = 0; b < 3; ++b)
+        for (std::size_t m = 0; m < 7; ++m)
+            for (std::size_t n = 0; n < 2; ++n)
+                assert(std::fabs(Z.at({b, m, n}) - matmul_reference(X, W, b, 0, m, n)) < 1e-5f);
+    std::cout << "  [PASS] collapsed batch\n";
+
+    // vector promotion: [8] x [8, 2] -> [2]
+    Tensor<float> v({8});
+    fill_pattern(v, 1.0f);
+    Tensor<float> vw = run_operator(make_node("MatMul"), {&v, &W});
+    assert((vw.shape() == std::vector<std::size_t>{2}));
+    std::cout << "  [PASS] 1-D promotion\n";
+}
+
+void test_transpose()
+{
+    std::cout << "\nRunning Transpose Test...\n";
+
+    // NCHW -> NHWC
+    Tensor<float> x({2, 3, 4, 5});
+    fill_pattern(x, 1.0f);
+
+    Tensor<float> y = run_operator(make_node_ints("Transpose", "perm", {0, 2, 3, 1}), {&x});
+    assert((y.shape() == std::vector<std::size_t>{2, 4, 5, 3}));
+    for (std::size_t n = 0; n < 2; ++n)
+        for (std::size_t c = 0; c < 3; ++c)
+            for (std::size_t h = 0; h < 4; ++h)
+                for (std::size_t w = 0; w < 5; ++w)
+                    assert(y.at({n, h, w, c}) == x.at({n, c, h, w}));
+    assert(!y.is_view());
+    std::cout << "  [PASS] NCHW -> NHWC\n";
+
+    // innermost axis kept, outer axes swapped: contiguous run copies
+    Tensor<float> z = run_operator(make_node_ints("Transpose", "perm", {1, 0, 2, 3}), {&x});
+    for (std::size_t n = 0; n < 2; ++n)
+        for (std::size_t c = 0; c < 3; ++c)
+            for (std::size_t h = 0; h < 4; ++h)
+                for (std::size_t w = 0; w < 5; ++w)
+                    assert(z.at({c, n, h, w}) == x.at({n, c, h, w}));
+
+    // default perm reverses the dims
+    Tensor<float> r = run_operator(make_node("Transpose"), {&x});
+    assert((r.shape() == std::vector<std::size_t>{5, 4, 3, 2}));
+    assert(r.at({4, 1, 2, 0}) == x.at({0, 2, 1, 4}));
+    std::cout << "  [PASS] run copies and default perm\n";
+
+    // only a size-1 dim moves: zero-copy view
+    Tensor<float> v({1, 6, 7});
+    fill_pattern(v, 1.0f);
+    Tensor<float> view = run_operator(make_node_ints("Transpose", "perm", {1, 0, 2}), {&v});
+    assert((view.shape() == std::vector<std::size_t>{6, 1, 7}));
+    assert(view.is_view() && view.data() == v.data());
+    std::cout << "  [PASS] size-1 permutation is zero-copy\n";
+}
+
+// naive grouped convolution with symmetric stride/pad/dilation
+float conv_reference(const Tensor<float>& X, const Tensor<float>& W, const Tensor<float>* B, std::size_t group,
+                     std::size_t n, std::size_t m, std::size_t oh, std::size_t ow, long stride, long pad, long dilation)
+{
+    const std::size_t Cg = W.shape()[1], KH = W.shape()[2], KW = W.shape()[3];
+    const long H = X.shape()[2], Wd = X.shape()[3];
+    const std::size_t g = m / (W.shape()[0] / group);
+
+    float sum = B ? (*B)[m] : 0.0f;
+    for (std::size_t c = 0; c < Cg; ++c)
+        for (std::size_t i = 0; i < KH; ++i)
+            for (std::size_t j = 0; j < KW; ++j)
+            {
+                long ih = static_cast<long>(oh) * stride + static_cast<long>(i) * dilation - pad;
+                long iw = static_cast<long>(ow) * stride + static_cast<long>(j) * dilation - pad;
+                if (ih < 0 || ih >= H || iw < 0 || iw >= Wd) continue;
+                sum += X.at({n, g * Cg + c, static_cast<std::size_t>(ih), static_cast<std::size_t>(iw)}) * W.at({m, c, i, j});
+            }
+    return sum;
+}
+
+void test_conv()
+{
+    std::cout << "\nRunning Conv Test...\n";
+
+    // grouped, strided, padded, dilated
+    Tensor<float> X({2, 4, 9, 8});
+    Tensor<float> W({6, 2, 3, 3});
+    Tensor<float> B({6});
+    fill_pattern(X, 0.2f);
+    fill_pattern(W, 0.1f);
+    fill_pattern(B, 1.0f);
+
+    onnx::NodeProto proto;
+    proto.set_op_type("Conv");
+    add_ints(proto, "strides", {2, 2});
+    add_ints(proto, "pads", {2, 2, 2, 2});
+    add_ints(proto, "dilations", {2, 2});
+    auto* group = proto.add_attribute();
+    group->set_name("group");
+    group->set_type(onnx::AttributeProto::INT);
+    group->set_i(2);
+
+    Tensor<float> Y = run_operator(Node(proto), {&X, &W, &B});
+    assert((Y.shape() == std::vector<std::size_t>{2, 6, 5, 4}));
+    for (std::size_t n = 0; n < 2; ++n)
+        for (std::size_t m = 0; m < 6; ++m)
+            for (std::size_t oh = 0; oh < 5; ++oh)
+                for (std::size_t ow = 0; ow < 4; ++ow)
+                    assert(std::fabs(Y.at({n, m, oh, ow}) - conv_reference(X, W, &B, 2, n, m, oh, ow, 2, 2, 2)) < 1e-4f);
+    std::cout << "  [PASS] grouped/strided/dilated\n";
+
+    // SAME_UPPER 5x5 without bias keeps the spatial size
+    Tensor<float> W5({3, 4, 5, 5});
+    fill_pattern(W5, 0.05f);
+    onnx::NodeProto same;
+    same.set_op_type("Conv");
+    auto* auto_pad = same.add_attribute();
+    auto_pad->set_name("auto_pad");
+    auto_pad->set_type(onnx::AttributeProto::STRING);
+    auto_pad->set_s("SAME_UPPER");
+
+    Tensor<float> Z = run_operator(Node(same), {&X, &W5});
+    assert((Z.shape() == std::vector<std::size_t>{2, 3, 9, 8}));
+    for (std::size_t m = 0; m < 3; ++m)
+        for (std::size_t oh = 0; oh < 9; ++oh)
+            for (std::size_t ow = 0; ow < 8; ++ow)
+                assert(std::fabs(Z.at({1, m, oh, ow}) - conv_reference(X, W5, nullptr, 1, 1, m, oh, ow, 1, 2, 1)) < 1e-4f);
+    std::cout << "  [PASS] SAME_UPPER padding\n";
+}
+
+void test_pooling()
+{
+    std::cout << "\nRunning Pooling Test...\n";
+
+    Tensor<float> X({1, 2, 5, 5});
+    fill_pattern(X, 1.0f);
+
+    onnx::NodeProto max_proto;
+    max_proto.set_op_type("MaxPool");
+    add_ints(max_proto, "kernel_shape", {2, 2});
+    add_ints(max_proto, "strides", {2, 2});
+
+    Tensor<float> M = run_operator(Node(max_proto), {&X});
+    assert((M.shape() == std::vector<std::size_t>{1, 2, 2, 2}));
+    for (std::size_t c = 0; c < 2; ++c)
+        for (std::size_t i = 0; i < 2; ++i)
+            for (std::size_t j = 0; j < 2; ++j)
+            {
+                float expected = std::max(std::max(X.at({0, c, 2 * i, 2 * j}), X.at({0, c, 2 * i, 2 * j + 1})),
+                                          std::max(X.at({0, c, 2 * i + 1, 2 * j}), X.at({0, c, 2 * i + 1, 2 * j + 1})));
+                assert(M.at({0, c, i, j}) == expected);
+            }
+
+    // padded average excludes the padding by default: the corner averages 4 values
+    onnx::NodeProto avg_proto;
+    avg_proto.set_op_type("AveragePool");
+    add_ints(avg_proto, "kernel_shape", {3, 3});
+    add_ints(avg_proto, "pads", {1, 1, 1, 1});
+
+    Tensor<float> A = run_operator(Node(avg_proto), {&X});
+    assert((A.shape() == std::vector<std::size_t>{1, 2, 5, 5}));
+    float corner = (X.at({0, 1, 0, 0}) + X.at({0, 1, 0, 1}) + X.at({0, 1, 1, 0}) + X.at({0, 1, 1, 1})) / 4.0f;
+    assert(std::fabs(A.at({0, 1, 0, 0}) - corner) < 1e-6f);
+
+    Tensor<float> G = run_operator(make_node("GlobalAveragePool"), {&X});
+    assert((G.shape() == std::vector<std::size_t>{1, 2, 1, 1}));
+    std::cout << "  [PASS] MaxPool/AveragePool/GlobalAveragePool\n";
+}
+
+void test_shape_ops()
+{
+    Tensor<float> x({2, 3, 4});
+    fill_pattern(x, 0.5f);
+    AnyTensor X(x);
+
+    // Shape -> Gather -> Reshape: the usual dynamic flatten chain
+    AnyTensor S = run_any(make_node("Shape"), {&X});
+    assert(S.dtype() == DataType::Int64);
+    assert((S.to_int64() == std::vector<int64_t>{2, 3, 4}));
+
+    Tensor<int32_t> idx({1});
+    idx[0] = -3;                                   // negative index counts from the end
+    AnyTensor I(idx);
+    AnyTensor batch = run_any(make_node("Gather"), {&S, &I});
+    assert((batch.to_int64() == std::vector<int64_t>{2}));
+
+    Tensor<int64_t> target({2});
+    target[0] = 0;
+    target[1] = -1;
+    AnyTensor T(target);
+    AnyTensor R = run_any(make_node("Reshape"), {&X, &T});
+    assert((R.shape() == std::vector<std::size_t>{2, 12}));
+    assert(R.is_view() && R.raw() == X.raw());
+
+    // Gather on axis 1 of float data
+    Tensor<int64_t> rows({2});
+    rows[0] = 2;
+    rows[1] = 0;
+    AnyTensor Rows(rows);
+    AnyTensor G = run_any(make_node("Gather", "axis", 1), {&X, &Rows});
+    assert((G.shape() == std::vector<std::size_t>{2, 2, 4}));
+    assert(G.get<float>().at({1, 0, 3}) == x.at({1, 2, 3}));
+    assert(G.get<float>().at({0, 1, 1}) == x.at({0, 0, 1}));
+
+    // Cast to float16 and back, then feed fp16 straight into a float operator
+    AnyTensor H = run_any(make_node("Cast", "to", 10), {&X});
+    assert(H.dtype() == DataType::Float16);
+    AnyTensor Y = run_any(make_node("Relu"), {&H});
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        float expected = x.data()[i] > 0.0f ? x.data()[i] : 0.0f;
+        assert(std::fabs(Y.get<float>().data()[i] - expected) <= 1e-3f * (1.0f + std::fabs(expected)));
+    }
+    std::cout << "  [PASS] Shape/Gather/Reshape/Cast on typed tensors\n";
+}
+
+int main()
+{
+    try
+    {
+        test_softmax_axis();
+        test_elementwise_activations();
+        test_add_broadcast();
+        test_matmul_batched();
+        test_transpose();
+        test_conv();
+        test_pooling();
+        test_shape_ops();
+        std::cout << "\nOPERATOR TESTS PASSED!\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Operator test failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,316 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "../src/graph.h"
+#include "../src/graph_optimizer.h"
+#include "../src/inference_engine.h"
+#include "../src/onnx-ml.pb.h"
+
+// add a float initializer with the given values to the graph proto
+void add_initializer(onnx::GraphProto& graph, const std::string& name, const std::vector<int64_t>& dims, const std::vector<float>& values)
+{
+    auto* init = graph.add_initializer();
+    init->set_name(name);
+    init->set_data_type(onnx::TensorProto::FLOAT);
+    for (auto d : dims) init->add_dims(d);
+    for (auto v : values) init->add_float_data(v);
+}
+
+// Gemm(transB) -> BatchNormalization -> out
+onnx::GraphProto build_gemm_bn_graph()
+{
+    onnx::GraphProto graph;
+    graph.add_input()->set_name("x");
+    graph.add_output()->set_name("out");
+
+    auto* gemm = graph.add_node();
+    gemm->set_name("fc");
+    gemm->set_op_type("Gemm");
+    gemm->add_input("x");
+    gemm->add_input("W");
+    gemm->add_input("C");
+    gemm->add_output("fc_out");
+    auto* trans = gemm->add_attribute();
+    trans->set_name("transB");
+    trans->set_type(onnx::AttributeProto::INT);
+    trans->set_i(1);
+
+    auto* bn = graph.add_node();
+    bn->set_name("bn");
+    bn->set_op_type("BatchNormalization");
+    for (const char* in : {"fc_out", "gamma", "beta", "mean", "var"}) bn->add_input(in);
+    bn->add_output("out");
+
+    // W is [N=3, K=4]
+    add_initializer(graph, "W", {3, 4}, {0.1f, -0.2f, 0.3f, 0.4f, 0.5f, 0.6f, -0.7f, 0.8f, 0.9f, 1.0f, 1.1f, -1.2f});
+    add_initializer(graph, "C", {3}, {0.5f, -0.5f, 0.25f});
+    add_initializer(graph, "gamma", {3}, {1.5f, 0.5f, 2.0f});
+    add_initializer(graph, "beta", {3}, {0.1f, 0.2f, -0.3f});
+    add_initializer(graph, "mean", {3}, {0.3f, -0.1f, 0.2f});
+    add_initializer(graph, "var", {3}, {0.9f, 1.2f, 0.4f});
+    return graph;
+}
+
+void test_fold_into_gemm()
+{
+    std::cout << "Running BatchNorm -> Gemm Folding Test...\n";
+
+    onnx::GraphProto proto = build_gemm_bn_graph();
+
+    Tensor<float> x({2, 4});
+    for (std::size_t i = 0; i < x.size(); ++i) x[i] = 0.3f * static_cast<float>(i) - 1.0f;
+
+    // reference: BatchNormalization executed as its own operator
+    Graph reference(proto);
+    InferenceEngine engine;
+    std::vector<float> expected;
+    {
+        auto results = engine.run(reference, {&x});
+        expected.assign(results[0]->data(), results[0]->data() + results[0]->size());
+    }
+
+    Graph folded(proto);
+    std::size_t count = GraphOptimizer::fold_batch_norm(folded);
+    assert(count == 1);
+    assert(folded.get_consumers("fc_out").empty());        // BN node is gone
+    assert(folded.get_producer("out")->get_optype() == "Gemm");
+    assert(!folded.has_initializer("gamma"));               // parameters freed
+    std::cout << "  [PASS] node removed and Gemm rewired\n";
+
+    auto results = engine.run(folded, {&x});
+    assert(results[0]->size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::fabs(results[0]->data()[i] - expected[i]) < 1e-5f);
+    }
+    std::cout << "  [PASS] folded output matches BatchNormalization\n";
+}
+
+void test_fold_into_conv()
+{
+    std::cout << "\nRunning BatchNorm -> Conv Folding Test...\n";
+
+    onnx::GraphProto graph;
+    graph.add_input()->set_name("x");
+    graph.add_output()->set_name("out");
+
+    // bias-free conv, the pass has to create one
+    auto* conv = graph.add_node();
+    conv->set_name("conv");
+    conv->set_op_type("Conv");
+    conv->add_input("x");
+    conv->add_input("W");
+    conv->add_output("conv_out");
+
+    auto* bn = graph.add_node();
+    bn->set_name("bn");
+    bn->set_op_type("BatchNormalization");
+    for (const char* in : {"conv_out", "gamma", "beta", "mean", "var"}) bn->add_input(in);
+    bn->add_output("out");
+
+    // W is [OC=2, IC=1, 1, 2]
+    add_initializer(graph, "W", {2, 1, 1, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+    add_initializer(graph, "gamma", {2}, {2.0f, 0.5f});
+    add_initializer(graph, "beta", {2}, {1.0f, -1.0f});
+    add_initializer(graph, "mean", {2}, {0.5f, 0.25f});
+    add_initializer(graph, "var", {2}, {3.0f, 0.0f});
+
+    Graph g(graph);
+    assert(GraphOptimizer::fold_batch_norm(g) == 1);
+
+    const float eps = 1e-5f;
+    const float a0 = 2.0f / std::sqrt(3.0f + eps), a1 = 0.5f / std::sqrt(0.0f + eps);
+
+    Node* folded = g.get_producer("out");
+    assert(folded && folded->get_inputs().size() == 3);
+    const Tensor<float>* W = g.get_initializer("W");
+    const Tensor<float>* B = g.get_initializer(folded->get_inputs()[2]);
+
+    assert(std::fabs(W->data()[0] - 1.0f * a0) < 1e-4f);
+    assert(std::fabs(W->data()[3] - 4.0f * a1) < 1e-1f);
+    assert(std::fabs(B->data()[0] - (1.0f - 0.5f * a0)) < 1e-4f);
+    assert(std::fabs(B->data()[1] - (-1.0f - 0.25f * a1)) < 1e-1f);
+    std::cout << "  [PASS] conv filters scaled and bias created\n";
+}
+
+// node with one input-list and optional INTS attributes
+onnx::NodeProto* add_node(onnx::GraphProto& graph, const std::string& op_type, const std::string& name,
+                          const std::vector<std::string>& inputs, const std::string& output)
+{
+    auto* node = graph.add_node();
+    node->set_name(name);
+    node->set_op_type(op_type);
+    for (const auto& in : inputs) node->add_input(in);
+    node->add_output(output);
+    return node;
+}
+
+void set_ints(onnx::NodeProto* node, const std::string& name, const std::vector<int64_t>& values)
+{
+    auto* attr = node->add_attribute();
+    attr->set_name(name);
+    attr->set_type(onnx::AttributeProto::INTS);
+    for (auto v : values) attr->add_ints(v);
+}
+
+std::vector<float> pattern(std::size_t n, float scale)
+{
+    std::vector<float> v(n);
+    for (std::size_t i = 0; i < n; ++i) v[i] = scale * static_cast<float>((i * 7) % 13) - 0.4f;
+    return v;
+}
+
+void test_nchwc_layout()
+{
+    std::cout << "\nRunning NCHWc Layout Test...\n";
+
+    // x -> Conv -> Add(bias) -> Relu -> MaxPool -> Conv -> Relu -> GlobalAveragePool -> out
+    //                                      \-> pooled (graph output, stays NCHW)
+    // channel counts (3, 10, 12) are not multiples of the block size
+    onnx::GraphProto proto;
+    proto.add_input()->set_name("x");
+    proto.add_output()->set_name("out");
+    proto.add_output()->set_name("pooled");
+
+    set_ints(add_node(proto, "Conv", "conv1", {"x", "W1"}, "c1"), "pads", {1, 1, 1, 1});
+    add_node(proto, "Add", "bias1", {"c1", "B1"}, "a1");
+    add_node(proto, "Relu", "relu1", {"a1"}, "r1");
+    auto* pool = add_node(proto, "MaxPool", "pool1", {"r1"}, "pooled");
+    set_ints(pool, "kernel_shape", {2, 2});
+    set_ints(pool, "strides", {2, 2});
+    set_ints(add_node(proto, "Conv", "conv2", {"pooled", "W2", "B2"}, "c2"), "strides", {1, 1});
+    add_node(proto, "Relu", "relu2", {"c2"}, "r2");
+    add_node(proto, "GlobalAveragePool", "gap", {"r2"}, "out");
+
+    add_initializer(proto, "W1", {10, 3, 3, 3}, pattern(270, 0.05f));
+    add_initializer(proto, "B1", {10, 1, 1}, pattern(10, 0.1f));
+    add_initializer(proto, "W2", {12, 10, 3, 3}, pattern(1080, 0.02f));
+    add_initializer(proto, "B2", {12}, pattern(12, 0.1f));
+
+    Tensor<float> x({1, 3, 11, 10});
+    std::vector<float> xv = pattern(x.size(), 0.3f);
+    std::copy(xv.begin(), xv.end(), x.data());
+
+    InferenceEngine engine;
+    Graph reference(proto);
+    auto expected = engine.run(reference, {&x});
+    std::vector<std::size_t> out_shape = expected[0]->shape(), pooled_shape = expected[1]->shape();
+    std::vector<float> out_ref(expected[0]->data(), expected[0]->data() + expected[0]->size());
+    std::vector<float> pooled_ref(expected[1]->data(), expected[1]->data() + expected[1]->size());
+
+    Graph blocked(proto);
+    GraphOptimizer::optimize(blocked);
+    assert(blocked.get_producer("a1") == nullptr);                          // bias Add folded
+    assert(blocked.get_producer("c2_nchwc")->get_optype() == "NchwcConv");
+    assert(blocked.get_producer("pooled")->get_optype() == "ReorderOutput");
+    assert(blocked.get_producer("r1") == nullptr);                          // unused reorder dropped
+    std::cout << "  [PASS] graph rewritten to NCHWc\n";
+
+    auto results = engine.run(blocked, {&x});
+    assert(results[0]->shape() == out_shape);
+    assert(results[1]->shape() == pooled_shape);
+    for (std::size_t i = 0; i < out_ref.size(); ++i) assert(std::fabs(results[0]->data()[i] - out_ref[i]) < 1e-4f);
+    for (std::size_t i = 0; i < pooled_ref.size(); ++i) assert(std::fabs(results[1]->data()[i] - pooled_ref[i]) < 1e-4f);
+    std::cout << "  [PASS] blocked outputs match NCHW\n";
+}
+
+void test_fp16_weights()
+{
+    std::cout << "\nRunning FP16 Weight Storage Test...\n";
+
+    onnx::GraphProto proto = build_gemm_bn_graph();
+
+    Tensor<float> x({2, 4});
+    for (std::size_t i = 0; i < x.size(); ++i) x[i] = 0.3f * static_cast<float>(i) - 1.0f;
+
+    Graph graph(proto);
+    InferenceEngine engine;
+    std::vector<float> expected;
+    {
+        auto results = engine.run(graph, {&x});
+        expected.assign(results[0]->data(), results[0]->data() + results[0]->size());
+    }
+
+    const std::size_t before = graph.initializer_bytes();
+    assert(GraphOptimizer::convert_weights_to_fp16(graph) == 1);
+    assert(graph.get_any_initializer("W")->dtype() == DataType::Float16);
+    assert(graph.get_any_initializer("C")->dtype() == DataType::Float32);   // bias stays float32
+    assert(graph.initializer_bytes() == before - 12 * 2);
+    assert(GraphOptimizer::convert_weights_to_fp16(graph) == 0);              // idempotent
+
+    auto results = engine.run(graph, {&x});
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::fabs(results[0]->data()[i] - expected[i]) < 5e-3f * (1.0f + std::fabs(expected[i])));
+    }
+    std::cout << "  [PASS] Gemm runs on float16 weights\n";
+}
+
+void test_sparse_weights()
+{
+    std::cout << "\nRunning Sparse Weight Test...\n";
+
+    // x [4, 512] -> MatMul with a 99% pruned [512, 512] weight -> out
+    const std::size_t K = 512, N = 512;
+    onnx::GraphProto proto;
+    proto.add_input()->set_name("x");
+    proto.add_output()->set_name("out");
+    auto* matmul = proto.add_node();
+    matmul->set_name("fc");
+    matmul->set_op_type("MatMul");
+    matmul->add_input("x");
+    matmul->add_input("W");
+    matmul->add_output("out");
+
+    std::vector<float> w(K * N, 0.0f);
+    for (std::size_t i = 0; i < w.size(); i += 97) w[i] = 0.01f * static_cast<float>(i % 13) - 0.05f;
+    add_initializer(proto, "W", {static_cast<int64_t>(K), static_cast<int64_t>(N)}, w);
+
+    Tensor<float> x({4, K});
+    for (std::size_t i = 0; i < x.size(); ++i) x[i] = std::sin(0.01f * static_cast<float>(i));
+
+    Graph graph(proto);
+    InferenceEngine engine;
+    std::vector<float> expected;
+    {
+        auto results = engine.run(graph, {&x});
+        expected.assign(results[0]->data(), results[0]->data() + results[0]->size());
+    }
+
+    // below the threshold nothing changes
+    assert(GraphOptimizer::sparsify_weights(graph, 0.999) == 0);
+    assert(graph.get_producer("out")->get_optype() == "MatMul");
+
+    assert(GraphOptimizer::sparsify_weights(graph, 0.9) == 1);
+    assert(graph.get_producer("out")->get_optype() == "SparseGemm");
+    assert(!graph.has_initializer("W"));
+    std::cout << "  [PASS] pruned MatMul moved to SparseGemm\n";
+
+    auto results = engine.run(graph, {&x});
+    assert((results[0]->shape() == std::vector<std::size_t>{4, N}));
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::fabs(results[0]->data()[i] - expected[i]) < 1e-4f);
+    }
+    std::cout << "  [PASS] sparse output matches dense\n";
+}
+
+int main()
+{
+    try
+    {
+        test_fold_into_gemm();
+        test_fold_into_conv();
+        test_nchwc_layout();
+        test_fp16_weights();
+        test_sparse_weights();
+        std::cout << "\nOPTIMIZER TESTS PASSED!\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Optimizer test failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/model_repository.h"
+#include "../src/inference_engine.h"
+#include "../src/kernels/kernels.h"
+
+namespace fs = std::filesystem;
+
+// scratch repository holding copies of the bundled models
+std::string make_repository()
+{
+    fs::path root = fs::temp_directory_path() / "infera_repository_test";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    fs::copy_file("models/mnist_ffn.onnx", root / "ffn_a.onnx");
+    fs::copy_file("models/mnist_ffn.onnx", root / "ffn_b.onnx");
+    fs::copy_file("models/mnist.onnx", root / "cnn.onnx");
+    return root.string();
+}
+
+void test_lazy_loading()
+{
+    const std::string root = make_repository();
+    ModelRepository repository(root);
+
+    assert((repository.available() == std::vector<std::string>{"cnn", "ffn_a", "ffn_b"}));
+    assert(repository.resident().empty() && repository.resident_bytes() == 0);
+
+    // concurrent first requests share one load
+    std::vector<std::shared_ptr<LoadedModel>> handles(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) threads.emplace_back([&, t] { handles[t] = repository.get("ffn_a"); });
+    for (auto& t : threads) t.join();
+    for (auto& h : handles) assert(h == handles[0]);
+    assert(repository.resident() == std::vector<std::string>{"ffn_a"});
+    assert(repository.resident_bytes() == handles[0]->bytes && handles[0]->bytes > 0);
+
+    Tensor<float> image({1, 1, 28, 28});
+    for (std::size_t i = 0; i < image.size(); ++i) image[i] = 0.5f;
+    InferenceEngine engine;
+    assert(engine.run(handles[0]->graph, {&image})[0]->size() == 10);
+
+    bool threw = false;
+    try { repository.get("missing"); }
+    catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    std::cout << "  [PASS] models load on first use, once\n";
+}
+
+void test_lru_eviction()
+{
+    const std::string root = make_repository();
+    const std::size_t ffn_bytes = ModelRepository::load_model("probe", root + "/ffn_a.onnx")->bytes;
+
+    // room for one ffn plus the small cnn, not two ffns
+    ModelRepository repository(root, ffn_bytes + ffn_bytes / 2);
+    auto a = repository.get("ffn_a");
+    repository.get("cnn");
+    repository.get("ffn_a");                                // a is now the most recent
+    repository.get("ffn_b");
+
+    // oldest first until under budget: cnn, then ffn_a
+    assert(repository.resident() == std::vector<std::string>{"ffn_b"});
+    assert(repository.resident_bytes() <= repository.memory_budget());
+
+    // the evicted handle is still usable by whoever held it
+    Tensor<float> image({1, 1, 28, 28});
+    for (std::size_t i = 0; i < image.size(); ++i) image[i] = 0.5f;
+    InferenceEngine engine;
+    assert(engine.run(a->graph, {&image})[0]->size() == 10);
+
+    // a fresh request reloads it
+    auto reloaded = repository.get("ffn_a");
+    assert(reloaded != a);
+    assert(repository.unload("ffn_a") && !repository.unload("ffn_a"));
+    std::cout << "  [PASS] least recently used models evicted under the budget\n";
+}
+
+void test_hot_swap()
+{
+    const std::string root = make_repository();
+    fs::create_directories(fs::path(root) / "digits");
+    fs::copy_file("models/mnist_ffn.onnx", fs::path(root) / "digits" / "1.onnx");
+
+    ModelRepository repository(root);
+    assert(repository.versions("digits") == std::vector<int64_t>{1});
+    auto v1 = repository.get("digits");
+    assert(v1->version == 1);
+
+    // a new version on disk is loaded in the background and published by scan
+    fs::copy_file("models/mnist.onnx", fs::path(root) / "digits" / "2.onnx");
+    repository.scan();
+    auto v2 = repository.swap("digits").get();              // joins the swap scan started
+    assert(v2->version == 2);
+    assert(repository.get("digits") == v2 && repository.get("digits", 2) == v2);
+
+    // requests holding version 1 finish on it, it is no longer served
+    Tensor<float> image({1, 1, 28, 28});
+    for (std::size_t i = 0; i < image.size(); ++i) image[i] = 0.5f;
+    InferenceEngine engine;
+    assert(engine.run(v1->graph, {&image})[0]->size() == 10);
+    bool threw = false;
+    try { repository.get("digits", 1); }
+    catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    assert(repository.resident_bytes() == v2->bytes);       // the old version is no longer accounted
+
+    // a broken version fails its swap and the current one keeps serving
+    { std::ofstream broken(fs::path(root) / "digits" / "3.onnx"); broken << "not a model"; }
+    repository.scan();
+    threw = false;
+    try { repository.swap("digits", 3).get(); }
+    catch (const std::exception&) { threw = true; }
+    assert(threw);
+    assert(repository.get("digits") == v2);
+
+    // explicit rollback to an older version
+    assert(repository.swap("digits", 1).get()->version == 1);
+    assert(repository.get("digits")->version == 1);
+
+    // a swap to another version while one is running is queued behind it, not merged
+    auto to_two = repository.swap("digits", 2);
+    auto to_one = repository.swap("digits", 1);
+    assert(to_two.get()->version == 2 && to_one.get()->version == 1);
+    assert(repository.get("digits")->version == 1);
+
+    // a cold model loads its highest version whatever the first request pins
+    fs::remove(fs::path(root) / "digits" / "3.onnx");
+    {
+        ModelRepository fresh(root);
+        threw = false;
+        try { fresh.get("digits", 1); }
+        catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        assert(fresh.get("digits")->version == 2);
+    }
+    {
+        // pinned requests joining the first load are refused too
+        ModelRepository fresh(root);
+        std::vector<std::thread> threads;
+        std::vector<int> refused(4, 0);
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&, t]
+            {
+                try { fresh.get("digits", t % 2 ? 1 : 2); }
+                catch (const std::runtime_error&) { refused[t] = 1; }
+            });
+        }
+        for (auto& t : threads) t.join();
+        assert((refused == std::vector<int>{0, 1, 0, 1}));
+        assert(fresh.get("digits")->version == 2);
+    }
+
+    // once its swaps are done a model that was swapped can still be removed
+    fs::remove_all(fs::path(root) / "digits");
+    repository.scan();
+    assert(!repository.contains("digits"));
+    std::cout << "  [PASS] versions swapped in without dropping in-flight handles\n";
+}
+
+void test_result_cache()
+{
+    const std::string root = make_repository();
+    fs::create_directories(fs::path(root) / "digits");
+    fs::copy_file("models/mnist_ffn.onnx", fs::path(root) / "digits" / "1.onnx");
+
+    ModelRepository repository(root);
+    repository.set_result_cache_bytes(1 << 20);
+    auto v1 = repository.get("digits");
+    assert(v1->cache && v1->bytes == v1->graph.initializer_bytes() + (1 << 20));
+
+    AnyTensor image(DataType::Float32, {1, 1, 28, 28}), other(DataType::Float32, {1, 1, 28, 28});
+    for (std::size_t i = 0; i < image.size(); ++i)
+    {
+        image.get<float>()[i] = 0.5f;
+        other.get<float>()[i] = i % 2 ? 1.0f : 0.0f;
+    }
+
+    // the first run computes and stores, the repeat is served without the engine
+    InferenceEngine engine;
+    CachedOutputs first, second;
+    std::vector<const AnyTensor*> computed = v1->run(engine, {&image}, first);
+    std::vector<const AnyTensor*> cached = v1->run(engine, {&image}, second);
+    assert(first && first == second && cached[0] == computed[0]);
+    assert(v1->cache->hits() == 1 && v1->cache->misses() == 1);
+
+    const float* expected = engine.run(v1->graph, {&image})[0]->get<float>().data();
+    for (std::size_t i = 0; i < 10; ++i) assert(cached[0]->get<float>().data()[i] == expected[i]);
+
+    CachedOutputs third;
+    v1->run(engine, {&other}, third);
+    assert(third != first && v1->cache->misses() == 2 && v1->cache->entries() == 2);
+
+    // each shard is an LRU bounded by its share of the budget
+    ResultCache small("probe", 4096, 2);
+    auto result = std::make_shared<const std::vector<AnyTensor>>(std::vector<AnyTensor>{AnyTensor(DataType::Float32, {100})});
+    for (uint64_t k = 0; k < 64; ++k) small.insert({k, k << 32}, result);
+    assert(small.bytes() <= 4096 && small.entries() < 64 && small.entries() > 0);
+    assert(small.lookup({63, 63ull << 32}) && !small.lookup({0, 0}));
+
+    // a new version starts cold, the old one keeps its entries for in-flight handles
+    fs::copy_file("models/mnist_ffn.onnx", fs::path(root) / "digits" / "2.onnx");
+    repository.scan();
+    auto v2 = repository.swap("digits").get();
+    assert(v2->cache && v2->cache != v1->cache && v2->cache->entries() == 0);
+    CachedOutputs fresh;
+    v2->run(engine, {&image}, fresh);
+    assert(fresh != first && v2->cache->misses() == 1);
+    std::cout << "  [PASS] repeated inputs are answered from a per-version result cache\n";
+}
+
+void test_postprocessing()
+{
+    // two rows of four scores: top-2 with a threshold that drops one slot
+    AnyTensor logits(DataType::Float32, {2, 4});
+    const float values[] = {0.1f, 0.7f, 0.15f, 0.05f, 0.4f, 0.1f, 0.4f, 0.1f};
+    std::copy(values, values + 8, logits.get<float>().data());
+
+    Postprocessor head = Postprocessor::parse("topk=2, threshold=0.2");
+    std::vector<AnyTensor> out = head.apply(logits);
+    const int64_t* classes = out[0].get<int64_t>().data();
+    const float* scores = out[1].get<float>().data();
+    assert(out[0].shape() == std::vector<std::size_t>({2, 2}) && out[1].shape() == out[0].shape());
+    assert(classes[0] == 1 && scores[0] == 0.7f && classes[1] == -1 && scores[1] == 0.0f);
+    assert(classes[2] == 0 && classes[3] == 2);             // ties go to the lower class
+
+    out = Postprocessor::parse("softmax,argmax").apply(logits);
+    assert(out[0].get<int64_t>()[0] == 1 && out[0].get<int64_t>()[1] == 0);
+    assert(out[1].get<float>()[0] > 0.25f && out[1].get<float>()[0] < 1.0f);
+
+    bool rejected = false;
+    try
+    {
+        Postprocessor::parse("softmax,topk=0");
+    }
+    catch (const std::runtime_error&)
+    {
+        rejected = true;
+    }
+    assert(rejected);
+
+    // a head configured beside a versioned model replaces its outputs, and the cache keeps the compact result
+    const std::string root = make_repository();
+    fs::create_directories(fs::path(root) / "digits");
+    fs::copy_file("models/mnist_ffn.onnx", fs::path(root) / "digits" / "1.onnx");
+    std::ofstream(fs::path(root) / "digits" / "postprocess") << "softmax   # probabilities\ntopk=3\nlabels=names.txt\n";
+    std::ofstream(fs::path(root) / "digits" / "names.txt") << "zero\none\ntwo\nthree\nfour\nfive\nsix\nseven\neight\nnine\n";
+
+    ModelRepository repository(root);
+    repository.set_result_cache_bytes(1 << 20);
+    auto model = repository.get("digits");
+    assert(!model->postprocess.empty() && model->postprocess.label(3) == "three");
+    assert(model->output_count() == 2 && model->output_name(0) == "classes" && model->output_info(1).shape[1] == 3);
+    assert(repository.get("ffn_a")->postprocess.empty() && repository.get("ffn_a")->output_name(0) == model->graph.get_output_name(0));
+
+    AnyTensor image(DataType::Float32, {1, 1, 28, 28});
+    for (std::size_t i = 0; i < image.size(); ++i) image.get<float>()[i] = (i % 28) / 28.0f;
+
+    InferenceEngine engine;
+    CachedOutputs held;
+    std::vector<const AnyTensor*> result = model->run(engine, {&image}, held);
+    assert(result.size() == 2 && result[0]->shape() == std::vector<std::size_t>({1, 3}));
+
+    std::vector<float> probabilities(10);
+    kernels().softmax(engine.run(model->graph, {&image})[0]->get<float>().data(), probabilities.data(), 10);
+    const int64_t best = std::max_element(probabilities.begin(), probabilities.end()) - probabilities.begin();
+    assert(result[0]->get<int64_t>()[0] == best && result[1]->get<float>()[0] == probabilities[best]);
+    assert(result[1]->get<float>()[0] >= result[1]->get<float>()[1] && result[1]->get<float>()[1] >= result[1]->get<float>()[2]);
+
+    CachedOutputs again;
+    assert(model->run(engine, {&image}, again)[0] == result[0] && model->cache->hits() == 1);
+    std::cout << "  [PASS] postprocessing heads select top-k classes and replace the model's outputs\n";
+}
+
+int main()
+{
+    try
+    {
+        test_lazy_loading();
+        test_lru_eviction();
+        test_hot_swap();
+        test_result_cache();
+        test_postprocessing();
+        fs::remove_all(fs::temp_directory_path() / "infera_repository_test");
+        std::cout << "\nREPOSITORY TESTS PASSED!\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Repository test failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,390 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../src/server/inference_server.h"
+#include "../src/server/json.h"
+#include "../src/server/shm_transport.h"
+#include "../src/model_repository.h"
+#include "../src/inference_engine.h"
+
+namespace fs = std::filesystem;
+
+struct Reply
+{
+    int status = 0;
+    std::string headers;
+    std::string body;
+};
+
+// blocking client: one socket, requests written raw, responses framed by Content-Length
+class Client
+{
+public:
+    explicit Client(uint16_t port)
+    {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) throw std::runtime_error("connect failed");
+    }
+    ~Client() { close(fd_); }
+
+    void send_raw(const std::string& data)
+    {
+        std::size_t sent = 0;
+        while (sent < data.size())
+        {
+            ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, 0);
+            if (n <= 0) throw std::runtime_error("send failed");
+            sent += static_cast<std::size_t>(n);
+        }
+    }
+
+    Reply read_reply()
+    {
+        std::size_t end;
+        while ((end = buffer_.find("\r\n\r\n")) == std::string::npos) fill();
+
+        Reply reply;
+        reply.headers = buffer_.substr(0, end + 2);
+        reply.status = std::stoi(reply.headers.substr(9, 3));
+        std::size_t length_at = reply.headers.find("Content-Length: ");
+        std::size_t length = std::stoul(reply.headers.substr(length_at + 16));
+
+        while (buffer_.size() < end + 4 + length) fill();
+        reply.body = buffer_.substr(end + 4, length);
+        buffer_.erase(0, end + 4 + length);
+        return reply;
+    }
+
+    Reply request(const std::string& method, const std::string& path, const std::string& body = "", const std::string& headers = "")
+    {
+        send_raw(method + " " + path + " HTTP/1.1\r\nHost: test\r\nContent-Length: " + std::to_string(body.size()) + "\r\n" + headers + "\r\n" + body);
+        return read_reply();
+    }
+private:
+    void fill()
+    {
+        char chunk[4096];
+        ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) throw std::runtime_error("connection closed");
+        buffer_.append(chunk, static_cast<std::size_t>(n));
+    }
+
+    int fd_;
+    std::string buffer_;
+};
+
+void test_json()
+{
+    JsonValue doc = JsonValue::parse(R"({"a": [1, 2.5, -3e2], "b": "x\"é", "c": {"d": null, "e": true}})");
+    assert(doc.at("a").size() == 3 && doc.at("a").as_array()[2].as_number() == -300.0);
+    assert(doc.at("b").as_string() == "x\"\xc3\xa9");
+    assert(doc.at("c").at("d").is_null() && doc.at("c").at("e").as_bool());
+    assert(JsonValue::parse(doc.dump()).dump() == doc.dump());
+
+    bool threw = false;
+    try { JsonValue::parse("{\"a\": [1, 2}"); }
+    catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    std::cout << "  [PASS] JSON round trip and errors\n";
+}
+
+void test_server()
+{
+    fs::path root = fs::temp_directory_path() / "infera_server_test";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    fs::copy_file("models/mnist_ffn.onnx", root / "ffn.onnx");
+
+    // reference result straight from the engine
+    auto reference_model = ModelRepository::load_model("ffn", (root / "ffn.onnx").string());
+    const std::string input_name = reference_model->graph.get_input_name(0);
+    Tensor<float> image({1, 1, 28, 28});
+    for (std::size_t i = 0; i < image.size(); ++i) image[i] = static_cast<float>(i % 17) / 17.0f;
+    InferenceEngine engine;
+    std::vector<float> expected(10);
+    std::memcpy(expected.data(), engine.run(reference_model->graph, {&image})[0]->data(), 10 * sizeof(float));
+
+    ModelRepository repository(root.string());
+    ServerOptions options;
+    options.host = "127.0.0.1";
+    options.port = 0;
+    options.io_threads = 2;
+    options.workers = 2;
+    InferenceServer server(repository, options);
+    server.start();
+    assert(server.port() != 0);
+
+    Client client(server.port());
+    assert(client.request("GET", "/v2/health/ready").status == 200);
+
+    Reply metadata = client.request("GET", "/v2/models/ffn");
+    assert(metadata.status == 200);
+    JsonValue meta = JsonValue::parse(metadata.body);
+    assert(meta.at("name").as_string() == "ffn" && meta.at("inputs").as_array()[0].at("name").as_string() == input_name);
+
+    // JSON tensor data
+    std::string data;
+    for (std::size_t i = 0; i < image.size(); ++i)
+    {
+        if (i) data += ",";
+        JsonValue::append_number(data, image[i]);
+    }
+    const std::string json_request = "{\"inputs\":[{\"name\":\"" + input_name + "\",\"datatype\":\"FP32\",\"shape\":[1,1,28,28],\"data\":[" + data + "]}]}";
+    Reply reply = client.request("POST", "/v2/models/ffn/infer", json_request);
+    assert(reply.status == 200);
+    const JsonValue result = JsonValue::parse(reply.body);
+    const JsonValue& output = result.at("outputs").as_array()[0];
+    assert(output.at("datatype").as_string() == "FP32" && output.at("data").size() == 10);
+    for (std::size_t i = 0; i < 10; ++i) assert(std::fabs(output.at("data").as_array()[i].as_number() - expected[i]) < 1e-5);
+    std::cout << "  [PASS] JSON inference matches the engine\n";
+
+    // binary tensor data both ways
+    const std::string header = "{\"inputs\":[{\"name\":\"" + input_name + "\",\"datatype\":\"FP32\",\"shape\":[1,1,28,28],"
+                               "\"parameters\":{\"binary_data_size\":" + std::to_string(image.size() * 4) + "}}],"
+                               "\"parameters\":{\"binary_data_output\":true}}";
+    std::string body = header + std::string(reinterpret_cast<const char*>(image.data()), image.size() * sizeof(float));
+    reply = client.request("POST", "/v2/models/ffn/infer", body, "Inference-Header-Content-Length: " + std::to_string(header.size()) + "\r\n");
+    assert(reply.status == 200);
+    std::size_t at = reply.headers.find("Inference-Header-Content-Length: ");
+    assert(at != std::string::npos);
+    std::size_t json_bytes = std::stoul(reply.headers.substr(at + 33));
+    assert(reply.body.size() == json_bytes + 10 * sizeof(float));
+    std::vector<float> binary(10);
+    std::memcpy(binary.data(), reply.body.data() + json_bytes, 10 * sizeof(float));
+    for (std::size_t i = 0; i < 10; ++i) assert(binary[i] == expected[i]);
+    std::cout << "  [PASS] binary tensor data\n";
+
+    // two requests in one write come back in order
+    client.send_raw("GET /v2/models/ffn/ready HTTP/1.1\r\nHost: test\r\n\r\nGET /v2/models/nope HTTP/1.1\r\nHost: test\r\n\r\n");
+    assert(client.read_reply().status == 200);
+    assert(client.read_reply().status == 404);
+    std::cout << "  [PASS] pipelined requests\n";
+
+    assert(client.request("POST", "/v2/models/ffn/infer", "{\"inputs\":[]}").status == 400);
+    assert(client.request("POST", "/v2/models/ffn/infer", "{not json").status == 400);
+    assert(client.request("GET", "/v2/models/ffn/infer").status == 405);
+
+    // a shape whose element count wraps to zero must not pass as an empty tensor
+    const std::string wrapping = "{\"name\":\"" + input_name + "\",\"datatype\":\"FP32\",\"shape\":[4294967296,4294967296]";
+    reply = client.request("POST", "/v2/models/ffn/infer", "{\"inputs\":[" + wrapping + ",\"data\":[]}]}");
+    assert(reply.status == 400 && reply.body.find("overflows") != std::string::npos);
+    const std::string wrapping_binary = "{\"inputs\":[" + wrapping + ",\"parameters\":{\"binary_data_size\":0}}]}";
+    reply = client.request("POST", "/v2/models/ffn/infer", wrapping_binary, "Inference-Header-Content-Length: " + std::to_string(wrapping_binary.size()) + "\r\n");
+    assert(reply.status == 400 && reply.body.find("overflows") != std::string::npos);
+    assert(client.request("GET", "/v2/models/ffn/versions/7").status == 404);
+
+    Reply metrics = client.request("GET", "/metrics");
+    assert(metrics.status == 200);
+    assert(metrics.body.find("infera_inference_queue_seconds_count{model=\"ffn\"}") != std::string::npos);
+    assert(metrics.body.find("infera_http_connections_total") != std::string::npos);
+    std::cout << "  [PASS] errors and /metrics\n";
+
+    server.stop();
+    fs::remove_all(root);
+}
+
+void test_overload()
+{
+    fs::path root = fs::temp_directory_path() / "infera_overload_test";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    fs::copy_file("models/mnist_ffn.onnx", root / "ffn.onnx");
+
+    ModelRepository repository(root.string());
+    ServerOptions options;
+    options.host = "127.0.0.1";
+    options.port = 0;
+    options.io_threads = 1;
+    options.workers = 1;
+    options.max_queue = 3;
+    InferenceServer server(repository, options);
+    server.start();
+
+    const std::string input_name = repository.get("ffn")->graph.get_input_name(0);
+    std::string data = "0";
+    for (int i = 1; i < 784; ++i) data += ",0";
+    const std::string body = "{\"inputs\":[{\"name\":\"" + input_name + "\",\"datatype\":\"FP32\",\"shape\":[1,1,28,28],\"data\":[" + data + "]}]}";
+    auto send_infer = [&](Client& client, const std::string& headers)
+    {
+        client.send_raw("POST /v2/models/ffn/infer HTTP/1.1\r\nHost: test\r\nContent-Length: " + std::to_string(body.size()) + "\r\n" + headers + "\r\n" + body);
+    };
+
+    // jobs that hold the only worker until released, so requests pile up behind them
+    AsyncEngine& workers = server.workers();
+    auto wait_queued = [&](std::size_t n) { while (workers.queued() != n) std::this_thread::sleep_for(std::chrono::milliseconds(1)); };
+    std::promise<void> release_first, release_second, first_parked, second_parked;
+    std::shared_future<void> first_released = release_first.get_future().share();
+    std::shared_future<void> second_released = release_second.get_future().share();
+    workers.post([&](InferenceEngine&) { first_parked.set_value(); first_released.wait(); }, nullptr);
+    first_parked.get_future().wait();
+
+    Client low(server.port()), high(server.port()), full(server.port());
+    send_infer(low, "X-Infera-Priority: low\r\n");
+    wait_queued(1);
+    workers.post([&](InferenceEngine&) { second_parked.set_value(); second_released.wait(); }, nullptr);
+    wait_queued(2);
+    send_infer(high, "X-Infera-Priority: high\r\n");
+    wait_queued(3);
+
+    // a full queue answers at once
+    Reply reply = full.request("POST", "/v2/models/ffn/infer", body);
+    assert(reply.status == 503 && reply.headers.rfind("HTTP/1.1 503 Service Unavailable\r\n", 0) == 0);
+    std::cout << "  [PASS] a full queue answers 503\n";
+
+    // the high request overtakes both earlier ones: it is answered while the
+    // second job holds the worker and the low request still waits
+    release_first.set_value();
+    second_parked.get_future().wait();
+    assert(high.read_reply().status == 200);
+    assert(workers.queued() == 1);
+    std::cout << "  [PASS] X-Infera-Priority orders the queue\n";
+
+    // one request past its deadline, one whose client goes away while it waits
+    Counter& cancelled = MetricsRegistry::instance().counter("infera_inference_rejected_total", "Requests failed without running", {{"reason", "cancelled"}});
+    const uint64_t cancelled_before = cancelled.value();
+    Client expired(server.port());
+    send_infer(expired, "X-Infera-Timeout-Ms: 100\r\n");
+    const auto sent = std::chrono::steady_clock::now();
+    wait_queued(2);
+    auto gone = std::make_unique<Client>(server.port());
+    send_infer(*gone, "");
+    wait_queued(3);
+    gone.reset();
+
+    // the loop sees the close before it answers later requests on the same thread
+    Client probe(server.port());
+    assert(probe.request("GET", "/v2/health/ready").status == 200);
+    std::this_thread::sleep_until(sent + std::chrono::milliseconds(150));  // past its deadline
+    release_second.set_value();
+
+    reply = expired.read_reply();
+    assert(reply.status == 504 && reply.headers.rfind("HTTP/1.1 504 Gateway Timeout\r\n", 0) == 0);
+    assert(low.read_reply().status == 200);
+    assert(cancelled.value() == cancelled_before + 1);
+    std::cout << "  [PASS] deadlines answer 504 and a closed connection cancels its request\n";
+
+    server.stop();
+    fs::remove_all(root);
+}
+
+void test_shared_memory()
+{
+    fs::path root = fs::temp_directory_path() / "infera_shm_test";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    fs::copy_file("models/mnist_ffn.onnx", root / "ffn.onnx");
+
+    auto reference_model = ModelRepository::load_model("ffn", (root / "ffn.onnx").string());
+    const std::string input_name = reference_model->graph.get_input_name(0);
+    const std::string output_name = reference_model->graph.get_output_name(0);
+    Tensor<float> image({1, 1, 28, 28});
+    for (std::size_t i = 0; i < image.size(); ++i) image[i] = static_cast<float>(i % 13) / 13.0f;
+    InferenceEngine engine;
+    const Tensor<float> expected = *engine.run(reference_model->graph, {&image})[0];
+
+    ModelRepository repository(root.string());
+    ShmServer server(repository, (root / "infera.sock").string());
+    server.start();
+
+    // input written straight into the channel, output into the bytes after it
+    ShmClient client((root / "infera.sock").string(), 64 * 1024);
+    std::memcpy(client.data(), image.data(), image.size() * sizeof(float));
+    std::vector<ShmClient::TensorRef> inputs = {{input_name, DataType::Float32, {1, 1, 28, 28}, 0, 0, image.size() * sizeof(float)}};
+    std::vector<ShmClient::TensorRef> outputs = {{output_name, DataType::Float32, {}, 0, 32 * 1024, 1024}};
+    for (int round = 0; round < 3; ++round)
+    {
+        client.infer("ffn", inputs, outputs);
+        assert(outputs[0].shape == expected.shape() && outputs[0].byte_size == 10 * sizeof(float));
+        const float* result = reinterpret_cast<const float*>(static_cast<char*>(client.data()) + 32 * 1024);
+        for (std::size_t i = 0; i < 10; ++i) assert(result[i] == expected[i]);
+    }
+    std::cout << "  [PASS] shared memory channel matches the engine\n";
+
+    // outputs into a separately registered POSIX shm region
+    const std::string key = "/infera_shm_test_" + std::to_string(getpid());
+    int fd = shm_open(key.c_str(), O_CREAT | O_RDWR, 0600);
+    assert(fd >= 0 && ftruncate(fd, 4096) == 0);
+    float* region = static_cast<float*>(mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    close(fd);
+    const uint32_t id = client.register_region(key, 4096);
+    outputs = {{output_name, DataType::Float32, {}, id, 64, 64}};
+    client.infer("ffn", inputs, outputs);
+    for (std::size_t i = 0; i < 10; ++i) assert(region[16 + i] == expected[i]);
+    client.unregister_region(id);
+    munmap(region, 4096);
+    shm_unlink(key.c_str());
+
+    // errors come back as exceptions, and the channel stays usable
+    bool threw = false;
+    try { client.infer("missing", inputs, outputs); }
+    catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    threw = false;
+    outputs = {{output_name, DataType::Float32, {}, 0, 32 * 1024, 8}};
+    try { client.infer("ffn", inputs, outputs); }
+    catch (const std::runtime_error& e) { threw = std::string(e.what()).find("needs 40 bytes") != std::string::npos; }
+    assert(threw);
+
+    // an element count that wraps to zero bytes must not pass as an empty tensor
+    threw = false;
+    outputs = {{output_name, DataType::Float32, {}, 0, 32 * 1024, 1024}};
+    std::vector<ShmClient::TensorRef> wrapping = {{input_name, DataType::Float32, {1ull << 62, 4}, 0, 0, 0}};
+    try { client.infer("ffn", wrapping, outputs); }
+    catch (const std::runtime_error& e) { threw = std::string(e.what()).find("overflows") != std::string::npos; }
+    assert(threw);
+    client.infer("ffn", inputs, outputs);
+    std::cout << "  [PASS] registered regions and errors\n";
+
+    // a client that connects and never sends its channel does not hold up stop().
+    // channels are accepted in order, so once a later one answers it is being served
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, (root / "infera.sock").c_str());
+    int silent = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    assert(connect(silent, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    ShmClient later((root / "infera.sock").string(), 64 * 1024);
+    std::memcpy(later.data(), image.data(), image.size() * sizeof(float));
+    later.infer("ffn", inputs, outputs);
+    server.stop();
+    close(silent);
+    std::cout << "  [PASS] stop with a silent client connected\n";
+
+    fs::remove_all(root);
+}
+
+int main()
+{
+    try
+    {
+        test_json();
+        test_server();
+        test_overload();
+        test_shared_memory();
+        std::cout << "\nSERVER TESTS PASSED!\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Server test failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <cassert>
 #include <vector>
 #include "../src/tensor.h"
+#include "../src/any_tensor.h"
 
 void test_constructor_and_size()
 {
@@ -42,6 +43,62 @@ void test_dimensions()
     std::cout << "Dimension tests passed!" << std::endl;
 }
 
+void test_view()
+{
+    Tensor<float> owner({2, 3});
+    Tensor<float> v;
+    v.view(owner.data(), {3, 2});
+    assert(v.is_view() && v.data() == owner.data() && v.size() == 6);
+
+    // resizing a view detaches it instead of writing into borrowed memory
+    v.resize({3, 2});
+    assert(!v.is_view() && v.data() != owner.data());
+    std::cout << "View tests passed!" << std::endl;
+}
+
+void test_half_conversions()
+{
+    // exact values round-trip bit for bit
+    assert(float_to_half(1.0f) == 0x3c00 && half_to_float(0x3c00) == 1.0f);
+    assert(float_to_half(-2.5f) == 0xc100);
+    assert(half_to_float(0x0001) == 5.9604644775390625e-8f);     // smallest subnormal
+    assert(float_to_half(65504.0f) == 0x7bff && float_to_half(1e6f) == 0x7c00);
+
+    // ties round to even: 1 + 2^-11 sits halfway between 1 and the next half
+    assert(float_to_half(1.00048828125f) == 0x3c00);
+    assert(float_to_half(1.00146484375f) == 0x3c02);
+
+    assert(float_to_bfloat16(1.0f) == 0x3f80 && bfloat16_to_float(0x3f80) == 1.0f);
+    assert(bfloat16_to_float(float_to_bfloat16(3.140625f)) == 3.140625f);
+    std::cout << "Half precision tests passed!" << std::endl;
+}
+
+void test_any_tensor_cast()
+{
+    Tensor<float> values({4});
+    float src[] = {-1.5f, 0.0f, 2.75f, 7.0f};
+    for (std::size_t i = 0; i < 4; ++i) values[i] = src[i];
+
+    AnyTensor any(values);
+    assert(any.dtype() == DataType::Float32 && any.bytes() == 16);
+
+    AnyTensor half = any.cast(DataType::Float16);
+    assert(half.dtype() == DataType::Float16 && half.bytes() == 8);
+    AnyTensor back = half.cast(DataType::Float32);
+    for (std::size_t i = 0; i < 4; ++i) assert(back.get<float>()[i] == src[i]);
+
+    // float -> int truncates, anything -> bool is != 0
+    AnyTensor ints = any.cast(DataType::Int64);
+    assert((ints.to_int64() == std::vector<int64_t>{-1, 0, 2, 7}));
+    AnyTensor flags = any.cast(DataType::Bool);
+    assert(flags.get<bool>()[0] && !flags.get<bool>()[1]);
+
+    bool threw = false;
+    try { any.get<int32_t>(); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    std::cout << "AnyTensor cast tests passed!" << std::endl;
+}
+
 int main()
 {
     try
@@ -50,6 +107,9 @@ int main()
         test_copy_assignment();
         test_move_semantics();
         test_dimensions();
+        test_view();
+        test_half_conversions();
+        test_any_tensor_cast();
         std::cout << "TENSOR TESTS PASSED!" << std::endl;
     }
     catch (const std::exception &e)
@@ -58,4 +118,4 @@ int main()
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file